@@ -126,12 +126,19 @@ void benchmark_k_hop( GDI_Database db, GDI_Label* vlabels, uint64_t* bfs_roots,
 /**
   code written by George Mitenkov
  */
-void benchmark_cdlp( GDI_Database db, /* GDI_Label* vlabels, */ uint64_t nglobalverts, uint32_t max_num_iterations, uint32_t num_measurements ) {
+void benchmark_cdlp( GDI_Database db, /* GDI_Label* vlabels, */ uint32_t max_num_iterations, uint32_t num_measurements ) {
   int status;
 
   LSB_Init( "gdi_cdlp" /* project name */, 0 /* autoprofiling interval, deactivated */);
   LSB_Set_Rparam_int( "max_num_iterations", max_num_iterations );
 
+  /**
+    bitmap index over all vertices, that enumerates the local vertices
+   */
+  GDI_Index vertex_index;
+  status = GDI_CreateIndex( GDI_INDEX_BITMAP, GDI_LABEL_NONE, GDI_PROPERTY_TYPE_NULL, db, &vertex_index );
+  assert( status == GDI_SUCCESS );
+
   MPI_Barrier( MPI_COMM_WORLD );
 
   GDI_Transaction transaction;
@@ -146,7 +153,7 @@ void benchmark_cdlp( GDI_Database db, /* GDI_Label* vlabels, */ uint64_t nglobal
     status = GDI_StartCollectiveTransaction( db, &transaction );
     assert( status == GDI_SUCCESS );
 
-    int ret = nod_cdlp_nonblocking_sorted( nglobalverts, transaction, max_num_iterations, &labels, &v_ids, &elem_cnt );
+    int ret = nod_cdlp_nonblocking_sorted( vertex_index, transaction, max_num_iterations, &labels, &v_ids, &elem_cnt );
 
     if( ret != 0 ) {
       status = GDI_CloseCollectiveTransaction( &transaction, GDI_TRANSACTION_ABORT );
@@ -180,19 +187,29 @@ void benchmark_cdlp( GDI_Database db, /* GDI_Label* vlabels, */ uint64_t nglobal
   }
 
   LSB_Finalize();
+
+  status = GDI_FreeIndex( &vertex_index );
+  assert( status == GDI_SUCCESS );
 }
 
 
 /**
   code written by George Mitenkov
  */
-void benchmark_pagerank( GDI_Database db, /* GDI_Label* vlabels, */ uint64_t nglobalverts, double damping_factor, uint32_t num_iterations, uint32_t num_measurements ) {
+void benchmark_pagerank( GDI_Database db, /* GDI_Label* vlabels, */ double damping_factor, uint32_t num_iterations, uint32_t num_measurements ) {
   int status;
 
   LSB_Init( "gdi_pr" /* project name */, 0 /* autoprofiling interval, deactivated */);
   LSB_Set_Rparam_int( "num_iterations", num_iterations );
   LSB_Set_Rparam_double( "damping_factor", damping_factor );
 
+  /**
+    bitmap index over all vertices, that enumerates the local vertices
+   */
+  GDI_Index vertex_index;
+  status = GDI_CreateIndex( GDI_INDEX_BITMAP, GDI_LABEL_NONE, GDI_PROPERTY_TYPE_NULL, db, &vertex_index );
+  assert( status == GDI_SUCCESS );
+
   MPI_Barrier( MPI_COMM_WORLD );
 
   GDI_Transaction transaction;
@@ -207,7 +224,7 @@ void benchmark_pagerank( GDI_Database db, /* GDI_Label* vlabels, */ uint64_t ngl
     status = GDI_StartCollectiveTransaction( db, &transaction );
     assert( status == GDI_SUCCESS );
 
-    int ret = nod_pagerank_nonblocking_sorted( nglobalverts, transaction, num_iterations, damping_factor, &scores, &v_ids, &elem_cnt );
+    int ret = nod_pagerank_nonblocking_sorted( vertex_index, transaction, num_iterations, damping_factor, &scores, &v_ids, &elem_cnt );
 
     if( ret != 0 ) {
       status = GDI_CloseCollectiveTransaction( &transaction, GDI_TRANSACTION_ABORT );
@@ -220,37 +237,40 @@ void benchmark_pagerank( GDI_Database db, /* GDI_Label* vlabels, */ uint64_t ngl
 
 #ifdef GDEBUG
       if (i == 0) {
-        int rank, comm_size;
-        MPI_Comm_rank( MPI_COMM_WORLD, &rank );
-        MPI_Comm_size( MPI_COMM_WORLD, &comm_size );
-
-        uint64_t local_size = (nglobalverts + comm_size - 1) / comm_size;
-        uint64_t global_start_position = MIN( rank * local_size, nglobalverts );
-        uint64_t local_num_verts = MIN( nglobalverts - global_start_position, local_size );
-
-        for( uint64_t j=0 ; j<local_num_verts ; j++ ) {
-          printf( "scores[%" PRIu64 "] = %.10f\n", global_start_position + j, scores[j] );
+        for( size_t j=0 ; j<elem_cnt ; j++ ) {
+          printf( "scores[%" PRIu64 "] = %.10f\n", v_ids[j], scores[j] );
         }
       }
 #endif
 
       free( scores );
+      free( v_ids );
     }
   }
 
   LSB_Finalize();
+
+  status = GDI_FreeIndex( &vertex_index );
+  assert( status == GDI_SUCCESS );
 }
 
 
 /**
   code written by George Mitenkov
  */
-void benchmark_wcc( GDI_Database db, /* GDI_Label* vlabels, */ uint64_t nglobalverts, uint32_t num_iterations, uint32_t num_measurements ) {
+void benchmark_wcc( GDI_Database db, /* GDI_Label* vlabels, */ uint32_t num_iterations, uint32_t num_measurements ) {
   int status;
 
   LSB_Init( "gdi_wcc" /* project name */, 0 /* autoprofiling interval, deactivated */);
   LSB_Set_Rparam_int( "num_iterations", num_iterations );
 
+  /**
+    bitmap index over all vertices, that enumerates the local vertices
+   */
+  GDI_Index vertex_index;
+  status = GDI_CreateIndex( GDI_INDEX_BITMAP, GDI_LABEL_NONE, GDI_PROPERTY_TYPE_NULL, db, &vertex_index );
+  assert( status == GDI_SUCCESS );
+
   MPI_Barrier( MPI_COMM_WORLD );
 
   GDI_Transaction transaction;
@@ -265,7 +285,7 @@ void benchmark_wcc( GDI_Database db, /* GDI_Label* vlabels, */ uint64_t nglobalv
     status = GDI_StartCollectiveTransaction( db, &transaction );
     assert( status == GDI_SUCCESS );
 
-    int ret = nod_wcc_pull_nonblocking_sorted( nglobalverts, transaction, num_iterations, &components, &v_ids, &elem_cnt );
+    int ret = nod_wcc_pull_nonblocking_sorted( vertex_index, transaction, num_iterations, &components, &v_ids, &elem_cnt );
 
     if( ret != 0 ) {
       status = GDI_CloseCollectiveTransaction( &transaction, GDI_TRANSACTION_ABORT );
@@ -299,6 +319,9 @@ void benchmark_wcc( GDI_Database db, /* GDI_Label* vlabels, */ uint64_t nglobalv
   }
 
   LSB_Finalize();
+
+  status = GDI_FreeIndex( &vertex_index );
+  assert( status == GDI_SUCCESS );
 }
 
 
@@ -317,7 +340,7 @@ void benchmark_wcc( GDI_Database db, /* GDI_Label* vlabels, */ uint64_t nglobalv
 /**
   code written by George Mitenkov
  */
-void benchmark_gnn( GDI_Database db, /* GDI_Label* vlabels, */ uint64_t nglobalverts, uint32_t num_layers, uint32_t num_features, uint32_t num_measurements ) {
+void benchmark_gnn( GDI_Database db, /* GDI_Label* vlabels, */ uint32_t num_layers, uint32_t num_features, uint32_t num_measurements ) {
   int status;
 
   LSB_Init( "gdi_gnn" /* project name */, 0 /* autoprofiling interval, deactivated */);
@@ -352,6 +375,13 @@ void benchmark_gnn( GDI_Database db, /* GDI_Label* vlabels, */ uint64_t nglobalv
     }
   }
 
+  /**
+    bitmap index over all vertices, that enumerates the local vertices
+   */
+  GDI_Index vertex_index;
+  status = GDI_CreateIndex( GDI_INDEX_BITMAP, GDI_LABEL_NONE, GDI_PROPERTY_TYPE_NULL, db, &vertex_index );
+  assert( status == GDI_SUCCESS );
+
   MPI_Barrier( MPI_COMM_WORLD );
 
   GDI_Transaction transaction;
@@ -367,7 +397,7 @@ void benchmark_gnn( GDI_Database db, /* GDI_Label* vlabels, */ uint64_t nglobalv
     status = GDI_StartCollectiveTransaction( db, &transaction );
     assert( status == GDI_SUCCESS );
 
-    int ret = nod_gnn_blocking_sorted( nglobalverts, transaction, num_layers, num_features, weights, bias, &y_pred, &v_ids, &elem_cnt );
+    int ret = nod_gnn_blocking_sorted( vertex_index, transaction, num_layers, num_features, weights, bias, &y_pred, &v_ids, &elem_cnt );
 
     if( ret != 0 ) {
       status = GDI_CloseCollectiveTransaction( &transaction, GDI_TRANSACTION_ABORT );
@@ -405,6 +435,9 @@ void benchmark_gnn( GDI_Database db, /* GDI_Label* vlabels, */ uint64_t nglobalv
 
   LSB_Finalize();
 
+  status = GDI_FreeIndex( &vertex_index );
+  assert( status == GDI_SUCCESS );
+
   /**
     clean up
    */
@@ -416,11 +449,18 @@ void benchmark_gnn( GDI_Database db, /* GDI_Label* vlabels, */ uint64_t nglobalv
 /**
   code written by George Mitenkov
  */
-void benchmark_lcc( GDI_Database db, /* GDI_Label* vlabels, */ uint64_t nglobalverts, uint32_t num_measurements ) {
+void benchmark_lcc( GDI_Database db, /* GDI_Label* vlabels, */ uint32_t num_measurements ) {
   int status;
 
   LSB_Init( "gdi_lcc" /* project name */, 0 /* autoprofiling interval, deactivated */);
 
+  /**
+    bitmap index over all vertices, that enumerates the local vertices
+   */
+  GDI_Index vertex_index;
+  status = GDI_CreateIndex( GDI_INDEX_BITMAP, GDI_LABEL_NONE, GDI_PROPERTY_TYPE_NULL, db, &vertex_index );
+  assert( status == GDI_SUCCESS );
+
   MPI_Barrier( MPI_COMM_WORLD );
 
   GDI_Transaction transaction;
@@ -436,7 +476,7 @@ void benchmark_lcc( GDI_Database db, /* GDI_Label* vlabels, */ uint64_t nglobalv
     status = GDI_StartCollectiveTransaction( db, &transaction );
     assert( status == GDI_SUCCESS );
 
-    int ret = nod_lcc( nglobalverts, transaction, &coefficients, &v_ids, &elem_cnt );
+    int ret = nod_lcc( vertex_index, transaction, &coefficients, &v_ids, &elem_cnt );
 
     if( ret != 0 ) {
       status = GDI_CloseCollectiveTransaction( &transaction, GDI_TRANSACTION_ABORT );
@@ -461,14 +501,29 @@ void benchmark_lcc( GDI_Database db, /* GDI_Label* vlabels, */ uint64_t nglobalv
   }
 
   LSB_Finalize();
+
+  status = GDI_FreeIndex( &vertex_index );
+  assert( status == GDI_SUCCESS );
 }
 
 
-void benchmark_bi( GDI_Database db, GDI_Label* vlabels, GDI_Label* elabels, GDI_PropertyType* ptypes, uint64_t nglobal_verts, uint32_t num_measurements ) {
+void benchmark_bi( GDI_Database db, GDI_Label* vlabels, GDI_Label* elabels, GDI_PropertyType* ptypes, uint32_t num_measurements ) {
   int status;
 
   LSB_Init( "gdi_bi" /* project name */, 0 /* autoprofiling interval, deactivated */);
 
+  /**
+    bitmap index over the resource vertices, that enumerates the local
+    resources, and prefix index over the names of the project vertices
+   */
+  GDI_Index resource_index;
+  status = GDI_CreateIndex( GDI_INDEX_BITMAP, vlabels[4], GDI_PROPERTY_TYPE_NULL, db, &resource_index );
+  assert( status == GDI_SUCCESS );
+
+  GDI_Index project_index;
+  status = GDI_CreateIndex( GDI_INDEX_PREFIX, vlabels[3], ptypes[0], db, &project_index );
+  assert( status == GDI_SUCCESS );
+
   MPI_Barrier( MPI_COMM_WORLD );
 
   GDI_Transaction transaction;
@@ -483,7 +538,7 @@ void benchmark_bi( GDI_Database db, GDI_Label* vlabels, GDI_Label* elabels, GDI_
     size_t* v_count;
     size_t elem_cnt;
 
-    int ret = business_intelligence( vlabels, elabels, ptypes, nglobal_verts, transaction, db, db->comm, 100, 'c', &res_name, &v_count, &elem_cnt );
+    int ret = business_intelligence( elabels, ptypes, resource_index, project_index, transaction, db, db->comm, 100, 'c', &res_name, &v_count, &elem_cnt );
 
     if( ret != 0 ) {
       status = GDI_CloseCollectiveTransaction( &transaction, GDI_TRANSACTION_ABORT );
@@ -516,4 +571,9 @@ void benchmark_bi( GDI_Database db, GDI_Label* vlabels, GDI_Label* elabels, GDI_
   }
 
   LSB_Finalize();
+
+  status = GDI_FreeIndex( &project_index );
+  assert( status == GDI_SUCCESS );
+  status = GDI_FreeIndex( &resource_index );
+  assert( status == GDI_SUCCESS );
 }
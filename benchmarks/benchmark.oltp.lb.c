@@ -20,6 +20,20 @@
 
 #define WARMUP_TRESHOLD 100
 
+#ifndef THROUGHPUT
+/**
+  query types of the LSB records of the queries 6 to 9 of the query mix:
+  add edge keeps the ID 6, which it had before the other edge queries
+  were part of the mix, and these are recorded with the IDs 7 to 9
+ */
+static const int edge_query_type[4] = {
+  7, /* linkbench_get_edges_filtered_by_vertices */
+  6, /* linkbench_add_edge */
+  8, /* linkbench_delete_edge */
+  9  /* linkbench_update_edge */
+};
+#endif
+
 void benchmark_linkbench( GDI_Database db, GDI_Label* vlabels, GDI_Label* elabels, GDI_PropertyType* ptypes, uint64_t nglobalverts, uint32_t num_measurements ) {
   int status;
 
@@ -35,39 +49,6 @@ void benchmark_linkbench( GDI_Database db, GDI_Label* vlabels, GDI_Label* elabel
 
   srand( time(NULL) + rank );
 
-#if 0
-  unmodified Linkbench probabilities:
-
-  uint8_t linkbench_query_count = 10;
-  uint16_t* linkbench_query_probability = malloc( linkbench_query_count * sizeof(uint16_t) );
-  linkbench_query_probability[0] =  129; /* linkbench_get_*_vertex */
-  linkbench_query_probability[1] =  155; /* linkbench_add_vertex */
-  linkbench_query_probability[2] =  165; /* linkbench_delete_vertex */
-  linkbench_query_probability[3] =  239; /* linkbench_update_vertex */
-  linkbench_query_probability[4] =  288; /* linkbench_count_edges */
-  linkbench_query_probability[5] =  795; /* linkbench_get_edges */
-  linkbench_query_probability[6] =  800; /* linkbench_get_edges_filtered_by_vertices */
-  linkbench_query_probability[7] =  890; /* linkbench_add_edge */
-  linkbench_query_probability[8] =  920; /* linkbench_delete_edge */
-  linkbench_query_probability[9] = 1000; /* linkbench_update_edge */
-#endif
-
-  /**
-    had to modify the Linkbench benchmark, because
-    linkbench_get_edges_filtered_by_vertices, linkbench_delete_edge,
-    linkbench_update_edge rely on a GDI_AssociateEdge, which is
-    currently not implemented
-   */
-  uint8_t linkbench_query_count = 7;
-  uint16_t* linkbench_query_probability = malloc( linkbench_query_count * sizeof(uint16_t) );
-  linkbench_query_probability[0] =  129; /* linkbench_get_*_vertex */
-  linkbench_query_probability[1] =  155; /* linkbench_add_vertex */
-  linkbench_query_probability[2] =  165; /* linkbench_delete_vertex */
-  linkbench_query_probability[3] =  239; /* linkbench_update_vertex */
-  linkbench_query_probability[4] =  288; /* linkbench_count_edges */
-  linkbench_query_probability[5] =  800; /* linkbench_get_edges: added probability from linkbench_get_edges_filtered_by_vertices as well */
-  linkbench_query_probability[6] = 1000; /* linkbench_add_edge: added probabilities from linkbench_delete_edge and linkbench_update_edge */
-
 #ifndef THROUGHPUT
   LSB_Init( "gdi_oltp.lb.lat" /* project name */, 0 /* autoprofiling interval, deactivated */);
 
@@ -100,36 +81,13 @@ void benchmark_linkbench( GDI_Database db, GDI_Label* vlabels, GDI_Label* elabel
     LSB_Res(); /* start measurement */
   }
 #endif
-    /* select query */
-    uint16_t random_num = rand() % 1000;
-    uint8_t query_idx;
-    for( query_idx = 0; query_idx<linkbench_query_count ; query_idx++ ) {
-      if( random_num < linkbench_query_probability[query_idx] ) {
-        break;
-      }
-    }
-
-    assert( query_idx < linkbench_query_count );
-
+    uint8_t query_idx = linkbench_select_query();
     switch( query_idx ) {
       case 0:
         {
           /* retrieve properties of vertex */
-          uint64_t application_level_ID = (
-            (((uint64_t) rand() <<  0) & 0x000000000000FFFFull) |
-            (((uint64_t) rand() << 16) & 0x00000000FFFF0000ull) |
-            (((uint64_t) rand() << 32) & 0x0000FFFF00000000ull) |
-            (((uint64_t) rand() << 48) & 0xFFFF000000000000ull)
-                                           ) % nglobalverts;
-
           uint8_t idx;
-          for( idx=0 ; idx<VERTEX_LABEL_COUNT ; idx++ ) {
-            if( application_level_ID < vlabel_range[idx] ) {
-              break;
-            }
-          }
-
-          assert( idx < VERTEX_LABEL_COUNT );
+          uint64_t application_level_ID = linkbench_random_vertex( nglobalverts, &idx );
 
           int ret;
           GDI_Transaction transaction;
@@ -314,21 +272,8 @@ void benchmark_linkbench( GDI_Database db, GDI_Label* vlabels, GDI_Label* elabel
       case 2:
         {
           /* delete vertex */
-          uint64_t application_level_ID = (
-            (((uint64_t) rand() <<  0) & 0x000000000000FFFFull) |
-            (((uint64_t) rand() << 16) & 0x00000000FFFF0000ull) |
-            (((uint64_t) rand() << 32) & 0x0000FFFF00000000ull) |
-            (((uint64_t) rand() << 48) & 0xFFFF000000000000ull)
-                                           ) % nglobalverts;
-
           uint8_t idx;
-          for( idx=0 ; idx<VERTEX_LABEL_COUNT ; idx++ ) {
-            if( application_level_ID < vlabel_range[idx] ) {
-              break;
-            }
-          }
-
-          assert( idx < VERTEX_LABEL_COUNT );
+          uint64_t application_level_ID = linkbench_random_vertex( nglobalverts, &idx );
 
           int ret;
           GDI_Transaction transaction;
@@ -362,21 +307,8 @@ void benchmark_linkbench( GDI_Database db, GDI_Label* vlabels, GDI_Label* elabel
       case 3:
         {
           /* update vertex properties */
-          uint64_t application_level_ID = (
-            (((uint64_t) rand() <<  0) & 0x000000000000FFFFull) |
-            (((uint64_t) rand() << 16) & 0x00000000FFFF0000ull) |
-            (((uint64_t) rand() << 32) & 0x0000FFFF00000000ull) |
-            (((uint64_t) rand() << 48) & 0xFFFF000000000000ull)
-                                           ) % nglobalverts;
-
           uint8_t idx;
-          for( idx=0 ; idx<VERTEX_LABEL_COUNT ; idx++ ) {
-            if( application_level_ID < vlabel_range[idx] ) {
-              break;
-            }
-          }
-
-          assert( idx < VERTEX_LABEL_COUNT );
+          uint64_t application_level_ID = linkbench_random_vertex( nglobalverts, &idx );
 
           int ret;
           GDI_Transaction transaction;
@@ -410,21 +342,8 @@ void benchmark_linkbench( GDI_Database db, GDI_Label* vlabels, GDI_Label* elabel
       case 4:
         {
           /* count edges */
-          uint64_t application_level_ID = (
-            (((uint64_t) rand() <<  0) & 0x000000000000FFFFull) |
-            (((uint64_t) rand() << 16) & 0x00000000FFFF0000ull) |
-            (((uint64_t) rand() << 32) & 0x0000FFFF00000000ull) |
-            (((uint64_t) rand() << 48) & 0xFFFF000000000000ull)
-                                           ) % nglobalverts;
-
           uint8_t idx;
-          for( idx=0 ; idx<VERTEX_LABEL_COUNT ; idx++ ) {
-            if( application_level_ID < vlabel_range[idx] ) {
-              break;
-            }
-          }
-
-          assert( idx < VERTEX_LABEL_COUNT );
+          uint64_t application_level_ID = linkbench_random_vertex( nglobalverts, &idx );
 
           uint8_t edge_idx = edge_matrix[idx][rand() % 5];
           size_t edge_count;
@@ -461,21 +380,8 @@ void benchmark_linkbench( GDI_Database db, GDI_Label* vlabels, GDI_Label* elabel
       case 5:
         {
           /* retrieve edges */
-          uint64_t application_level_ID = (
-            (((uint64_t) rand() <<  0) & 0x000000000000FFFFull) |
-            (((uint64_t) rand() << 16) & 0x00000000FFFF0000ull) |
-            (((uint64_t) rand() << 32) & 0x0000FFFF00000000ull) |
-            (((uint64_t) rand() << 48) & 0xFFFF000000000000ull)
-                                           ) % nglobalverts;
-
           uint8_t idx;
-          for( idx=0 ; idx<VERTEX_LABEL_COUNT ; idx++ ) {
-            if( application_level_ID < vlabel_range[idx] ) {
-              break;
-            }
-          }
-
-          assert( idx < VERTEX_LABEL_COUNT );
+          uint64_t application_level_ID = linkbench_random_vertex( nglobalverts, &idx );
 
           uint8_t edge_idx = edge_matrix[idx][rand() % 5];
           size_t edge_count;
@@ -513,39 +419,16 @@ void benchmark_linkbench( GDI_Database db, GDI_Label* vlabels, GDI_Label* elabel
           break;
         }
       case 6:
+      case 7:
+      case 8:
+      case 9:
         {
-          /* add edge */
-          uint64_t origin_ID = (
-            (((uint64_t) rand() <<  0) & 0x000000000000FFFFull) |
-            (((uint64_t) rand() << 16) & 0x00000000FFFF0000ull) |
-            (((uint64_t) rand() << 32) & 0x0000FFFF00000000ull) |
-            (((uint64_t) rand() << 48) & 0xFFFF000000000000ull)
-                               ) % nglobalverts;
-
+          /* queries on the edges between two vertices */
           uint8_t origin_idx;
-          for( origin_idx=0 ; origin_idx<VERTEX_LABEL_COUNT ; origin_idx++ ) {
-            if( origin_ID < vlabel_range[origin_idx] ) {
-              break;
-            }
-          }
-
-          assert( origin_idx < VERTEX_LABEL_COUNT );
-
-          uint64_t target_ID = (
-            (((uint64_t) rand() <<  0) & 0x000000000000FFFFull) |
-            (((uint64_t) rand() << 16) & 0x00000000FFFF0000ull) |
-            (((uint64_t) rand() << 32) & 0x0000FFFF00000000ull) |
-            (((uint64_t) rand() << 48) & 0xFFFF000000000000ull)
-                               ) % nglobalverts;
+          uint64_t origin_ID = linkbench_random_vertex( nglobalverts, &origin_idx );
 
           uint8_t target_idx;
-          for( target_idx=0 ; target_idx<VERTEX_LABEL_COUNT ; target_idx++ ) {
-            if( target_ID < vlabel_range[target_idx] ) {
-              break;
-            }
-          }
-
-          assert( target_idx < VERTEX_LABEL_COUNT );
+          uint64_t target_ID = linkbench_random_vertex( nglobalverts, &target_idx );
 
           int ret;
           GDI_Transaction transaction;
@@ -557,7 +440,7 @@ void benchmark_linkbench( GDI_Database db, GDI_Label* vlabels, GDI_Label* elabel
           status = GDI_StartTransaction( db, &transaction );
           assert( status == GDI_SUCCESS );
 
-          ret = linkbench_add_edge( vlabels[origin_idx], origin_ID, vlabels[target_idx], target_ID, elabels[edge_matrix[origin_idx][target_idx]], transaction );
+          ret = linkbench_edge_query( query_idx, vlabels[origin_idx], origin_ID, vlabels[target_idx], target_ID, elabels[edge_matrix[origin_idx][target_idx]], ptypes, transaction, db );
 
           if( ret != 0 ) {
             status = GDI_CloseTransaction( &transaction, GDI_TRANSACTION_ABORT );
@@ -570,7 +453,7 @@ void benchmark_linkbench( GDI_Database db, GDI_Label* vlabels, GDI_Label* elabel
             assert( status == GDI_SUCCESS );
 
 #ifndef THROUGHPUT
-            LSB_Rec(6 /* query type */); /* finish measurement */
+            LSB_Rec(edge_query_type[query_idx - 6] /* query type */); /* finish measurement */
 #endif
           }
 
@@ -587,9 +470,4 @@ void benchmark_linkbench( GDI_Database db, GDI_Label* vlabels, GDI_Label* elabel
 #endif
 
   LSB_Finalize();
-
-  /**
-    clean up
-   */
-  free( linkbench_query_probability );
 }
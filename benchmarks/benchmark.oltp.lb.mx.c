@@ -0,0 +1,246 @@
+// Copyright (c) 2023 ETH-Zurich.
+//                    All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <assert.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "rma.h"
+#include "gdi.h"
+
+#include "liblsb.h"
+
+#include "data_scheme_1.h"
+#include "executor.h"
+#include "queries.h"
+
+#define WARMUP_TRESHOLD 100
+
+/**
+  Linkbench throughput benchmark with multiple in-flight transactions
+  per rank
+
+  uses the same query mix as benchmark_linkbench (see
+  linkbench_select_query), but every query is executed as a task of the
+  multiplexed executor
+ */
+
+typedef struct lb_task_args {
+  GDI_Label* vlabels;
+  GDI_Label* elabels;
+  GDI_PropertyType* ptypes;
+  uint64_t nglobalverts;
+} lb_task_args_t;
+
+
+/**
+  runs a single randomly selected Linkbench query in its own transaction
+ */
+static int linkbench_task( GDI_Database db, void* arg ) {
+  lb_task_args_t* args = (lb_task_args_t*) arg;
+  int status;
+  int ret = 0;
+
+  GDI_Transaction transaction;
+  status = GDI_StartTransaction( db, &transaction );
+  assert( status == GDI_SUCCESS );
+
+  uint8_t query_idx = linkbench_select_query();
+  switch( query_idx ) {
+    case 0:
+      {
+        /* retrieve properties of vertex */
+        uint8_t idx;
+        uint64_t application_level_ID = linkbench_random_vertex( args->nglobalverts, &idx );
+
+        switch( idx ) {
+          case 0:
+            {
+              lb_prop_company_t* return_data;
+              ret = linkbench_get_company_vertex( args->vlabels[0], application_level_ID, args->ptypes, transaction, &return_data );
+              if( ret == 0 ) {
+                linkbench_cleanup_prop_company( &return_data );
+              }
+              break;
+            }
+          case 1:
+            {
+              lb_prop_person_t* return_data;
+              ret = linkbench_get_person_vertex( args->vlabels[1], application_level_ID, args->ptypes, transaction, &return_data );
+              if( ret == 0 ) {
+                linkbench_cleanup_prop_person( &return_data );
+              }
+              break;
+            }
+          case 2:
+            {
+              lb_prop_place_t* return_data;
+              ret = linkbench_get_place_vertex( args->vlabels[2], application_level_ID, args->ptypes, transaction, &return_data );
+              if( ret == 0 ) {
+                linkbench_cleanup_prop_place( &return_data );
+              }
+              break;
+            }
+          case 3:
+            {
+              lb_prop_project_t* return_data;
+              ret = linkbench_get_project_vertex( args->vlabels[3], application_level_ID, args->ptypes, transaction, &return_data );
+              if( ret == 0 ) {
+                linkbench_cleanup_prop_project( &return_data );
+              }
+              break;
+            }
+          default:
+            {
+              lb_prop_ressource_t* return_data;
+              ret = linkbench_get_ressource_vertex( args->vlabels[4], application_level_ID, args->ptypes, transaction, &return_data );
+              if( ret == 0 ) {
+                linkbench_cleanup_prop_ressource( &return_data );
+              }
+              break;
+            }
+        }
+        break;
+      }
+    case 1:
+      {
+        /* add vertex */
+        linkbench_add_vertex( args->vlabels, args->ptypes, args->nglobalverts, transaction );
+        break;
+      }
+    case 2:
+      {
+        /* delete vertex */
+        uint8_t idx;
+        uint64_t application_level_ID = linkbench_random_vertex( args->nglobalverts, &idx );
+        ret = linkbench_delete_vertex( args->vlabels[idx], application_level_ID, transaction );
+        break;
+      }
+    case 3:
+      {
+        /* update vertex properties */
+        uint8_t idx;
+        uint64_t application_level_ID = linkbench_random_vertex( args->nglobalverts, &idx );
+        ret = linkbench_update_vertex( args->vlabels[idx], application_level_ID, args->vlabels, args->ptypes, transaction );
+        break;
+      }
+    case 4:
+      {
+        /* count edges */
+        uint8_t idx;
+        uint64_t application_level_ID = linkbench_random_vertex( args->nglobalverts, &idx );
+        uint8_t edge_idx = edge_matrix[idx][rand() % 5];
+        size_t edge_count;
+        ret = linkbench_count_edges( args->vlabels[idx], application_level_ID, args->elabels[edge_idx], transaction, db, &edge_count );
+        break;
+      }
+    case 5:
+      {
+        /* retrieve edges */
+        uint8_t idx;
+        uint64_t application_level_ID = linkbench_random_vertex( args->nglobalverts, &idx );
+        uint8_t edge_idx = edge_matrix[idx][rand() % 5];
+        size_t edge_count;
+        GDI_Edge_uid* edge_uids = NULL;
+        ret = linkbench_get_edges( args->vlabels[idx], application_level_ID, args->elabels[edge_idx], transaction, db, &edge_count, &edge_uids );
+        free( edge_uids );
+        break;
+      }
+    case 6:
+    case 7:
+    case 8:
+    case 9:
+      {
+        /* queries on the edges between two vertices */
+        uint8_t origin_idx, target_idx;
+        uint64_t origin_ID = linkbench_random_vertex( args->nglobalverts, &origin_idx );
+        uint64_t target_ID = linkbench_random_vertex( args->nglobalverts, &target_idx );
+        ret = linkbench_edge_query( query_idx, args->vlabels[origin_idx], origin_ID, args->vlabels[target_idx], target_ID, args->elabels[edge_matrix[origin_idx][target_idx]], args->ptypes, transaction, db );
+        break;
+      }
+  }
+
+  if( ret != 0 ) {
+    status = GDI_CloseTransaction( &transaction, GDI_TRANSACTION_ABORT );
+  } else {
+    status = GDI_CloseTransaction( &transaction, GDI_TRANSACTION_COMMIT );
+  }
+  assert( status == GDI_SUCCESS );
+
+  return ret;
+}
+
+
+void benchmark_linkbench_multiplexed( GDI_Database db, GDI_Label* vlabels, GDI_Label* elabels, GDI_PropertyType* ptypes, uint64_t nglobalverts, uint32_t num_measurements, uint32_t num_inflight ) {
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  if( num_measurements <= WARMUP_TRESHOLD ) {
+    if( rank == 0 ) {
+      fprintf( stderr, "Number of queries (%u) is less than the number of queries for warmup (%i), so no measurements would be performed.\n", num_measurements, WARMUP_TRESHOLD );
+    }
+    MPI_Abort( MPI_COMM_WORLD, 1 );
+  }
+
+  if( num_inflight == 0 ) {
+    if( rank == 0 ) {
+      fprintf( stderr, "The number of in-flight transactions per rank should not be zero.\n" );
+    }
+    MPI_Abort( MPI_COMM_WORLD, 1 );
+  }
+
+  srand( time(NULL) + rank );
+
+  lb_task_args_t args;
+  args.vlabels = vlabels;
+  args.elabels = elabels;
+  args.ptypes = ptypes;
+  args.nglobalverts = nglobalverts;
+
+  executor_t executor;
+  executor_create( db, num_inflight, EXECUTOR_DEFAULT_STACK_SIZE, &executor );
+
+  uint64_t results[EXECUTOR_RESULT_COUNT] = { 0, 0, 0 };
+
+  LSB_Init( "gdi_oltp.lb.mx" /* project name */, 0 /* autoprofiling interval, deactivated */);
+
+  LSB_Set_Rparam_int( "num_inflight", num_inflight );
+  LSB_Set_Rparam_int( "num_queries", 0 );
+  LSB_Set_Rparam_int( "failed_queries", 0 );
+  LSB_Set_Rparam_int( "deleted_vertices", 0 );
+
+  /**
+    warm up period
+   */
+  executor_run( executor, WARMUP_TRESHOLD, linkbench_task, &args, results );
+
+  results[1] = 0;
+  results[2] = 0;
+  MPI_Barrier( MPI_COMM_WORLD );
+  /**
+    measure the latency of a single barrier, so that we can determine
+    the overhead for the subsequent measurement
+   */
+  LSB_Res(); /* start measurement */
+  MPI_Barrier( MPI_COMM_WORLD );
+  LSB_Rec(0 /* barrier */); /* finish measurement */
+  LSB_Set_Rparam_int( "num_queries", num_measurements - WARMUP_TRESHOLD );
+  LSB_Res(); /* start measurement */
+
+  executor_run( executor, num_measurements - WARMUP_TRESHOLD, linkbench_task, &args, results );
+
+  MPI_Barrier( MPI_COMM_WORLD );
+  LSB_Set_Rparam_int( "failed_queries", results[2] );
+  LSB_Set_Rparam_int( "deleted_vertices", results[1] );
+  LSB_Rec(1 /* queries */); /* finish measurement */
+
+  LSB_Finalize();
+
+  /**
+    clean up
+   */
+  executor_free( &executor );
+}
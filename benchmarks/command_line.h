@@ -59,7 +59,7 @@ class CLBase {
   int argc_;
   char** argv_;
   std::string name_;
-  std::string get_args_ = "b:de:f:hi:l:m:n:or:s:t:v:w:";
+  std::string get_args_ = "b:de:f:hi:l:m:n:or:s:t:v:w:x:";
   std::vector<std::string> help_strings_;
 
   uint32_t blocksize_ = 512;
@@ -76,6 +76,7 @@ class CLBase {
   uint32_t SCALE_ = 3;
   bool     startAtOne_ = false;
   uint32_t vector_ = 500;
+  uint32_t inflight_ = 1;
 
   void AddHelpLine(char opt, std::string opt_arg, std::string text,
                    std::string def = "") {
@@ -107,6 +108,7 @@ class CLBase {
     AddHelpLine('t', "time", "duration to run Linkbench queries", "5");
     AddHelpLine('v', "vector", "size of feature vector for GNN", "500");
     AddHelpLine('w', "damp", "damping factor for PageRank", "0.85");
+    AddHelpLine('x', "inflight", "in-flight transactions per rank (OLTP)", "1");
     AddHelpLine('h', "", "print this help message");
   }
 
@@ -136,6 +138,7 @@ class CLBase {
       case 't': duration_ = strtod(opt_arg, NULL);           break;
       case 'v': vector_ = strtoul(opt_arg, NULL, 10);        break;
       case 'w': dampingfactor_ = strtod(opt_arg, NULL);      break;
+      case 'x': inflight_ = strtoul(opt_arg, NULL, 10);      break;
     }
   }
 
@@ -160,6 +163,7 @@ class CLBase {
   uint32_t rcount() const { return rcount_; }
   uint32_t scale() const { return SCALE_; }
   uint32_t feature_vector_size() const { return vector_; }
+  uint32_t inflight() const { return inflight_; }
 };
 
 #endif // __LPG_GRAPH500_GDI_COMMAND_LINE_H
@@ -0,0 +1,168 @@
+// Copyright (c) 2023 ETH-Zurich.
+//                    All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#define _XOPEN_SOURCE 700
+
+#include <assert.h>
+#include <stdbool.h>
+#include <ucontext.h>
+
+#include "gda_yield.h"
+#include "executor.h"
+
+typedef struct executor_slot {
+  ucontext_t context;
+  void* stack;
+  bool finished;
+} executor_slot_t;
+
+struct executor_desc {
+  GDI_Database db;
+  uint32_t num_inflight;
+  size_t stack_size;
+  executor_slot_t* slots;
+  /**
+    context of the scheduler (executor_run)
+   */
+  ucontext_t scheduler;
+  /**
+    index of the slot that is currently running, num_inflight while the
+    scheduler itself is running
+   */
+  uint32_t current;
+
+  /**
+    state of the current executor_run call
+   */
+  executor_task_t task;
+  void* arg;
+  uint64_t remaining_tasks;
+  uint64_t* results;
+};
+
+
+/**
+  called by the library through GDA_Yield
+ */
+static void executor_yield( void* arg ) {
+  executor_t executor = (executor_t) arg;
+
+  if( executor->current == executor->num_inflight ) {
+    /**
+      not called from within a slot (e.g. the scheduler itself)
+     */
+    return;
+  }
+
+  executor_slot_t* slot = &(executor->slots[executor->current]);
+  swapcontext( &(slot->context), &(executor->scheduler) );
+}
+
+
+/**
+  makecontext only passes int arguments, so the executor pointer is
+  split into two halves
+ */
+static void executor_slot_main( int lo, int hi ) {
+  executor_t executor = (executor_t) ((((uintptr_t)(uint32_t) hi) << 32) | ((uintptr_t)(uint32_t) lo));
+
+  while( executor->remaining_tasks > 0 ) {
+    executor->remaining_tasks--;
+    int ret = executor->task( executor->db, executor->arg );
+    assert( (ret >= 0) && (ret < EXECUTOR_RESULT_COUNT) );
+    executor->results[ret]++;
+  }
+
+  executor->slots[executor->current].finished = true;
+  /**
+    returning switches to uc_link, which is the scheduler
+   */
+}
+
+
+void executor_create( GDI_Database db, uint32_t num_inflight, size_t stack_size, executor_t* executor ) {
+  assert( num_inflight > 0 );
+
+  executor_t ex = malloc( sizeof(executor_desc_t) );
+  assert( ex != NULL );
+
+  ex->db = db;
+  ex->num_inflight = num_inflight;
+  ex->stack_size = stack_size;
+  ex->current = num_inflight;
+
+  ex->slots = malloc( num_inflight * sizeof(executor_slot_t) );
+  assert( ex->slots != NULL );
+
+  for( uint32_t i=0 ; i<num_inflight ; i++ ) {
+    ex->slots[i].stack = malloc( stack_size );
+    assert( ex->slots[i].stack != NULL );
+    ex->slots[i].finished = true;
+  }
+
+  *executor = ex;
+}
+
+
+void executor_free( executor_t* executor ) {
+  for( uint32_t i=0 ; i<(*executor)->num_inflight ; i++ ) {
+    free( (*executor)->slots[i].stack );
+  }
+  free( (*executor)->slots );
+  free( *executor );
+  *executor = NULL;
+}
+
+
+static void executor_init_slot( executor_t executor, uint32_t i ) {
+  uintptr_t ptr = (uintptr_t) executor;
+  executor_slot_t* slot = &(executor->slots[i]);
+
+  int status = getcontext( &(slot->context) );
+  assert( status == 0 );
+  (void) status;
+  slot->context.uc_stack.ss_sp = slot->stack;
+  slot->context.uc_stack.ss_size = executor->stack_size;
+  slot->context.uc_link = &(executor->scheduler);
+  makecontext( &(slot->context), (void (*)(void)) executor_slot_main, 2, (int)(uint32_t) ptr, (int)(uint32_t) (((uint64_t) ptr) >> 32) );
+  slot->finished = false;
+}
+
+
+void executor_run( executor_t executor, uint64_t num_tasks, executor_task_t task, void* arg, uint64_t* results ) {
+  executor->task = task;
+  executor->arg = arg;
+  executor->remaining_tasks = num_tasks;
+  executor->results = results;
+
+  /**
+    (re)initialize the contexts of all slots
+   */
+  for( uint32_t i=0 ; i<executor->num_inflight ; i++ ) {
+    executor_init_slot( executor, i );
+  }
+
+  GDA_SetYieldFunction( executor_yield, executor );
+
+  /**
+    round-robin over the slots until all of them ran out of tasks
+   */
+  uint32_t active = executor->num_inflight;
+  while( active > 0 ) {
+    for( uint32_t i=0 ; i<executor->num_inflight ; i++ ) {
+      if( !executor->slots[i].finished ) {
+        executor->current = i;
+        swapcontext( &(executor->scheduler), &(executor->slots[i].context) );
+        executor->current = executor->num_inflight;
+        if( executor->slots[i].finished ) {
+          active--;
+        }
+      }
+    }
+  }
+
+  GDA_SetYieldFunction( NULL, NULL );
+}
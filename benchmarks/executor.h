@@ -0,0 +1,69 @@
+// Copyright (c) 2023 ETH-Zurich.
+//                    All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef __LPG_GRAPH500_EXECUTOR_H
+#define __LPG_GRAPH500_EXECUTOR_H
+
+#include <inttypes.h>
+#include <stdlib.h>
+
+#include "gdi.h"
+
+/**
+  Multiplexed OLTP executor
+
+  Keeps up to num_inflight single process transactions in flight on a
+  rank. Each in-flight transaction runs on its own user level context
+  (coroutine). The executor registers itself with GDA_SetYieldFunction,
+  so whenever a transaction has issued a remote operation and is about
+  to wait for its completion, the executor switches to the next
+  transaction in a round-robin fashion. Once the scheduler returns to a
+  suspended transaction, it completes the outstanding operations with the
+  flush call that it was about to make, so the network latency of all
+  in-flight transactions overlaps.
+
+  A task runs exactly one query including the start and the end of its
+  transaction and reports the outcome with the same return codes that
+  the Linkbench query functions use:
+  0 - success
+  1 - vertex was not found
+  2 - transaction critical error
+ */
+
+
+/**
+  constant definitions
+ */
+
+#define EXECUTOR_RESULT_COUNT 3
+#define EXECUTOR_DEFAULT_STACK_SIZE (256*1024)
+
+
+/**
+  data type definitions
+ */
+
+typedef int (*executor_task_t)( GDI_Database db, void* arg );
+
+typedef struct executor_desc executor_desc_t;
+typedef executor_desc_t* executor_t;
+
+
+/**
+  function prototypes
+ */
+
+void executor_create( GDI_Database db, uint32_t num_inflight, size_t stack_size, executor_t* executor );
+void executor_free( executor_t* executor );
+
+/**
+  runs the task num_tasks times across all in-flight slots and returns
+  once all of them have finished; results[i] is incremented for every
+  task that returned i
+ */
+void executor_run( executor_t executor, uint64_t num_tasks, executor_task_t task, void* arg, uint64_t* results );
+
+#endif // __LPG_GRAPH500_EXECUTOR_H
@@ -18,7 +18,7 @@
 #include "data_scheme_1.h"
 #include "queries.h"
 
-#define PROPERTY_TYPE_COUNT 13
+#define PROPERTY_TYPE_COUNT 14
 
 /**
   code of determineByteRange modeled after respective function from the
@@ -490,7 +490,7 @@ void createGraphDatabase( uint32_t block_size, uint64_t memory_size, uint64_t ng
   GDI_Transaction transaction;
   int status;
 
-  GDA_Init_params parameters;
+  GDA_Init_params parameters = {0};
   parameters.block_size = block_size;
   parameters.memory_size = memory_size;
   parameters.comm = MPI_COMM_WORLD;
@@ -536,6 +536,7 @@ void createGraphDatabase( uint32_t block_size, uint64_t memory_size, uint64_t ng
     ptypes[10]: density
     ptypes[11]: meltingPoint
     ptypes[12]: formula
+    ptypes[13]: data (edges)
    */
 
   status = GDI_CreatePropertyType( "name", GDI_SINGLE_ENTITY, GDI_CHAR, GDI_MAX_SIZE, 100, db, &ptypes[0] );
@@ -577,6 +578,32 @@ void createGraphDatabase( uint32_t block_size, uint64_t memory_size, uint64_t ng
   status = GDI_CreatePropertyType( "formula", GDI_SINGLE_ENTITY, GDI_CHAR, GDI_MAX_SIZE, 100, db, &ptypes[12] );
   assert( status == GDI_SUCCESS );
 
+  status = GDI_CreatePropertyType( "data", GDI_SINGLE_ENTITY, GDI_CHAR, GDI_MAX_SIZE, 255, db, &ptypes[13] );
+  assert( status == GDI_SUCCESS );
+
+  /**
+    the fixed size properties of each vertex label are stored in slots
+   */
+  GDI_PropertyType company_ptypes[1] = { ptypes[2] /* revenue */ };
+  status = GDI_SetPropertyTypesOfLabel( company_ptypes, 1, vlabels[0] );
+  assert( status == GDI_SUCCESS );
+
+  GDI_PropertyType person_ptypes[1] = { ptypes[6] /* birthday */ };
+  status = GDI_SetPropertyTypesOfLabel( person_ptypes, 1, vlabels[1] );
+  assert( status == GDI_SUCCESS );
+
+  GDI_PropertyType place_ptypes[2] = { ptypes[7] /* longitude */, ptypes[8] /* latitude */ };
+  status = GDI_SetPropertyTypesOfLabel( place_ptypes, 2, vlabels[2] );
+  assert( status == GDI_SUCCESS );
+
+  GDI_PropertyType project_ptypes[1] = { ptypes[9] /* budget */ };
+  status = GDI_SetPropertyTypesOfLabel( project_ptypes, 1, vlabels[3] );
+  assert( status == GDI_SUCCESS );
+
+  GDI_PropertyType ressource_ptypes[2] = { ptypes[10] /* density */, ptypes[11] /* meltingPoint */ };
+  status = GDI_SetPropertyTypesOfLabel( ressource_ptypes, 2, vlabels[4] );
+  assert( status == GDI_SUCCESS );
+
   /**
     add vertices to database
    */
@@ -127,7 +127,7 @@ int main( int argc, char* argv[] ) {
     MPI_Abort( MPI_COMM_WORLD, 1 );
   }
   uint32_t rcount = 10;
-  benchmark_bi( db, vlabels, elabels, ptypes, nglobalverts, rcount );
+  benchmark_bi( db, vlabels, elabels, ptypes, rcount );
 
   /**
     clean up
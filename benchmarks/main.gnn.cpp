@@ -130,7 +130,7 @@ int main( int argc, char* argv[] ) {
   uint32_t rcount = 10;
   uint32_t nlayers = cli.nlayers();
   uint32_t nfeatures = cli.feature_vector_size();
-  benchmark_gnn( db, /* vlabels, */ nglobalverts, nlayers, nfeatures, rcount );
+  benchmark_gnn( db, /* vlabels, */ nlayers, nfeatures, rcount );
 
   /**
     clean up
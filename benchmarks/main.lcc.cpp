@@ -128,7 +128,7 @@ int main( int argc, char* argv[] ) {
   }
 
   uint32_t rcount = 10;
-  benchmark_lcc( db, /* vlabels, */ nglobalverts, rcount );
+  benchmark_lcc( db, /* vlabels, */ rcount );
 
   /**
     clean up
@@ -128,7 +128,12 @@ int main( int argc, char* argv[] ) {
   }
 
   uint32_t rcount = cli.rcount();
+#ifdef MULTIPLEXED
+  uint32_t inflight = cli.inflight();
+  benchmark_linkbench_multiplexed( db, vlabels, elabels, ptypes, nglobalverts, rcount, inflight );
+#else
   benchmark_linkbench( db, vlabels, elabels, ptypes, nglobalverts, rcount );
+#endif
 
   /**
     clean up
@@ -130,7 +130,7 @@ int main( int argc, char* argv[] ) {
   uint32_t rcount = 10;
   uint32_t iterations = cli.iterations();
   double damping_factor = cli.dampingfactor();
-  benchmark_pagerank( db, /* vlabels, */ nglobalverts, damping_factor, iterations, rcount );
+  benchmark_pagerank( db, /* vlabels, */ damping_factor, iterations, rcount );
 
   /**
     clean up
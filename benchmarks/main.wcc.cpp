@@ -129,7 +129,7 @@ int main( int argc, char* argv[] ) {
 
   uint32_t rcount = 10;
   uint32_t iterations = cli.iterations();
-  benchmark_wcc( db, /* vlabels, */ nglobalverts, iterations, rcount );
+  benchmark_wcc( db, /* vlabels, */ iterations, rcount );
 
   /**
     clean up
@@ -11,19 +11,22 @@ id_to_query = {
   3: "update vertex", # update object (vertex)
   4: "count edges", # count edges
   5: "retrieve edges", # get edges
-  6: "add edges" # add edges
+  6: "add edges", # add edges
+  7: "retrieve edges between vertices", # get edges filtered by vertices
+  8: "delete edges", # delete edges
+  9: "update edges" # update edges
 }
 
 colors = {"1": "#009900", "2": "#000099", "4": "#990000", "8": "#990099"}
 
 matplotlib.rc('pdf')
-fig, axs = plt.subplots(7, sharex=True, sharey=True, figsize=(5, 10))
+fig, axs = plt.subplots(len(id_to_query), sharex=True, sharey=True, figsize=(5, 14))
 
 maximum = 5000
 
 for i in ("8", "4", "2", "1"):
   plots_data = []
-  for query_type in range(7):
+  for query_type in range(len(id_to_query)):
     plots_data.append([])
 
   # read data
@@ -46,7 +49,7 @@ for i in ("8", "4", "2", "1"):
         query_data[i] = maximum+1
     axs[subp].hist(query_data, int(maximum/20), range=(0, maximum+11), density=False, color=color, label=label)
 
-for subp in range(7):
+for subp in range(len(id_to_query)):
   #grid
   axs[subp].set_axisbelow(True) #draw grid behind the bars
   axs[subp].grid(True, which="both", axis="y")
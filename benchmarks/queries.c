@@ -13,6 +13,7 @@
 #include <string.h>
 
 #include "gdi.h"
+#include "gda_lightweight_edges.h"
 #include "data_scheme_1.h"
 #include "queries.h"
 #include "radix7.h"
@@ -68,7 +69,7 @@ void GDA_PurgeBuffer( GDI_Transaction transaction ) {
   for( size_t i=0 ; i<vec_size ; i++ ) {
     GDI_VertexHolder vertex = *(GDI_VertexHolder*)GDA_vector_at( transaction->vertices, i );
     free( vertex->property_data );
-    free( vertex->lightweight_edge_data );
+    GDA_LightweightEdgesFree( vertex );
 
     GDA_list_free( &(vertex->edges) );
     GDA_vector_free( &(vertex->blocks) );
@@ -81,6 +82,60 @@ void GDA_PurgeBuffer( GDI_Transaction transaction ) {
 }
 
 
+/**
+  cumulative probabilities (per mille) of the Linkbench queries
+ */
+static const uint16_t linkbench_query_probability[LINKBENCH_QUERY_COUNT] = {
+   129, /* linkbench_get_*_vertex */
+   155, /* linkbench_add_vertex */
+   165, /* linkbench_delete_vertex */
+   239, /* linkbench_update_vertex */
+   288, /* linkbench_count_edges */
+   795, /* linkbench_get_edges */
+   800, /* linkbench_get_edges_filtered_by_vertices */
+   890, /* linkbench_add_edge */
+   920, /* linkbench_delete_edge */
+  1000  /* linkbench_update_edge */
+};
+
+
+uint8_t linkbench_select_query() {
+  uint16_t random_num = rand() % 1000;
+  uint8_t query_idx;
+  for( query_idx = 0; query_idx<LINKBENCH_QUERY_COUNT ; query_idx++ ) {
+    if( random_num < linkbench_query_probability[query_idx] ) {
+      break;
+    }
+  }
+
+  assert( query_idx < LINKBENCH_QUERY_COUNT );
+
+  return query_idx;
+}
+
+
+uint64_t linkbench_random_vertex( uint64_t nglobal_verts, uint8_t* label_idx ) {
+  uint64_t application_level_ID = (
+    (((uint64_t) rand() <<  0) & 0x000000000000FFFFull) |
+    (((uint64_t) rand() << 16) & 0x00000000FFFF0000ull) |
+    (((uint64_t) rand() << 32) & 0x0000FFFF00000000ull) |
+    (((uint64_t) rand() << 48) & 0xFFFF000000000000ull)
+                                   ) % nglobal_verts;
+
+  uint8_t idx;
+  for( idx=0 ; idx<VERTEX_LABEL_COUNT ; idx++ ) {
+    if( application_level_ID < vlabel_range[idx] ) {
+      break;
+    }
+  }
+
+  assert( idx < VERTEX_LABEL_COUNT );
+
+  *label_idx = idx;
+  return application_level_ID;
+}
+
+
 uint64_t linkbench_add_vertex( GDI_Label* vlabels, GDI_PropertyType* ptypes, uint64_t nglobal_verts, GDI_Transaction transaction ) {
   int status;
 
@@ -582,37 +637,32 @@ void linkbench_cleanup_prop_ressource( lb_prop_ressource_t** ressource ) {
 int linkbench_add_edge( GDI_Label origin_label, uint64_t origin_ID, GDI_Label target_label, uint64_t target_ID, GDI_Label edge_label, GDI_Transaction transaction ) {
   int status;
 
-  bool found_flag;
-  GDI_Vertex_uid vertex_uid;
-  status = GDI_TranslateVertexID( &found_flag, &vertex_uid, origin_label, &origin_ID, sizeof(uint64_t), transaction );
+  /**
+    translate both IDs with a single call
+   */
+  bool found_flags[2];
+  GDI_Vertex_uid vertex_uids[2];
+  GDI_Label labels[2] = { origin_label, target_label };
+  uint64_t IDs[2] = { origin_ID, target_ID };
+  status = GDI_TranslateVertexIDs( found_flags, vertex_uids, labels, IDs, sizeof(uint64_t), 2, transaction );
   assert( (status == GDI_SUCCESS) || (status == GDI_ERROR_TRANSACTION_CRITICAL) );
   if( status == GDI_ERROR_TRANSACTION_CRITICAL ) {
     return 2;
   }
 
-  if( !found_flag ) {
+  if( !found_flags[0] || !found_flags[1] ) {
     return 1;
   }
 
   GDI_VertexHolder v_origin;
-  status = GDI_AssociateVertex( vertex_uid, transaction, &v_origin );
+  status = GDI_AssociateVertex( vertex_uids[0], transaction, &v_origin );
   assert( (status == GDI_SUCCESS) || (status == GDI_ERROR_TRANSACTION_CRITICAL) );
   if( status == GDI_ERROR_TRANSACTION_CRITICAL ) {
     return 2;
   }
 
-  status = GDI_TranslateVertexID( &found_flag, &vertex_uid, target_label, &target_ID, sizeof(uint64_t), transaction );
-  assert( (status == GDI_SUCCESS) || (status == GDI_ERROR_TRANSACTION_CRITICAL) );
-  if( status == GDI_ERROR_TRANSACTION_CRITICAL ) {
-    return 2;
-  }
-
-  if( !found_flag ) {
-    return 1;
-  }
-
   GDI_VertexHolder v_target;
-  status = GDI_AssociateVertex( vertex_uid, transaction, &v_target );
+  status = GDI_AssociateVertex( vertex_uids[1], transaction, &v_target );
   assert( (status == GDI_SUCCESS) || (status == GDI_ERROR_TRANSACTION_CRITICAL) );
   if( status == GDI_ERROR_TRANSACTION_CRITICAL ) {
     return 2;
@@ -746,6 +796,194 @@ int linkbench_get_edges( GDI_Label vlabel, uint64_t application_level_ID, GDI_La
 }
 
 
+/**
+  associates all edges with edge_label between the two vertices
+
+  return codes are the same as for the linkbench queries on edges,
+  edges has to be freed by the caller, if 0 is returned
+ */
+static int linkbench_associate_edges( GDI_Label origin_label, uint64_t origin_ID, GDI_Label target_label, uint64_t target_ID, GDI_Label edge_label, GDI_Transaction transaction, GDI_Database db, GDI_EdgeHolder** edges, size_t* edge_count ) {
+  int status;
+
+  /**
+    translate both IDs with a single call
+   */
+  bool found_flags[2];
+  GDI_Vertex_uid vertex_uids[2];
+  GDI_Label labels[2] = { origin_label, target_label };
+  uint64_t IDs[2] = { origin_ID, target_ID };
+  status = GDI_TranslateVertexIDs( found_flags, vertex_uids, labels, IDs, sizeof(uint64_t), 2, transaction );
+  assert( (status == GDI_SUCCESS) || (status == GDI_ERROR_TRANSACTION_CRITICAL) );
+  if( status == GDI_ERROR_TRANSACTION_CRITICAL ) {
+    return 2;
+  }
+
+  if( !found_flags[0] || !found_flags[1] ) {
+    return 1;
+  }
+
+  GDI_VertexHolder v_origin;
+  status = GDI_AssociateVertex( vertex_uids[0], transaction, &v_origin );
+  assert( (status == GDI_SUCCESS) || (status == GDI_ERROR_TRANSACTION_CRITICAL) );
+  if( status == GDI_ERROR_TRANSACTION_CRITICAL ) {
+    return 2;
+  }
+
+  /**
+    create constraint
+   */
+  GDI_Constraint constraint;
+  GDI_Subconstraint subconstraint;
+
+  status = GDI_CreateConstraint( db, &constraint );
+  assert( status == GDI_SUCCESS );
+  status = GDI_CreateSubconstraint( db, &subconstraint );
+  assert( status == GDI_SUCCESS );
+  status = GDI_AddLabelConditionToSubconstraint( edge_label, GDI_EQUAL, subconstraint );
+  assert( status == GDI_SUCCESS );
+  status = GDI_AddSubconstraintToConstraint( subconstraint, constraint );
+  assert( status == GDI_SUCCESS );
+
+  size_t num_uids;
+  status = GDI_GetEdgesOfVertex( NULL, 0, &num_uids, constraint, GDI_EDGE_UNDIRECTED, v_origin );
+  assert( status == GDI_SUCCESS );
+  GDI_Edge_uid* edge_uids = malloc( (num_uids + 1) * sizeof(GDI_Edge_uid) );
+  status = GDI_GetEdgesOfVertex( edge_uids, num_uids + 1, &num_uids, constraint, GDI_EDGE_UNDIRECTED, v_origin );
+  assert( status == GDI_SUCCESS );
+
+  /**
+    clean up
+   */
+  status = GDI_FreeSubconstraint( &subconstraint );
+  assert( status == GDI_SUCCESS );
+  status = GDI_FreeConstraint( &constraint );
+  assert( status == GDI_SUCCESS );
+
+  /**
+    the edge objects are needed to determine the second vertex of each edge
+   */
+  *edges = malloc( (num_uids + 1) * sizeof(GDI_EdgeHolder) );
+  *edge_count = 0;
+  for( size_t i=0 ; i<num_uids ; i++ ) {
+    GDI_EdgeHolder edge;
+    status = GDI_AssociateEdge( edge_uids[i], transaction, &edge );
+    assert( (status == GDI_SUCCESS) || (status == GDI_ERROR_TRANSACTION_CRITICAL) );
+    if( status == GDI_ERROR_TRANSACTION_CRITICAL ) {
+      free( edge_uids );
+      free( *edges );
+      return 2;
+    }
+
+    GDI_Vertex_uid uids[2];
+    status = GDI_GetVerticesOfEdge( &uids[0], &uids[1], edge );
+    assert( status == GDI_SUCCESS );
+    if( (uids[0] == vertex_uids[1]) || (uids[1] == vertex_uids[1]) ) {
+      (*edges)[(*edge_count)++] = edge;
+    }
+  }
+
+  free( edge_uids );
+
+  return 0;
+}
+
+
+int linkbench_get_edges_filtered_by_vertices( GDI_Label origin_label, uint64_t origin_ID, GDI_Label target_label, uint64_t target_ID, GDI_Label edge_label, GDI_PropertyType* ptypes, GDI_Transaction transaction, GDI_Database db, size_t* edge_count ) {
+  int status;
+
+  GDI_EdgeHolder* edges;
+  int ret = linkbench_associate_edges( origin_label, origin_ID, target_label, target_ID, edge_label, transaction, db, &edges, edge_count );
+  if( ret != 0 ) {
+    return ret;
+  }
+
+  /**
+    retrieve the data of the edges
+   */
+  char buf[256];
+  size_t array_of_offsets[2];
+  size_t buf_resultcount, offset_resultcount;
+  for( size_t i=0 ; i<*edge_count ; i++ ) {
+    status = GDI_GetPropertiesOfEdge( buf, 256 /* buf count */, &buf_resultcount,
+      array_of_offsets, 2 /* offset count */, &offset_resultcount, ptypes[13] /* data */, edges[i] );
+    assert( status == GDI_SUCCESS );
+  }
+
+  free( edges );
+
+  return 0;
+}
+
+
+int linkbench_delete_edge( GDI_Label origin_label, uint64_t origin_ID, GDI_Label target_label, uint64_t target_ID, GDI_Label edge_label, GDI_Transaction transaction, GDI_Database db ) {
+  int status;
+
+  GDI_EdgeHolder* edges;
+  size_t edge_count;
+  int ret = linkbench_associate_edges( origin_label, origin_ID, target_label, target_ID, edge_label, transaction, db, &edges, &edge_count );
+  if( ret != 0 ) {
+    return ret;
+  }
+
+  if( edge_count > 0 ) {
+    status = GDI_FreeEdge( &edges[0] );
+    assert( (status == GDI_SUCCESS) || (status == GDI_ERROR_TRANSACTION_CRITICAL) );
+    if( status == GDI_ERROR_TRANSACTION_CRITICAL ) {
+      ret = 2;
+    }
+  }
+
+  free( edges );
+
+  return ret;
+}
+
+
+int linkbench_update_edge( GDI_Label origin_label, uint64_t origin_ID, GDI_Label target_label, uint64_t target_ID, GDI_Label edge_label, GDI_PropertyType* ptypes, GDI_Transaction transaction, GDI_Database db ) {
+  int status;
+
+  GDI_EdgeHolder* edges;
+  size_t edge_count;
+  int ret = linkbench_associate_edges( origin_label, origin_ID, target_label, target_ID, edge_label, transaction, db, &edges, &edge_count );
+  if( ret != 0 ) {
+    return ret;
+  }
+
+  if( edge_count > 0 ) {
+    int numBytes = rand() % 256;
+    char* string = create_string_property( numBytes );
+    status = GDI_SetPropertyOfEdge( string, numBytes, ptypes[13] /* data */, edges[0] );
+    assert( (status == GDI_SUCCESS) || (status == GDI_ERROR_TRANSACTION_CRITICAL) );
+    if( status == GDI_ERROR_TRANSACTION_CRITICAL ) {
+      ret = 2;
+    }
+    free( string );
+  }
+
+  free( edges );
+
+  return ret;
+}
+
+
+int linkbench_edge_query( uint8_t query_idx, GDI_Label origin_label, uint64_t origin_ID, GDI_Label target_label, uint64_t target_ID, GDI_Label edge_label, GDI_PropertyType* ptypes, GDI_Transaction transaction, GDI_Database db ) {
+  switch( query_idx ) {
+    case 6:
+      {
+        size_t edge_count;
+        return linkbench_get_edges_filtered_by_vertices( origin_label, origin_ID, target_label, target_ID, edge_label, ptypes, transaction, db, &edge_count );
+      }
+    case 7:
+      return linkbench_add_edge( origin_label, origin_ID, target_label, target_ID, edge_label, transaction );
+    case 8:
+      return linkbench_delete_edge( origin_label, origin_ID, target_label, target_ID, edge_label, transaction, db );
+    default:
+      assert( query_idx == 9 );
+      return linkbench_update_edge( origin_label, origin_ID, target_label, target_ID, edge_label, ptypes, transaction, db );
+  }
+}
+
+
 /**
   start_vertex, vlabel and transaction need to be the same
   on all participating processes
@@ -806,13 +1044,6 @@ int nod_bfs_sort_u32( GDI_Label vlabel, uint64_t start_vertex, GDI_Transaction t
   GDA_HashMap* depth_hm;
   GDA_hashmap_create( &depth_hm, sizeof(uint32_t) /* key size */, ASSOC_TRESHOLD /* capacity */, sizeof(uint8_t) /* value size */, &GDA_int_to_int );
 
-  size_t adjacent_count = 32;
-  GDI_Vertex_uid* vertex_uids = malloc( adjacent_count * sizeof(GDI_Vertex_uid) );
-  if( vertex_uids == NULL ) {
-    fprintf( stderr, "Not enough memory on rank %i.\n", transaction->db->commrank );
-    MPI_Abort( transaction->db->comm, -2 );
-  }
-
   uint32_t** buffer = malloc( transaction->db->commsize * sizeof(uint32_t*) );
   if( buffer == NULL ) {
     fprintf( stderr, "Not enough memory on rank %i.\n", transaction->db->commrank );
@@ -904,23 +1135,19 @@ int nod_bfs_sort_u32( GDI_Label vlabel, uint64_t start_vertex, GDI_Transaction t
       printf("depth[%lu] = %u\n", (*v_ids)[*elem_cnt], depth_level);
 #endif
 
-      size_t neighbors_count;
-      status = GDI_GetNeighborVerticesOfVertex( vertex_uids, adjacent_count, &neighbors_count, GDI_CONSTRAINT_NULL, GDI_EDGE_UNDIRECTED, vertex );
-      if( status == GDI_ERROR_TRUNCATE ) {
-        status = GDI_GetNeighborVerticesOfVertex( NULL, 0, &adjacent_count, GDI_CONSTRAINT_NULL, GDI_EDGE_UNDIRECTED, vertex );
-        assert( status == GDI_SUCCESS );
-        vertex_uids = realloc( vertex_uids, adjacent_count * sizeof(GDI_Vertex_uid) );
-        if( vertex_uids == NULL ) {
-          fprintf( stderr, "Not enough memory on rank %i.\n", transaction->db->commrank );
-          MPI_Abort( transaction->db->comm, -2 );
-        }
-        status = GDI_GetNeighborVerticesOfVertex( vertex_uids, adjacent_count, &neighbors_count, GDI_CONSTRAINT_NULL, GDI_EDGE_UNDIRECTED, vertex );
-      }
+      GDI_NeighborIterator neighbors;
+      GDI_Vertex_uid neighbor_uid;
+      bool found_flag;
+      status = GDI_InitNeighborIterator( &neighbors, GDI_CONSTRAINT_NULL, GDI_EDGE_UNDIRECTED, vertex );
       assert( status == GDI_SUCCESS );
 
       /* add neighbors of current vertex to the appropriate buffers */
-      for( size_t j=0 ; j<neighbors_count ; j++ ) {
-        GDA_GetDPointer( &voffset, &vrank, vertex_uids[j] );
+      while( true ) {
+        GDI_NextNeighborVertex( &neighbor_uid, &found_flag, &neighbors );
+        if( !found_flag ) {
+          break;
+        }
+        GDA_GetDPointer( &voffset, &vrank, neighbor_uid );
 
         if( buffer_cnt[vrank] == buffer_cnt[transaction->db->commsize+vrank] ) {
           /* buffer is full */
@@ -1056,7 +1283,6 @@ int nod_bfs_sort_u32( GDI_Label vlabel, uint64_t start_vertex, GDI_Transaction t
     if( global_next_frontier_count == 0 ) {
       /* we are done */
       free( current );
-      free( vertex_uids );
       for( unsigned int i=0 ; i<transaction->db->commsize ; i++ ) {
         free( buffer[i] );
       }
@@ -1131,13 +1357,6 @@ int nod_k_hop( GDI_Label vlabel, uint64_t start_vertex, GDI_Transaction transact
   GDA_HashMap* depth_hm;
   GDA_hashmap_create( &depth_hm, sizeof(uint32_t) /* key size */, ASSOC_TRESHOLD /* capacity */, sizeof(uint8_t) /* value size */, &GDA_int_to_int );
 
-  size_t adjacent_count = 32;
-  GDI_Vertex_uid* vertex_uids = malloc( adjacent_count * sizeof(GDI_Vertex_uid) );
-  if( vertex_uids == NULL ) {
-    fprintf( stderr, "Not enough memory on rank %i.\n", transaction->db->commrank );
-    MPI_Abort( transaction->db->comm, -2 );
-  }
-
   uint32_t** buffer = malloc( transaction->db->commsize * sizeof(uint32_t*) );
   if( buffer == NULL ) {
     fprintf( stderr, "Not enough memory on rank %i.\n", transaction->db->commrank );
@@ -1211,23 +1430,19 @@ int nod_k_hop( GDI_Label vlabel, uint64_t start_vertex, GDI_Transaction transact
         MPI_Abort( transaction->db->comm, -4 );
       }
 
-      size_t neighbors_count;
-      status = GDI_GetNeighborVerticesOfVertex( vertex_uids, adjacent_count, &neighbors_count, GDI_CONSTRAINT_NULL, GDI_EDGE_UNDIRECTED, vertex );
-      if( status == GDI_ERROR_TRUNCATE ) {
-        status = GDI_GetNeighborVerticesOfVertex( NULL, 0, &adjacent_count, GDI_CONSTRAINT_NULL, GDI_EDGE_UNDIRECTED, vertex );
-        assert( status == GDI_SUCCESS );
-        vertex_uids = realloc( vertex_uids, adjacent_count * sizeof(GDI_Vertex_uid) );
-        if( vertex_uids == NULL ) {
-          fprintf( stderr, "Not enough memory on rank %i.\n", transaction->db->commrank );
-          MPI_Abort( transaction->db->comm, -2 );
-        }
-        status = GDI_GetNeighborVerticesOfVertex( vertex_uids, adjacent_count, &neighbors_count, GDI_CONSTRAINT_NULL, GDI_EDGE_UNDIRECTED, vertex );
-      }
+      GDI_NeighborIterator neighbors;
+      GDI_Vertex_uid neighbor_uid;
+      bool found_flag;
+      status = GDI_InitNeighborIterator( &neighbors, GDI_CONSTRAINT_NULL, GDI_EDGE_UNDIRECTED, vertex );
       assert( status == GDI_SUCCESS );
 
       /* add neighbors of current vertex to the appropriate buffers */
-      for( size_t j=0 ; j<neighbors_count ; j++ ) {
-        GDA_GetDPointer( &voffset, &vrank, vertex_uids[j] );
+      while( true ) {
+        GDI_NextNeighborVertex( &neighbor_uid, &found_flag, &neighbors );
+        if( !found_flag ) {
+          break;
+        }
+        GDA_GetDPointer( &voffset, &vrank, neighbor_uid );
 
         if( buffer_cnt[vrank] == buffer_cnt[transaction->db->commsize+vrank] ) {
           /* buffer is full */
@@ -1366,7 +1581,6 @@ int nod_k_hop( GDI_Label vlabel, uint64_t start_vertex, GDI_Transaction transact
   }
 
   free( current );
-  free( vertex_uids );
   for( unsigned int i=0 ; i<transaction->db->commsize ; i++ ) {
     free( buffer[i] );
   }
@@ -1426,39 +1640,79 @@ uint64_t max_frequency( uint64_t* histogram, size_t n ) {
 
 
 /**
-  based on CDLP code by George Mitenkov
-  optimized by Robert Gerstenberger
+  retrieves the UIDs of the vertices, whose primary blocks are stored on
+  the local process, in ascending order from a bitmap index over all
+  vertices
+
+  Kernels, that share a value per vertex, allocate a window with one
+  entry per local block, so that other processes can address the entry
+  of a vertex by the block offset of its UID: local_blocks (optional)
+  receives the entry of each local vertex and num_blocks the number of
+  entries.
  */
-int nod_cdlp_nonblocking_sorted( uint64_t global_num_verts, GDI_Transaction transaction, uint32_t max_num_iterations, uint64_t** labels, uint64_t** v_ids, size_t* elem_cnt ) {
-  int status;
-
-  size_t assoc_count = 0; /* track the number of vertices associated with the collective transaction */
+static void get_local_vertices( GDI_Index vertex_index, GDI_Transaction transaction, GDI_Vertex_uid** local_uids, uint64_t** local_blocks, uint64_t* local_num_verts, uint64_t* num_blocks ) {
+  size_t count;
+  int status = GDI_GetLocalVerticesOfIndex( NULL, 0, &count, vertex_index, transaction );
+  assert( status == GDI_SUCCESS );
 
-  /**
-    next step is a bit iffy: we compute the vertex UIDs of the vertices
-    local to this process
+  /* one additional element, so that a process without vertices gets a valid buffer */
+  *local_uids = malloc( (count + 1) * sizeof(GDI_Vertex_uid) );
+  if( *local_uids == NULL ) {
+    fprintf( stderr, "Not enough memory on rank %i.\n", transaction->db->commrank );
+    MPI_Abort( transaction->db->comm, -2 );
+  }
 
-    equivalent would be a GDI_GetLocalVerticesOfIndex call
+  if( count > 0 ) {
+    status = GDI_GetLocalVerticesOfIndex( *local_uids, count, &count, vertex_index, transaction );
+    assert( status == GDI_SUCCESS );
+  }
 
-    normally afterwards, we would need to extract the highest block
-    offset to use the memory allocations of the windows; because of
-    how the database is created, local_num_verts is that maximum
+  /**
+    the UIDs are sorted, so the last one holds the highest block offset
    */
-  uint64_t local_num_verts = global_num_verts / transaction->db->commsize;
-  if( (uint64_t)(transaction->db->commrank) < (global_num_verts - local_num_verts * transaction->db->commsize) ) {
-    local_num_verts++;
+  *num_blocks = 0;
+  if( count > 0 ) {
+    uint64_t offset, rank;
+    GDA_GetDPointer( &offset, &rank, (*local_uids)[count-1] );
+    *num_blocks = offset / transaction->db->block_size + 1;
   }
 
-  GDI_Vertex_uid* local_uids = malloc( local_num_verts * sizeof(GDI_Vertex_uid) );
-  if( local_uids == NULL ) {
-    fprintf( stderr, "Not enough memory on rank %i.\n", transaction->db->commrank );
-    MPI_Abort( transaction->db->comm, -2 );
-  }
+  if( local_blocks != NULL ) {
+    *local_blocks = malloc( (count + 1) * sizeof(uint64_t) );
+    if( *local_blocks == NULL ) {
+      fprintf( stderr, "Not enough memory on rank %i.\n", transaction->db->commrank );
+      MPI_Abort( transaction->db->comm, -2 );
+    }
 
-  for( uint64_t i=0 ; i<local_num_verts ; i++ ) {
-    GDA_SetDPointer( i * transaction->db->block_size, transaction->db->commrank, &local_uids[i] );
+    for( size_t i=0 ; i<count ; i++ ) {
+      uint64_t offset, rank;
+      GDA_GetDPointer( &offset, &rank, (*local_uids)[i] );
+      (*local_blocks)[i] = offset / transaction->db->block_size;
+    }
   }
 
+  *local_num_verts = count;
+}
+
+
+/**
+  based on CDLP code by George Mitenkov
+  optimized by Robert Gerstenberger
+ */
+int nod_cdlp_nonblocking_sorted( GDI_Index vertex_index, GDI_Transaction transaction, uint32_t max_num_iterations, uint64_t** labels, uint64_t** v_ids, size_t* elem_cnt ) {
+  int status;
+
+  size_t assoc_count = 0; /* track the number of vertices associated with the collective transaction */
+
+  /**
+    vertex UIDs of the vertices local to this process and the entries of
+    their values in the windows
+   */
+  GDI_Vertex_uid* local_uids;
+  uint64_t* local_blocks;
+  uint64_t local_num_verts, num_blocks;
+  get_local_vertices( vertex_index, transaction, &local_uids, &local_blocks, &local_num_verts, &num_blocks );
+
   *v_ids = malloc( local_num_verts * sizeof(uint64_t) );
   if( *v_ids == NULL ) {
     fprintf( stderr, "Not enough memory on rank %i.\n", transaction->db->commrank );
@@ -1487,32 +1741,22 @@ int nod_cdlp_nonblocking_sorted( uint64_t global_num_verts, GDI_Transaction tran
    */
   RMA_Win labels_window;
   uint64_t* prev_labels;
-  RMA_Win_allocate( local_num_verts * sizeof(uint64_t), sizeof(uint64_t), MPI_INFO_NULL, transaction->db->comm, &prev_labels, &labels_window );
+  RMA_Win_allocate( num_blocks * sizeof(uint64_t), sizeof(uint64_t), MPI_INFO_NULL, transaction->db->comm, &prev_labels, &labels_window );
 
   RMA_Win_lock_all( 0, labels_window );
 
   /**
-    initialization
+    initialization: the degrees and IDs of all local vertices are
+    fetched as two columns, without associating the vertices
    */
-  for( uint64_t i=0 ; i<local_num_verts ; i++ ) {
-    GDI_VertexHolder vertex;
-    bound_memory( assoc_count );
-    status = GDI_AssociateVertex( local_uids[i], transaction, &vertex );
-    assert( (status == GDI_SUCCESS) || (status == GDI_ERROR_TRANSACTION_CRITICAL) );
-
-    if( status == GDI_ERROR_TRANSACTION_CRITICAL ) {
-      fprintf( stderr, "Rank %i: vertex association was transaction-critical.\n", transaction->db->commrank );
-      MPI_Abort( transaction->db->comm, -4 );
-    }
-
-    size_t result_count, offset_result_count, array_of_offsets[2];
-    status = GDI_GetPropertiesOfVertex( &degrees[i], 1, &result_count, array_of_offsets, 2, &offset_result_count, GDI_PROPERTY_TYPE_DEGREE, vertex );
-    assert( (status == GDI_SUCCESS) && (offset_result_count == 2) );
-
-    status = GDI_GetPropertiesOfVertex( &curr_labels[i], 8, &result_count,
-      array_of_offsets, 2 /* offset count */, &offset_result_count, GDI_PROPERTY_TYPE_ID, vertex );
-    assert( (status == GDI_SUCCESS) && (offset_result_count == 2) );
+  void* columns[2] = { degrees, curr_labels };
+  size_t column_counts[2] = { local_num_verts, local_num_verts * sizeof(uint64_t) };
+  size_t column_resultcounts[2];
+  GDI_PropertyType column_ptypes[2] = { GDI_PROPERTY_TYPE_DEGREE, GDI_PROPERTY_TYPE_ID };
+  status = GDI_GetPropertiesOfVertices( columns, column_counts, column_resultcounts, NULL, column_ptypes, 2, local_uids, local_num_verts, transaction );
+  assert( (status == GDI_SUCCESS) && (column_resultcounts[1] == local_num_verts * sizeof(uint64_t)) );
 
+  for( uint64_t i=0 ; i<local_num_verts ; i++ ) {
     (*v_ids)[i] = curr_labels[i];
   }
 
@@ -1540,7 +1784,7 @@ int nod_cdlp_nonblocking_sorted( uint64_t global_num_verts, GDI_Transaction tran
    */
   for( uint32_t iteration = 0 ; iteration < max_num_iterations ; iteration++ ) {
     for( size_t i=0; i<local_num_verts; i++ ) {
-      prev_labels[i] = curr_labels[i];
+      prev_labels[local_blocks[i]] = curr_labels[i];
     }
 
     /* ensure that the data in the window is updated */
@@ -1615,6 +1859,7 @@ int nod_cdlp_nonblocking_sorted( uint64_t global_num_verts, GDI_Transaction tran
   free( neighbor_labels );
   free( neighbor_uids );
   free( local_uids );
+  free( local_blocks );
   free( degrees );
 
   *labels = curr_labels;
@@ -1632,40 +1877,24 @@ int nod_cdlp_nonblocking_sorted( uint64_t global_num_verts, GDI_Transaction tran
   instead of only returning the unique vertices of the neighborhood like
   the changed version in the specification suggests
  */
-int nod_pagerank_nonblocking_sorted( uint64_t global_num_verts, GDI_Transaction transaction, uint32_t num_iterations, double damping_factor, double** scores, uint64_t** v_ids, size_t* elem_cnt ) {
+int nod_pagerank_nonblocking_sorted( GDI_Index vertex_index, GDI_Transaction transaction, uint32_t num_iterations, double damping_factor, double** scores, uint64_t** v_ids, size_t* elem_cnt ) {
   int status;
 
   size_t assoc_count = 0; /* track the number of vertices associated with the collective transaction */
 
   /**
-    next step is a bit iffy: we compute the vertex UIDs of the vertices
-    local to this process
-
-    equivalent would be a GDI_GetLocalVerticesOfIndex call
-
-    normally afterwards, we would need to extract the highest block
-    offset to use the memory allocations of the windows; because of
-    how the database is created, local_num_verts is that maximum
+    vertex UIDs of the vertices local to this process and the entries of
+    their values in the windows
    */
-  uint64_t local_num_verts = global_num_verts / transaction->db->commsize;
-  if( (uint64_t)(transaction->db->commrank) < (global_num_verts - local_num_verts * transaction->db->commsize) ) {
-    local_num_verts++;
-  }
-
-  GDI_Vertex_uid* local_uids = malloc( local_num_verts * sizeof(GDI_Vertex_uid) );
-  if( local_uids == NULL ) {
-    fprintf( stderr, "Not enough memory on rank %i.\n", transaction->db->commrank );
-    MPI_Abort( transaction->db->comm, -2 );
-  }
-
-  for( uint64_t i=0 ; i<local_num_verts ; i++ ) {
-    GDA_SetDPointer( i * transaction->db->block_size, transaction->db->commrank, &local_uids[i] );
-  }
+  GDI_Vertex_uid* local_uids;
+  uint64_t* local_blocks;
+  uint64_t local_num_verts, num_blocks;
+  get_local_vertices( vertex_index, transaction, &local_uids, &local_blocks, &local_num_verts, &num_blocks );
 
   *v_ids = malloc( local_num_verts * sizeof(uint64_t) );
   if( *v_ids == NULL ) {
     fprintf( stderr, "Not enough memory on rank %i.\n", transaction->db->commrank );
-    MPI_Abort( transaction->db->comm, -2 ); /* a bit iffy */
+    MPI_Abort( transaction->db->comm, -2 );
   }
 
   /**
@@ -1675,6 +1904,9 @@ int nod_pagerank_nonblocking_sorted( uint64_t global_num_verts, GDI_Transaction
 
     Compute them in advance.
    */
+  uint64_t global_num_verts;
+  MPI_Allreduce( &local_num_verts, &global_num_verts, 1, MPI_UINT64_T, MPI_SUM, transaction->db->comm );
+
   double initial_score = 1.0 / global_num_verts;
   double teleport_score = (1.0 - damping_factor) / global_num_verts;
 
@@ -1713,7 +1945,7 @@ int nod_pagerank_nonblocking_sorted( uint64_t global_num_verts, GDI_Transaction
    */
   RMA_Win scores_window;
   double* prev_scores = NULL;
-  RMA_Win_allocate( local_num_verts * sizeof(double), sizeof(double), MPI_INFO_NULL, transaction->db->comm, &prev_scores, &scores_window );
+  RMA_Win_allocate( num_blocks * sizeof(double), sizeof(double), MPI_INFO_NULL, transaction->db->comm, &prev_scores, &scores_window );
 
   for( size_t i=0; i<local_num_verts; i++ ) {
     curr_scores[i] = initial_score;
@@ -1753,7 +1985,7 @@ int nod_pagerank_nonblocking_sorted( uint64_t global_num_verts, GDI_Transaction
    */
   for( uint32_t iteration = 1 ; iteration<num_iterations ; iteration++ ) {
     for( size_t i=0; i<local_num_verts; i++ ) {
-      prev_scores[i] = curr_scores[i]/out_degrees[i];
+      prev_scores[local_blocks[i]] = curr_scores[i]/out_degrees[i];
     }
 
     /* ensure that the data in the windows is updated */
@@ -1827,6 +2059,7 @@ int nod_pagerank_nonblocking_sorted( uint64_t global_num_verts, GDI_Transaction
   RMA_Win_free( &scores_window );
   free( neighbor_uids );
   free( local_uids );
+  free( local_blocks );
   free( neighbor_outdegree );
   free( neighbor_score );
   free( out_degrees );
@@ -1841,35 +2074,19 @@ int nod_pagerank_nonblocking_sorted( uint64_t global_num_verts, GDI_Transaction
   based on wcc_pull code by George Mitenkov
   optimized by Robert Gerstenberger
  */
-int nod_wcc_pull_nonblocking_sorted( uint64_t global_num_verts, GDI_Transaction transaction, uint32_t max_num_iterations, uint64_t** components, uint64_t** v_ids, size_t* elem_cnt ) {
+int nod_wcc_pull_nonblocking_sorted( GDI_Index vertex_index, GDI_Transaction transaction, uint32_t max_num_iterations, uint64_t** components, uint64_t** v_ids, size_t* elem_cnt ) {
   int status;
 
   size_t assoc_count = 0; /* track the number of vertices associated with the collective transaction */
 
   /**
-    next step is a bit iffy: we compute the vertex UIDs of the vertices
-    local to this process
-
-    equivalent would be a GDI_GetLocalVerticesOfIndex call
-
-    normally afterwards, we would need to extract the highest block
-    offset to use the memory allocations of the windows; because of
-    how the database is created, local_num_verts is that maximum
+    vertex UIDs of the vertices local to this process and the entries of
+    their values in the windows
    */
-  uint64_t local_num_verts = global_num_verts / transaction->db->commsize;
-  if( (uint64_t)(transaction->db->commrank) < (global_num_verts - local_num_verts * transaction->db->commsize) ) {
-    local_num_verts++;
-  }
-
-  GDI_Vertex_uid* local_uids = malloc( local_num_verts * sizeof(GDI_Vertex_uid) );
-  if( local_uids == NULL ) {
-    fprintf( stderr, "Not enough memory on rank %i.\n", transaction->db->commrank );
-    MPI_Abort( transaction->db->comm, -2 );
-  }
-
-  for( uint64_t i=0 ; i<local_num_verts ; i++ ) {
-    GDA_SetDPointer( i * transaction->db->block_size, transaction->db->commrank, &local_uids[i] );
-  }
+  GDI_Vertex_uid* local_uids;
+  uint64_t* local_blocks;
+  uint64_t local_num_verts, num_blocks;
+  get_local_vertices( vertex_index, transaction, &local_uids, &local_blocks, &local_num_verts, &num_blocks );
 
   /**
     data allocations
@@ -1878,7 +2095,7 @@ int nod_wcc_pull_nonblocking_sorted( uint64_t global_num_verts, GDI_Transaction
   *v_ids = malloc( local_num_verts * sizeof(uint64_t) );
   if( *v_ids == NULL ) {
     fprintf( stderr, "Not enough memory on rank %i.\n", transaction->db->commrank );
-    MPI_Abort( transaction->db->comm, -2 ); /* a bit iffy */
+    MPI_Abort( transaction->db->comm, -2 );
   }
 
   uint64_t* curr_components = malloc( local_num_verts * sizeof(uint64_t) );
@@ -1893,7 +2110,7 @@ int nod_wcc_pull_nonblocking_sorted( uint64_t global_num_verts, GDI_Transaction
    */
   RMA_Win components_window;
   uint64_t* prev_components;
-  RMA_Win_allocate( local_num_verts * sizeof(uint64_t), sizeof(uint64_t), MPI_INFO_NULL, transaction->db->comm, &prev_components, &components_window );
+  RMA_Win_allocate( num_blocks * sizeof(uint64_t), sizeof(uint64_t), MPI_INFO_NULL, transaction->db->comm, &prev_components, &components_window );
 
   size_t max_adjacent_count = 0;
   for( uint64_t i=0 ; i<local_num_verts ; i++ ) {
@@ -1942,7 +2159,9 @@ int nod_wcc_pull_nonblocking_sorted( uint64_t global_num_verts, GDI_Transaction
     and selecting the minimum ones as the component's representative
    */
   for( uint32_t iteration = 0 ; iteration < max_num_iterations ; iteration++ ) {
-    memcpy( prev_components, curr_components, local_num_verts * sizeof(uint64_t) );
+    for( uint64_t i=0 ; i<local_num_verts ; i++ ) {
+      prev_components[local_blocks[i]] = curr_components[i];
+    }
 
     MPI_Barrier( transaction->db->comm );
 
@@ -2002,6 +2221,7 @@ int nod_wcc_pull_nonblocking_sorted( uint64_t global_num_verts, GDI_Transaction
   RMA_Win_free( &components_window );
 
   free( local_uids );
+  free( local_blocks );
   free( neighbor_uids );
   free( neighbor_components );
 
@@ -2020,35 +2240,19 @@ int nod_wcc_pull_nonblocking_sorted( uint64_t global_num_verts, GDI_Transaction
   instead of only returning the unique vertices of the neighborhood like
   the changed version in the specification suggests
  */
-int nod_gnn_blocking_sorted( uint64_t global_num_verts, GDI_Transaction transaction, uint32_t num_layers, uint32_t num_features, double* weights, double* bias, double** y_pred, uint64_t** v_ids, size_t* elem_cnt ) {
+int nod_gnn_blocking_sorted( GDI_Index vertex_index, GDI_Transaction transaction, uint32_t num_layers, uint32_t num_features, double* weights, double* bias, double** y_pred, uint64_t** v_ids, size_t* elem_cnt ) {
   int status;
 
   size_t assoc_count = 0; /* track the number of vertices associated with the collective transaction */
 
   /**
-    next step is a bit iffy: we compute the vertex UIDs of the vertices
-    local to this process
-
-    equivalent would be a GDI_GetLocalVerticesOfIndex call
-
-    normally afterwards, we would need to extract the highest block
-    offset to use the memory allocations of the windows; because of
-    how the database is created, local_num_verts is that maximum
+    vertex UIDs of the vertices local to this process and the entries of
+    their values in the windows
    */
-  uint64_t local_num_verts = global_num_verts / transaction->db->commsize;
-  if( (uint64_t)(transaction->db->commrank) < (global_num_verts - local_num_verts * transaction->db->commsize) ) {
-    local_num_verts++;
-  }
-
-  GDI_Vertex_uid* local_uids = malloc( local_num_verts * sizeof(GDI_Vertex_uid) );
-  if( local_uids == NULL ) {
-    fprintf( stderr, "Not enough memory on rank %i.\n", transaction->db->commrank );
-    MPI_Abort( transaction->db->comm, -2 );
-  }
-
-  for( uint64_t i=0 ; i<local_num_verts ; i++ ) {
-    GDA_SetDPointer( i * transaction->db->block_size, transaction->db->commrank, &local_uids[i] );
-  }
+  GDI_Vertex_uid* local_uids;
+  uint64_t* local_blocks;
+  uint64_t local_num_verts, num_blocks;
+  get_local_vertices( vertex_index, transaction, &local_uids, &local_blocks, &local_num_verts, &num_blocks );
 
   /**
     data allocations
@@ -2057,7 +2261,7 @@ int nod_gnn_blocking_sorted( uint64_t global_num_verts, GDI_Transaction transact
   *v_ids = malloc( local_num_verts * sizeof(uint64_t) );
   if( *v_ids == NULL ) {
     fprintf( stderr, "Not enough memory on rank %i.\n", transaction->db->commrank );
-    MPI_Abort( transaction->db->comm, -2 ); /* a bit iffy */
+    MPI_Abort( transaction->db->comm, -2 );
   }
 
   /* initial layer */
@@ -2092,7 +2296,7 @@ int nod_gnn_blocking_sorted( uint64_t global_num_verts, GDI_Transaction transact
 
   RMA_Win output_window;
   double* output = NULL;
-  RMA_Win_allocate( local_num_verts * num_features * sizeof(double), num_features * sizeof(double), MPI_INFO_NULL, transaction->db->comm, &output, &output_window );
+  RMA_Win_allocate( num_blocks * num_features * sizeof(double), num_features * sizeof(double), MPI_INFO_NULL, transaction->db->comm, &output, &output_window );
 
   uint64_t* in_degrees = malloc( local_num_verts * sizeof(uint64_t) );
   if( in_degrees == NULL ) {
@@ -2148,7 +2352,7 @@ int nod_gnn_blocking_sorted( uint64_t global_num_verts, GDI_Transaction transact
      */
     for( uint64_t i=0; i<local_num_verts; i++ ) {
       for( uint32_t j=0 ; j<num_features ; j++ ) {
-        output[i * num_features + j] = input[i * num_features + j]/sqrt(in_degrees[i]);
+        output[local_blocks[i] * num_features + j] = input[i * num_features + j]/sqrt(in_degrees[i]);
       }
       memcpy( &input[i * num_features], &bias[layer * num_features], num_features * sizeof(double) );
     }
@@ -2229,6 +2433,7 @@ int nod_gnn_blocking_sorted( uint64_t global_num_verts, GDI_Transaction transact
   RMA_Win_free( &output_window );
 
   free( local_uids );
+  free( local_blocks );
   free( neighbor_uids );
   free( message );
   free( neighbor_input );
@@ -2244,35 +2449,17 @@ int nod_gnn_blocking_sorted( uint64_t global_num_verts, GDI_Transaction transact
   based on lcc code by George Mitenkov
   optimized by Robert Gerstenberger
  */
-int nod_lcc( uint64_t global_num_verts, GDI_Transaction transaction, double** coefficients, uint64_t** v_ids, size_t* elem_cnt ) {
+int nod_lcc( GDI_Index vertex_index, GDI_Transaction transaction, double** coefficients, uint64_t** v_ids, size_t* elem_cnt ) {
   int status;
 
   size_t assoc_count = 0; /* track the number of vertices associated with the collective transaction */
 
   /**
-    next step is a bit iffy: we compute the vertex UIDs of the vertices
-    local to this process
-
-    equivalent would be a GDI_GetLocalVerticesOfIndex call
-
-    normally afterwards, we would need to extract the highest block
-    offset to use the memory allocations of the windows; because of
-    how the database is created, local_num_verts is that maximum
+    vertex UIDs of the vertices local to this process
    */
-  uint64_t local_num_verts = global_num_verts / transaction->db->commsize;
-  if( (uint64_t)(transaction->db->commrank) < (global_num_verts - local_num_verts * transaction->db->commsize) ) {
-    local_num_verts++;
-  }
-
-  GDI_Vertex_uid* local_uids = malloc( local_num_verts * sizeof(GDI_Vertex_uid) );
-  if( local_uids == NULL ) {
-    fprintf( stderr, "Not enough memory on rank %i.\n", transaction->db->commrank );
-    MPI_Abort( transaction->db->comm, -2 );
-  }
-
-  for( uint64_t i=0 ; i<local_num_verts ; i++ ) {
-    GDA_SetDPointer( i * transaction->db->block_size, transaction->db->commrank, &local_uids[i] );
-  }
+  GDI_Vertex_uid* local_uids;
+  uint64_t local_num_verts, num_blocks;
+  get_local_vertices( vertex_index, transaction, &local_uids, NULL, &local_num_verts, &num_blocks );
 
   /**
     data allocations
@@ -2289,13 +2476,6 @@ int nod_lcc( uint64_t global_num_verts, GDI_Transaction transaction, double** co
     MPI_Abort( transaction->db->comm, -2 );
   }
 
-  size_t nneighbor_max_count = 32;
-  GDI_Vertex_uid* nneighbor_uids = malloc( nneighbor_max_count * sizeof(GDI_Vertex_uid) );
-  if( nneighbor_uids == NULL ) {
-    fprintf( stderr, "Not enough memory on rank %i.\n", transaction->db->commrank );
-    MPI_Abort( transaction->db->comm, -2 );
-  }
-
   size_t max_adjacent_count = 0;
   for( uint64_t i=0 ; i<local_num_verts ; i++ ) {
     GDI_VertexHolder vertex;
@@ -2348,31 +2528,15 @@ int nod_lcc( uint64_t global_num_verts, GDI_Transaction transaction, double** co
     status = GDI_GetNeighborVerticesOfVertex( neighbor_uids, max_adjacent_count, &neighbors_count, GDI_CONSTRAINT_NULL, GDI_EDGE_UNDIRECTED, vertex );
     assert( status == GDI_SUCCESS );
 
-    /**
-      use a hashmap to store the number of times a vertex is a neighbor
-     */
     radix_sort7( neighbor_uids, neighbors_count );
 
-    GDA_HashMap* neighbor_hm;
-    GDA_hashmap_create( &neighbor_hm, sizeof(GDA_DPointer) /* key size */, 2 * neighbors_count /* capacity: 50% filled */, sizeof(uint64_t) /* value size */, &GDA_int64_to_int );
-
     tc[i] = 0.0;
     uint64_t degree = neighbors_count;
-    for( uint64_t j=0 ; j<neighbors_count ; j++ ) {
-      uint64_t repetition = 1;
-      while( ((j+1) < neighbors_count) && (neighbor_uids[j] == neighbor_uids[j+1]) ) {
-        j++;
-        repetition++;
-      }
 
-      if( local_uids[i] != neighbor_uids[j] ) { /* eliminate self loops */
-        GDA_hashmap_insert( neighbor_hm, &neighbor_uids[j], &repetition );
-      } else {
-        degree -= repetition; /* remove edges from self loops */
-      }
-    }
-
-    /* go through neighbors */
+    /**
+      go through the distinct neighbors: the number of triangles through
+      a neighbor is the number of common neighbors of both vertices
+     */
     for( size_t j=0 ; j<neighbors_count ; j++ ) {
       uint64_t repetition = 1;
       while( ((j+1) < neighbors_count) && (neighbor_uids[j] == neighbor_uids[j+1]) ) {
@@ -2382,7 +2546,18 @@ int nod_lcc( uint64_t global_num_verts, GDI_Transaction transaction, double** co
 
       if( local_uids[i] != neighbor_uids[j] ) { /* eliminate self loops */
         bound_memory( assoc_count );
-        status = GDI_AssociateVertex( neighbor_uids[j], transaction, &vertex );
+        if( assoc_count == 0 ) {
+          /**
+            the buffer was purged, so the local vertex has to be
+            associated again
+           */
+          status = GDI_AssociateVertex( local_uids[i], transaction, &vertex );
+          assert( status == GDI_SUCCESS );
+          assoc_count++;
+        }
+
+        GDI_VertexHolder neighbor_vertex;
+        status = GDI_AssociateVertex( neighbor_uids[j], transaction, &neighbor_vertex );
         assert( (status == GDI_SUCCESS) || (status == GDI_ERROR_TRANSACTION_CRITICAL) );
 
         if( status == GDI_ERROR_TRANSACTION_CRITICAL ) {
@@ -2390,41 +2565,16 @@ int nod_lcc( uint64_t global_num_verts, GDI_Transaction transaction, double** co
           MPI_Abort( transaction->db->comm, -4 );
         }
 
-        size_t nneighbors_count;
-        status = GDI_GetNeighborVerticesOfVertex( nneighbor_uids, nneighbor_max_count, &nneighbors_count, GDI_CONSTRAINT_NULL, GDI_EDGE_UNDIRECTED, vertex );
-        if( status == GDI_ERROR_TRUNCATE ) {
-          status = GDI_GetNeighborVerticesOfVertex( NULL, 0, &nneighbor_max_count, GDI_CONSTRAINT_NULL, GDI_EDGE_UNDIRECTED, vertex );
-          assert( status == GDI_SUCCESS );
-          nneighbor_uids = realloc( nneighbor_uids, nneighbor_max_count * sizeof(GDI_Vertex_uid) );
-          if( nneighbor_uids == NULL ) {
-            fprintf( stderr, "Not enough memory on rank %i.\n", transaction->db->commrank );
-            MPI_Abort( transaction->db->comm, -2 );
-          }
-          status = GDI_GetNeighborVerticesOfVertex( nneighbor_uids, nneighbor_max_count, &nneighbors_count, GDI_CONSTRAINT_NULL, GDI_EDGE_UNDIRECTED, vertex );
-        }
+        size_t common_count;
+        status = GDI_GetNumCommonNeighborsOfVertices( &common_count, GDI_CONSTRAINT_NULL, GDI_EDGE_UNDIRECTED, vertex, neighbor_vertex );
         assert( status == GDI_SUCCESS );
 
-        radix_sort7( nneighbor_uids, nneighbors_count );
-
-        for( size_t k=0 ; k<nneighbors_count ; k++ ) {
-          uint64_t nrepetition = 1;
-          while( ((k+1) < nneighbors_count) && (nneighbor_uids[k] == nneighbor_uids[k+1]) ) {
-            k++;
-            nrepetition++;
-          }
-
-          if( neighbor_uids[j] != nneighbor_uids[k] ) { /* eliminate self loops */
-            uint64_t* nfactor = GDA_hashmap_get( neighbor_hm, &nneighbor_uids[k] );
-            if( nfactor != NULL ) {
-              tc[i] += *nfactor * nrepetition * repetition;
-            }
-          }
-        }
+        tc[i] += common_count * repetition;
+      } else {
+        degree -= repetition; /* remove edges from self loops */
       }
     }
 
-    GDA_hashmap_free( &neighbor_hm );
-
     /* correct overcounting */
     tc[i] /= 2;
 
@@ -2437,7 +2587,6 @@ int nod_lcc( uint64_t global_num_verts, GDI_Transaction transaction, double** co
   /**
     clean up
    */
-  free( nneighbor_uids );
   free( neighbor_uids );
   free( local_uids );
 
@@ -2446,6 +2595,26 @@ int nod_lcc( uint64_t global_num_verts, GDI_Transaction transaction, double** co
   return 0;
 }
 
+/**
+  returns true, if uid is contained in the ascending array uids
+ */
+static bool contains_uid( GDI_Vertex_uid* uids, size_t count, GDI_Vertex_uid uid ) {
+  size_t low = 0;
+  size_t high = count;
+
+  while( low < high ) {
+    size_t mid = low + (high - low) / 2;
+    if( uids[mid] < uid ) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  return (low < count) && (uids[low] == uid);
+}
+
+
 /**
   retrieve the resource vertices that are used by projects whose name
   starts with a character identical to the letter argument and the number
@@ -2454,6 +2623,12 @@ int nod_lcc( uint64_t global_num_verts, GDI_Transaction transaction, double** co
   letter should be in the range of 'a' to 'z' or 'A' to 'Z' and the same
   across all ranks.
 
+  resource_index is a bitmap index on the resource label and enumerates
+  the local resource vertices, project_index is a prefix index on the
+  name property type with the project label and returns the matching
+  projects, so that neither the other vertices nor the projects are
+  associated.
+
   limit should be at least 1.
 
   return codes:
@@ -2464,7 +2639,7 @@ int nod_lcc( uint64_t global_num_verts, GDI_Transaction transaction, double** co
   -2: not enough memory
   -4: transaction critical error occured
  */
-int business_intelligence( GDI_Label* vlabels, GDI_Label* elabels, GDI_PropertyType* ptypes, uint64_t nglobal_verts,
+int business_intelligence( GDI_Label* elabels, GDI_PropertyType* ptypes, GDI_Index resource_index, GDI_Index project_index,
   GDI_Transaction transaction, GDI_Database db, MPI_Comm comm, size_t limit, char letter, char** res_name, size_t** v_count,
   size_t* elem_cnt ) {
 
@@ -2494,26 +2669,45 @@ int business_intelligence( GDI_Label* vlabels, GDI_Label* elabels, GDI_PropertyT
   size_t assoc_count = 0; /* track the number of vertices associated with the collective transaction */
 
   /**
-    next step is a bit iffy: we compute the vertex UIDs of the vertices
-    local to this process
-
-    equivalent would be a GDI_GetLocalVerticesOfIndex call
+    vertex UIDs of the resource vertices local to this process
    */
-  uint64_t local_num_verts = nglobal_verts / transaction->db->commsize;
-  if( (uint64_t)(transaction->db->commrank) < (nglobal_verts - local_num_verts * transaction->db->commsize) ) {
-    local_num_verts++;
-  }
+  GDI_Vertex_uid* local_uids;
+  uint64_t local_num_verts, num_blocks;
+  get_local_vertices( resource_index, transaction, &local_uids, NULL, &local_num_verts, &num_blocks );
 
-  GDI_Vertex_uid* local_uids = malloc( local_num_verts * sizeof(GDI_Vertex_uid) );
-  if( local_uids == NULL ) {
+  /**
+    vertex UIDs of all projects, whose name starts with the letter (in
+    lower or upper case), sorted to test the project neighbors of a
+    resource vertex without associating them
+   */
+  char prefixes[2] = { lletter, uletter };
+  size_t num_projects = 0;
+  GDI_Vertex_uid* projects = malloc( sizeof(GDI_Vertex_uid) );
+  if( projects == NULL ) {
     fprintf( stderr, "Not enough memory on rank %i.\n", rank );
     MPI_Abort( comm, -2 );
   }
 
-  for( uint64_t i=0 ; i<local_num_verts ; i++ ) {
-    GDA_SetDPointer( i * transaction->db->block_size, transaction->db->commrank, &local_uids[i] );
+  for( int i=0 ; i<2 ; i++ ) {
+    size_t count;
+    status = GDI_GetVerticesOfIndexByPrefix( NULL, 0, &count, &prefixes[i], 1, project_index, transaction );
+    assert( status == GDI_SUCCESS );
+
+    if( count > 0 ) {
+      projects = realloc( projects, (num_projects + count) * sizeof(GDI_Vertex_uid) );
+      if( projects == NULL ) {
+        fprintf( stderr, "Not enough memory on rank %i.\n", rank );
+        MPI_Abort( comm, -2 );
+      }
+
+      status = GDI_GetVerticesOfIndexByPrefix( projects + num_projects, count, &count, &prefixes[i], 1, project_index, transaction );
+      assert( status == GDI_SUCCESS );
+      num_projects += count;
+    }
   }
 
+  radix_sort7( projects, num_projects );
+
   /**
     data allocations
    */
@@ -2562,7 +2756,7 @@ int business_intelligence( GDI_Label* vlabels, GDI_Label* elabels, GDI_PropertyT
   assert( status == GDI_SUCCESS );
 
   /**
-    find all vertices with the resource label
+    go through all local resource vertices
    */
   for( uint64_t i=0 ; i<local_num_verts ; i++ ) {
     GDI_VertexHolder vertex;
@@ -2575,30 +2769,30 @@ int business_intelligence( GDI_Label* vlabels, GDI_Label* elabels, GDI_PropertyT
       MPI_Abort( comm, -4 );
     }
 
-    GDI_Label label;
-    size_t result_count;
-    status = GDI_GetAllLabelsOfVertex( &label, 1, &result_count, vertex );
-    assert( (status == GDI_SUCCESS) && (result_count == 1) );
-
-    if( label == vlabels[4] ) {
-      /* vertex with label resource */
-
-      /* obtain all neighbors that are projects */
-      size_t neighbors_count;
+    /* obtain all neighbors that are projects */
+    size_t neighbors_count;
+    status = GDI_GetNeighborVerticesOfVertex( v_projects, max_adjacent_count, &neighbors_count, constraint, GDI_EDGE_UNDIRECTED, vertex );
+    if( status == GDI_ERROR_TRUNCATE ) {
+      status = GDI_GetNeighborVerticesOfVertex( NULL, 0, &max_adjacent_count, constraint, GDI_EDGE_UNDIRECTED, vertex );
+      assert( status == GDI_SUCCESS );
+      v_projects = realloc( v_projects, max_adjacent_count * sizeof(GDI_Vertex_uid) );
+      if( v_projects == NULL ) {
+        fprintf( stderr, "Not enough memory on rank %i.\n", rank );
+        MPI_Abort( comm, -2 );
+      }
       status = GDI_GetNeighborVerticesOfVertex( v_projects, max_adjacent_count, &neighbors_count, constraint, GDI_EDGE_UNDIRECTED, vertex );
-      if( status == GDI_ERROR_TRUNCATE ) {
-        status = GDI_GetNeighborVerticesOfVertex( NULL, 0, &max_adjacent_count, constraint, GDI_EDGE_UNDIRECTED, vertex );
-        assert( status == GDI_SUCCESS );
-        v_projects = realloc( v_projects, max_adjacent_count * sizeof(GDI_Vertex_uid) );
-        if( v_projects == NULL ) {
-          fprintf( stderr, "Not enough memory on rank %i.\n", rank );
-          MPI_Abort( comm, -2 );
+    }
+    assert( status == GDI_SUCCESS );
+
+    if( neighbors_count > result_minimum ) { /* prune unnecessary operations */
+      size_t count = 0;
+      for( size_t j=0 ; j<neighbors_count ; j++ ) {
+        if( contains_uid( projects, num_projects, v_projects[j] ) ) {
+          count++;
         }
-        status = GDI_GetNeighborVerticesOfVertex( v_projects, max_adjacent_count, &neighbors_count, constraint, GDI_EDGE_UNDIRECTED, vertex );
       }
-      assert( status == GDI_SUCCESS );
 
-      if( neighbors_count > result_minimum ) { /* prune unnecessary operations */
+      if( count > 0 ) {
         char name[num_chars_name];
         size_t name_size;
         size_t offset_result_count, array_of_offsets[2];
@@ -2607,86 +2801,55 @@ int business_intelligence( GDI_Label* vlabels, GDI_Label* elabels, GDI_PropertyT
         name[name_size] = '\0';
         name_size++;
 
-        size_t count = 0;
-        for( size_t j=0 ; j<neighbors_count ; j++ ) {
-          GDI_VertexHolder neighbor;
-          bound_memory( assoc_count );
-          status = GDI_AssociateVertex( v_projects[j], transaction, &neighbor );
-          assert( (status == GDI_SUCCESS) || (status == GDI_ERROR_TRANSACTION_CRITICAL) );
-
-          if( status == GDI_ERROR_TRANSACTION_CRITICAL ) {
-            fprintf( stderr, "Rank %i: vertex association was transaction-critical.\n", rank );
-            MPI_Abort( comm, -4 );
-          }
-
-#if 0
-          status = GDI_GetAllLabelsOfVertex( &label, 1, &result_count, neighbor );
-          assert( (status == GDI_SUCCESS) && (result_count == 1) );
-          assert( label == vlabels[3] );
-#endif
-
-          char buf[100];
-          size_t offset_result_count, array_of_offsets[2];
-          status = GDI_GetPropertiesOfVertex( buf, num_chars_name, &result_count, array_of_offsets, 2, &offset_result_count, ptypes[0], neighbor );
-          assert( (status == GDI_SUCCESS) && (offset_result_count == 2) );
-
-          if( (buf[0] == lletter) || (buf[0] == uletter) ) {
-            count++;
-          }
-        }
-
-        /* add resource vertex to results if warranted */
-        if( count > 0 ) {
-          if( cnt_resources == limit ) {
-            if( count > result_minimum ) {
-              size_t idx = cnt_resources; /* initialize to avoid compiler warnings */
-              for( size_t j=0 ; j<cnt_resources ; j++ ) {
-                if( (*v_count)[j] == result_minimum ) {
-                  idx = j;
-                  break;
-                }
+        if( cnt_resources == limit ) {
+          if( count > result_minimum ) {
+            size_t idx = cnt_resources; /* initialize to avoid compiler warnings */
+            for( size_t j=0 ; j<cnt_resources ; j++ ) {
+              if( (*v_count)[j] == result_minimum ) {
+                idx = j;
+                break;
               }
+            }
 
-              assert( idx < cnt_resources );
+            assert( idx < cnt_resources );
 
-              memcpy( *res_name+idx*num_chars_name, name, name_size );
-              (*v_count)[idx] = count;
+            memcpy( *res_name+idx*num_chars_name, name, name_size );
+            (*v_count)[idx] = count;
 
-              result_minimum = (*v_count)[0];
-              for( size_t j=1 ; j<cnt_resources ; j++ ) {
-                if( (*v_count)[j] < result_minimum ) {
-                  result_minimum = (*v_count)[j];
-                }
+            result_minimum = (*v_count)[0];
+            for( size_t j=1 ; j<cnt_resources ; j++ ) {
+              if( (*v_count)[j] < result_minimum ) {
+                result_minimum = (*v_count)[j];
               }
             }
-          } else {
-            if( cnt_resources == num_resources ) {
-              /* arrays are full, have to increase */
-              num_resources *= 2;
-              if( limit < num_resources ) {
-                num_resources = limit;
-              }
-              *res_name = realloc( *res_name, num_resources * num_chars_name * sizeof(char) );
-              if( *res_name == NULL ) {
-                fprintf( stderr, "Not enough memory on rank %i.\n", rank );
-                MPI_Abort( comm, -2 );
-              }
-              *v_count = realloc( *v_count, num_resources * sizeof(size_t) );
-              if( *v_count == NULL ) {
-                fprintf( stderr, "Not enough memory on rank %i.\n", rank );
-                MPI_Abort( comm, -2 );
-              }
+          }
+        } else {
+          if( cnt_resources == num_resources ) {
+            /* arrays are full, have to increase */
+            num_resources *= 2;
+            if( limit < num_resources ) {
+              num_resources = limit;
+            }
+            *res_name = realloc( *res_name, num_resources * num_chars_name * sizeof(char) );
+            if( *res_name == NULL ) {
+              fprintf( stderr, "Not enough memory on rank %i.\n", rank );
+              MPI_Abort( comm, -2 );
+            }
+            *v_count = realloc( *v_count, num_resources * sizeof(size_t) );
+            if( *v_count == NULL ) {
+              fprintf( stderr, "Not enough memory on rank %i.\n", rank );
+              MPI_Abort( comm, -2 );
             }
+          }
 
-            memcpy( *res_name+cnt_resources*num_chars_name, name, name_size );
-            (*v_count)[cnt_resources++] = count;
+          memcpy( *res_name+cnt_resources*num_chars_name, name, name_size );
+          (*v_count)[cnt_resources++] = count;
 
-            if( cnt_resources == limit ) {
-              result_minimum = (*v_count)[0];
-              for( size_t j=1 ; j<cnt_resources ; j++ ) {
-                if( (*v_count)[j] < result_minimum ) {
-                  result_minimum = (*v_count)[j];
-                }
+          if( cnt_resources == limit ) {
+            result_minimum = (*v_count)[0];
+            for( size_t j=1 ; j<cnt_resources ; j++ ) {
+              if( (*v_count)[j] < result_minimum ) {
+                result_minimum = (*v_count)[j];
               }
             }
           }
@@ -2699,6 +2862,7 @@ int business_intelligence( GDI_Label* vlabels, GDI_Label* elabels, GDI_PropertyT
     clean up
    */
   free( local_uids );
+  free( projects );
   free( v_projects );
   status = GDI_FreeConstraint( &constraint );
   assert( status == GDI_SUCCESS );
@@ -12,6 +12,34 @@
 GDI_Date create_birthdate_property();
 
 
+/**
+  Linkbench: query mix
+
+  selects a query of the Linkbench mix at random and returns its index:
+  0 - linkbench_get_*_vertex
+  1 - linkbench_add_vertex
+  2 - linkbench_delete_vertex
+  3 - linkbench_update_vertex
+  4 - linkbench_count_edges
+  5 - linkbench_get_edges
+  6 - linkbench_get_edges_filtered_by_vertices
+  7 - linkbench_add_edge
+  8 - linkbench_delete_edge
+  9 - linkbench_update_edge
+ */
+#define LINKBENCH_QUERY_COUNT 10
+
+uint8_t linkbench_select_query();
+
+
+/**
+  returns the application-level ID of a random vertex of the initial
+  graph (smaller than nglobal_verts) and the index of its label in
+  label_idx
+ */
+uint64_t linkbench_random_vertex( uint64_t nglobal_verts, uint8_t* label_idx );
+
+
 /**
   Linkbench: obj_insert(ot, version, time, data)
 
@@ -155,8 +183,7 @@ void linkbench_cleanup_prop_ressource( lb_prop_ressource_t** ressource );
 /**
   linkbench: assoc_insert(at, id1, id2, vis, time, version, data)
 
-  ignores version, time and visbility and GDI doesn't support
-  properties for edges at the moment
+  ignores version, time, visbility and data
 
   return codes:
   0 - success
@@ -190,6 +217,60 @@ int linkbench_count_edges( GDI_Label vlabel, uint64_t application_level_ID, GDI_
 int linkbench_get_edges( GDI_Label vlabel, uint64_t application_level_ID, GDI_Label edge_label, GDI_Transaction transaction, GDI_Database db, size_t* edge_count, GDI_Edge_uid** edge_uids );
 
 
+/**
+  linkbench: assoc_get(at, id1, id2set, high, low)
+
+  id2set only contains a single vertex, ignores high and low,
+  edge_count is the number of edges between both vertices
+
+  return codes:
+  0 - success
+  1 - one of the vertices was not found
+  2 - transaction critical error
+ */
+int linkbench_get_edges_filtered_by_vertices( GDI_Label origin_label, uint64_t origin_ID, GDI_Label target_label, uint64_t target_ID, GDI_Label edge_label, GDI_PropertyType* ptypes, GDI_Transaction transaction, GDI_Database db, size_t* edge_count );
+
+
+/**
+  linkbench: assoc_delete(at, id1, id2)
+
+  deletes a single edge between both vertices, if there is any
+
+  return codes:
+  0 - success
+  1 - one of the vertices was not found
+  2 - transaction critical error
+ */
+int linkbench_delete_edge( GDI_Label origin_label, uint64_t origin_ID, GDI_Label target_label, uint64_t target_ID, GDI_Label edge_label, GDI_Transaction transaction, GDI_Database db );
+
+
+/**
+  linkbench: assoc_update(at, id1, id2, vis, time, version, data)
+
+  ignores version, time and visbility, only updates the data of
+  a single edge between both vertices, if there is any
+
+  return codes:
+  0 - success
+  1 - one of the vertices was not found
+  2 - transaction critical error
+ */
+int linkbench_update_edge( GDI_Label origin_label, uint64_t origin_ID, GDI_Label target_label, uint64_t target_ID, GDI_Label edge_label, GDI_PropertyType* ptypes, GDI_Transaction transaction, GDI_Database db );
+
+
+/**
+  runs one of the queries on the edges between two vertices, which is
+  selected by its index in the query mix (see linkbench_select_query):
+  6 - linkbench_get_edges_filtered_by_vertices
+  7 - linkbench_add_edge
+  8 - linkbench_delete_edge
+  9 - linkbench_update_edge
+
+  return codes are the ones of the selected query
+ */
+int linkbench_edge_query( uint8_t query_idx, GDI_Label origin_label, uint64_t origin_ID, GDI_Label target_label, uint64_t target_ID, GDI_Label edge_label, GDI_PropertyType* ptypes, GDI_Transaction transaction, GDI_Database db );
+
+
 int nod_bfs_sort_u32( GDI_Label vlabel, uint64_t start_vertex, GDI_Transaction transaction, uint8_t** depth, uint64_t** v_ids, size_t* elem_cnt );
 
 int nod_k_hop( GDI_Label vlabel, uint64_t start_vertex, GDI_Transaction transaction, uint8_t k, GDI_Vertex_uid** v_ids, size_t* elem_cnt );
@@ -209,7 +290,7 @@ int nod_k_hop( GDI_Label vlabel, uint64_t start_vertex, GDI_Transaction transact
     -2 - not enough memory
     -4 - transaction-critical error
  */
-int nod_cdlp_nonblocking_sorted( uint64_t global_num_verts, GDI_Transaction transaction, uint32_t max_num_iterations, uint64_t** labels, uint64_t** v_ids, size_t* elem_cnt );
+int nod_cdlp_nonblocking_sorted( GDI_Index vertex_index, GDI_Transaction transaction, uint32_t max_num_iterations, uint64_t** labels, uint64_t** v_ids, size_t* elem_cnt );
 
 
 /**
@@ -226,7 +307,7 @@ int nod_cdlp_nonblocking_sorted( uint64_t global_num_verts, GDI_Transaction tran
     -2 - not enough memory
     -4 - transaction-critical error
  */
-int nod_pagerank_nonblocking_sorted( uint64_t global_num_verts, GDI_Transaction transaction, uint32_t num_iterations, double damping_factor, double** scores, uint64_t** v_ids, size_t* elem_cnt );
+int nod_pagerank_nonblocking_sorted( GDI_Index vertex_index, GDI_Transaction transaction, uint32_t num_iterations, double damping_factor, double** scores, uint64_t** v_ids, size_t* elem_cnt );
 
 
 /**
@@ -243,7 +324,7 @@ int nod_pagerank_nonblocking_sorted( uint64_t global_num_verts, GDI_Transaction
     -2 - not enough memory
     -4 - transaction-critical error
  */
-int nod_wcc_pull_nonblocking_sorted( uint64_t global_num_verts, GDI_Transaction transaction, uint32_t max_num_iterations, uint64_t** components, uint64_t** v_ids, size_t* elem_cnt );
+int nod_wcc_pull_nonblocking_sorted( GDI_Index vertex_index, GDI_Transaction transaction, uint32_t max_num_iterations, uint64_t** components, uint64_t** v_ids, size_t* elem_cnt );
 
 
 /**
@@ -272,7 +353,7 @@ int nod_wcc_pull_nonblocking_sorted( uint64_t global_num_verts, GDI_Transaction
     -2 - not enough memory
     -4 - transaction-critical error
  */
-int nod_gnn_blocking_sorted( uint64_t global_num_verts, GDI_Transaction transaction, uint32_t num_layers, uint32_t num_features, double* weights, double* bias, double** y_pred, uint64_t** v_ids, size_t* elem_cnt );
+int nod_gnn_blocking_sorted( GDI_Index vertex_index, GDI_Transaction transaction, uint32_t num_layers, uint32_t num_features, double* weights, double* bias, double** y_pred, uint64_t** v_ids, size_t* elem_cnt );
 
 
 /**
@@ -291,7 +372,7 @@ int nod_gnn_blocking_sorted( uint64_t global_num_verts, GDI_Transaction transact
     -2 - not enough memory
     -4 - transaction-critical error
  */
-int nod_lcc( uint64_t global_num_verts, GDI_Transaction transaction, double** coefficients, uint64_t** v_ids, size_t* elem_cnt );
+int nod_lcc( GDI_Index vertex_index, GDI_Transaction transaction, double** coefficients, uint64_t** v_ids, size_t* elem_cnt );
 
 /**
   retrieve the resource vertices that are used by projects whose name
@@ -301,6 +382,12 @@ int nod_lcc( uint64_t global_num_verts, GDI_Transaction transaction, double** co
   letter should be in the range of 'a' to 'z' or 'A' to 'Z' and the same
   across all ranks.
 
+  resource_index is a bitmap index on the resource label and enumerates
+  the local resource vertices, project_index is a prefix index on the
+  name property type with the project label and returns the matching
+  projects, so that neither the other vertices nor the projects are
+  associated.
+
   return codes:
   2: argument letter is not a..z or A..Z
 
@@ -308,7 +395,7 @@ int nod_lcc( uint64_t global_num_verts, GDI_Transaction transaction, double** co
   -2: not enough memory
   -4: transaction critical error occured
  */
-int business_intelligence( GDI_Label* vlabels, GDI_Label* elabels, GDI_PropertyType* ptypes, uint64_t nglobal_verts,
+int business_intelligence( GDI_Label* elabels, GDI_PropertyType* ptypes, GDI_Index resource_index, GDI_Index project_index,
   GDI_Transaction transaction, GDI_Database db, MPI_Comm comm, size_t limit, char letter, char** res_name, size_t** v_count,
   size_t* elem_cnt );
 
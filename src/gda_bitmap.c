@@ -0,0 +1,113 @@
+// Copyright (c) 2023 ETH Zurich.
+//                    All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <assert.h>
+
+#include "gda_bitmap.h"
+#include "gda_yield.h"
+
+
+/**
+  each rank must submit same numbers
+ */
+void GDA_CreateRMABitmap( size_t num_bits_local, MPI_Comm comm, GDA_RMABitmap* bitmap ) {
+  GDA_RMABitmap internal_bitmap = malloc( sizeof(GDA_RMABitmap_desc_t) );
+  assert( internal_bitmap != NULL );
+
+  internal_bitmap->comm = comm;
+  MPI_Comm_rank( comm, &(internal_bitmap->comm_rank) );
+
+  internal_bitmap->num_bits_local = num_bits_local;
+  internal_bitmap->num_words_local = (num_bits_local + 63 /* round up */)/64;
+  if( internal_bitmap->num_words_local == 0 ) {
+    internal_bitmap->num_words_local = 1;
+  }
+
+  /**
+    displacement unit is a single word
+   */
+  RMA_Win_allocate( internal_bitmap->num_words_local * sizeof(uint64_t), sizeof(uint64_t), MPI_INFO_NULL, comm, &(internal_bitmap->words), &(internal_bitmap->win_words) );
+
+  RMA_Win_lock_all( 0 /* assert */, internal_bitmap->win_words );
+
+  for( size_t i=0 ; i<internal_bitmap->num_words_local ; i++ ) {
+    internal_bitmap->words[i] = 0;
+  }
+
+  *bitmap = internal_bitmap;
+}
+
+
+void GDA_FreeRMABitmap( GDA_RMABitmap* bitmap ) {
+  RMA_Win_unlock_all( (*bitmap)->win_words );
+  RMA_Win_free( &((*bitmap)->win_words) );
+
+  free( *bitmap );
+  *bitmap = NULL;
+}
+
+
+void GDA_SetBitInRMABitmap( uint64_t bit, uint64_t target_rank, GDA_RMABitmap bitmap ) {
+  assert( bit < bitmap->num_bits_local );
+
+  uint64_t mask = (uint64_t)1 << (bit % 64);
+  RMA_Accumulate( &mask, 1, MPI_UINT64_T, target_rank, bit / 64, 1, MPI_UINT64_T, RMA_BOR, bitmap->win_words );
+  GDA_Yield();
+  RMA_Win_flush( target_rank, bitmap->win_words );
+}
+
+
+void GDA_ClearBitInRMABitmap( uint64_t bit, uint64_t target_rank, GDA_RMABitmap bitmap ) {
+  assert( bit < bitmap->num_bits_local );
+
+  uint64_t mask = ~((uint64_t)1 << (bit % 64));
+  RMA_Accumulate( &mask, 1, MPI_UINT64_T, target_rank, bit / 64, 1, MPI_UINT64_T, RMA_BAND, bitmap->win_words );
+  GDA_Yield();
+  RMA_Win_flush( target_rank, bitmap->win_words );
+}
+
+
+/**
+  appends the positions (uint64_t) of all bits, that are set on the
+  local process, to bits in ascending order
+
+  the words are read with an atomic operation, so that concurrent
+  updates by other processes are either seen completely or not at all
+ */
+void GDA_CollectLocalBitsOfRMABitmap( GDA_Vector* bits, GDA_RMABitmap bitmap ) {
+  uint64_t* words = malloc( bitmap->num_words_local * sizeof(uint64_t) );
+  assert( words != NULL );
+
+  RMA_Get_accumulate( NULL, 0, MPI_UINT64_T, words, bitmap->num_words_local, MPI_UINT64_T, bitmap->comm_rank, 0, bitmap->num_words_local, MPI_UINT64_T, RMA_NO_OP, bitmap->win_words );
+  RMA_Win_flush_local( bitmap->comm_rank, bitmap->win_words );
+
+  for( size_t i=0 ; i<bitmap->num_words_local ; i++ ) {
+    uint64_t word = words[i];
+    uint64_t position = i * 64;
+    /**
+      skip the empty parts of the word, so that the loop is bound by
+      the number of set bits
+     */
+    while( word != 0 ) {
+      if( (word & 0xFFFFFFFF) == 0 ) {
+        word >>= 32;
+        position += 32;
+      }
+      if( (word & 0xFF) == 0 ) {
+        word >>= 8;
+        position += 8;
+        continue;
+      }
+      if( word & 1 ) {
+        GDA_vector_push_back( bits, &position );
+      }
+      word >>= 1;
+      position++;
+    }
+  }
+
+  free( words );
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2023 ETH Zurich.
+//                    All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef __GDA_BITMAP_H
+#define __GDA_BITMAP_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "gda_vector.h"
+#include "rma.h"
+
+/**
+  distributed bitmap
+
+  Every process holds the same number of bits. The bitmap is used with
+  one bit per block of the block window, so that the bits, that are set
+  on a process, identify the vertices, whose primary blocks are stored
+  on that process.
+
+  Bits are set and cleared with atomic operations, so that different
+  processes can update bits in the same word concurrently.
+ */
+
+
+/**
+  data type definitions
+ */
+
+typedef struct GDA_RMABitmap_desc {
+  /**
+    communicator over which the bitmap should span
+   */
+  MPI_Comm comm;
+  /**
+    leave this as int since it is also used as input for MPI calls
+   */
+  int comm_rank;
+
+  RMA_Win win_words;
+  /**
+    basepointer
+   */
+  uint64_t* words;
+
+  size_t num_bits_local;
+  size_t num_words_local;
+} GDA_RMABitmap_desc_t;
+
+typedef GDA_RMABitmap_desc_t* GDA_RMABitmap;
+
+
+/**
+  function prototypes
+ */
+
+void GDA_CreateRMABitmap( size_t num_bits_local, MPI_Comm comm, GDA_RMABitmap* bitmap );
+void GDA_FreeRMABitmap( GDA_RMABitmap* bitmap );
+void GDA_SetBitInRMABitmap( uint64_t bit, uint64_t target_rank, GDA_RMABitmap bitmap );
+void GDA_ClearBitInRMABitmap( uint64_t bit, uint64_t target_rank, GDA_RMABitmap bitmap );
+void GDA_CollectLocalBitsOfRMABitmap( GDA_Vector* bits, GDA_RMABitmap bitmap );
+
+#endif // #ifndef __GDA_BITMAP_H
@@ -0,0 +1,180 @@
+// Copyright (c) 2023 ETH Zurich.
+//                    All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <assert.h>
+
+#include "gda_bloom_filter.h"
+#include "gda_yield.h"
+
+
+static inline uint64_t BloomMix( uint64_t h ) {
+  /**
+    finalizer of splitmix64
+   */
+  h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+  return h ^ (h >> 31);
+}
+
+
+/**
+  calculates the block of a key on the given process and the counter of
+  each probe within it
+
+  the block is derived from the hashed key, the probes from the key
+  itself, so that keys, which collide in the hashed key, are still
+  distinguished
+ */
+static inline void LocateKey( uint64_t rank, uint64_t hashed_key, uint64_t key, uint64_t* b_offset, unsigned* probes, GDA_RMABloomFilter filter ) {
+  assert( rank < filter->comm_size );
+  *b_offset = BloomMix( hashed_key ) % filter->num_blocks_local;
+
+  uint64_t h = BloomMix( key ^ (hashed_key * 0x9E3779B97F4A7C15ULL) );
+  for( int i=0 ; i<GDA_BLOOM_NUM_PROBES ; i++ ) {
+    probes[i] = h % GDA_BLOOM_BLOCK_COUNTERS;
+    h /= GDA_BLOOM_BLOCK_COUNTERS;
+  }
+}
+
+
+static inline bool CheckBlock( const GDA_RMABloomFilter_Block* block, const unsigned* probes ) {
+  for( int i=0 ; i<GDA_BLOOM_NUM_PROBES ; i++ ) {
+    if( block->counters[probes[i]] == 0 ) {
+      return false;
+    }
+  }
+  return true;
+}
+
+
+/**
+  adds delta (modulo 2^16) to all counters of a key
+ */
+static void UpdateCounters( uint64_t rank, uint64_t hashed_key, uint64_t key, uint16_t delta, GDA_RMABloomFilter filter ) {
+  uint64_t b_offset;
+  unsigned probes[GDA_BLOOM_NUM_PROBES];
+  LocateKey( rank, hashed_key, key, &b_offset, probes, filter );
+
+  for( int i=0 ; i<GDA_BLOOM_NUM_PROBES ; i++ ) {
+    RMA_Accumulate( &delta, 1, MPI_UINT16_T, rank, b_offset * GDA_BLOOM_BLOCK_COUNTERS + probes[i], 1, MPI_UINT16_T, RMA_SUM, filter->win_blocks );
+  }
+  RMA_Win_flush( rank, filter->win_blocks );
+}
+
+
+/**
+  each rank must submit same numbers
+ */
+void GDA_CreateRMABloomFilter( size_t num_blocks, MPI_Comm comm, GDA_RMABloomFilter* filter ) {
+  GDA_RMABloomFilter internal_filter = malloc( sizeof(GDA_RMABloomFilter_desc_t) );
+  assert( internal_filter != NULL );
+
+  internal_filter->comm = comm;
+  int temp;
+  MPI_Comm_size( comm, &temp );
+  /**
+    extra step to avoid compiler warnings comparing unsigned types with a signed type
+   */
+  internal_filter->comm_size = temp;
+  MPI_Comm_rank( comm, &(internal_filter->comm_rank) );
+
+  internal_filter->num_blocks_local = (num_blocks + internal_filter->comm_size - 1)/internal_filter->comm_size;
+  if( internal_filter->num_blocks_local == 0 ) {
+    internal_filter->num_blocks_local = 1;
+  }
+  internal_filter->num_blocks_total = internal_filter->num_blocks_local * internal_filter->comm_size;
+
+  /**
+    displacement unit is a single counter
+   */
+  RMA_Win_allocate( internal_filter->num_blocks_local * sizeof(GDA_RMABloomFilter_Block), sizeof(uint16_t), MPI_INFO_NULL, comm, &(internal_filter->blocks), &(internal_filter->win_blocks) );
+
+  RMA_Win_lock_all( 0 /* assert */, internal_filter->win_blocks );
+
+  for( size_t i=0 ; i<internal_filter->num_blocks_local ; i++ ) {
+    for( int j=0 ; j<GDA_BLOOM_BLOCK_COUNTERS ; j++ ) {
+      internal_filter->blocks[i].counters[j] = 0;
+    }
+  }
+
+  *filter = internal_filter;
+}
+
+
+void GDA_FreeRMABloomFilter( GDA_RMABloomFilter* filter ) {
+  RMA_Win_unlock_all( (*filter)->win_blocks );
+  RMA_Win_free( &((*filter)->win_blocks) );
+
+  free( *filter );
+  *filter = NULL;
+}
+
+
+/**
+  has to be called before the key is inserted into the index
+ */
+void GDA_AddToRMABloomFilter( uint64_t rank, uint64_t hashed_key, uint64_t key, GDA_RMABloomFilter filter ) {
+  UpdateCounters( rank, hashed_key, key, 1, filter );
+}
+
+
+/**
+  has to be called after the key was removed from the index
+ */
+void GDA_RemoveFromRMABloomFilter( uint64_t rank, uint64_t hashed_key, uint64_t key, GDA_RMABloomFilter filter ) {
+  /**
+    adding 0xFFFF decrements the counters modulo 2^16
+   */
+  UpdateCounters( rank, hashed_key, key, UINT16_MAX, filter );
+}
+
+
+/**
+  returns false, if the key is definitely not in the index
+ */
+bool GDA_QueryRMABloomFilter( uint64_t rank, uint64_t hashed_key, uint64_t key, GDA_RMABloomFilter filter ) {
+  uint64_t b_offset;
+  unsigned probes[GDA_BLOOM_NUM_PROBES];
+  LocateKey( rank, hashed_key, key, &b_offset, probes, filter );
+
+  GDA_RMABloomFilter_Block block;
+  RMA_Get( &block, GDA_BLOOM_BLOCK_COUNTERS, MPI_UINT16_T, rank, b_offset * GDA_BLOOM_BLOCK_COUNTERS, GDA_BLOOM_BLOCK_COUNTERS, MPI_UINT16_T, filter->win_blocks );
+  GDA_Yield();
+  RMA_Win_flush_local( rank, filter->win_blocks );
+
+  return CheckBlock( &block, probes );
+}
+
+
+/**
+  batched version of GDA_QueryRMABloomFilter: the blocks of all keys are
+  fetched at once
+ */
+void GDA_QueryManyRMABloomFilter( size_t count, const uint64_t* ranks, const uint64_t* hashed_keys, const uint64_t* keys, bool* maybe_flags, GDA_RMABloomFilter filter ) {
+  if( count == 0 ) {
+    return;
+  }
+
+  GDA_RMABloomFilter_Block* blocks = malloc( count * sizeof(GDA_RMABloomFilter_Block) );
+  assert( blocks != NULL );
+  unsigned* probes = malloc( count * GDA_BLOOM_NUM_PROBES * sizeof(unsigned) );
+  assert( probes != NULL );
+
+  for( size_t i=0 ; i<count ; i++ ) {
+    uint64_t b_offset;
+    LocateKey( ranks[i], hashed_keys[i], keys[i], &b_offset, &(probes[i * GDA_BLOOM_NUM_PROBES]), filter );
+    RMA_Get( &(blocks[i]), GDA_BLOOM_BLOCK_COUNTERS, MPI_UINT16_T, ranks[i], b_offset * GDA_BLOOM_BLOCK_COUNTERS, GDA_BLOOM_BLOCK_COUNTERS, MPI_UINT16_T, filter->win_blocks );
+  }
+  GDA_Yield();
+  RMA_Win_flush_local_all( filter->win_blocks );
+
+  for( size_t i=0 ; i<count ; i++ ) {
+    maybe_flags[i] = CheckBlock( &(blocks[i]), &(probes[i * GDA_BLOOM_NUM_PROBES]) );
+  }
+
+  free( probes );
+  free( blocks );
+}
@@ -0,0 +1,86 @@
+// Copyright (c) 2023 ETH Zurich.
+//                    All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef __GDA_BLOOM_FILTER_H
+#define __GDA_BLOOM_FILTER_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "rma.h"
+
+/**
+  distributed counting Bloom filter
+
+  The filter is split into blocks of 64 bytes (32 counters of 16 bits),
+  which are distributed over all processes. All probes of a key fall into
+  the same block, so a query only needs a single RMA get. Counters
+  instead of bits allow to remove keys again.
+
+  The caller passes the process, that holds the block of a key. The
+  internal index passes the owner of the table slot of the key, so that
+  the filter query targets the same process as the following lookup and
+  the filter is loaded exactly like the index. The block on that process
+  is selected by the hashed key.
+
+  The filter never reports a false negative as long as each key is added
+  before it becomes visible elsewhere, and removed after it was taken out.
+ */
+
+
+/**
+  constant definitions
+ */
+
+#define GDA_BLOOM_BLOCK_COUNTERS  32
+#define GDA_BLOOM_NUM_PROBES       4
+
+
+/**
+  data type definitions
+ */
+
+typedef struct GDA_RMABloomFilter_Block_desc {
+  uint16_t counters[GDA_BLOOM_BLOCK_COUNTERS];
+} GDA_RMABloomFilter_Block;
+
+typedef struct GDA_RMABloomFilter_desc {
+  /**
+    communicator over which the filter should span
+   */
+  MPI_Comm comm;
+  size_t comm_size;
+  /**
+    leave this as int since it is also used as input for MPI calls
+   */
+  int comm_rank;
+
+  RMA_Win win_blocks;
+  /**
+    basepointer
+   */
+  GDA_RMABloomFilter_Block* blocks;
+
+  size_t num_blocks_total;
+  size_t num_blocks_local;
+} GDA_RMABloomFilter_desc_t;
+
+typedef GDA_RMABloomFilter_desc_t* GDA_RMABloomFilter;
+
+
+/**
+  function prototypes
+ */
+
+void GDA_CreateRMABloomFilter( size_t num_blocks, MPI_Comm comm, GDA_RMABloomFilter* filter );
+void GDA_FreeRMABloomFilter( GDA_RMABloomFilter* filter );
+void GDA_AddToRMABloomFilter( uint64_t rank, uint64_t hashed_key, uint64_t key, GDA_RMABloomFilter filter );
+void GDA_RemoveFromRMABloomFilter( uint64_t rank, uint64_t hashed_key, uint64_t key, GDA_RMABloomFilter filter );
+bool GDA_QueryRMABloomFilter( uint64_t rank, uint64_t hashed_key, uint64_t key, GDA_RMABloomFilter filter );
+void GDA_QueryManyRMABloomFilter( size_t count, const uint64_t* ranks, const uint64_t* hashed_keys, const uint64_t* keys, bool* maybe_flags, GDA_RMABloomFilter filter );
+
+#endif // #ifndef __GDA_BLOOM_FILTER_H
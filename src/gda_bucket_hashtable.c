@@ -0,0 +1,504 @@
+// Copyright (c) 2023 ETH Zurich.
+//                    All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <assert.h>
+#include <stdio.h>
+
+#include "gda_bucket_hashtable.h"
+#include "gda_yield.h"
+
+/**
+  return values of MatchInBucket (otherwise the slot number is returned)
+ */
+#define GDA_BUCKET_NO_MATCH   -1
+#define GDA_BUCKET_TORN       -2
+
+/**
+  state of a single lookup in GDA_FindElementsInRMABucketHashMap
+ */
+#define GDA_BUCKET_LOOKUP_ACTIVE    0
+#define GDA_BUCKET_LOOKUP_DONE      1
+#define GDA_BUCKET_LOOKUP_OVERFLOW  2
+
+
+static inline uint32_t BucketChecksum( uint64_t key, uint64_t value, uint32_t incarnation ) {
+  /**
+    mixing steps of splitmix64
+   */
+  uint64_t h = key ^ (value * 0x9E3779B97F4A7C15ULL) ^ ((uint64_t) incarnation << 17);
+  h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+  h = h ^ (h >> 31);
+  return (uint32_t)(h >> (64 - GDA_BUCKET_CHECKSUM_BITS));
+}
+
+
+static inline uint32_t StoredChecksum( uint32_t control, int slot ) {
+  return (control >> (slot * GDA_BUCKET_CHECKSUM_BITS)) & GDA_BUCKET_CHECKSUM_MASK;
+}
+
+
+/**
+  displacement of a field of a bucket in the window (in 32-bit units)
+ */
+static inline uint64_t BucketDisp( uint64_t b_offset, uint64_t field ) {
+  return b_offset * GDA_BUCKET_UNITS + field;
+}
+
+
+/**
+  calculates the home bucket of a key
+ */
+static inline void LocateBucket( uint64_t hashed_key, uint64_t* b_rank, uint64_t* b_offset, GDA_RMABucketHashMap hashmap ) {
+  uint64_t hash = hashed_key % hashmap->num_buckets_total;
+  *b_rank = hash / hashmap->num_buckets_local;
+  *b_offset = hash % hashmap->num_buckets_local;
+}
+
+
+static inline void FetchBucket( GDA_RMABucketHashMap_Bucket* bucket, uint64_t b_rank, uint64_t b_offset, GDA_RMABucketHashMap hashmap ) {
+  // TODO: change to MPI_UINT64_T
+  RMA_Get( bucket, sizeof(GDA_RMABucketHashMap_Bucket)/sizeof(uint64_t), MPI_INT64_T, b_rank, BucketDisp( b_offset, 0 ), sizeof(GDA_RMABucketHashMap_Bucket)/sizeof(uint64_t), MPI_INT64_T, hashmap->win_buckets );
+  GDA_Yield();
+  RMA_Win_flush_local( b_rank, hashmap->win_buckets );
+}
+
+
+/**
+  returns the slot, that holds the key, or GDA_BUCKET_NO_MATCH, without
+  looking at the checksum
+ */
+static inline int FindKeyInBucket( const GDA_RMABucketHashMap_Bucket* bucket, uint64_t key ) {
+  for( int i=0 ; i<GDA_BUCKET_ENTRIES ; i++ ) {
+    if( bucket->keys[i] == key ) {
+      return i;
+    }
+  }
+  return GDA_BUCKET_NO_MATCH;
+}
+
+
+/**
+  returns the slot, that holds the key, GDA_BUCKET_NO_MATCH, or
+  GDA_BUCKET_TORN, if the entry with the matching key failed the
+  checksum test
+ */
+static inline int MatchInBucket( const GDA_RMABucketHashMap_Bucket* bucket, uint64_t key ) {
+  int slot = FindKeyInBucket( bucket, key );
+  if( slot != GDA_BUCKET_NO_MATCH ) {
+    if( BucketChecksum( key, bucket->values[slot], bucket->incarnations[slot] ) != StoredChecksum( bucket->control, slot ) ) {
+      return GDA_BUCKET_TORN;
+    }
+  }
+  return slot;
+}
+
+
+/**
+  sets the bits of the control word of a bucket, that are selected by
+  mask, to bits
+ */
+static void UpdateControl( uint32_t control, uint32_t mask, uint32_t bits, uint64_t b_rank, uint64_t b_offset, GDA_RMABucketHashMap hashmap ) {
+  while( true ) {
+    uint32_t new_control = (control & ~mask) | bits;
+    if( new_control == control ) {
+      return;
+    }
+
+    uint32_t swap_result;
+    RMA_Compare_and_swap( &new_control, &control, &swap_result, MPI_UINT32_T, b_rank, BucketDisp( b_offset, GDA_BUCKET_CONTROL ), hashmap->win_buckets );
+    RMA_Win_flush( b_rank, hashmap->win_buckets );
+
+    if( swap_result == control ) {
+      return;
+    }
+    control = swap_result;
+  }
+}
+
+
+/**
+  fallback for an entry, that failed the checksum test
+  GDA_BUCKET_MAX_RETRIES times in a row: value and incarnation are read
+  with atomic operations, framed by two atomic reads of the key, so they
+  belong to the same entry, unless the key was removed and inserted into
+  the same slot again in the meantime
+
+  returns false, if the slot does not hold the key anymore
+ */
+static bool ReadEntryAtomically( uint64_t key, int slot, uint64_t* value, uint64_t* incarnation, uint64_t b_rank, uint64_t b_offset, GDA_RMABucketHashMap hashmap ) {
+  uint64_t keys[2];
+  uint32_t inc;
+
+  RMA_Fetch_and_op( NULL, &keys[0], MPI_UINT64_T, b_rank, BucketDisp( b_offset, GDA_BUCKET_KEYS + 2 * slot ), RMA_NO_OP, hashmap->win_buckets );
+  RMA_Win_flush( b_rank, hashmap->win_buckets );
+  RMA_Fetch_and_op( NULL, value, MPI_UINT64_T, b_rank, BucketDisp( b_offset, GDA_BUCKET_VALUES + 2 * slot ), RMA_NO_OP, hashmap->win_buckets );
+  RMA_Fetch_and_op( NULL, &inc, MPI_UINT32_T, b_rank, BucketDisp( b_offset, GDA_BUCKET_INCARNATIONS + slot ), RMA_NO_OP, hashmap->win_buckets );
+  RMA_Win_flush( b_rank, hashmap->win_buckets );
+  RMA_Fetch_and_op( NULL, &keys[1], MPI_UINT64_T, b_rank, BucketDisp( b_offset, GDA_BUCKET_KEYS + 2 * slot ), RMA_NO_OP, hashmap->win_buckets );
+  RMA_Win_flush( b_rank, hashmap->win_buckets );
+
+  *incarnation = inc;
+  return (keys[0] == key) && (keys[1] == key);
+}
+
+
+/**
+  each rank must submit same numbers
+ */
+void GDA_CreateRMABucketHashMap( size_t num_buckets, MPI_Comm comm, GDA_RMABucketHashMap* hashmap ) {
+  assert( sizeof(GDA_RMABucketHashMap_Bucket) == GDA_BUCKET_UNITS * sizeof(uint32_t) );
+
+  GDA_RMABucketHashMap internal_hashmap = malloc( sizeof(GDA_RMABucketHashMap_desc_t) );
+  assert( internal_hashmap != NULL );
+
+  internal_hashmap->comm = comm;
+  int temp;
+  MPI_Comm_size( comm, &temp );
+  /**
+    extra step to avoid compiler warnings comparing unsigned types with a signed type
+   */
+  internal_hashmap->comm_size = temp;
+  MPI_Comm_rank( comm, &(internal_hashmap->comm_rank) );
+
+  internal_hashmap->num_buckets_local = (num_buckets + internal_hashmap->comm_size - 1)/internal_hashmap->comm_size;
+  if( internal_hashmap->num_buckets_local == 0 ) {
+    internal_hashmap->num_buckets_local = 1;
+  }
+  internal_hashmap->num_buckets_total = internal_hashmap->num_buckets_local * internal_hashmap->comm_size;
+
+  RMA_Win_allocate( internal_hashmap->num_buckets_local * sizeof(GDA_RMABucketHashMap_Bucket), sizeof(uint32_t), MPI_INFO_NULL, comm, &(internal_hashmap->buckets), &(internal_hashmap->win_buckets) );
+
+  RMA_Win_lock_all( 0 /* assert */, internal_hashmap->win_buckets );
+
+  for( size_t i=0 ; i<internal_hashmap->num_buckets_local ; i++ ) {
+    for( int j=0 ; j<GDA_BUCKET_ENTRIES ; j++ ) {
+      internal_hashmap->buckets[i].keys[j] = GDA_BUCKET_EMPTY;
+      internal_hashmap->buckets[i].values[j] = GDA_DPOINTER_NULL;
+      internal_hashmap->buckets[i].incarnations[j] = 0;
+    }
+    internal_hashmap->buckets[i].control = 0;
+  }
+
+  /**
+    the overflow table starts small, since it grows on its own
+   */
+  GDA_CreateRMAHashMap( num_buckets/16 /* table size */, num_buckets/16 /* heap size */, comm, &(internal_hashmap->overflow) );
+
+  *hashmap = internal_hashmap;
+}
+
+
+void GDA_FreeRMABucketHashMap( GDA_RMABucketHashMap* hashmap ) {
+  GDA_FreeRMAHashMap( &((*hashmap)->overflow) );
+
+  RMA_Win_unlock_all( (*hashmap)->win_buckets );
+  RMA_Win_free( &((*hashmap)->win_buckets) );
+
+  free( *hashmap );
+  *hashmap = NULL;
+}
+
+
+/**
+  may cause double inserts if insert same key again
+ */
+void GDA_InsertElementIntoRMABucketHashMap( uint64_t hashed_key, uint64_t key, uint64_t value, uint64_t incarnation, GDA_RMABucketHashMap hashmap ) {
+  assert( (key != GDA_BUCKET_EMPTY) && (key != GDA_BUCKET_TOMBSTONE) && (key != GDA_BUCKET_RESERVED) );
+
+  uint64_t b_rank;
+  uint64_t b_offset;
+  LocateBucket( hashed_key, &b_rank, &b_offset, hashmap );
+
+  GDA_RMABucketHashMap_Bucket bucket;
+  FetchBucket( &bucket, b_rank, b_offset, hashmap );
+
+  for( int i=0 ; i<GDA_BUCKET_ENTRIES ; i++ ) {
+    uint64_t old_key = bucket.keys[i];
+    if( (old_key != GDA_BUCKET_EMPTY) && (old_key != GDA_BUCKET_TOMBSTONE) ) {
+      continue;
+    }
+
+    /**
+      try to claim the slot
+     */
+    uint64_t reserved = GDA_BUCKET_RESERVED;
+    uint64_t swap_result;
+    RMA_Compare_and_swap( &reserved, &old_key, &swap_result, MPI_UINT64_T, b_rank, BucketDisp( b_offset, GDA_BUCKET_KEYS + 2 * i ), hashmap->win_buckets );
+    RMA_Win_flush( b_rank, hashmap->win_buckets );
+
+    if( swap_result != old_key ) {
+      /**
+        another process was faster, try the next slot
+       */
+      continue;
+    }
+
+    /**
+      fill in value, incarnation and checksum, before the key is published
+     */
+    uint32_t inc = incarnation & 0x00000000FFFFFFFF;
+    // TODO: change to MPI_UINT64_T
+    RMA_Put( &value, 1, MPI_INT64_T, b_rank, BucketDisp( b_offset, GDA_BUCKET_VALUES + 2 * i ), 1, MPI_INT64_T, hashmap->win_buckets );
+    RMA_Put( &inc, 1, MPI_UINT32_T, b_rank, BucketDisp( b_offset, GDA_BUCKET_INCARNATIONS + i ), 1, MPI_UINT32_T, hashmap->win_buckets );
+    UpdateControl( bucket.control, GDA_BUCKET_CHECKSUM_MASK << (i * GDA_BUCKET_CHECKSUM_BITS), BucketChecksum( key, value, inc ) << (i * GDA_BUCKET_CHECKSUM_BITS), b_rank, b_offset, hashmap );
+    RMA_Win_flush( b_rank, hashmap->win_buckets );
+
+    RMA_Compare_and_swap( &key, &reserved, &swap_result, MPI_UINT64_T, b_rank, BucketDisp( b_offset, GDA_BUCKET_KEYS + 2 * i ), hashmap->win_buckets );
+    RMA_Win_flush( b_rank, hashmap->win_buckets );
+    assert( swap_result == GDA_BUCKET_RESERVED );
+    return;
+  }
+
+  /**
+    bucket is full: mark it, so that lookups continue in the overflow
+    table, and insert the key there
+   */
+  UpdateControl( bucket.control, GDA_BUCKET_OVERFLOW, GDA_BUCKET_OVERFLOW, b_rank, b_offset, hashmap );
+  GDA_InsertElementIntoRMAHashMap( hashed_key, key, value, incarnation, hashmap->overflow );
+}
+
+
+void GDA_FindElementInRMABucketHashMap( uint64_t hashed_key, uint64_t key, uint64_t* value, uint64_t* incarnation, bool* found_flag, GDA_RMABucketHashMap hashmap ) {
+  uint64_t b_rank;
+  uint64_t b_offset;
+  LocateBucket( hashed_key, &b_rank, &b_offset, hashmap );
+
+  GDA_RMABucketHashMap_Bucket bucket;
+  int slot;
+
+  size_t retries = 0;
+  do {
+    FetchBucket( &bucket, b_rank, b_offset, hashmap );
+    slot = MatchInBucket( &bucket, key );
+    /**
+      fetch the bucket again in case of a concurrent update of the entry
+     */
+  } while( (slot == GDA_BUCKET_TORN) && (++retries < GDA_BUCKET_MAX_RETRIES) );
+
+  if( slot == GDA_BUCKET_TORN ) {
+    if( ReadEntryAtomically( key, FindKeyInBucket( &bucket, key ), value, incarnation, b_rank, b_offset, hashmap ) ) {
+      *found_flag = true;
+      return;
+    }
+    slot = GDA_BUCKET_NO_MATCH;
+  }
+
+  if( slot != GDA_BUCKET_NO_MATCH ) {
+    *found_flag = true;
+    *value = bucket.values[slot];
+    *incarnation = bucket.incarnations[slot];
+    return;
+  }
+
+  if( bucket.control & GDA_BUCKET_OVERFLOW ) {
+    GDA_FindElementInRMAHashMap( hashed_key, key, value, incarnation, found_flag, hashmap->overflow );
+    return;
+  }
+
+  *found_flag = false;
+  *value = GDA_DPOINTER_NULL;
+}
+
+
+/**
+  batched version of GDA_FindElementInRMABucketHashMap
+
+  same approach as GDA_FindElementsInRMAHashMap: in every round the home
+  bucket of all unresolved keys is fetched, before the process waits for
+  the completion of those operations. The keys, whose home buckets
+  overflowed, are looked up in the overflow table at the end.
+ */
+void GDA_FindElementsInRMABucketHashMap( size_t count, const uint64_t* hashed_keys, const uint64_t* keys, uint64_t* values, uint64_t* incarnations, bool* found_flags, GDA_RMABucketHashMap hashmap ) {
+  if( count == 0 ) {
+    return;
+  }
+
+  uint8_t* state = malloc( count * sizeof(uint8_t) );
+  assert( state != NULL );
+  uint64_t* b_ranks = malloc( count * sizeof(uint64_t) );
+  assert( b_ranks != NULL );
+  uint64_t* b_offsets = malloc( count * sizeof(uint64_t) );
+  assert( b_offsets != NULL );
+  size_t* retries = malloc( count * sizeof(size_t) );
+  assert( retries != NULL );
+  GDA_RMABucketHashMap_Bucket* buckets = malloc( count * sizeof(GDA_RMABucketHashMap_Bucket) );
+  assert( buckets != NULL );
+
+  for( size_t i=0 ; i<count ; i++ ) {
+    state[i] = GDA_BUCKET_LOOKUP_ACTIVE;
+    retries[i] = 0;
+    found_flags[i] = false;
+    values[i] = GDA_DPOINTER_NULL;
+    LocateBucket( hashed_keys[i], &(b_ranks[i]), &(b_offsets[i]), hashmap );
+  }
+
+  size_t active = count;
+  size_t num_overflows = 0;
+  while( active > 0 ) {
+    for( size_t i=0 ; i<count ; i++ ) {
+      if( state[i] == GDA_BUCKET_LOOKUP_ACTIVE ) {
+        // TODO: change to MPI_UINT64_T
+        RMA_Get( &(buckets[i]), sizeof(GDA_RMABucketHashMap_Bucket)/sizeof(uint64_t), MPI_INT64_T, b_ranks[i], BucketDisp( b_offsets[i], 0 ), sizeof(GDA_RMABucketHashMap_Bucket)/sizeof(uint64_t), MPI_INT64_T, hashmap->win_buckets );
+      }
+    }
+    GDA_Yield();
+    RMA_Win_flush_local_all( hashmap->win_buckets );
+
+    for( size_t i=0 ; i<count ; i++ ) {
+      if( state[i] != GDA_BUCKET_LOOKUP_ACTIVE ) {
+        continue;
+      }
+
+      int slot = MatchInBucket( &(buckets[i]), keys[i] );
+
+      if( slot == GDA_BUCKET_TORN ) {
+        if( ++(retries[i]) < GDA_BUCKET_MAX_RETRIES ) {
+          /**
+            fetch the same bucket again in the next round
+           */
+          continue;
+        }
+
+        if( ReadEntryAtomically( keys[i], FindKeyInBucket( &(buckets[i]), keys[i] ), &(values[i]), &(incarnations[i]), b_ranks[i], b_offsets[i], hashmap ) ) {
+          found_flags[i] = true;
+          state[i] = GDA_BUCKET_LOOKUP_DONE;
+          active--;
+          continue;
+        }
+        values[i] = GDA_DPOINTER_NULL;
+        slot = GDA_BUCKET_NO_MATCH;
+      }
+
+      if( slot != GDA_BUCKET_NO_MATCH ) {
+        found_flags[i] = true;
+        values[i] = buckets[i].values[slot];
+        incarnations[i] = buckets[i].incarnations[slot];
+        state[i] = GDA_BUCKET_LOOKUP_DONE;
+      } else {
+        if( buckets[i].control & GDA_BUCKET_OVERFLOW ) {
+          state[i] = GDA_BUCKET_LOOKUP_OVERFLOW;
+          num_overflows++;
+        } else {
+          state[i] = GDA_BUCKET_LOOKUP_DONE;
+        }
+      }
+      active--;
+    }
+  }
+
+  if( num_overflows > 0 ) {
+    size_t* positions = malloc( num_overflows * sizeof(size_t) );
+    assert( positions != NULL );
+    uint64_t* o_hashed_keys = malloc( num_overflows * sizeof(uint64_t) );
+    assert( o_hashed_keys != NULL );
+    uint64_t* o_keys = malloc( num_overflows * sizeof(uint64_t) );
+    assert( o_keys != NULL );
+    uint64_t* o_values = malloc( num_overflows * sizeof(uint64_t) );
+    assert( o_values != NULL );
+    uint64_t* o_incarnations = malloc( num_overflows * sizeof(uint64_t) );
+    assert( o_incarnations != NULL );
+    bool* o_found_flags = malloc( num_overflows * sizeof(bool) );
+    assert( o_found_flags != NULL );
+
+    size_t pos = 0;
+    for( size_t i=0 ; i<count ; i++ ) {
+      if( state[i] == GDA_BUCKET_LOOKUP_OVERFLOW ) {
+        positions[pos] = i;
+        o_hashed_keys[pos] = hashed_keys[i];
+        o_keys[pos] = keys[i];
+        pos++;
+      }
+    }
+
+    GDA_FindElementsInRMAHashMap( num_overflows, o_hashed_keys, o_keys, o_values, o_incarnations, o_found_flags, hashmap->overflow );
+
+    for( size_t i=0 ; i<num_overflows ; i++ ) {
+      found_flags[positions[i]] = o_found_flags[i];
+      values[positions[i]] = o_values[i];
+      incarnations[positions[i]] = o_incarnations[i];
+    }
+
+    free( o_found_flags );
+    free( o_incarnations );
+    free( o_values );
+    free( o_keys );
+    free( o_hashed_keys );
+    free( positions );
+  }
+
+  free( buckets );
+  free( retries );
+  free( b_offsets );
+  free( b_ranks );
+  free( state );
+}
+
+
+bool GDA_RemoveElementFromRMABucketHashMap( uint64_t hashed_key, uint64_t key, GDA_RMABucketHashMap hashmap ) {
+  uint64_t b_rank;
+  uint64_t b_offset;
+  LocateBucket( hashed_key, &b_rank, &b_offset, hashmap );
+
+  GDA_RMABucketHashMap_Bucket bucket;
+
+  for( size_t retries=0 ; retries<GDA_BUCKET_MAX_RETRIES ; retries++ ) {
+    FetchBucket( &bucket, b_rank, b_offset, hashmap );
+
+    /**
+      the removal only depends on the key, so a torn entry doesn't matter
+     */
+    int slot = FindKeyInBucket( &bucket, key );
+
+    if( slot == GDA_BUCKET_NO_MATCH ) {
+      break;
+    }
+
+    /**
+      mark the slot as deleted, the overflow flag is left untouched,
+      since other keys might depend on it
+     */
+    uint64_t tombstone = GDA_BUCKET_TOMBSTONE;
+    uint64_t swap_result;
+    RMA_Compare_and_swap( &tombstone, &key, &swap_result, MPI_UINT64_T, b_rank, BucketDisp( b_offset, GDA_BUCKET_KEYS + 2 * slot ), hashmap->win_buckets );
+    RMA_Win_flush( b_rank, hashmap->win_buckets );
+
+    if( swap_result == key ) {
+      return true;
+    }
+
+    /**
+      slot changed in the meantime -> look at the bucket again
+     */
+  }
+
+  if( bucket.control & GDA_BUCKET_OVERFLOW ) {
+    return GDA_RemoveElementFromRMAHashMap( hashed_key, key, hashmap->overflow );
+  }
+
+  return false;
+}
+
+
+/**
+  collective call, see GDA_MaintainRMAHashMap
+ */
+void GDA_MaintainRMABucketHashMap( GDA_RMABucketHashMap hashmap ) {
+  GDA_MaintainRMAHashMap( hashmap->overflow );
+}
+
+
+/**
+  returns the process, that holds the home bucket of a key
+
+  local call
+ */
+uint64_t GDA_RankOfKeyInRMABucketHashMap( uint64_t hashed_key, GDA_RMABucketHashMap hashmap ) {
+  uint64_t b_rank;
+  uint64_t b_offset;
+  LocateBucket( hashed_key, &b_rank, &b_offset, hashmap );
+  return b_rank;
+}
@@ -0,0 +1,143 @@
+// Copyright (c) 2023 ETH Zurich.
+//                    All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef __GDA_BUCKET_HASHTABLE_H
+#define __GDA_BUCKET_HASHTABLE_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "gda_distributed_hashtable.h"
+#include "gda_dpointer.h"
+#include "rma.h"
+
+/**
+  This header provides an alternative implementation of the distributed
+  hashtable, that is used for the internal index. Instead of a table of
+  DPointers into a heap of chained elements, the table consists of
+  buckets, that have the size of a cache line (64 Bytes) and hold the
+  entries inline:
+
+   --------------------------------------------------------------------
+  | key 0 | key 1 | key 2 | value 0 | value 1 | value 2 | inc 0-2 | ctl |
+   --------------------------------------------------------------------
+
+  The incarnations take 32 bits each. The control word ctl holds a
+  checksum of GDA_BUCKET_CHECKSUM_BITS bits over key, value and
+  incarnation for each entry and the overflow flag in the highest bit.
+
+  A key goes into its home bucket, if a slot is free. Otherwise the
+  overflow flag is set, and the key is inserted into a chained hashtable
+  (gda_distributed_hashtable.h), which grows online, so the table never
+  runs full. A lookup usually consists of a single 64 Byte Get, and only
+  continues in the overflow table, if the flag is set.
+
+  Inserts claim a slot with a compare and swap on the key field, write
+  value, incarnation and checksum and only then publish the key. Lookups
+  read the whole bucket with a single Get, which is not atomic, so every
+  entry is self verifying: a lookup, whose checksum does not match, has
+  seen a torn entry and fetches the bucket again. After
+  GDA_BUCKET_MAX_RETRIES torn reads, the entry is read field by field
+  with atomic operations instead, framed by two reads of the key.
+
+  The keys GDA_BUCKET_EMPTY, GDA_BUCKET_TOMBSTONE and GDA_BUCKET_RESERVED
+  are reserved. The internal index uses the upper 8 bits of the key for
+  the label handle, so they could only collide with an application-level
+  ID of 0xFFFFFFFFFFFFFF (or larger) in combination with the label handle
+  255.
+ */
+
+
+/**
+  constant definitions
+ */
+
+#define GDA_BUCKET_ENTRIES        3
+/**
+  the window is addressed in 32-bit units: layout of a bucket
+ */
+#define GDA_BUCKET_UNITS          16
+#define GDA_BUCKET_KEYS           0
+#define GDA_BUCKET_VALUES         6
+#define GDA_BUCKET_INCARNATIONS   12
+#define GDA_BUCKET_CONTROL        15
+
+#define GDA_BUCKET_CHECKSUM_BITS  10
+#define GDA_BUCKET_CHECKSUM_MASK  0x000003FF
+#define GDA_BUCKET_OVERFLOW       0x80000000
+
+/**
+  number of torn reads of an entry, before it is read with atomic
+  operations
+ */
+#define GDA_BUCKET_MAX_RETRIES    16
+
+#define GDA_BUCKET_EMPTY          0xFFFFFFFFFFFFFFFF
+#define GDA_BUCKET_TOMBSTONE      0xFFFFFFFFFFFFFFFE
+#define GDA_BUCKET_RESERVED       0xFFFFFFFFFFFFFFFD
+
+
+/**
+  data type definitions
+ */
+
+typedef struct GDA_RMABucketHashMap_Bucket_desc {
+  uint64_t keys[GDA_BUCKET_ENTRIES];
+  uint64_t values[GDA_BUCKET_ENTRIES];
+  uint32_t incarnations[GDA_BUCKET_ENTRIES];
+  /**
+    checksum of entry i in the bits i*GDA_BUCKET_CHECKSUM_BITS and above,
+    overflow flag in the highest bit
+   */
+  uint32_t control;
+} GDA_RMABucketHashMap_Bucket;
+
+typedef struct GDA_RMABucketHashMap_desc {
+  /**
+    communicator over which hash map should span
+   */
+  MPI_Comm comm;
+  size_t comm_size;
+  /**
+    leave this as int since it is also used as input for MPI calls
+   */
+  int comm_rank;
+
+  /**
+    buckets (displacement unit is a single uint32_t)
+   */
+  RMA_Win win_buckets;
+  /**
+    basepointer
+   */
+  GDA_RMABucketHashMap_Bucket* buckets;
+
+  size_t num_buckets_total;
+  size_t num_buckets_local;
+
+  /**
+    holds the keys, that did not fit into their home bucket
+   */
+  GDA_RMAHashMap overflow;
+} GDA_RMABucketHashMap_desc_t;
+
+typedef GDA_RMABucketHashMap_desc_t* GDA_RMABucketHashMap;
+
+
+/**
+  function prototypes
+ */
+
+void GDA_CreateRMABucketHashMap( size_t num_buckets, MPI_Comm comm, GDA_RMABucketHashMap* hashmap );
+void GDA_FreeRMABucketHashMap( GDA_RMABucketHashMap* hashmap );
+void GDA_InsertElementIntoRMABucketHashMap( uint64_t hashed_key, uint64_t key, uint64_t value, uint64_t incarnation, GDA_RMABucketHashMap hashmap );
+void GDA_FindElementInRMABucketHashMap( uint64_t hashed_key, uint64_t key, uint64_t* value, uint64_t* incarnation, bool* found_flag, GDA_RMABucketHashMap hashmap );
+void GDA_FindElementsInRMABucketHashMap( size_t count, const uint64_t* hashed_keys, const uint64_t* keys, uint64_t* values, uint64_t* incarnations, bool* found_flags, GDA_RMABucketHashMap hashmap );
+bool GDA_RemoveElementFromRMABucketHashMap( uint64_t hashed_key, uint64_t key, GDA_RMABucketHashMap hashmap );
+void GDA_MaintainRMABucketHashMap( GDA_RMABucketHashMap hashmap );
+uint64_t GDA_RankOfKeyInRMABucketHashMap( uint64_t hashed_key, GDA_RMABucketHashMap hashmap );
+
+#endif // #ifndef __GDA_BUCKET_HASHTABLE_H
@@ -11,7 +11,9 @@
 
 #include "gdi.h"
 #include "gda_constraint.h"
+#include "gda_dictionary.h"
 #include "gda_operation.h"
+#include "gda_property.h"
 
 /**
   Convenience function to free a property type condition: it erases itself from the list that the subconstraint holds,
@@ -136,6 +138,8 @@ int GDA_MarkStaleByLabel( GDI_Label label ) {
     desc->cond.subconstraint->stale = GDA_SUBCONSTRAINT_STALE;
     if(desc->cond.subconstraint->constraint != NULL) {
       desc->cond.subconstraint->constraint->stale = GDA_CONSTRAINT_STALE;
+      // the compiled form refers to the conditions, that are removed below
+      GDA_InvalidateCompiledConstraint(desc->cond.subconstraint->constraint);
     }
 
     curr = GDA_list_next(label_list, curr);
@@ -179,6 +183,8 @@ int GDA_MarkStaleByPropertyType( GDI_PropertyType ptype ) {
     desc->cond.subconstraint->stale = GDA_SUBCONSTRAINT_STALE;
     if(desc->cond.subconstraint->constraint != NULL) {
       desc->cond.subconstraint->constraint->stale = GDA_CONSTRAINT_STALE;
+      // the compiled form refers to the conditions, that are removed below
+      GDA_InvalidateCompiledConstraint(desc->cond.subconstraint->constraint);
     }
 
     curr = GDA_list_next(label_list, curr);
@@ -192,360 +198,271 @@ int GDA_MarkStaleByPropertyType( GDI_PropertyType ptype ) {
 
 
 /**
-  helper function for GDA_EvalConstraintInLightweightEdgeContext
-
-  list_ptr can contain either the blacklist or the whitelist
-  list_flag:
-  - true:  whitelist
-  - false: blacklist
-
-  function written by Robert Gerstenberger
+  sets the bits of the edge labels, with which an edge satisfies the
+  label conditions of at least one subconstraint: the label of an edge
+  is a single integer handle (0 for an edge without a label), so that
+  each possible handle can simply be tried
  */
-static inline void GDA_ParseLabelSubconstraintInLightweightEdgeContext( uint8_t** list_ptr, size_t* list_maxcount, size_t* list_resultcount, bool* list_flag, bool* satisfiable, GDI_Subconstraint sc ) {
-
-  assert( *list_maxcount > 0 );
-
-  int ret;
-  size_t resultcount;
-  size_t num_conditions = 10;
-  GDI_Label* array_of_labels = malloc( num_conditions * sizeof(GDI_Label) );
-  GDI_Op* array_of_ops = malloc( num_conditions * sizeof(GDI_Op) );
-
-  uint8_t* list = *list_ptr;
-
-  /**
-    extract the label conditions
-    resize the two arrays if necessary
-   */
-  ret = GDI_GetAllLabelConditionsFromSubconstraint( array_of_labels, array_of_ops, num_conditions, &resultcount, sc );
-  if( ret == GDI_ERROR_TRUNCATE ) {
-    GDI_GetAllLabelConditionsFromSubconstraint( NULL, NULL, 0, &num_conditions, sc );
-    array_of_labels = realloc( array_of_labels, num_conditions * sizeof(GDI_Label) );
-    array_of_ops = realloc( array_of_ops, num_conditions * sizeof(GDI_Op) );
-
-    ret = GDI_GetAllLabelConditionsFromSubconstraint( array_of_labels, array_of_ops, num_conditions, &resultcount, sc );
-  }
-  assert( ret == GDI_SUCCESS );
-
-  *satisfiable = true;
-  *list_resultcount = 0;
-
-  /**
-    parse the label conditions
-   */
-  if( resultcount > 0 ) {
-    /* init list */
-    list[0] = array_of_labels[0]->int_handle;
-    *list_resultcount = 1;
-    if( array_of_ops[0] == GDI_EQUAL ) {
-      *list_flag = true; /* mark as whitelist */
-    } else {
-      *list_flag = false; /* mark as blacklist */
-    }
-  }
-
-  for( size_t i=1 ; i<resultcount ; i++ ) {
-    if( array_of_ops[i] == GDI_EQUAL ) {
-      if( !(*list_flag) ) {
-        /**
-          merge existing blacklist with an equal condition: only have to
-          check whether the current label is already present in the blacklist:
-          if it is, then is not possible to satisfy the subconstraint
-          (edge has to have that label AND edge has to have not that label)
-         */
-        for( size_t j=0 ; j<(*list_resultcount) ; j++ ) {
-          if( list[j] == array_of_labels[i]->int_handle ) {
-            *satisfiable = false;
-
-            /* clean up */
-            free( array_of_labels );
-            free( array_of_ops );
-            return;
-          }
-        }
-      } else {
-        /**
-          merge existing whitelist with an equal condition: only one element allowed
-          in a whitelist, since NOD currently only supports one label per edge
-         */
-        if( array_of_labels[i]->int_handle != list[0] ) {
-          /**
-            edge can't have two labels in NOD right now: not possible to satisfy
-            this subconstraint
-           */
-          *satisfiable = false;
-
-          /* clean up */
-          free( array_of_labels );
-          free( array_of_ops );
-          return;
+static void GDA_CompileLabelSet( GDA_CompiledConstraint* compiled ) {
+  memset( compiled->label_set, 0, sizeof(compiled->label_set) );
+
+  for( uint32_t label_int_handle=0 ; label_int_handle<256 ; label_int_handle++ ) {
+    for( size_t i=0 ; i<compiled->num_subconstraints ; i++ ) {
+      bool satisfied = true;
+      for( size_t j=compiled->offsets[i] ; satisfied && (j<compiled->offsets[i+1]) ; j++ ) {
+        const GDA_CompiledCondition* cond = compiled->conditions + j;
+        if( cond->ptype == GDI_PROPERTY_TYPE_NULL ) {
+          satisfied = ((cond->label_int_handle == label_int_handle) == (cond->op == GDI_EQUAL));
         }
       }
-    } else {
-      /**
-        equal to GDI_NOTEQUAL, as labels only support those two GDI_Ops
-       */
-      if( !(*list_flag) ) {
-        /**
-          merge blacklist with a non-equal condition: just have to make sure
-          that label is not already a part of the blacklist before adding it
-          to the blacklist
-         */
-        bool add_flag = true;
-        for( size_t j=0 ; j<(*list_resultcount) ; j++ ) {
-          if( list[j] == array_of_labels[i]->int_handle ) {
-            add_flag = false;
-            break;
-          }
-        }
 
-        if( add_flag ) {
-          if( *list_resultcount == *list_maxcount ) {
-            /**
-              list (which is an array) is too small for one more element
-             */
-            *list_maxcount = *list_maxcount << 1;
-            *list_ptr = realloc( *list_ptr, *list_maxcount * sizeof(uint8_t) );
-            list = *list_ptr;
-          }
-          list[(*list_resultcount)++] = array_of_labels[i]->int_handle;
-        }
-      } else {
-        /**
-          merge whitelist with a non-equal condition: either the whitelist contains
-          the same label as the current condition, in which case it is not possible
-          to satisfy the subconstraint, or the list will be a blacklist afterwards
-         */
-        if( array_of_labels[i]->int_handle == list[0] ) {
-          *satisfiable = false;
-
-          /* clean up */
-          free( array_of_labels );
-          free( array_of_ops );
-          return;
-        } else {
-          *list_flag = false; /* mark as blacklist */
-          list[0] = array_of_labels[i]->int_handle;
-        }
+      if( satisfied ) {
+        compiled->label_set[label_int_handle >> 6] |= (uint64_t)1 << (label_int_handle & 63);
+        break;
       }
     }
   }
 
-  /* clean up */
-  free( array_of_labels );
-  free( array_of_ops );
+  compiled->label_flag = false;
+  for( int i=0 ; i<4 ; i++ ) {
+    if( compiled->label_set[i] != ~(uint64_t)0 ) {
+      compiled->label_flag = true;
+    }
+  }
 }
 
-/**
-  helper function for GDA_EvalConstraintInLightweightEdgeContext
-
-  list_flags decide whether the respective list is either a blacklist or a whitelist
-  - true:  whitelist
-  - false: blacklist
 
-  function written by Robert Gerstenberger
+/**
+  flattens the subconstraints of the constraint into one array of
+  conditions, with the labels resolved to their integer handles and the
+  sizes of the property values in Bytes, and precomputes the edge labels
+  that satisfy the constraint
  */
-void GDA_MergeLists( uint8_t* sc_list, size_t num_sc_list, bool sc_list_flag, GDA_List** c_list_ptr, bool* c_list_flag ) {
+static GDA_CompiledConstraint* GDA_CompileConstraint( GDI_Constraint constraint ) {
+  GDA_List* subconstraints = constraint->subconstraints;
+
+  GDA_CompiledConstraint* compiled = malloc( sizeof(GDA_CompiledConstraint) );
+  assert( compiled != NULL );
+  compiled->num_subconstraints = GDA_list_size( subconstraints );
+  compiled->offsets = malloc( (compiled->num_subconstraints + 1) * sizeof(size_t) );
+  assert( compiled->offsets != NULL );
+
+  size_t num_conditions = 0;
+  size_t num_label_conditions = 0;
+  for( GDA_Node* node = GDA_list_front( subconstraints ) ; node != NULL ; node = GDA_list_next( subconstraints, node ) ) {
+    GDI_Subconstraint sc = *(GDI_Subconstraint*) GDA_list_value( subconstraints, node );
+    num_label_conditions += GDA_list_size( sc->label_conditions );
+    num_conditions += GDA_list_size( sc->label_conditions ) + GDA_list_size( sc->property_conditions );
+  }
+  compiled->conditions = malloc( num_conditions * sizeof(GDA_CompiledCondition) );
+  assert( (compiled->conditions != NULL) || (num_conditions == 0) );
+
+  size_t i = 0;
+  size_t pos = 0;
+  for( GDA_Node* node = GDA_list_front( subconstraints ) ; node != NULL ; node = GDA_list_next( subconstraints, node ) ) {
+    GDI_Subconstraint sc = *(GDI_Subconstraint*) GDA_list_value( subconstraints, node );
+    compiled->offsets[i++] = pos;
+
+    GDA_List* lconds = sc->label_conditions;
+    for( GDA_Node* lnode = GDA_list_front( lconds ) ; lnode != NULL ; lnode = GDA_list_next( lconds, lnode ) ) {
+      GDI_LabelCondition_desc_t* lcond = *(GDI_LabelCondition_desc_t**) GDA_list_value( lconds, lnode );
+      GDA_CompiledCondition* cond = compiled->conditions + pos++;
+      cond->ptype = GDI_PROPERTY_TYPE_NULL;
+      cond->label_int_handle = lcond->label->int_handle;
+      cond->op = lcond->op;
+      cond->data = NULL;
+      cond->size = 0;
+      cond->code = 0;
+    }
 
-  if( sc_list_flag ) {
-    if( *c_list_flag ) {
-      /**
-        merge two whitelists
-        - subconstraint whitelist is exactly one label
-        - check whether that label is already present in the constraint whitelist:
-          if not, add that label as well to the constraint whitelist
-       */
-      assert( num_sc_list == 1 );
-      bool add_flag = true;
-      GDA_Node* node = (*c_list_ptr)->head;
-      while( node != NULL ) {
-        if( *(uint8_t*)(node->value) == sc_list[0] ) {
-          add_flag = false;
-          break;
-        }
-        node = node->next;
-      }
-      if( add_flag ) {
-        GDA_list_push_back( *c_list_ptr, &(sc_list[0]) );
-      }
-    } else {
-      /**
-        merge a subconstraint whitelist with a constraint blacklist
-        - subconstraint whitelist is exactly one label
-        - check whether that label is already present in the constraint blacklist:
-          if so, remove that label from the constraint blacklist
-       */
-      GDA_Node* node = (*c_list_ptr)->head;
-      while( node != NULL ) {
-        if( *(uint8_t*)(node->value) == sc_list[0] ) {
-          GDA_list_erase_single( *c_list_ptr, node );
-          break;
-        }
-        node = node->next;
-      }
+    GDA_List* pconds = sc->property_conditions;
+    for( GDA_Node* pnode = GDA_list_front( pconds ) ; pnode != NULL ; pnode = GDA_list_next( pconds, pnode ) ) {
+      GDI_PropertyCondition_desc_t* pcond = *(GDI_PropertyCondition_desc_t**) GDA_list_value( pconds, pnode );
+      size_t dsize;
+      GDI_GetSizeOfDatatype( &dsize, pcond->ptype->dtype );
+
+      GDA_CompiledCondition* cond = compiled->conditions + pos++;
+      cond->ptype = pcond->ptype;
+      cond->label_int_handle = 0;
+      cond->op = pcond->op;
+      cond->data = pcond->data;
+      cond->size = pcond->nelems * dsize;
+      cond->code = GDA_DictionaryCode( cond->data, cond->size );
     }
+  }
+  compiled->offsets[i] = pos;
+  compiled->property_flag = (pos > num_label_conditions);
+
+  if( compiled->num_subconstraints == 0 ) {
+    /**
+      a constraint without subconstraints doesn't filter anything
+     */
+    memset( compiled->label_set, 0xFF, sizeof(compiled->label_set) );
+    compiled->label_flag = false;
   } else {
-    if( *c_list_flag ) {
-      /**
-        merge a subconstraint blacklist with a constraint whitelist
-        - will change the constraint whitelist into a blacklist
-        - check for each label in the constraint whitelist, whether it is present
-          in the subconstraint blacklist: if so, that label is not added to new
-          constraint blacklist
-       */
-      GDA_List* new_c_list;
-      GDA_list_create( &new_c_list, sizeof(uint8_t) );
-
-      for( size_t i=0 ; i<num_sc_list ; i++ ) {
-        bool add_flag = true;
-        GDA_Node* node = (*c_list_ptr)->head;
-        while( node != NULL ) {
-          if( *(uint8_t*)(node->value) == sc_list[i] ) {
-            add_flag = false;
-            break;
-          }
-          node = node->next;
-        }
+    GDA_CompileLabelSet( compiled );
+  }
 
-        if( add_flag ) {
-          GDA_list_push_back( new_c_list, &(sc_list[i]) );
-        }
-      }
+  return compiled;
+}
 
-      /* switch the two lists */
-      GDA_list_free( c_list_ptr );
-      *c_list_ptr = new_c_list;
 
-      *c_list_flag = false; /* mark as blacklist */
-    } else {
-      /**
-        merge two blacklists
-        - check for each label in the the subconstraint blacklist, whether it is
-          present in the constraint blacklist: if so, that label is added to a new
-          constraint blacklist
-       */
-      GDA_List* new_c_list;
-      GDA_list_create( &new_c_list, sizeof(uint8_t) );
-
-      for( size_t i=0 ; i<num_sc_list ; i++ ) {
-        bool add_flag = false;
-        GDA_Node* node = (*c_list_ptr)->head;
-        while( node != NULL ) {
-          if( *(uint8_t*)(node->value) == sc_list[i] ) {
-            add_flag = true;
-            break;
-          }
-          node = node->next;
-        }
+static void GDA_FreeCompiledConstraint( GDA_CompiledConstraint* compiled ) {
+  free( compiled->conditions );
+  free( compiled->offsets );
+  free( compiled );
+}
 
-        if( add_flag ) {
-          GDA_list_push_back( new_c_list, &(sc_list[i]) );
-        }
-      }
 
-      /* switch the two lists */
-      GDA_list_free( c_list_ptr );
-      *c_list_ptr = new_c_list;
-    }
+GDA_CompiledConstraint* GDA_GetCompiledConstraint( GDI_Constraint constraint ) {
+  if( constraint->compiled == NULL ) {
+    constraint->compiled = GDA_CompileConstraint( constraint );
+  }
+  return constraint->compiled;
+}
+
+
+void GDA_InvalidateCompiledConstraint( GDI_Constraint constraint ) {
+  if( constraint->compiled != NULL ) {
+    GDA_FreeCompiledConstraint( constraint->compiled );
+    constraint->compiled = NULL;
   }
 }
 
 
 /**
-  This NOD function can be used to evaluate constraints in the labeled lightweight edge context.
+  This NOD function evaluates a constraint in the labeled lightweight edge
+  context once, so that the edges only have to be tested against the
+  resulting label set.
 
   - assumes that constraint is a valid object
-  - list_flag and list are only significant, if list_size > 0
-  - list has to be freed by the caller, if list_size > 0
+  - compiles the constraint, if it isn't already
+  - label_set is the 256 bit set of the integer handles of the edge labels,
+    with which an edge satisfies the constraint, indexed by the integer
+    handle of the label (bit (handle % 64) of word (handle / 64)); it is
+    owned by the constraint object and stays valid until the constraint
+    is modified
+  - label_set is NULL, if the constraint doesn't restrict the labels of the
+    edges, so that every edge satisfies it
 
   - returns GDI_ERROR_CONSTRAINT, if the constraint object contains any property conditions
   - returns GDI_SUCCESS otherwise
-
-  function written by Robert Gerstenberger
  */
-int GDA_EvalConstraintInLightweightEdgeContext( uint8_t** list, size_t* list_size, bool* list_flag, GDI_Constraint constraint ) {
+int GDA_EvalConstraintInLightweightEdgeContext( const uint64_t** label_set, GDI_Constraint constraint ) {
+  GDA_CompiledConstraint* compiled = GDA_GetCompiledConstraint( constraint );
+  if( compiled->property_flag ) {
+    return GDI_ERROR_CONSTRAINT;
+  }
 
-  int ret;
-  size_t num_subconstraints;
-  GDI_Subconstraint* array_of_subconstraints = malloc( 10 * sizeof(GDI_Subconstraint) );
+  *label_set = compiled->label_flag ? compiled->label_set : NULL;
+  return GDI_SUCCESS;
+}
 
-  /**
-    retrieve all subconstraints of the constraint object
-   */
-  ret = GDI_GetAllSubconstraintsOfConstraint( array_of_subconstraints, 10, &num_subconstraints, constraint );
-  if( ret == GDI_ERROR_TRUNCATE ) {
-    GDI_GetAllSubconstraintsOfConstraint( NULL, 0, &num_subconstraints, constraint );
-    array_of_subconstraints = realloc( array_of_subconstraints, num_subconstraints * sizeof(GDI_Subconstraint) );
 
-    ret = GDI_GetAllSubconstraintsOfConstraint( array_of_subconstraints, num_subconstraints, &num_subconstraints, constraint );
+#define GDA_COMPARE_ELEMENTS( type ) { \
+  type x, y; \
+  memcpy( &x, a, sizeof(type) ); \
+  memcpy( &y, b, sizeof(type) ); \
+  return (x > y) - (x < y); \
+}
+
+/**
+  returns a negative number, zero or a positive number, if element a is
+  smaller than, equal to or greater than element b
+ */
+static inline int GDA_CompareElements( const char* a, const char* b, GDI_Datatype dtype, size_t dsize ) {
+  switch( dtype ) {
+    case GDI_INT8_T:   GDA_COMPARE_ELEMENTS( int8_t )
+    case GDI_INT16_T:  GDA_COMPARE_ELEMENTS( int16_t )
+    case GDI_INT32_T:  GDA_COMPARE_ELEMENTS( int32_t )
+    case GDI_INT64_T:  GDA_COMPARE_ELEMENTS( int64_t )
+    case GDI_UINT16_T: GDA_COMPARE_ELEMENTS( uint16_t )
+    case GDI_UINT32_T:
+    case GDI_DATE:
+    case GDI_TIME:     GDA_COMPARE_ELEMENTS( uint32_t )
+    case GDI_UINT64_T:
+    case GDI_DATETIME: GDA_COMPARE_ELEMENTS( uint64_t )
+    case GDI_FLOAT:    GDA_COMPARE_ELEMENTS( float )
+    case GDI_DOUBLE:   GDA_COMPARE_ELEMENTS( double )
+    default:
+      /**
+        GDI_UINT8_T, GDI_BOOL and the types without an order of their own
+       */
+      return memcmp( a, b, dsize );
   }
-  assert( ret == GDI_SUCCESS );
-
-  /**
-    check for any property conditions, which is an error case
-   */
-  for( size_t i=0 ; i<num_subconstraints ; i++ ) {
-    size_t resultcount;
-
-    GDI_GetAllPropertyTypesOfSubconstraint( NULL, 0, &resultcount, array_of_subconstraints[i] );
-    if( resultcount > 0 ) {
-      free( array_of_subconstraints );
-      return GDI_ERROR_CONSTRAINT;
+}
+
+#undef GDA_COMPARE_ELEMENTS
+
+
+static int GDA_CompareValues( const char* a, uint64_t a_size, const char* b, uint64_t b_size, GDI_Datatype dtype ) {
+  size_t dsize;
+  GDI_GetSizeOfDatatype( &dsize, dtype );
+
+  uint64_t size = (a_size < b_size) ? a_size : b_size;
+  for( uint64_t offset=0 ; offset<size ; offset+=dsize ) {
+    int cmp = GDA_CompareElements( a + offset, b + offset, dtype, dsize );
+    if( cmp != 0 ) {
+      return cmp;
     }
   }
+  return (a_size > b_size) - (a_size < b_size);
+}
 
-  /**
-    prepare a couple of data structures
-   */
-  /* blacklist of the subconstraint */
-  size_t max_num_sc_list = 10;
-  uint8_t* sc_list = malloc( max_num_sc_list * sizeof(uint8_t) );
-
-  /* global list of the constraint */
-  bool c_list_flag = true; /* indicates, whether c_list is a whitelist or a blacklist: true = whitelist, false = blacklist */
-  GDA_List* c_list;
-  GDA_list_create( &c_list, sizeof(uint8_t) );
-
-  bool evaluate_something = false;
-
-  /**
-    iterate over the subconstraint objects and assemble the global constraint list
-   */
-  for( size_t i=0 ; i<num_subconstraints ; i++ ) {
-    bool sc_list_flag;
-    bool satisfiable;
-    size_t num_sc_list;
-    GDA_ParseLabelSubconstraintInLightweightEdgeContext( &sc_list, &max_num_sc_list, &num_sc_list, &sc_list_flag, &satisfiable, array_of_subconstraints[i] );
-    if( satisfiable && (num_sc_list > 0) ) {
-      GDA_MergeLists( sc_list, num_sc_list, sc_list_flag, &c_list, &c_list_flag );
-    }
 
-    if( GDA_list_size( c_list ) == 0 ) {
-      if( evaluate_something ) {
-        /* constraint can always be satisfied */
-        break;
-      }
-    } else {
-      evaluate_something = true;
+static bool GDA_EvalCompiledPropertyCondition( const GDA_CompiledCondition* cond, GDI_VertexHolder vertex ) {
+  if( (cond->op == GDI_EQUAL) || (cond->op == GDI_NOTEQUAL) ) {
+    /**
+      dictionary encoded values are compared by their codes
+     */
+    return GDA_LinearScanningHasPropertyValue( cond->data, cond->size, cond->code, cond->ptype, vertex ) == (cond->op == GDI_EQUAL);
+  }
+
+  GDA_PropertyCursor cursor;
+  GDA_LinearScanningInitPropertyCursor( &cursor, cond->ptype, vertex );
+
+  const char* value;
+  uint64_t size;
+  while( GDA_LinearScanningNextProperty( &value, &size, &cursor ) ) {
+    int cmp = GDA_CompareValues( value, size, cond->data, cond->size, cond->ptype->dtype );
+    switch( cond->op ) {
+      case GDI_GREATER:   if( cmp > 0 )  { return true; } break;
+      case GDI_EQGREATER: if( cmp >= 0 ) { return true; } break;
+      case GDI_SMALLER:   if( cmp < 0 )  { return true; } break;
+      case GDI_EQSMALLER: if( cmp <= 0 ) { return true; } break;
     }
   }
+  return false;
+}
+
 
-  /**
-    prepare the output buffers
-   */
-  *list_size = GDA_list_size( c_list );
-  if( *list_size != 0 ) {
-    *list = malloc( *list_size * sizeof(uint8_t) );
-    GDA_list_to_array( c_list, *list, *list_size );
-    *list_flag = c_list_flag;
+/**
+  a vertex satisfies the constraint, if it satisfies all conditions of at
+  least one subconstraint
+ */
+bool GDA_EvalCompiledConstraint( const GDA_CompiledConstraint* compiled, GDI_VertexHolder vertex ) {
+  if( compiled->num_subconstraints == 0 ) {
+    /**
+      same as in the lightweight edge context: a constraint without
+      subconstraints doesn't filter anything
+     */
+    return true;
   }
 
-  /**
-    clean up
-   */
-  free( array_of_subconstraints );
-  free( sc_list );
-  GDA_list_free( &c_list );
+  for( size_t i=0 ; i<compiled->num_subconstraints ; i++ ) {
+    bool satisfied = true;
+    for( size_t j=compiled->offsets[i] ; satisfied && (j<compiled->offsets[i+1]) ; j++ ) {
+      const GDA_CompiledCondition* cond = compiled->conditions + j;
+      if( cond->ptype == GDI_PROPERTY_TYPE_NULL ) {
+        satisfied = (GDA_LinearScanningHasLabel( cond->label_int_handle, vertex ) == (cond->op == GDI_EQUAL));
+      } else {
+        satisfied = GDA_EvalCompiledPropertyCondition( cond, vertex );
+      }
+    }
 
-  return GDI_SUCCESS;
+    if( satisfied ) {
+      return true;
+    }
+  }
+  return false;
 }
@@ -22,6 +22,58 @@
 #define GDA_SUBCONSTRAINT_STALE 1
 
 
+/**
+  data type definitions
+ */
+
+/**
+  condition of a compiled constraint: a label condition, if ptype is
+  GDI_PROPERTY_TYPE_NULL, and a property condition otherwise
+ */
+typedef struct GDA_CompiledCondition_desc {
+  GDI_PropertyType ptype;
+  uint32_t label_int_handle;
+  GDI_Op op;
+  /**
+    value of a property condition, which is owned by the condition
+    object, and its size in Bytes
+   */
+  const char* data;
+  uint64_t size;
+  /**
+    dictionary code of the value (GDA_DictionaryCode), so that values,
+    that are still encoded, can be compared without decoding them
+   */
+  uint64_t code;
+} GDA_CompiledCondition;
+
+/**
+  A constraint in a form, that can be evaluated against the property
+  data of a vertex without walking the lists of the constraint objects:
+  the conditions of subconstraint i are conditions[offsets[i]] up to
+  conditions[offsets[i+1]], which all have to hold, while one of the
+  subconstraints has to hold. The label conditions of a subconstraint
+  come before its property conditions, since they are cheaper to check.
+ */
+typedef struct GDA_CompiledConstraint_desc {
+  size_t num_subconstraints;
+  size_t* offsets;
+  GDA_CompiledCondition* conditions;
+  /**
+    whether any subconstraint has a property condition, which can't be
+    evaluated in the lightweight edge context
+   */
+  bool property_flag;
+  /**
+    set of the integer handles of the edge labels, with which an edge
+    satisfies the label conditions (lightweight edge context), and
+    whether the set restricts the labels at all
+   */
+  uint64_t label_set[4];
+  bool label_flag;
+} GDA_CompiledConstraint;
+
+
 /**
   function prototypes
  */
@@ -73,17 +125,50 @@ int GDA_FreeAllConstraint( GDI_Database graph_db );
 int GDA_FreeAllSubconstraint( GDI_Database graph_db );
 
 /**
-  This NOD function can be used to evaluate constraints in the labeled
-  lightweight edge context.
+  This NOD function evaluates a constraint in the labeled lightweight edge
+  context once and returns the set of the edge labels, that satisfy it.
 
   - assumes that constraint is a valid object
-  - list_flag and list are only significant, if list_size > 0
-  - list has to be freed by the caller, if list_size > 0
+  - label_set is the 256 bit set of the integer handles of the edge labels,
+    with which an edge satisfies the constraint; it is owned by the
+    constraint object and stays valid until the constraint is modified
+  - label_set is NULL, if the constraint doesn't restrict the labels of
+    the edges
 
   - returns GDI_ERROR_CONSTRAINT, if the constraint object contains any
     property conditions
   - returns GDI_SUCCESS otherwise
  */
-int GDA_EvalConstraintInLightweightEdgeContext( uint8_t** list, size_t* list_size, bool* list_flag, GDI_Constraint constraint );
+int GDA_EvalConstraintInLightweightEdgeContext( const uint64_t** label_set, GDI_Constraint constraint );
+
+/**
+  This NOD function returns the compiled form of a constraint, which is
+  compiled on its first use and then cached on the constraint object.
+
+  - assumes that constraint is a valid object
+ */
+GDA_CompiledConstraint* GDA_GetCompiledConstraint( GDI_Constraint constraint );
+
+/**
+  This NOD function drops the compiled form of a constraint, which has
+  to be called, whenever the constraint changes or becomes stale, since
+  the compiled form refers to the values of its property conditions.
+ */
+void GDA_InvalidateCompiledConstraint( GDI_Constraint constraint );
+
+/**
+  This NOD function evaluates a compiled constraint against the labels
+  and the property data of a vertex.
+
+  A label condition holds, if the vertex has (GDI_EQUAL) or doesn't
+  have (GDI_NOTEQUAL) the label. A property condition with GDI_NOTEQUAL
+  holds, if no value of the property type is equal to the value of the
+  condition, a property condition with any other operation holds, if at
+  least one value of the property type compares with the value of the
+  condition accordingly. Values with more than one element are compared
+  element by element, and a value, that is a prefix of the other one,
+  is the smaller one.
+ */
+bool GDA_EvalCompiledConstraint( const GDA_CompiledConstraint* compiled, GDI_VertexHolder vertex );
 
 #endif // __GDA_CONDITION_H_
@@ -0,0 +1,256 @@
+// Copyright (c) 2023 ETH Zurich.
+//                    All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <assert.h>
+#include <string.h>
+
+#include "gdi.h"
+#include "gda_block.h"
+#include "gda_dictionary.h"
+#include "gda_yield.h"
+
+/**
+  collective call
+ */
+void GDA_CreateDictionary( GDI_Database graph_db ) {
+  size_t num_blocks = graph_db->memsize / graph_db->block_size * graph_db->commsize;
+
+  /**
+    the dictionary is meant for a small number of distinct values, the
+    hash table grows on demand anyway
+   */
+  GDA_CreateRMAHashMap( num_blocks/64 /* table size */, num_blocks/64 /* heap size */, graph_db->comm, &(graph_db->dictionary) );
+
+  /**
+    an entry of the cache points to the size of the value (uint64_t)
+    followed by the value itself
+   */
+  GDA_hashmap_create( &(graph_db->dictionary_cache), sizeof(uint64_t), 64, sizeof(char*), &GDA_int64_to_int );
+}
+
+
+/**
+  collective call
+ */
+void GDA_FreeDictionary( GDI_Database graph_db ) {
+  GDA_FreeRMAHashMap( &(graph_db->dictionary) );
+
+  GDA_HashMap* cache = graph_db->dictionary_cache;
+  size_t capacity = GDA_hashmap_capacity( cache );
+  for( size_t i=0 ; i<capacity ; i++ ) {
+    if( cache->uses[i] != GDA_HASHMAP_NOT_IN_USE ) {
+      free( *(char**)GDA_hashmap_get_at( cache, i ) );
+    }
+  }
+  GDA_hashmap_free( &(graph_db->dictionary_cache) );
+}
+
+
+/**
+  collective call
+
+  no process accesses the dictionary at this point, so that the old
+  generations of its hash table can be freed
+ */
+void GDA_MaintainDictionary( GDI_Database graph_db ) {
+  GDA_MaintainRMAHashMap( graph_db->dictionary );
+}
+
+
+static inline uint64_t GDA_DictionaryMix( uint64_t x ) {
+  /**
+    finalizer of splitmix64 (as for the keys of the edge records)
+   */
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+
+uint64_t GDA_DictionaryCode( const char* value, uint64_t size ) {
+  uint64_t code = GDA_DictionaryMix( size );
+  while( size > 0 ) {
+    uint64_t word = 0;
+    uint64_t chunk = (size < sizeof(uint64_t)) ? size : sizeof(uint64_t);
+    memcpy( &word, value, chunk );
+    code = GDA_DictionaryMix( code ^ word );
+    value += chunk;
+    size -= chunk;
+  }
+
+  if( code == GDA_HASHINT_NULL ) {
+    /**
+      reserved by the hash table
+     */
+    code--;
+  }
+  return code;
+}
+
+
+static char* GDA_DictionaryCacheEntry( uint64_t code, GDI_Database graph_db ) {
+  char** entry = GDA_hashmap_get( graph_db->dictionary_cache, &code );
+  if( entry == NULL ) {
+    return NULL;
+  }
+  return *entry;
+}
+
+
+static char* GDA_DictionaryAddCacheEntry( uint64_t code, uint64_t size, GDI_Database graph_db ) {
+  char* entry = malloc( sizeof(uint64_t) + size );
+  assert( entry != NULL );
+  *(uint64_t*) entry = size;
+  GDA_hashmap_insert( graph_db->dictionary_cache, &code, &entry );
+  return entry;
+}
+
+
+/**
+  fetches the value with the code from the dictionary into the cache,
+  returns NULL, if the code is unknown
+ */
+static char* GDA_DictionaryFetch( uint64_t code, GDI_Database graph_db ) {
+  uint64_t value, incarnation;
+  bool found_flag;
+  GDA_FindElementInRMAHashMap( code, code, &value, &incarnation, &found_flag, graph_db->dictionary );
+  if( !found_flag ) {
+    return NULL;
+  }
+
+  uint64_t block_size = graph_db->block_size;
+  char* buf = malloc( block_size );
+  assert( buf != NULL );
+
+  GDA_DPointer dpointer = value;
+  GDA_GetBlock( buf, dpointer, graph_db );
+  GDA_Yield();
+  RMA_Win_flush_all( graph_db->win_blocks );
+
+  uint64_t remaining_size = *(uint64_t*)(buf+GDA_DICTIONARY_OFFSET_SIZE);
+  char* entry = GDA_DictionaryAddCacheEntry( code, remaining_size, graph_db );
+
+  uint64_t chunk = block_size - GDA_DICTIONARY_METADATA_SIZE;
+  char* target_address = entry + sizeof(uint64_t);
+  char* source_address = buf + GDA_DICTIONARY_METADATA_SIZE;
+
+  while( true ) {
+    if( chunk > remaining_size ) {
+      chunk = remaining_size;
+    }
+    memcpy( target_address, source_address, chunk );
+    target_address += chunk;
+    remaining_size -= chunk;
+
+    dpointer = *(GDA_DPointer*)(buf+GDA_DICTIONARY_OFFSET_NEXT_BLOCK);
+    if( remaining_size == 0 ) {
+      break;
+    }
+
+    assert( dpointer != GDA_DPOINTER_NULL );
+    GDA_GetBlock( buf, dpointer, graph_db );
+    GDA_Yield();
+    RMA_Win_flush_all( graph_db->win_blocks );
+
+    chunk = block_size - sizeof(GDA_DPointer);
+    source_address = buf + sizeof(GDA_DPointer);
+  }
+
+  free( buf );
+  return entry;
+}
+
+
+/**
+  writes the value into new blocks on the local process and inserts it
+  into the dictionary
+ */
+static void GDA_DictionaryInsert( uint64_t code, const char* value, uint64_t size, GDI_Database graph_db ) {
+  uint64_t block_size = graph_db->block_size;
+  uint64_t payload_size = block_size - sizeof(GDA_DPointer);
+  uint64_t total_size = GDA_DICTIONARY_METADATA_SIZE - sizeof(GDA_DPointer) + size;
+  size_t num_blocks = (total_size + payload_size - 1) / payload_size;
+
+  GDA_DPointer* dp = malloc( num_blocks * sizeof(GDA_DPointer) );
+  assert( dp != NULL );
+  for( size_t i=0 ; i<num_blocks ; i++ ) {
+    dp[i] = GDA_AllocateBlock( graph_db->commrank, graph_db );
+    if( dp[i] == GDA_DPOINTER_NULL ) {
+      /**
+        couldn't acquire enough resources
+       */
+      // TODO
+      assert( 0 );
+    }
+  }
+
+  char* buf = malloc( num_blocks * block_size );
+  assert( buf != NULL );
+  *(uint64_t*)(buf+GDA_DICTIONARY_OFFSET_SIZE) = size;
+
+  uint64_t remaining_size = size;
+  for( size_t i=0 ; i<num_blocks ; i++ ) {
+    char* block = buf + i * block_size;
+    *(GDA_DPointer*)(block+GDA_DICTIONARY_OFFSET_NEXT_BLOCK) = (i+1 < num_blocks) ? dp[i+1] : GDA_DPOINTER_NULL;
+
+    uint64_t header_size = (i == 0) ? GDA_DICTIONARY_METADATA_SIZE : sizeof(GDA_DPointer);
+    uint64_t chunk = block_size - header_size;
+    if( chunk > remaining_size ) {
+      chunk = remaining_size;
+    }
+    memcpy( block + header_size, value, chunk );
+    value += chunk;
+    remaining_size -= chunk;
+
+    GDA_PutBlock( block, dp[i], graph_db );
+  }
+  assert( remaining_size == 0 );
+
+  /**
+    other processes may only find the code, once the value is in place
+   */
+  GDA_Yield();
+  RMA_Win_flush_all( graph_db->win_blocks );
+  free( buf );
+
+  GDA_InsertElementIntoRMAHashMap( code, code, dp[0], 0 /* incarnation */, graph_db->dictionary );
+  free( dp );
+}
+
+
+bool GDA_DictionaryEncode( uint64_t* code, const char* value, uint64_t size, GDI_Database graph_db ) {
+  *code = GDA_DictionaryCode( value, size );
+
+  char* entry = GDA_DictionaryCacheEntry( *code, graph_db );
+  if( entry == NULL ) {
+    entry = GDA_DictionaryFetch( *code, graph_db );
+  }
+
+  if( entry == NULL ) {
+    /**
+      first occurrence of the value: two processes, that intern the same
+      value at the same time, both insert it, which only costs the space
+      of the second copy
+     */
+    GDA_DictionaryInsert( *code, value, size, graph_db );
+    entry = GDA_DictionaryAddCacheEntry( *code, size, graph_db );
+    memcpy( entry + sizeof(uint64_t), value, size );
+    return true;
+  }
+
+  return (*(uint64_t*) entry == size) && (memcmp( entry + sizeof(uint64_t), value, size ) == 0);
+}
+
+
+const char* GDA_DictionaryDecode( uint64_t code, uint64_t size, GDI_Database graph_db ) {
+  char* entry = GDA_DictionaryCacheEntry( code, graph_db );
+  if( entry == NULL ) {
+    entry = GDA_DictionaryFetch( code, graph_db );
+  }
+  assert( entry != NULL );
+  assert( *(uint64_t*) entry == size );
+  return entry + sizeof(uint64_t);
+}
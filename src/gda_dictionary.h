@@ -0,0 +1,75 @@
+// Copyright (c) 2023 ETH Zurich.
+//                    All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef __GDA_DICTIONARY_H
+#define __GDA_DICTIONARY_H
+
+#include "gdi.h"
+
+/**
+  Values of property types, that were created with the
+  GDI_DICTIONARY_ENCODED flag, are meant for low-cardinality strings
+  (like a type or a country name): when the property data of a vertex
+  or an edge record is written back during a commit, each such value is
+  interned in the dictionary of the database and only its code is
+  stored (gda_property.h), so that every distinct value is stored once.
+
+  The code of a value is a 64 bit hash of its Bytes. The dictionary is a
+  distributed hash table (dictionary of the database), that maps a code
+  to the first block of a chain of blocks with the value: each block
+  starts with the DPointer of the next block (GDA_DPOINTER_NULL for the
+  last one), the first block continues with the size of the value,
+  followed by the value itself. Values are never removed from the
+  dictionary, so each process keeps a local cache (dictionary_cache of
+  the database) of all values, that it has interned or decoded, which
+  never has to be invalidated.
+
+  A value, whose code is already taken by a different value, is stored
+  as is. A stored code therefore always stands for the value, from which
+  it was computed: values with different codes are different, and only
+  values with the same code have to be compared (GDA_DictionaryDecode).
+
+  The codes are kept in memory, when the property data is loaded, and a
+  value is only decoded, once it is read (gda_property.h).
+ */
+
+
+/**
+  constant definitions
+ */
+
+#define GDA_DICTIONARY_OFFSET_NEXT_BLOCK 0
+#define GDA_DICTIONARY_OFFSET_SIZE       (GDA_DICTIONARY_OFFSET_NEXT_BLOCK+8)
+#define GDA_DICTIONARY_METADATA_SIZE     (GDA_DICTIONARY_OFFSET_SIZE+8)
+
+
+/**
+  function prototypes
+ */
+
+void GDA_CreateDictionary( GDI_Database graph_db );
+void GDA_FreeDictionary( GDI_Database graph_db );
+void GDA_MaintainDictionary( GDI_Database graph_db );
+
+/**
+  code of the value, which only depends on its Bytes, so that it can be
+  computed without accessing the dictionary
+ */
+uint64_t GDA_DictionaryCode( const char* value, uint64_t size );
+
+/**
+  interns the value and returns its code, returns false, if the code is
+  already taken by a different value
+ */
+bool GDA_DictionaryEncode( uint64_t* code, const char* value, uint64_t size, GDI_Database graph_db );
+
+/**
+  returns the value with the code, which has the given size, the value
+  is owned by the cache of the dictionary
+ */
+const char* GDA_DictionaryDecode( uint64_t code, uint64_t size, GDI_Database graph_db );
+
+#endif // #ifndef __GDA_DICTIONARY_H
@@ -12,14 +12,281 @@
 // The improvements (including a delete call) were made by Robert
 // Gerstenberger, while working on a different project.
 
+#include <assert.h>
 #include <stdio.h>
 #include <string.h>
 
 #include "gda_distributed_hashtable.h"
+#include "gda_yield.h"
 
 
-uint64_t hashfunc( uint64_t key, GDA_RMAHashMap hashmap ) {
-  return key % hashmap->table_size_total;
+/**
+  folds the hashed key to 32 bits, so that it can be stored alongside the
+  incarnation of an element
+ */
+static inline uint64_t GDA_FoldHash( uint64_t hashed_key ) {
+  return (hashed_key ^ (hashed_key >> 32)) & 0x00000000FFFFFFFF;
+}
+
+
+/**
+  checks whether an element matches the given key and value, where a
+  value of GDA_HASHINT_NULL matches any value
+ */
+static inline bool GDA_ElementMatches( const GDA_RMAHashMap_Element* element, uint64_t key, uint64_t value ) {
+  return (element->key == key) && ((value == GDA_HASHINT_NULL) || (element->value == value));
+}
+
+
+/**
+  layout of the table directory of each process (in 64-bit words)
+ */
+#define GDA_RMAHASHMAP_DIR_COUNT       0
+#define GDA_RMAHASHMAP_DIR_BASE        1
+#define GDA_RMAHASHMAP_DIR_GENERATIONS 2
+
+
+/**
+  process, that owns the table slot of a hash
+ */
+static inline uint64_t GDA_TableRank( uint64_t hash, GDA_RMAHashMap hashmap ) {
+  return hash % hashmap->comm_size;
+}
+
+
+/**
+  offset of the table slot of a hash within the given table generation
+  of its process
+ */
+static inline uint64_t GDA_TableOffset( uint64_t hash, uint64_t generation, GDA_RMAHashMap hashmap ) {
+  return (hash / hashmap->comm_size) % (hashmap->table_size_local << generation);
+}
+
+
+/**
+  checks whether the elements of a table slot are moved into the next
+  generation (GDA_RMAHASHMAP_SLOT_MOVED is not included)
+ */
+static inline bool GDA_SlotIsMigrating( uint64_t slot ) {
+  if( slot == GDA_RMAHASHMAP_SLOT_MIGRATING_NULL ) {
+    return true;
+  }
+  return ((slot >> 32) != 0x00000000FFFFFFFF) && ((slot & GDA_RMAHASHMAP_SLOT_MIGRATING) != 0);
+}
+
+
+/**
+  DPointer to the first element of the chain of a table slot
+ */
+static inline GDA_DPointer GDA_SlotHead( uint64_t slot ) {
+  if( (slot >> 32) == 0x00000000FFFFFFFF ) {
+    /**
+      GDA_DPOINTER_NULL or one of the special values
+     */
+    return GDA_DPOINTER_NULL;
+  }
+  return slot & ~GDA_RMAHASHMAP_SLOT_MIGRATING;
+}
+
+
+/**
+  value of a table slot with the given first element
+ */
+static inline uint64_t GDA_SlotValue( GDA_DPointer head, bool migrating_flag ) {
+  if( !migrating_flag ) {
+    return head;
+  }
+  if( head == GDA_DPOINTER_NULL ) {
+    return GDA_RMAHASHMAP_SLOT_MIGRATING_NULL;
+  }
+  return head | GDA_RMAHASHMAP_SLOT_MIGRATING;
+}
+
+
+/**
+  first element index of a heap segment
+ */
+static inline uint64_t GDA_HeapSegmentStart( size_t segment, GDA_RMAHashMap hashmap ) {
+  return hashmap->heap_size_local * ((UINT64_C(1) << segment) - 1);
+}
+
+
+/**
+  heap segment that holds the element with the given index
+ */
+static inline size_t GDA_HeapSegment( uint64_t index, GDA_RMAHashMap hashmap ) {
+  uint64_t q = index / hashmap->heap_size_local + 1;
+  size_t segment = 0;
+  while( q > 1 ) {
+    q >>= 1;
+    segment++;
+  }
+  return segment;
+}
+
+
+static inline GDA_RMAHashMap_Element* GDA_LocalHeapElement( uint64_t index, GDA_RMAHashMap hashmap ) {
+  size_t segment = GDA_HeapSegment( index, hashmap );
+  return hashmap->heap_segments[segment] + (index - GDA_HeapSegmentStart( segment, hashmap ));
+}
+
+
+/**
+  translates an offset (counted in 64-bit words) into the heap of the
+  given rank into a displacement of the dynamic heap window
+
+  the address of a remote heap segment is fetched from the heap
+  directory of that rank on first use and cached afterwards, since
+  segments are only detached, when the hash map is freed
+ */
+static MPI_Aint GDA_HeapDisp( uint64_t rank, uint64_t word_offset, GDA_RMAHashMap hashmap ) {
+  uint64_t index = word_offset / 4;
+  size_t segment = GDA_HeapSegment( index, hashmap );
+
+  MPI_Aint* address = &(hashmap->heap_directory_cache[rank * GDA_RMAHASHMAP_MAX_HEAP_SEGMENTS + segment]);
+  if( *address == 0 ) {
+    /**
+      the segment is published before any element of it is linked into a
+      table, so this loop will only spin in case of a delayed update
+     */
+    uint64_t temp = 0;
+    while( temp == 0 ) {
+      // TODO: change to MPI_UINT64_T
+      RMA_Get( &temp, 1, MPI_INT64_T, rank, segment, 1, MPI_INT64_T, hashmap->win_heap_directory );
+      RMA_Win_flush_local( rank, hashmap->win_heap_directory );
+    }
+    *address = (MPI_Aint) temp;
+  }
+
+  return *address + (MPI_Aint)(((index - GDA_HeapSegmentStart( segment, hashmap )) * 4 + word_offset % 4) * sizeof(uint64_t));
+}
+
+
+/**
+  grows the local heap by attaching another segment to the heap window,
+  which is twice as large as the previous one
+
+  local call
+ */
+static void GDA_AttachHeapSegment( GDA_RMAHashMap hashmap ) {
+  size_t segment = hashmap->num_heap_segments;
+  size_t size = hashmap->heap_size_local << segment;
+
+  /**
+    the offsets of the next pointers have to fit into the 32-bit offset
+    of a DPointer
+   */
+  if( (segment == GDA_RMAHASHMAP_MAX_HEAP_SEGMENTS) || (hashmap->heap_capacity_local + size > (UINT64_C(1) << 30)) ) {
+    fprintf( stderr, "RMA_Hashmap: Not enough space on local heap of rank %i. -> will abort\n", hashmap->comm_rank );
+    MPI_Abort( MPI_COMM_WORLD, -1 );
+  }
+
+  GDA_RMAHashMap_Element* base = malloc( size * sizeof(GDA_RMAHashMap_Element) );
+  assert( base != NULL );
+  RMA_Win_attach( hashmap->win_heap, base, size * sizeof(GDA_RMAHashMap_Element) );
+
+  MPI_Aint address;
+  MPI_Get_address( base, &address );
+
+  hashmap->heap_segments[segment] = base;
+  hashmap->heap_directory[segment] = (uint64_t) address;
+  RMA_Win_sync( hashmap->win_heap_directory );
+
+  hashmap->heap_capacity_local += size;
+  hashmap->num_heap_segments++;
+}
+
+
+/**
+  translates the offset of a slot in a table generation of the given rank
+  into a displacement of the dynamic table window
+
+  the addresses of the generations are cached as the heap segments are,
+  since a generation is only detached, once all processes agreed on it
+  (see GDA_MaintainRMAHashMap)
+ */
+static MPI_Aint GDA_TableDisp( uint64_t rank, uint64_t generation, uint64_t t_offset, GDA_RMAHashMap hashmap ) {
+  assert( generation < GDA_RMAHASHMAP_MAX_TABLE_GENERATIONS );
+
+  MPI_Aint* address = &(hashmap->table_directory_cache[rank * GDA_RMAHASHMAP_MAX_TABLE_GENERATIONS + generation]);
+  if( *address == 0 ) {
+    /**
+      a generation is published before any slot refers to it, so this
+      loop will only spin in case of a delayed update
+     */
+    uint64_t temp = 0;
+    while( temp == 0 ) {
+      // TODO: change to MPI_UINT64_T
+      RMA_Get( &temp, 1, MPI_INT64_T, rank, GDA_RMAHASHMAP_DIR_GENERATIONS + generation, 1, MPI_INT64_T, hashmap->win_table_directory );
+      RMA_Win_flush_local( rank, hashmap->win_table_directory );
+    }
+    *address = (MPI_Aint) temp;
+  }
+
+  return *address + (MPI_Aint)(t_offset * sizeof(GDA_DPointer));
+}
+
+
+/**
+  oldest table generation of the given rank, whose slots are not all
+  moved, which is where each operation starts
+ */
+static uint64_t GDA_TableBase( uint64_t rank, GDA_RMAHashMap hashmap ) {
+  uint64_t* base = &(hashmap->table_base_cache[rank]);
+  if( *base == GDA_HASHINT_NULL ) {
+    // TODO: change to MPI_UINT64_T
+    RMA_Get( base, 1, MPI_INT64_T, rank, GDA_RMAHASHMAP_DIR_BASE, 1, MPI_INT64_T, hashmap->win_table_directory );
+    RMA_Win_flush_local( rank, hashmap->win_table_directory );
+  }
+  return *base;
+}
+
+
+/**
+  called for a slot, that forwards to the next generation: if the slot
+  belongs to the cached base generation of the rank, that generation is
+  probably completely moved, so the base is fetched again next time
+ */
+static inline void GDA_SkipMovedSlot( uint64_t rank, uint64_t generation, GDA_RMAHashMap hashmap ) {
+  if( hashmap->table_base_cache[rank] == generation ) {
+    hashmap->table_base_cache[rank] = GDA_HASHINT_NULL;
+  }
+}
+
+
+/**
+  attaches a table generation of the local process to the table window
+  and publishes its address
+
+  local call
+ */
+static void GDA_AttachTableGeneration( uint64_t generation, GDA_RMAHashMap hashmap ) {
+  size_t size = hashmap->table_size_local << generation;
+
+  GDA_DPointer* slots = malloc( size * sizeof(GDA_DPointer) );
+  assert( slots != NULL );
+  for( size_t i=0 ; i<size ; i++ ) {
+    slots[i] = GDA_DPOINTER_NULL;
+  }
+  RMA_Win_attach( hashmap->win_table, slots, size * sizeof(GDA_DPointer) );
+
+  MPI_Aint address;
+  MPI_Get_address( slots, &address );
+
+  hashmap->table_generations[generation] = slots;
+  hashmap->table_directory[GDA_RMAHASHMAP_DIR_GENERATIONS + generation] = (uint64_t) address;
+  RMA_Win_sync( hashmap->win_table_directory );
+}
+
+
+/**
+  local call
+ */
+static void GDA_DetachTableGeneration( uint64_t generation, GDA_RMAHashMap hashmap ) {
+  RMA_Win_detach( hashmap->win_table, hashmap->table_generations[generation] );
+  free( hashmap->table_generations[generation] );
+  hashmap->table_generations[generation] = NULL;
+  hashmap->table_directory[GDA_RMAHASHMAP_DIR_GENERATIONS + generation] = 0;
 }
 
 
@@ -28,6 +295,7 @@ uint64_t hashfunc( uint64_t key, GDA_RMAHashMap hashmap ) {
  */
 void GDA_CreateRMAHashMap( size_t table_size, size_t heap_size, MPI_Comm comm, GDA_RMAHashMap* hashmap ) {
   GDA_RMAHashMap internal_hashmap = malloc( sizeof(GDA_RMAHashMap_desc_t) );
+  assert( internal_hashmap != NULL );
 
   internal_hashmap->comm = comm;
   int temp;
@@ -39,12 +307,29 @@ void GDA_CreateRMAHashMap( size_t table_size, size_t heap_size, MPI_Comm comm, G
   MPI_Comm_rank( comm, &(internal_hashmap->comm_rank) );
 
   internal_hashmap->table_size_local = (table_size + internal_hashmap->comm_size - 1)/internal_hashmap->comm_size;
-  internal_hashmap->heap_size_local = (heap_size + internal_hashmap->comm_size - 1)/internal_hashmap->comm_size;
-
+  if( internal_hashmap->table_size_local == 0 ) {
+    internal_hashmap->table_size_local = 1;
+  }
   internal_hashmap->table_size_total = internal_hashmap->table_size_local * internal_hashmap->comm_size;
+  for( size_t i=0 ; i<GDA_RMAHASHMAP_MAX_TABLE_GENERATIONS ; i++ ) {
+    internal_hashmap->table_generations[i] = NULL;
+  }
+  internal_hashmap->table_base = 0;
+  internal_hashmap->table_current = 0;
+  internal_hashmap->migration_offset = 0;
+  internal_hashmap->num_lookups = 0;
+
+  internal_hashmap->heap_size_local = (heap_size + internal_hashmap->comm_size - 1)/internal_hashmap->comm_size;
+  if( internal_hashmap->heap_size_local == 0 ) {
+    internal_hashmap->heap_size_local = 1;
+  }
+  internal_hashmap->heap_capacity_local = 0;
+  internal_hashmap->num_heap_segments = 0;
 
-  RMA_Win_allocate( internal_hashmap->table_size_local * sizeof(uint64_t), sizeof(uint64_t), MPI_INFO_NULL, comm, &(internal_hashmap->table), &(internal_hashmap->win_table) );
-  RMA_Win_allocate( internal_hashmap->heap_size_local * 4 * sizeof(uint64_t), sizeof(uint64_t), MPI_INFO_NULL, comm, &(internal_hashmap->heap), &(internal_hashmap->win_heap) );
+  RMA_Win_create_dynamic( MPI_INFO_NULL, comm, &(internal_hashmap->win_table) );
+  RMA_Win_allocate( (GDA_RMAHASHMAP_DIR_GENERATIONS + GDA_RMAHASHMAP_MAX_TABLE_GENERATIONS) * sizeof(uint64_t), sizeof(uint64_t), MPI_INFO_NULL, comm, &(internal_hashmap->table_directory), &(internal_hashmap->win_table_directory) );
+  RMA_Win_create_dynamic( MPI_INFO_NULL, comm, &(internal_hashmap->win_heap) );
+  RMA_Win_allocate( GDA_RMAHASHMAP_MAX_HEAP_SEGMENTS * sizeof(uint64_t), sizeof(uint64_t), MPI_INFO_NULL, comm, &(internal_hashmap->heap_directory), &(internal_hashmap->win_heap_directory) );
   RMA_Win_allocate( 2 * sizeof(uint64_t), sizeof(uint64_t), MPI_INFO_NULL, comm, &(internal_hashmap->heap_counter), &(internal_hashmap->win_heap_counter) );
 
   /**
@@ -56,13 +341,42 @@ void GDA_CreateRMAHashMap( size_t table_size, size_t heap_size, MPI_Comm comm, G
    */
   internal_hashmap->heap_counter[1] = GDA_DPOINTER_NULL;
 
+  /**
+    no elements yet, every process starts with generation 0
+   */
+  internal_hashmap->table_directory[GDA_RMAHASHMAP_DIR_COUNT] = 0;
+  internal_hashmap->table_directory[GDA_RMAHASHMAP_DIR_BASE] = 0;
+  for( size_t i=0 ; i<GDA_RMAHASHMAP_MAX_TABLE_GENERATIONS ; i++ ) {
+    internal_hashmap->table_directory[GDA_RMAHASHMAP_DIR_GENERATIONS + i] = 0;
+  }
+
   RMA_Win_lock_all( 0 /* assert */, internal_hashmap->win_table );
+  RMA_Win_lock_all( 0 /* assert */, internal_hashmap->win_table_directory );
   RMA_Win_lock_all( 0 /* assert */, internal_hashmap->win_heap );
+  RMA_Win_lock_all( 0 /* assert */, internal_hashmap->win_heap_directory );
   RMA_Win_lock_all( 0 /* assert */, internal_hashmap->win_heap_counter );
 
-  for( size_t i=0 ; i<internal_hashmap->table_size_local ; i++ ) {
-    internal_hashmap->table[i] = GDA_DPOINTER_NULL;
+  for( size_t i=0 ; i<GDA_RMAHASHMAP_MAX_HEAP_SEGMENTS ; i++ ) {
+    internal_hashmap->heap_directory[i] = 0;
   }
+  internal_hashmap->heap_directory_cache = calloc( internal_hashmap->comm_size * GDA_RMAHASHMAP_MAX_HEAP_SEGMENTS, sizeof(MPI_Aint) );
+  assert( internal_hashmap->heap_directory_cache != NULL );
+  internal_hashmap->table_directory_cache = calloc( internal_hashmap->comm_size * GDA_RMAHASHMAP_MAX_TABLE_GENERATIONS, sizeof(MPI_Aint) );
+  assert( internal_hashmap->table_directory_cache != NULL );
+  internal_hashmap->table_base_cache = calloc( internal_hashmap->comm_size, sizeof(uint64_t) );
+  assert( internal_hashmap->table_base_cache != NULL );
+
+  /**
+    first table generation and heap segment
+   */
+  GDA_AttachTableGeneration( 0, internal_hashmap );
+  GDA_AttachHeapSegment( internal_hashmap );
+
+  /**
+    make sure that the directories are initialized everywhere, before any
+    process accesses them
+   */
+  MPI_Barrier( comm );
 
   *hashmap = internal_hashmap;
 }
@@ -70,16 +384,40 @@ void GDA_CreateRMAHashMap( size_t table_size, size_t heap_size, MPI_Comm comm, G
 
 void GDA_FreeRMAHashMap( GDA_RMAHashMap* hashmap ) {
   RMA_Win_unlock_all( (*hashmap)->win_table );
+  RMA_Win_unlock_all( (*hashmap)->win_table_directory );
   RMA_Win_unlock_all( (*hashmap)->win_heap );
+  RMA_Win_unlock_all( (*hashmap)->win_heap_directory );
   RMA_Win_unlock_all( (*hashmap)->win_heap_counter );
 
+  for( size_t i=0 ; i<GDA_RMAHASHMAP_MAX_TABLE_GENERATIONS ; i++ ) {
+    if( (*hashmap)->table_generations[i] != NULL ) {
+      RMA_Win_detach( (*hashmap)->win_table, (*hashmap)->table_generations[i] );
+    }
+  }
+  for( size_t i=0 ; i<(*hashmap)->num_heap_segments ; i++ ) {
+    RMA_Win_detach( (*hashmap)->win_heap, (*hashmap)->heap_segments[i] );
+  }
+
   RMA_Win_free( &((*hashmap)->win_table) );
+  RMA_Win_free( &((*hashmap)->win_table_directory) );
   RMA_Win_free( &((*hashmap)->win_heap) );
+  RMA_Win_free( &((*hashmap)->win_heap_directory) );
   RMA_Win_free( &((*hashmap)->win_heap_counter) );
 
+  for( size_t i=0 ; i<GDA_RMAHASHMAP_MAX_TABLE_GENERATIONS ; i++ ) {
+    free( (*hashmap)->table_generations[i] );
+  }
+  for( size_t i=0 ; i<(*hashmap)->num_heap_segments ; i++ ) {
+    free( (*hashmap)->heap_segments[i] );
+  }
+  free( (*hashmap)->heap_directory_cache );
+  free( (*hashmap)->table_directory_cache );
+  free( (*hashmap)->table_base_cache );
+
   free( *hashmap );
 }
 
+
 void GDA_DeallocateElementOfRMAHashMap( GDA_DPointer elem, GDA_RMAHashMap hashmap ) {
   uint64_t dp_rank;
   uint64_t dp_offset;
@@ -106,7 +444,7 @@ void GDA_DeallocateElementOfRMAHashMap( GDA_DPointer elem, GDA_RMAHashMap hashma
     // TODO: just an assignment if locally
     // TODO: change to MPI_UINT64_T
     // TODO: should be an accumulate call with MPI_OP_REPLACE
-    RMA_Put( &temp, 1, MPI_INT64_T, dp_rank, dp_offset*4+1 /* offset */, 1 /* size */, MPI_INT64_T, hashmap->win_heap );
+    RMA_Put( &temp, 1, MPI_INT64_T, dp_rank, GDA_HeapDisp( dp_rank, dp_offset*4+1, hashmap ) /* offset */, 1 /* size */, MPI_INT64_T, hashmap->win_heap );
     RMA_Win_flush_local( dp_rank, hashmap->win_heap );
 
     uint64_t swap_result;
@@ -120,129 +458,152 @@ void GDA_DeallocateElementOfRMAHashMap( GDA_DPointer elem, GDA_RMAHashMap hashma
 
 
 /**
-  may cause double inserts if insert same key again
+  returns the index of an unused element on the local heap, the heap
+  grows, if neither unused nor previously freed elements are left
  */
-void GDA_InsertElementIntoRMAHashMap( uint64_t hashed_key, uint64_t key, uint64_t value, uint64_t incarnation, GDA_RMAHashMap hashmap ) {
-  uint64_t hash = hashfunc( hashed_key, hashmap );
-
-  uint64_t t_rank = hash / hashmap->table_size_local;
+static uint64_t GDA_AllocateElementOfRMAHashMap( GDA_RMAHashMap hashmap ) {
+#if 0
+  // right now we don't support the allocation of heap space on remote processes
   /**
-    offset counted in elements
+    add 1
    */
-  // TODO: change this?
-  uint64_t t_offset = hash % hashmap->table_size_local;
+  uint64_t origin = 1;
+  RMA_Fetch_and_op( &origin, &h_offset, MPI_INT64_T, hashmap->comm_rank, /* disp */ 0, RMA_SUM, hashmap->win_heap_counter );
+  RMA_Win_flush_local( hashmap->comm_rank, hashmap->win_heap_counter);
+#endif
+  if( hashmap->heap_counter[0] < hashmap->heap_capacity_local ) {
+    return (hashmap->heap_counter[0])++;
+  }
 
   /**
-    allocate on heap
+    check the linked list for already used elements
    */
-  GDA_DPointer dp;
   uint64_t h_offset;
-
-  /**
-    get a local element
-   */
-  {
-#if 0
-    // right now we don't support the allocation of heap space on remote processes
-    /**
-      add 1
-     */
-    uint64_t origin = 1;
-    RMA_Fetch_and_op( &origin, &h_offset, MPI_INT64_T, hashmap->comm_rank, /* disp */ 0, RMA_SUM, hashmap->win_heap_counter );
-    RMA_Win_flush_local( hashmap->comm_rank, hashmap->win_heap_counter);
-
+  uint64_t swap_result;
+  do {
     /**
-      check if result is not out of bounds:
+      for the first part there is no need for RMA operations
      */
-    if( h_offset >= hashmap->heap_size_local ) {
-#endif
-    if( hashmap->heap_counter[0] < hashmap->heap_size_local ) {
-      h_offset = (hashmap->heap_counter[0])++;
-    } else {
+    h_offset = hashmap->heap_counter[1];
+    if( h_offset == GDA_DPOINTER_NULL ) {
       /**
-        check the linked list for already used elements
+        local heap is exhausted -> attach another segment
        */
-      uint64_t swap_result;
-      do {
-        /**
-          for the first part there is no need for RMA operations
-         */
-        h_offset = hashmap->heap_counter[1];
-        if( h_offset == GDA_DPOINTER_NULL ) {
-          fprintf( stderr, "RMA_Hashmap: Not enough space on local heap of rank %i. -> will abort\n", hashmap->comm_rank );
-          MPI_Abort( MPI_COMM_WORLD, -1 );
-        }
-        uint64_t temp = hashmap->heap[h_offset].value;
-
-        RMA_Compare_and_swap( &temp, &h_offset, &swap_result, MPI_UINT64_T, hashmap->comm_rank, 1 /* offset */, hashmap->win_heap_counter );
-        RMA_Win_flush_local( hashmap->comm_rank, hashmap->win_heap_counter );
-      } while( swap_result != h_offset );
+      GDA_AttachHeapSegment( hashmap );
+      return (hashmap->heap_counter[0])++;
     }
-    GDA_SetDPointer( h_offset, hashmap->comm_rank, &dp );
-  }
+    uint64_t temp = GDA_LocalHeapElement( h_offset, hashmap )->value;
 
-  hashmap->heap[h_offset].key = key;
-  hashmap->heap[h_offset].value = value;
-  hashmap->heap[h_offset].incarnation = incarnation;
+    RMA_Compare_and_swap( &temp, &h_offset, &swap_result, MPI_UINT64_T, hashmap->comm_rank, 1 /* offset */, hashmap->win_heap_counter );
+    RMA_Win_flush_local( hashmap->comm_rank, hashmap->win_heap_counter );
+  } while( swap_result != h_offset );
+
+  return h_offset;
+}
+
+
+/**
+  inserts an element into the chain of its slot in the given table
+  generation, a slot that is migrated (or moved) forwards the element to
+  the next generation
+
+  may cause double inserts if insert same key again
+ */
+static void GDA_InsertElementIntoTable( uint64_t hash, uint64_t key, uint64_t value, uint64_t incarnation, uint64_t generation, GDA_RMAHashMap hashmap ) {
+  uint64_t t_rank = GDA_TableRank( hash, hashmap );
+
+  /**
+    allocate on heap (get a local element)
+   */
+  uint64_t h_offset = GDA_AllocateElementOfRMAHashMap( hashmap );
+  GDA_DPointer dp;
+  GDA_SetDPointer( h_offset, hashmap->comm_rank, &dp );
+
+  GDA_RMAHashMap_Element* element = GDA_LocalHeapElement( h_offset, hashmap );
+  element->key = key;
+  element->value = value;
+  element->incarnation = (hash << 32) | (incarnation & 0x00000000FFFFFFFF);
 
   /**
     fill in (try to swap in in table)
    */
   while (true) {
+    MPI_Aint t_disp = GDA_TableDisp( t_rank, generation, GDA_TableOffset( hash, generation, hashmap ), hashmap );
+
     /**
       read current in table:
      */
+    uint64_t slot;
     // TODO: change to MPI_UINT64_T
     // TODO: should be a fetch_and_op call with MPI_NO_OP
-    RMA_Get( &(hashmap->heap[h_offset].next), 1, MPI_INT64_T, t_rank, t_offset, 1, MPI_INT64_T, hashmap->win_table );
+    RMA_Get( &slot, 1, MPI_INT64_T, t_rank, t_disp, 1, MPI_INT64_T, hashmap->win_table );
     RMA_Win_flush_local( t_rank, hashmap->win_table );
 
+    if( slot == GDA_RMAHASHMAP_SLOT_MOVED ) {
+      GDA_SkipMovedSlot( t_rank, generation, hashmap );
+      generation++;
+      continue;
+    }
+
+    if( GDA_SlotIsMigrating( slot ) ) {
+      /**
+        no new elements are added to a slot, that is migrated
+       */
+      generation++;
+      continue;
+    }
+
+    element->next = slot;
+
     /**
       swap element in
      */
     uint64_t swap_result;
-    RMA_Compare_and_swap( &dp, &(hashmap->heap[h_offset].next), &swap_result, MPI_UINT64_T, t_rank, t_offset, hashmap->win_table );
+    RMA_Compare_and_swap( &dp, &(element->next), &swap_result, MPI_UINT64_T, t_rank, t_disp, hashmap->win_table );
     RMA_Win_flush_local( t_rank, hashmap->win_table );
 
-    if( swap_result == hashmap->heap[h_offset].next ) {
+    if( swap_result == element->next ) {
       return;
     }
   }
 }
 
 
-void GDA_FindElementInRMAHashMap( uint64_t hashed_key, uint64_t key, uint64_t* value, uint64_t* incarnation, bool* found_flag, GDA_RMAHashMap hashmap ) {
-  uint64_t hash = hashfunc( hashed_key, hashmap );
+/**
+  looks up the key in the chain of its slot in the given table generation
 
-  uint64_t t_rank = hash / hashmap->table_size_local;
-  /**
-    counted in elements
-   */
-  // TODO: change this?
-  uint64_t t_offset = hash % hashmap->table_size_local;
+  returns true, if the key was not found and the lookup has to continue
+  in the next generation, since the slot is migrated (or moved)
+ */
+static bool GDA_FindElementInTable( uint64_t hash, uint64_t key, uint64_t* value, uint64_t* incarnation, bool* found_flag, uint64_t generation, GDA_RMAHashMap hashmap ) {
+  uint64_t t_rank = GDA_TableRank( hash, hashmap );
+  MPI_Aint t_disp = GDA_TableDisp( t_rank, generation, GDA_TableOffset( hash, generation, hashmap ), hashmap );
+
+  *found_flag = false;
+  *value = GDA_DPOINTER_NULL;
 
   /**
     check table
    */
-  GDA_DPointer dp;
+  uint64_t slot;
   // TODO: change to MPI_UINT64_T
   // TODO: should be a fetch_and_op call with MPI_NO_OP
-  RMA_Get( &dp, 1, MPI_INT64_T, t_rank, t_offset, 1, MPI_INT64_T, hashmap->win_table );
+  RMA_Get( &slot, 1, MPI_INT64_T, t_rank, t_disp, 1, MPI_INT64_T, hashmap->win_table );
+  GDA_Yield();
   RMA_Win_flush_local( t_rank, hashmap->win_table );
 
-  if( dp == GDA_DPOINTER_NULL ) {
-    /**
-      empty table slot
-     */
-    *found_flag = false;
-    *value = GDA_DPOINTER_NULL;
-    return;
+  if( slot == GDA_RMAHASHMAP_SLOT_MOVED ) {
+    GDA_SkipMovedSlot( t_rank, generation, hashmap );
+    return true;
   }
 
+  bool migrating_flag = GDA_SlotIsMigrating( slot );
+
   /**
     chase down the list
    */
-  while( true ) {
+  GDA_DPointer dp = GDA_SlotHead( slot );
+  while( dp != GDA_DPOINTER_NULL ) {
     /**
       fetch element (at dp)
      */
@@ -253,16 +614,17 @@ void GDA_FindElementInRMAHashMap( uint64_t hashed_key, uint64_t key, uint64_t* v
     GDA_RMAHashMap_Element element;
     // TODO: change to MPI_UINT64_T
     // TODO: should be a get_accumulate call with MPI_NO_OP
-    RMA_Get( &element, 4, MPI_INT64_T, dp_rank, dp_offset * 4, 4, MPI_INT64_T, hashmap->win_heap );
+    RMA_Get( &element, 4, MPI_INT64_T, dp_rank, GDA_HeapDisp( dp_rank, dp_offset * 4, hashmap ), 4, MPI_INT64_T, hashmap->win_heap );
+    GDA_Yield();
     RMA_Win_flush_local( dp_rank, hashmap->win_heap );
 
     if( element.next == dp ) {
       /**
-        element points to itself -> in process of getting deleted
+        element points to itself -> in process of getting deleted (or
+        moved into the next generation)
         restart from the beginning
        */
-      GDA_FindElementInRMAHashMap( hashed_key, key, value, incarnation, found_flag, hashmap );
-      return;
+      return GDA_FindElementInTable( hash, key, value, incarnation, found_flag, generation, hashmap );
     }
 
     if (element.key == key) {
@@ -271,55 +633,212 @@ void GDA_FindElementInRMAHashMap( uint64_t hashed_key, uint64_t key, uint64_t* v
        */
       *found_flag = true;
       *value = element.value;
-      *incarnation = element.incarnation;
-      return;
+      *incarnation = element.incarnation & 0x00000000FFFFFFFF;
+      return false;
     }
 
     /**
       not the element in question -> iterate
      */
     dp = element.next;
-    if( dp == GDA_DPOINTER_NULL ) {
-      /**
-        element was not found
-       */
-      *found_flag = false;
-      *value = GDA_DPOINTER_NULL;
-      return;
+  }
+
+  /**
+    element was not found
+   */
+  return migrating_flag;
+}
+
+
+/**
+  state of a single lookup in GDA_FindElementsInTable:
+  GDA_LOOKUP_TABLE - table slot has to be fetched
+  GDA_LOOKUP_CHAIN - element at the current DPointer has to be fetched
+  GDA_LOOKUP_DONE  - lookup is finished
+ */
+#define GDA_LOOKUP_TABLE 0
+#define GDA_LOOKUP_CHAIN 1
+#define GDA_LOOKUP_DONE  2
+
+/**
+  batched version of GDA_FindElementInTable
+
+  All lookups advance in lockstep: in the first round the table slots of
+  all keys are fetched, in the following rounds the next element of all
+  chains, that are not resolved yet. Each round issues the gets of all
+  keys to their respective owner ranks before it waits for their
+  completion, so the latency of the whole batch is bounded by the longest
+  chain instead of the sum of all lookups.
+
+  A key, whose current element is in the process of getting deleted,
+  restarts from its table slot in the next round (as in the single
+  lookup). A key, whose slot is migrated, continues with its slot in the
+  next generation. Keys, whose found flag is already set, are skipped.
+ */
+static void GDA_FindElementsInTable( size_t count, const uint64_t* hashes, const uint64_t* keys, uint64_t* values, uint64_t* incarnations, bool* found_flags, GDA_RMAHashMap hashmap ) {
+  uint8_t* state = malloc( count * sizeof(uint8_t) );
+  assert( state != NULL );
+  GDA_DPointer* dps = malloc( count * sizeof(GDA_DPointer) );
+  assert( dps != NULL );
+  GDA_RMAHashMap_Element* elements = malloc( count * sizeof(GDA_RMAHashMap_Element) );
+  assert( elements != NULL );
+  uint64_t* generations = malloc( count * sizeof(uint64_t) );
+  assert( generations != NULL );
+  bool* migrating_flags = malloc( count * sizeof(bool) );
+  assert( migrating_flags != NULL );
+
+  size_t active = 0;
+  for( size_t i=0 ; i<count ; i++ ) {
+    if( found_flags[i] ) {
+      state[i] = GDA_LOOKUP_DONE;
+    } else {
+      state[i] = GDA_LOOKUP_TABLE;
+      generations[i] = GDA_TableBase( GDA_TableRank( hashes[i], hashmap ), hashmap );
+      active++;
+    }
+  }
+
+  while( active > 0 ) {
+    bool table_flag = false;
+    bool heap_flag = false;
+
+    /**
+      issue one get for every unresolved key
+     */
+    for( size_t i=0 ; i<count ; i++ ) {
+      if( state[i] == GDA_LOOKUP_TABLE ) {
+        uint64_t t_rank = GDA_TableRank( hashes[i], hashmap );
+        MPI_Aint t_disp = GDA_TableDisp( t_rank, generations[i], GDA_TableOffset( hashes[i], generations[i], hashmap ), hashmap );
+
+        // TODO: change to MPI_UINT64_T
+        RMA_Get( &(dps[i]), 1, MPI_INT64_T, t_rank, t_disp, 1, MPI_INT64_T, hashmap->win_table );
+        table_flag = true;
+      } else {
+        if( state[i] == GDA_LOOKUP_CHAIN ) {
+          uint64_t dp_rank;
+          uint64_t dp_offset;
+          GDA_GetDPointer( &dp_offset, &dp_rank, dps[i] );
+
+          // TODO: change to MPI_UINT64_T
+          RMA_Get( &(elements[i]), 4, MPI_INT64_T, dp_rank, GDA_HeapDisp( dp_rank, dp_offset * 4, hashmap ), 4, MPI_INT64_T, hashmap->win_heap );
+          heap_flag = true;
+        }
+      }
+    }
+
+    GDA_Yield();
+    if( table_flag ) {
+      RMA_Win_flush_local_all( hashmap->win_table );
+    }
+    if( heap_flag ) {
+      RMA_Win_flush_local_all( hashmap->win_heap );
+    }
+
+    /**
+      evaluate the results of this round
+     */
+    for( size_t i=0 ; i<count ; i++ ) {
+      bool end_flag = false;
+
+      if( state[i] == GDA_LOOKUP_TABLE ) {
+        if( dps[i] == GDA_RMAHASHMAP_SLOT_MOVED ) {
+          GDA_SkipMovedSlot( GDA_TableRank( hashes[i], hashmap ), generations[i], hashmap );
+          generations[i]++;
+        } else {
+          migrating_flags[i] = GDA_SlotIsMigrating( dps[i] );
+          dps[i] = GDA_SlotHead( dps[i] );
+          if( dps[i] == GDA_DPOINTER_NULL ) {
+            /**
+              empty table slot
+             */
+            end_flag = true;
+          } else {
+            state[i] = GDA_LOOKUP_CHAIN;
+          }
+        }
+      } else {
+        if( state[i] == GDA_LOOKUP_CHAIN ) {
+          if( elements[i].next == dps[i] ) {
+            /**
+              element points to itself -> in process of getting deleted
+              restart from the beginning
+             */
+            state[i] = GDA_LOOKUP_TABLE;
+          } else {
+            if( elements[i].key == keys[i] ) {
+              /**
+                found the element
+               */
+              found_flags[i] = true;
+              values[i] = elements[i].value;
+              incarnations[i] = elements[i].incarnation & 0x00000000FFFFFFFF;
+              state[i] = GDA_LOOKUP_DONE;
+              active--;
+            } else {
+              /**
+                not the element in question -> iterate
+               */
+              dps[i] = elements[i].next;
+              if( dps[i] == GDA_DPOINTER_NULL ) {
+                end_flag = true;
+              }
+            }
+          }
+        }
+      }
+
+      if( end_flag ) {
+        /**
+          end of the chain: continue in the next generation, if the slot
+          is migrated
+         */
+        if( migrating_flags[i] ) {
+          generations[i]++;
+          state[i] = GDA_LOOKUP_TABLE;
+        } else {
+          state[i] = GDA_LOOKUP_DONE;
+          active--;
+        }
+      }
     }
   }
+
+  free( migrating_flags );
+  free( generations );
+  free( elements );
+  free( dps );
+  free( state );
 }
 
 
 /**
-  same code as GDA_RemoveElementFromRMAHashMap()
-  but already marked the element for deletion, so we only need to repair the linked list
+  same code as GDA_RemoveElementFromTable()
+  but already marked the element at elem for deletion, so we only need to repair the linked list
+
+  The element is identified by its DPointer. It stays in the chain of its
+  slot in the given generation, until it is unlinked here, since neither
+  a removal nor a migration can take over a marked element.
 
   TODO: Can it happen, that two ranks try to remove the same key, and one wins the first CAS and the other one the second?
  */
-bool GDA_RemoveElementFromRMAHashMap_internal( uint64_t hashed_key, uint64_t key, uint64_t next, GDA_RMAHashMap hashmap ) {
-  uint64_t hash = hashfunc( hashed_key, hashmap );
-
-  uint64_t t_rank = hash / hashmap->table_size_local;
-  /**
-    counted in elements
-   */
-  // TODO: change this?
-  uint64_t t_offset = hash % hashmap->table_size_local;
+static bool GDA_RemoveElementFromTable_internal( uint64_t hash, GDA_DPointer elem, uint64_t next, uint64_t generation, GDA_RMAHashMap hashmap ) {
+  uint64_t t_rank = GDA_TableRank( hash, hashmap );
+  MPI_Aint t_disp = GDA_TableDisp( t_rank, generation, GDA_TableOffset( hash, generation, hashmap ), hashmap );
 
   /**
     check table
    */
-  GDA_DPointer dp;
+  uint64_t slot;
   // TODO: change to MPI_UINT64_T
   // TODO: should be a fetch_and_op call with MPI_NO_OP
-  RMA_Get( &dp, 1, MPI_INT64_T, t_rank, t_offset, 1, MPI_INT64_T, hashmap->win_table );
+  RMA_Get( &slot, 1, MPI_INT64_T, t_rank, t_disp, 1, MPI_INT64_T, hashmap->win_table );
   RMA_Win_flush_local( t_rank, hashmap->win_table );
 
   /**
     table can never be empty
    */
   // TODO: only for debug
+  GDA_DPointer dp = GDA_SlotHead( slot );
   if( dp == GDA_DPOINTER_NULL ) {
     /**
       empty table slot
@@ -343,16 +862,16 @@ bool GDA_RemoveElementFromRMAHashMap_internal( uint64_t hashed_key, uint64_t key
 
   // TODO: change to MPI_UINT64_T
   // TODO: should be a get_accumulate call with MPI_NO_OP
-  RMA_Get( &element, 4, MPI_INT64_T, dp_rank, dp_offset * 4, 4, MPI_INT64_T, hashmap->win_heap );
+  RMA_Get( &element, 4, MPI_INT64_T, dp_rank, GDA_HeapDisp( dp_rank, dp_offset * 4, hashmap ), 4, MPI_INT64_T, hashmap->win_heap );
   RMA_Win_flush_local( dp_rank, hashmap->win_heap );
 
   if( element.next == dp ) {
-    if( element.key != key ) {
+    if( dp != elem ) {
       /**
         element points to itself -> in process of getting deleted
         restart from the beginning
        */
-      return GDA_RemoveElementFromRMAHashMap_internal( hashed_key, key, next, hashmap );
+      return GDA_RemoveElementFromTable_internal( hash, elem, next, generation, hashmap );
     } else {
       /**
         found element
@@ -360,12 +879,14 @@ bool GDA_RemoveElementFromRMAHashMap_internal( uint64_t hashed_key, uint64_t key
       uint64_t swap_result;
 
       /**
-        element is marked for deletion: use table this time
+        element is marked for deletion: use table this time (and keep
+        the migration flag of the slot)
        */
-      RMA_Compare_and_swap( &next, &dp /* compare */, &swap_result, MPI_UINT64_T, t_rank, t_offset, hashmap->win_table );
+      uint64_t new_slot = GDA_SlotValue( next, GDA_SlotIsMigrating( slot ) );
+      RMA_Compare_and_swap( &new_slot, &slot /* compare */, &swap_result, MPI_UINT64_T, t_rank, t_disp, hashmap->win_table );
       RMA_Win_flush_local( t_rank, hashmap->win_table );
 
-      if( swap_result == dp ) {
+      if( swap_result == slot ) {
         GDA_DeallocateElementOfRMAHashMap( dp, hashmap );
         return true; // tested
       } else {
@@ -373,7 +894,7 @@ bool GDA_RemoveElementFromRMAHashMap_internal( uint64_t hashed_key, uint64_t key
           failed to update the previous element
           have to restart but still have to remember the pointer to the next element
          */
-        return GDA_RemoveElementFromRMAHashMap_internal( hashed_key, key, next, hashmap );
+        return GDA_RemoveElementFromTable_internal( hash, elem, next, generation, hashmap );
       }
     }
   }
@@ -400,23 +921,23 @@ bool GDA_RemoveElementFromRMAHashMap_internal( uint64_t hashed_key, uint64_t key
 
     // TODO: change to MPI_UINT64_T
     // TODO: should be a get_accumlate call with MPI_NO_OP
-    RMA_Get( &element, 4, MPI_INT64_T, dp_rank, dp_offset * 4, 4, MPI_INT64_T, hashmap->win_heap );
+    RMA_Get( &element, 4, MPI_INT64_T, dp_rank, GDA_HeapDisp( dp_rank, dp_offset * 4, hashmap ), 4, MPI_INT64_T, hashmap->win_heap );
     RMA_Win_flush_local( dp_rank, hashmap->win_heap );
 
     if( element.next == dp ) {
-      if( element.key != key ) {
+      if( dp != elem ) {
         /**
           element points to itself -> in process of getting deleted
           restart from the beginning
          */
-        return GDA_RemoveElementFromRMAHashMap_internal( hashed_key, key, next, hashmap );
+        return GDA_RemoveElementFromTable_internal( hash, elem, next, generation, hashmap );
       } else {
         // found element
         uint64_t swap_result;
 
         // element is marked for deletion
         GDA_GetDPointer( &dp_offset, &dp_rank, previous );
-        RMA_Compare_and_swap( &next, &dp /* compare */, &swap_result, MPI_UINT64_T, dp_rank, dp_offset, hashmap->win_heap );
+        RMA_Compare_and_swap( &next, &dp /* compare */, &swap_result, MPI_UINT64_T, dp_rank, GDA_HeapDisp( dp_rank, dp_offset, hashmap ), hashmap->win_heap );
         RMA_Win_flush_local( dp_rank, hashmap->win_heap );
 
         if( swap_result == dp ) {
@@ -427,7 +948,7 @@ bool GDA_RemoveElementFromRMAHashMap_internal( uint64_t hashed_key, uint64_t key
             failed to update the previous element
             have to restart but still have to remember the pointer to the next element
            */
-          return GDA_RemoveElementFromRMAHashMap_internal( hashed_key, key, next, hashmap );
+          return GDA_RemoveElementFromTable_internal( hash, elem, next, generation, hashmap );
         }
       }
     }
@@ -445,29 +966,42 @@ bool GDA_RemoveElementFromRMAHashMap_internal( uint64_t hashed_key, uint64_t key
 }
 
 
-bool GDA_RemoveElementFromRMAHashMap( uint64_t hashed_key, uint64_t key, GDA_RMAHashMap hashmap ) {
-  uint64_t hash = hashfunc( hashed_key, hashmap );
+/**
+  removes an element, that matches key and value (see
+  GDA_ElementMatches), from the chain of its slot in the given table
+  generation
 
-  uint64_t t_rank = hash / hashmap->table_size_local;
-  /**
-    offset counted in elements
-   */
-  // TODO: change this?
-  uint64_t t_offset = hash % hashmap->table_size_local;
+  next_flag is set, if no element was found and the removal has to
+  continue in the next generation, since the slot is migrated (or moved)
+ */
+static bool GDA_RemoveElementFromTable( uint64_t hash, uint64_t key, uint64_t value, uint64_t generation, bool* next_flag, GDA_RMAHashMap hashmap ) {
+  uint64_t t_rank = GDA_TableRank( hash, hashmap );
+  MPI_Aint t_disp = GDA_TableDisp( t_rank, generation, GDA_TableOffset( hash, generation, hashmap ), hashmap );
+
+  *next_flag = false;
 
   /**
     check table
    */
-  GDA_DPointer dp;
+  uint64_t slot;
   // TODO: change to MPI_UINT64_T
   // TODO: should be a fetch_and_op call with MPI_NO_OP
-  RMA_Get( &dp, 1, MPI_INT64_T, t_rank, t_offset, 1, MPI_INT64_T, hashmap->win_table );
+  RMA_Get( &slot, 1, MPI_INT64_T, t_rank, t_disp, 1, MPI_INT64_T, hashmap->win_table );
   RMA_Win_flush_local( t_rank, hashmap->win_table );
 
+  if( slot == GDA_RMAHASHMAP_SLOT_MOVED ) {
+    GDA_SkipMovedSlot( t_rank, generation, hashmap );
+    *next_flag = true;
+    return false;
+  }
+
+  bool migrating_flag = GDA_SlotIsMigrating( slot );
+  GDA_DPointer dp = GDA_SlotHead( slot );
   if( dp == GDA_DPOINTER_NULL ) {
     /**
       empty table slot
      */
+    *next_flag = migrating_flag;
     return false; // tested
   }
 
@@ -487,7 +1021,7 @@ bool GDA_RemoveElementFromRMAHashMap( uint64_t hashed_key, uint64_t key, GDA_RMA
 
   // TODO: change to MPI_UINT64_T
   // TODO: should be a get_accumulate call with MPI_NO_OP
-  RMA_Get( &element, 4, MPI_INT64_T, dp_rank, dp_offset * 4, 4, MPI_INT64_T, hashmap->win_heap );
+  RMA_Get( &element, 4, MPI_INT64_T, dp_rank, GDA_HeapDisp( dp_rank, dp_offset * 4, hashmap ), 4, MPI_INT64_T, hashmap->win_heap );
   RMA_Win_flush_local( dp_rank, hashmap->win_heap );
 
   if( element.next == dp ) {
@@ -495,15 +1029,15 @@ bool GDA_RemoveElementFromRMAHashMap( uint64_t hashed_key, uint64_t key, GDA_RMA
       element points to itself -> in process of getting deleted
       restart from the beginning
      */
-    return GDA_RemoveElementFromRMAHashMap( hashed_key, key, hashmap );
+    return GDA_RemoveElementFromTable( hash, key, value, generation, next_flag, hashmap );
   }
 
-  if (element.key == key) {
+  if( GDA_ElementMatches( &element, key, value ) ) {
     /**
       found element
      */
     uint64_t swap_result;
-    RMA_Compare_and_swap( &dp, &(element.next) /* compare */, &swap_result, MPI_UINT64_T, dp_rank, dp_offset * 4 + 3, hashmap->win_heap );
+    RMA_Compare_and_swap( &dp, &(element.next) /* compare */, &swap_result, MPI_UINT64_T, dp_rank, GDA_HeapDisp( dp_rank, dp_offset * 4 + 3, hashmap ), hashmap->win_heap );
     RMA_Win_flush_local( dp_rank, hashmap->win_heap );
 
     if( swap_result != element.next ) {
@@ -512,16 +1046,18 @@ bool GDA_RemoveElementFromRMAHashMap( uint64_t hashed_key, uint64_t key, GDA_RMA
         element, or a deletion of the next element is in progress
         -> restart from the beginning
        */
-      return GDA_RemoveElementFromRMAHashMap( hashed_key, key, hashmap );
+      return GDA_RemoveElementFromTable( hash, key, value, generation, next_flag, hashmap );
     }
 
     /**
-      element is marked for deletion: use table this time
+      element is marked for deletion: use table this time (and keep the
+      migration flag of the slot)
       */
-    RMA_Compare_and_swap( &(element.next), &dp /* compare */, &swap_result, MPI_UINT64_T, t_rank, t_offset, hashmap->win_table );
+    uint64_t new_slot = GDA_SlotValue( element.next, migrating_flag );
+    RMA_Compare_and_swap( &new_slot, &slot /* compare */, &swap_result, MPI_UINT64_T, t_rank, t_disp, hashmap->win_table );
     RMA_Win_flush_local( t_rank, hashmap->win_table );
 
-    if( swap_result == dp ) {
+    if( swap_result == slot ) {
       GDA_DeallocateElementOfRMAHashMap( dp, hashmap );
       return true; // tested
     } else {
@@ -530,7 +1066,7 @@ bool GDA_RemoveElementFromRMAHashMap( uint64_t hashed_key, uint64_t key, GDA_RMA
         have to restart but still have to remember the pointer to the
         next element
        */
-      return GDA_RemoveElementFromRMAHashMap_internal( hashed_key, key, element.next, hashmap );
+      return GDA_RemoveElementFromTable_internal( hash, dp, element.next, generation, hashmap );
     }
   }
 
@@ -541,6 +1077,7 @@ bool GDA_RemoveElementFromRMAHashMap( uint64_t hashed_key, uint64_t key, GDA_RMA
   GDA_SetDPointer( dp_offset * 4 + 3, dp_rank, &previous );
   dp = element.next;
   if( dp == GDA_DPOINTER_NULL ) {
+    *next_flag = migrating_flag;
     return false; // tested
   }
 
@@ -555,7 +1092,7 @@ bool GDA_RemoveElementFromRMAHashMap( uint64_t hashed_key, uint64_t key, GDA_RMA
 
     // TODO: change to MPI_UINT64_T
     // TODO: should be a get_accumulate call with MPI_NO_OP
-    RMA_Get( &element, 4, MPI_INT64_T, dp_rank, dp_offset * 4, 4, MPI_INT64_T, hashmap->win_heap );
+    RMA_Get( &element, 4, MPI_INT64_T, dp_rank, GDA_HeapDisp( dp_rank, dp_offset * 4, hashmap ), 4, MPI_INT64_T, hashmap->win_heap );
     RMA_Win_flush_local( dp_rank, hashmap->win_heap );
 
     if( element.next == dp ) {
@@ -563,15 +1100,15 @@ bool GDA_RemoveElementFromRMAHashMap( uint64_t hashed_key, uint64_t key, GDA_RMA
         element points to itself -> in process of getting deleted
         restart from the beginning
        */
-      return GDA_RemoveElementFromRMAHashMap( hashed_key, key, hashmap );
+      return GDA_RemoveElementFromTable( hash, key, value, generation, next_flag, hashmap );
     }
 
-    if( element.key == key ) {
+    if( GDA_ElementMatches( &element, key, value ) ) {
       /**
         found element
        */
       uint64_t swap_result;
-      RMA_Compare_and_swap( &dp, &(element.next) /* compare */, &swap_result, MPI_UINT64_T, dp_rank, dp_offset * 4 + 3, hashmap->win_heap );
+      RMA_Compare_and_swap( &dp, &(element.next) /* compare */, &swap_result, MPI_UINT64_T, dp_rank, GDA_HeapDisp( dp_rank, dp_offset * 4 + 3, hashmap ), hashmap->win_heap );
       RMA_Win_flush_local( dp_rank, hashmap->win_heap );
 
       if( swap_result != element.next ) {
@@ -580,14 +1117,15 @@ bool GDA_RemoveElementFromRMAHashMap( uint64_t hashed_key, uint64_t key, GDA_RMA
           element, or a deletion of the next element is in progress
           -> restart from the beginning
          */
-        return GDA_RemoveElementFromRMAHashMap( hashed_key, key, hashmap );
+        return GDA_RemoveElementFromTable( hash, key, value, generation, next_flag, hashmap );
       }
 
       /**
         element is marked for deletion
        */
+      GDA_DPointer elem = dp;
       GDA_GetDPointer( &dp_offset, &dp_rank, previous );
-      RMA_Compare_and_swap( &(element.next), &dp /* compare */, &swap_result, MPI_UINT64_T, dp_rank, dp_offset, hashmap->win_heap );
+      RMA_Compare_and_swap( &(element.next), &dp /* compare */, &swap_result, MPI_UINT64_T, dp_rank, GDA_HeapDisp( dp_rank, dp_offset, hashmap ), hashmap->win_heap );
       RMA_Win_flush_local( dp_rank, hashmap->win_heap );
 
       if( swap_result == dp ) {
@@ -598,7 +1136,7 @@ bool GDA_RemoveElementFromRMAHashMap( uint64_t hashed_key, uint64_t key, GDA_RMA
           failed to update the previous element
           have to restart but still have to remember the pointer to the next element
          */
-        return GDA_RemoveElementFromRMAHashMap_internal( hashed_key, key, element.next, hashmap );
+        return GDA_RemoveElementFromTable_internal( hash, elem, element.next, generation, hashmap );
       }
     }
 
@@ -608,7 +1146,475 @@ bool GDA_RemoveElementFromRMAHashMap( uint64_t hashed_key, uint64_t key, GDA_RMA
     GDA_SetDPointer( dp_offset * 4 + 3, dp_rank, &previous );
     dp = element.next;
     if( dp == GDA_DPOINTER_NULL ) {
+      *next_flag = migrating_flag;
       return false; // tested
     }
   }
 }
+
+
+/**
+  adds diff to the number of elements in the slots of the given rank
+ */
+static void GDA_CountElementsOfRMAHashMap( uint64_t t_rank, int64_t diff, GDA_RMAHashMap hashmap ) {
+  RMA_Accumulate( &diff, 1, MPI_INT64_T, t_rank, GDA_RMAHASHMAP_DIR_COUNT, 1, MPI_INT64_T, RMA_SUM, hashmap->win_table_directory );
+  RMA_Win_flush( t_rank, hashmap->win_table_directory );
+}
+
+
+/**
+  returns the number of elements in the table slots of the local process
+  (the sum over all processes is the number of elements)
+ */
+int64_t GDA_NumLocalElementsOfRMAHashMap( GDA_RMAHashMap hashmap ) {
+  int64_t num_elements;
+  RMA_Fetch_and_op( NULL, &num_elements, MPI_INT64_T, hashmap->comm_rank, GDA_RMAHASHMAP_DIR_COUNT, RMA_NO_OP, hashmap->win_table_directory );
+  RMA_Win_flush_local( hashmap->comm_rank, hashmap->win_table_directory );
+  return num_elements;
+}
+
+
+/**
+  moves all elements of a local slot of the base generation into the next
+  generation
+
+  The slot is flagged first, so that new elements go into the next
+  generation and lookups check both generations. Then the first element
+  of the chain is marked for deletion, so that lookups and removals, that
+  reach it, restart, copied into the next generation and unlinked
+  afterwards. A lookup therefore either sees the element or its copy. If
+  another process marked the element first, it removes the element
+  instead. Once the chain is empty, the slot forwards all operations to
+  the next generation.
+
+  local call
+ */
+static void GDA_MigrateSlotOfRMAHashMap( uint64_t t_offset, GDA_RMAHashMap hashmap ) {
+  uint64_t t_rank = hashmap->comm_rank;
+  uint64_t generation = hashmap->table_base;
+  MPI_Aint t_disp = GDA_TableDisp( t_rank, generation, t_offset, hashmap );
+
+  while( true ) {
+    uint64_t slot;
+    // TODO: change to MPI_UINT64_T
+    RMA_Get( &slot, 1, MPI_INT64_T, t_rank, t_disp, 1, MPI_INT64_T, hashmap->win_table );
+    RMA_Win_flush_local( t_rank, hashmap->win_table );
+
+    if( slot == GDA_RMAHASHMAP_SLOT_MOVED ) {
+      return;
+    }
+
+    uint64_t swap_result;
+    if( !GDA_SlotIsMigrating( slot ) ) {
+      /**
+        flag the slot, retry if an element was added or removed meanwhile
+       */
+      uint64_t new_slot = GDA_SlotValue( slot, true );
+      RMA_Compare_and_swap( &new_slot, &slot /* compare */, &swap_result, MPI_UINT64_T, t_rank, t_disp, hashmap->win_table );
+      RMA_Win_flush_local( t_rank, hashmap->win_table );
+      continue;
+    }
+
+    if( slot == GDA_RMAHASHMAP_SLOT_MIGRATING_NULL ) {
+      /**
+        chain is empty and no element is added anymore
+       */
+      uint64_t new_slot = GDA_RMAHASHMAP_SLOT_MOVED;
+      RMA_Compare_and_swap( &new_slot, &slot /* compare */, &swap_result, MPI_UINT64_T, t_rank, t_disp, hashmap->win_table );
+      RMA_Win_flush_local( t_rank, hashmap->win_table );
+      continue;
+    }
+
+    GDA_DPointer dp = GDA_SlotHead( slot );
+    uint64_t dp_rank;
+    uint64_t dp_offset;
+    GDA_GetDPointer( &dp_offset, &dp_rank, dp );
+
+    GDA_RMAHashMap_Element element;
+    // TODO: change to MPI_UINT64_T
+    RMA_Get( &element, 4, MPI_INT64_T, dp_rank, GDA_HeapDisp( dp_rank, dp_offset * 4, hashmap ), 4, MPI_INT64_T, hashmap->win_heap );
+    RMA_Win_flush_local( dp_rank, hashmap->win_heap );
+
+    if( element.next == dp ) {
+      /**
+        element is in process of getting deleted -> look again
+       */
+      continue;
+    }
+
+    RMA_Compare_and_swap( &dp, &(element.next) /* compare */, &swap_result, MPI_UINT64_T, dp_rank, GDA_HeapDisp( dp_rank, dp_offset * 4 + 3, hashmap ), hashmap->win_heap );
+    RMA_Win_flush_local( dp_rank, hashmap->win_heap );
+
+    if( swap_result != element.next ) {
+      /**
+        another process marked the element or the next one
+       */
+      continue;
+    }
+
+    uint64_t hash = element.incarnation >> 32;
+    GDA_InsertElementIntoTable( hash, element.key, element.value, element.incarnation, generation + 1, hashmap );
+    GDA_RemoveElementFromTable_internal( hash, dp, element.next, generation, hashmap );
+  }
+}
+
+
+/**
+  migrates up to num_slots local slots of the base generation during a
+  rehash, and publishes the next generation as the new base, once all
+  slots are moved
+
+  local call
+ */
+static void GDA_MigrateRMAHashMap( size_t num_slots, GDA_RMAHashMap hashmap ) {
+  while( (num_slots > 0) && (hashmap->table_base != hashmap->table_current) ) {
+    GDA_MigrateSlotOfRMAHashMap( hashmap->migration_offset, hashmap );
+    hashmap->migration_offset++;
+    num_slots--;
+
+    if( hashmap->migration_offset == (hashmap->table_size_local << hashmap->table_base) ) {
+      hashmap->table_base++;
+      hashmap->migration_offset = 0;
+
+      hashmap->table_directory[GDA_RMAHASHMAP_DIR_BASE] = hashmap->table_base;
+      RMA_Win_sync( hashmap->win_table_directory );
+      hashmap->table_base_cache[hashmap->comm_rank] = hashmap->table_base;
+    }
+  }
+}
+
+
+/**
+  starts a rehash of the local part of the table, once the number of
+  elements in its slots exceeds GDA_RMAHASHMAP_MAX_LOAD_FACTOR times the
+  number of slots, unless a rehash is already in progress
+
+  returns true, if a rehash was started
+
+  local call
+ */
+static bool GDA_CheckLoadOfRMAHashMap( GDA_RMAHashMap hashmap ) {
+  if( (hashmap->table_base != hashmap->table_current) || (hashmap->table_current + 1 == GDA_RMAHASHMAP_MAX_TABLE_GENERATIONS) ) {
+    return false;
+  }
+
+  int64_t num_elements = GDA_NumLocalElementsOfRMAHashMap( hashmap );
+  if( num_elements <= (int64_t)(GDA_RMAHASHMAP_MAX_LOAD_FACTOR * (hashmap->table_size_local << hashmap->table_current)) ) {
+    return false;
+  }
+
+  GDA_AttachTableGeneration( hashmap->table_current + 1, hashmap );
+  hashmap->table_current++;
+  hashmap->migration_offset = 0;
+
+  return true;
+}
+
+
+/**
+  advances a rehash of the local part of the table alongside an operation
+  of the local process, or checks whether one is needed (lookups only
+  check every GDA_RMAHASHMAP_CHECK_INTERVAL calls)
+
+  local call
+ */
+static void GDA_ProgressRMAHashMap( bool check_flag, GDA_RMAHashMap hashmap ) {
+  if( hashmap->table_base != hashmap->table_current ) {
+    GDA_MigrateRMAHashMap( GDA_RMAHASHMAP_MIGRATION_STEP, hashmap );
+    return;
+  }
+
+  if( !check_flag ) {
+    hashmap->num_lookups++;
+    if( hashmap->num_lookups < GDA_RMAHASHMAP_CHECK_INTERVAL ) {
+      return;
+    }
+  }
+  hashmap->num_lookups = 0;
+
+  GDA_CheckLoadOfRMAHashMap( hashmap );
+}
+
+
+/**
+  may cause double inserts if insert same key again
+ */
+void GDA_InsertElementIntoRMAHashMap( uint64_t hashed_key, uint64_t key, uint64_t value, uint64_t incarnation, GDA_RMAHashMap hashmap ) {
+  uint64_t hash = GDA_FoldHash( hashed_key );
+  uint64_t t_rank = GDA_TableRank( hash, hashmap );
+
+  GDA_InsertElementIntoTable( hash, key, value, incarnation, GDA_TableBase( t_rank, hashmap ), hashmap );
+  GDA_CountElementsOfRMAHashMap( t_rank, 1, hashmap );
+
+  GDA_ProgressRMAHashMap( true /* check_flag */, hashmap );
+}
+
+
+void GDA_FindElementInRMAHashMap( uint64_t hashed_key, uint64_t key, uint64_t* value, uint64_t* incarnation, bool* found_flag, GDA_RMAHashMap hashmap ) {
+  uint64_t hash = GDA_FoldHash( hashed_key );
+
+  uint64_t generation = GDA_TableBase( GDA_TableRank( hash, hashmap ), hashmap );
+  while( GDA_FindElementInTable( hash, key, value, incarnation, found_flag, generation, hashmap ) ) {
+    generation++;
+  }
+
+  GDA_ProgressRMAHashMap( false /* check_flag */, hashmap );
+}
+
+
+/**
+  batched version of GDA_FindElementInRMAHashMap (see GDA_FindElementsInTable)
+ */
+void GDA_FindElementsInRMAHashMap( size_t count, const uint64_t* hashed_keys, const uint64_t* keys, uint64_t* values, uint64_t* incarnations, bool* found_flags, GDA_RMAHashMap hashmap ) {
+  if( count == 0 ) {
+    return;
+  }
+
+  uint64_t* hashes = malloc( count * sizeof(uint64_t) );
+  assert( hashes != NULL );
+
+  for( size_t i=0 ; i<count ; i++ ) {
+    hashes[i] = GDA_FoldHash( hashed_keys[i] );
+    found_flags[i] = false;
+    values[i] = GDA_DPOINTER_NULL;
+  }
+
+  GDA_FindElementsInTable( count, hashes, keys, values, incarnations, found_flags, hashmap );
+
+  free( hashes );
+
+  GDA_ProgressRMAHashMap( false /* check_flag */, hashmap );
+}
+
+
+bool GDA_RemoveElementFromRMAHashMap( uint64_t hashed_key, uint64_t key, GDA_RMAHashMap hashmap ) {
+  return GDA_RemoveElementWithValueFromRMAHashMap( hashed_key, key, GDA_HASHINT_NULL, hashmap );
+}
+
+
+/**
+  removes a single element, that matches both key and value
+
+  needed if several elements share the same key, as in the secondary
+  indexes
+ */
+bool GDA_RemoveElementWithValueFromRMAHashMap( uint64_t hashed_key, uint64_t key, uint64_t value, GDA_RMAHashMap hashmap ) {
+  uint64_t hash = GDA_FoldHash( hashed_key );
+  uint64_t t_rank = GDA_TableRank( hash, hashmap );
+
+  bool found_flag = false;
+  bool next_flag = true;
+  for( uint64_t generation=GDA_TableBase( t_rank, hashmap ) ; next_flag ; generation++ ) {
+    found_flag = GDA_RemoveElementFromTable( hash, key, value, generation, &next_flag, hashmap );
+  }
+
+  if( found_flag ) {
+    GDA_CountElementsOfRMAHashMap( t_rank, -1, hashmap );
+  }
+
+  GDA_ProgressRMAHashMap( true /* check_flag */, hashmap );
+
+  return found_flag;
+}
+
+
+/**
+  appends all elements in the chain of the given table slot, whose key
+  lies within [key_min, key_max], to elements (the incarnation field only
+  holds the incarnation)
+
+  returns true, if the slot is migrated (or moved), so that the
+  corresponding slot of the next generation has to be visited as well
+ */
+static bool GDA_CollectElementsOfSlot( uint64_t t_rank, uint64_t generation, uint64_t t_offset, uint64_t key_min, uint64_t key_max, GDA_Vector* elements, GDA_RMAHashMap hashmap ) {
+  size_t start_size = elements->size;
+  MPI_Aint t_disp = GDA_TableDisp( t_rank, generation, t_offset, hashmap );
+
+  uint64_t slot;
+  // TODO: change to MPI_UINT64_T
+  // TODO: should be a fetch_and_op call with MPI_NO_OP
+  RMA_Get( &slot, 1, MPI_INT64_T, t_rank, t_disp, 1, MPI_INT64_T, hashmap->win_table );
+  GDA_Yield();
+  RMA_Win_flush_local( t_rank, hashmap->win_table );
+
+  /**
+    chase down the list
+   */
+  GDA_DPointer dp = GDA_SlotHead( slot );
+  while( dp != GDA_DPOINTER_NULL ) {
+    uint64_t dp_rank;
+    uint64_t dp_offset;
+    GDA_GetDPointer( &dp_offset, &dp_rank, dp );
+
+    GDA_RMAHashMap_Element element;
+    // TODO: change to MPI_UINT64_T
+    // TODO: should be a get_accumulate call with MPI_NO_OP
+    RMA_Get( &element, 4, MPI_INT64_T, dp_rank, GDA_HeapDisp( dp_rank, dp_offset * 4, hashmap ), 4, MPI_INT64_T, hashmap->win_heap );
+    GDA_Yield();
+    RMA_Win_flush_local( dp_rank, hashmap->win_heap );
+
+    if( element.next == dp ) {
+      /**
+        element points to itself -> in process of getting deleted
+        drop the results of this chain and restart from the beginning
+       */
+      elements->size = start_size;
+      RMA_Get( &slot, 1, MPI_INT64_T, t_rank, t_disp, 1, MPI_INT64_T, hashmap->win_table );
+      GDA_Yield();
+      RMA_Win_flush_local( t_rank, hashmap->win_table );
+      dp = GDA_SlotHead( slot );
+      continue;
+    }
+
+    if( (element.key >= key_min) && (element.key <= key_max) ) {
+      element.incarnation &= 0x00000000FFFFFFFF;
+      GDA_vector_push_back( elements, &element );
+    }
+
+    dp = element.next;
+  }
+
+  if( slot == GDA_RMAHASHMAP_SLOT_MOVED ) {
+    GDA_SkipMovedSlot( t_rank, generation, hashmap );
+    return true;
+  }
+  return GDA_SlotIsMigrating( slot );
+}
+
+
+/**
+  appends all elements, that are stored under hashed_key and whose key
+  lies within [key_min, key_max], to elements
+
+  An element, that is migrated concurrently, might be reported twice.
+ */
+void GDA_CollectElementsInRMAHashMap( uint64_t hashed_key, uint64_t key_min, uint64_t key_max, GDA_Vector* elements, GDA_RMAHashMap hashmap ) {
+  uint64_t hash = GDA_FoldHash( hashed_key );
+  uint64_t t_rank = GDA_TableRank( hash, hashmap );
+
+  uint64_t generation = GDA_TableBase( t_rank, hashmap );
+  while( GDA_CollectElementsOfSlot( t_rank, generation, GDA_TableOffset( hash, generation, hashmap ), key_min, key_max, elements, hashmap ) ) {
+    generation++;
+  }
+}
+
+
+/**
+  scans all slots of a process: the slots of a generation are fetched
+  with a single get, only non-empty chains are followed afterwards, and
+  the next generation is only scanned, if a slot is migrated
+ */
+static void GDA_CollectAllElementsOfProcess( uint64_t t_rank, uint64_t key_min, uint64_t key_max, GDA_Vector* elements, GDA_RMAHashMap hashmap ) {
+  bool next_flag = true;
+  for( uint64_t generation=GDA_TableBase( t_rank, hashmap ) ; next_flag ; generation++ ) {
+    size_t size = hashmap->table_size_local << generation;
+    GDA_DPointer* slots = malloc( size * sizeof(GDA_DPointer) );
+    assert( slots != NULL );
+
+    // TODO: change to MPI_UINT64_T
+    RMA_Get( slots, size, MPI_INT64_T, t_rank, GDA_TableDisp( t_rank, generation, 0, hashmap ), size, MPI_INT64_T, hashmap->win_table );
+    GDA_Yield();
+    RMA_Win_flush_local( t_rank, hashmap->win_table );
+
+    next_flag = false;
+    for( uint64_t t_offset=0 ; t_offset<size ; t_offset++ ) {
+      if( slots[t_offset] != GDA_DPOINTER_NULL ) {
+        if( GDA_CollectElementsOfSlot( t_rank, generation, t_offset, key_min, key_max, elements, hashmap ) ) {
+          next_flag = true;
+        }
+      }
+    }
+
+    free( slots );
+  }
+}
+
+
+/**
+  appends all elements of the hash map, whose key lies within
+  [key_min, key_max], to elements
+
+  used for range queries, that span too many hashed keys to look them up
+  one by one
+ */
+void GDA_CollectAllElementsInRMAHashMap( uint64_t key_min, uint64_t key_max, GDA_Vector* elements, GDA_RMAHashMap hashmap ) {
+  for( uint64_t t_rank=0 ; t_rank<hashmap->comm_size ; t_rank++ ) {
+    GDA_CollectAllElementsOfProcess( t_rank, key_min, key_max, elements, hashmap );
+  }
+}
+
+
+/**
+  appends all elements, whose chains start in the table slots of the
+  local process, to elements
+
+  collective context: no other process may change the hash map, while
+  this function is executed, so that every element is reported by
+  exactly one process
+ */
+void GDA_CollectLocalElementsInRMAHashMap( GDA_Vector* elements, GDA_RMAHashMap hashmap ) {
+  for( uint64_t generation=hashmap->table_base ; generation<=hashmap->table_current ; generation++ ) {
+    GDA_DPointer* slots = hashmap->table_generations[generation];
+    size_t size = hashmap->table_size_local << generation;
+
+    for( uint64_t t_offset=0 ; t_offset<size ; t_offset++ ) {
+      if( GDA_SlotHead( slots[t_offset] ) != GDA_DPOINTER_NULL ) {
+        GDA_CollectElementsOfSlot( hashmap->comm_rank, generation, t_offset, 0, UINT64_MAX, elements, hashmap );
+      }
+    }
+  }
+}
+
+
+/**
+  finishes the rehash of the local part of the table (and any rehash,
+  that becomes necessary afterwards) and frees the table generations,
+  whose slots are all moved
+
+  Rehashes are started and advanced by the operations of each process on
+  its own (see GDA_ProgressRMAHashMap), this call only reclaims the
+  memory of the old generations, which other processes might still
+  access outside of a collective context.
+
+  collective call: no other process may access the hash map, while this
+  function is executed
+ */
+void GDA_MaintainRMAHashMap( GDA_RMAHashMap hashmap ) {
+  do {
+    GDA_MigrateRMAHashMap( SIZE_MAX, hashmap );
+  } while( GDA_CheckLoadOfRMAHashMap( hashmap ) );
+
+  int free_flag = (hashmap->table_base > 0) && (hashmap->table_generations[hashmap->table_base-1] != NULL);
+  MPI_Allreduce( MPI_IN_PLACE, &free_flag, 1, MPI_INT, MPI_LOR, hashmap->comm );
+  if( !free_flag ) {
+    return;
+  }
+
+  /**
+    all processes finished their migration, so the base generations of
+    the other processes have to be fetched again, and their old
+    generations are not accessed anymore
+   */
+  for( size_t i=0 ; i<hashmap->comm_size ; i++ ) {
+    hashmap->table_base_cache[i] = GDA_HASHINT_NULL;
+  }
+  memset( hashmap->table_directory_cache, 0, hashmap->comm_size * GDA_RMAHASHMAP_MAX_TABLE_GENERATIONS * sizeof(MPI_Aint) );
+  hashmap->table_base_cache[hashmap->comm_rank] = hashmap->table_base;
+
+  for( uint64_t generation=0 ; generation<hashmap->table_base ; generation++ ) {
+    if( hashmap->table_generations[generation] != NULL ) {
+      GDA_DetachTableGeneration( generation, hashmap );
+    }
+  }
+}
+
+
+/**
+  returns the process, that owns the table slot of a key in all
+  generations
+
+  local call
+ */
+uint64_t GDA_RankOfKeyInRMAHashMap( uint64_t hashed_key, GDA_RMAHashMap hashmap ) {
+  return GDA_TableRank( GDA_FoldHash( hashed_key ), hashmap );
+}
@@ -18,6 +18,7 @@
 #include <stdlib.h>
 
 #include "gda_dpointer.h"
+#include "gda_vector.h"
 #include "rma.h"
 
 
@@ -27,6 +28,47 @@
 
 #define GDA_HASHINT_NULL 0xFFFFFFFFFFFFFFFF
 
+/**
+  maximum number of heap segments per process: segment i holds
+  heap_size_local * 2^i elements
+ */
+#define GDA_RMAHASHMAP_MAX_HEAP_SEGMENTS 32
+/**
+  maximum number of table generations per process: generation i holds
+  table_size_local * 2^i slots
+ */
+#define GDA_RMAHASHMAP_MAX_TABLE_GENERATIONS 32
+/**
+  a process doubles its part of the table, once the number of elements in
+  its slots exceeds this value times the number of its slots
+ */
+#define GDA_RMAHASHMAP_MAX_LOAD_FACTOR 2
+/**
+  number of local slots of the old table generation, that are migrated
+  alongside each operation of the process during a rehash
+ */
+#define GDA_RMAHASHMAP_MIGRATION_STEP 4
+/**
+  number of lookups of a process between two checks of its load factor
+  (insert and remove operations always check it)
+ */
+#define GDA_RMAHASHMAP_CHECK_INTERVAL 64
+
+/**
+  a table slot holds a DPointer to the first element of its chain or one
+  of the following values
+
+  GDA_RMAHASHMAP_SLOT_MIGRATING is set in a non-empty slot, whose
+  elements are moved into the next table generation, and
+  GDA_RMAHASHMAP_SLOT_MIGRATING_NULL is used for such a slot, once it is
+  empty. Both are possible, since the rank field of a DPointer is never
+  all ones (except for GDA_DPOINTER_NULL) and element offsets are smaller
+  than 2^30 (see GDA_AttachHeapSegment).
+ */
+#define GDA_RMAHASHMAP_SLOT_MIGRATING      ((uint64_t) 0x0000000080000000)
+#define GDA_RMAHASHMAP_SLOT_MIGRATING_NULL 0xFFFFFFFFFFFFFFFE
+#define GDA_RMAHASHMAP_SLOT_MOVED          0xFFFFFFFFFFFFFFFD
+
 
 /**
   data type definitions
@@ -38,8 +80,9 @@ typedef struct GDA_RMAHashMap_Element_desc {
   uint64_t key;
   uint64_t value;
   /**
-    uin32_t would be enough, but to keep the alignment intact we use
-    a 64-Bit integer
+    lower 32 bits: incarnation
+    upper 32 bits: folded hash of the key, which is needed to relocate the
+    element during a rehash
    */
   uint64_t incarnation;
   /**
@@ -53,6 +96,21 @@ typedef struct GDA_RMAHashMap_Element_desc {
   Table has DPointers to elements belonging to a certain hash-entry.
   These elements build a linked list.
 
+  The heap is a dynamic window, that grows by attaching additional
+  segments, whenever the local heap is exhausted. The addresses of the
+  segments are published in win_heap_directory.
+
+  The table is a dynamic window as well. Each process owns the slots of
+  the keys with hash % comm_size == comm_rank and grows its part on its
+  own: once its slots hold too many elements, it attaches a new table
+  generation twice as large as the previous one and moves the elements
+  of the old generation slot by slot alongside its following operations.
+  A slot, that is migrated, is flagged first, so that new elements go
+  into the next generation and lookups check both generations. An empty
+  flagged slot becomes GDA_RMAHASHMAP_SLOT_MOVED and forwards all
+  operations to the next generation. So no collective call is needed to
+  grow the table.
+
   // TODO: sort this
  */
 typedef struct GDA_RMAHashMap_desc {
@@ -67,35 +125,72 @@ typedef struct GDA_RMAHashMap_desc {
   int comm_rank;
 
   /**
-    MPI windows:
+    table (holds DPointers to elements): local basepointers of the table
+    generations, NULL if not attached (anymore)
    */
+  RMA_Win win_table;
+  GDA_DPointer* table_generations[GDA_RMAHASHMAP_MAX_TABLE_GENERATIONS];
   /**
-    table (holds DPointers to elements)
+    size of the first table generation per process and in total
    */
-  RMA_Win win_table;
+  size_t table_size_local;
+  size_t table_size_total;
   /**
-    basepointer
+    oldest local generation, whose slots are not all moved, and newest
+    local generation (a rehash is in progress, if they differ)
    */
-  GDA_DPointer *table;
+  size_t table_base;
+  size_t table_current;
+  /**
+    next local slot of the base generation, that has to be migrated
+   */
+  size_t migration_offset;
+  /**
+    per process: number of elements in its slots, its base generation and
+    the addresses of its table generations (as MPI_Aint)
+   */
+  RMA_Win win_table_directory;
+  uint64_t* table_directory;
+  /**
+    cached base generations (GDA_HASHINT_NULL if not known) and cached
+    addresses of the table generations of all processes
+    (comm_size * GDA_RMAHASHMAP_MAX_TABLE_GENERATIONS, 0 if not known yet)
+   */
+  uint64_t* table_base_cache;
+  MPI_Aint* table_directory_cache;
+  /**
+    number of lookups since the last check of the load factor
+   */
+  size_t num_lookups;
+
   /**
     heap (holds elements)
    */
   RMA_Win win_heap;
   /**
-    basepointer
+    local basepointers of the heap segments
+   */
+  GDA_RMAHashMap_Element *heap_segments[GDA_RMAHASHMAP_MAX_HEAP_SEGMENTS];
+  size_t num_heap_segments;
+  /**
+    addresses of the heap segments (as MPI_Aint)
    */
-  GDA_RMAHashMap_Element *heap;
+  RMA_Win win_heap_directory;
+  uint64_t* heap_directory;
+  /**
+    cached addresses of the heap segments of all processes
+    (comm_size * GDA_RMAHASHMAP_MAX_HEAP_SEGMENTS, 0 if not known yet)
+   */
+  MPI_Aint* heap_directory_cache;
   RMA_Win win_heap_counter;
   uint64_t* heap_counter;
 
   /**
-    table_size -> where hash into (the more the less collisions) -> DPointer each
-    heap_size -> how much can hold in heap -> element each
-    numbers may be rounded up to get symmetric space requirements
+    heap_size_local -> size of the first heap segment -> element each
+    heap_capacity_local -> size of all heap segments together
    */
-  size_t table_size_total;
-  size_t table_size_local;
   size_t heap_size_local;
+  size_t heap_capacity_local;
 
 #if 0
   /**
@@ -118,6 +213,14 @@ void GDA_CreateRMAHashMap( size_t table_size, size_t heap_size, MPI_Comm comm, G
 void GDA_FreeRMAHashMap( GDA_RMAHashMap* hashmap );
 void GDA_InsertElementIntoRMAHashMap( uint64_t hashed_key, uint64_t key, uint64_t value, uint64_t incarnation, GDA_RMAHashMap hashmap );
 void GDA_FindElementInRMAHashMap( uint64_t hashed_key, uint64_t key, uint64_t* value, uint64_t* incarnation, bool* found_flag, GDA_RMAHashMap hashmap );
+void GDA_FindElementsInRMAHashMap( size_t count, const uint64_t* hashed_keys, const uint64_t* keys, uint64_t* values, uint64_t* incarnations, bool* found_flags, GDA_RMAHashMap hashmap );
 bool GDA_RemoveElementFromRMAHashMap( uint64_t hashed_key, uint64_t key, GDA_RMAHashMap hashmap );
+bool GDA_RemoveElementWithValueFromRMAHashMap( uint64_t hashed_key, uint64_t key, uint64_t value, GDA_RMAHashMap hashmap );
+void GDA_CollectElementsInRMAHashMap( uint64_t hashed_key, uint64_t key_min, uint64_t key_max, GDA_Vector* elements, GDA_RMAHashMap hashmap );
+void GDA_CollectAllElementsInRMAHashMap( uint64_t key_min, uint64_t key_max, GDA_Vector* elements, GDA_RMAHashMap hashmap );
+void GDA_CollectLocalElementsInRMAHashMap( GDA_Vector* elements, GDA_RMAHashMap hashmap );
+int64_t GDA_NumLocalElementsOfRMAHashMap( GDA_RMAHashMap hashmap );
+void GDA_MaintainRMAHashMap( GDA_RMAHashMap hashmap );
+uint64_t GDA_RankOfKeyInRMAHashMap( uint64_t hashed_key, GDA_RMAHashMap hashmap );
 
 #endif // #ifndef __GDA_DISTRIBUTED_HASHTABLE_H
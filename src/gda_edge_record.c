@@ -0,0 +1,428 @@
+// Copyright (c) 2023 ETH Zurich.
+//                    All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <assert.h>
+#include <string.h>
+
+#include "gdi.h"
+#include "gda_block.h"
+#include "gda_edge_record.h"
+#include "gda_lightweight_edges.h"
+#include "gda_property.h"
+#include "gda_yield.h"
+
+/**
+  collective call
+ */
+void GDA_CreateEdgeRecords( GDI_Database graph_db ) {
+  size_t num_blocks = graph_db->memsize / graph_db->block_size * graph_db->commsize;
+
+  /**
+    the hash table grows on demand, so it starts with the same size as a
+    secondary index
+   */
+  GDA_CreateRMAHashMap( num_blocks/4 /* table size */, num_blocks/4 /* heap size */, graph_db->comm, &(graph_db->edge_records) );
+}
+
+
+/**
+  collective call
+ */
+void GDA_FreeEdgeRecords( GDI_Database graph_db ) {
+  GDA_FreeRMAHashMap( &(graph_db->edge_records) );
+}
+
+
+/**
+  collective call
+
+  no process accesses the edge records at this point, so that the old
+  generations of their hash table can be freed
+ */
+void GDA_MaintainEdgeRecords( GDI_Database graph_db ) {
+  GDA_MaintainRMAHashMap( graph_db->edge_records );
+}
+
+
+static inline uint64_t GDA_EdgeRecordMix( uint64_t x ) {
+  /**
+    finalizer of splitmix64, the hash table uses the key modulo the
+    table size, so all bits of the key should depend on the input
+   */
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+
+uint64_t GDA_EdgeRecordKey( GDA_DPointer vertex, GDA_DPointer other_vertex, uint8_t metadata, uint8_t label_int_handle ) {
+  GDA_DPointer origin = vertex;
+  GDA_DPointer target = other_vertex;
+  /**
+    the record index tells the records of parallel edges apart
+   */
+  uint64_t tag = label_int_handle | ((uint64_t) (metadata >> GDA_LIGHTWEIGHT_EDGES_RECORD_INDEX_SHIFT) << 12);
+
+  metadata &= GDA_LIGHTWEIGHT_EDGES_ORIENTATION;
+  if( metadata == (uint8_t) GDI_EDGE_INCOMING ) {
+    origin = other_vertex;
+    target = vertex;
+  } else {
+    if( metadata == (uint8_t) GDI_EDGE_UNDIRECTED ) {
+      /**
+        both vertices have to compute the same key
+       */
+      if( origin > target ) {
+        origin = other_vertex;
+        target = vertex;
+      }
+      tag |= 0x100;
+    }
+  }
+
+  uint64_t key = GDA_EdgeRecordMix( origin ^ GDA_EdgeRecordMix( target ^ GDA_EdgeRecordMix( tag ) ) );
+  if( key == GDA_HASHINT_NULL ) {
+    /**
+      reserved by the hash table
+     */
+    key--;
+  }
+  return key;
+}
+
+
+uint64_t GDA_EdgeRecordKeyOfEdge( GDI_EdgeHolder edge ) {
+  uint8_t *metadata, *label;
+  GDA_LightweightEdgesGetMetadataPointerWithOffset( &metadata, edge->origin, edge->origin_lightweight_edge_offset );
+  GDA_LightweightEdgesGetLabelPointerWithOffset( &label, edge->origin, edge->origin_lightweight_edge_offset );
+  return GDA_EdgeRecordKey( *(GDA_DPointer*) edge->origin->blocks->data, *(GDA_DPointer*) edge->target->blocks->data, *metadata, *label );
+}
+
+
+bool GDA_EdgeHasRecord( GDI_EdgeHolder edge ) {
+  uint8_t* metadata;
+  GDA_LightweightEdgesGetMetadataPointerWithOffset( &metadata, edge->origin, edge->origin_lightweight_edge_offset );
+  return (*metadata & GDA_LIGHTWEIGHT_EDGES_RECORD) != 0;
+}
+
+
+/**
+  sets the record bit and a record index, that none of the parallel
+  edges with a record uses, in the lightweight entries of the edge on
+  both vertices, which have to hold a write lock
+
+  returns false, if all GDA_LIGHTWEIGHT_EDGES_MAX_RECORDS record indexes
+  are taken
+ */
+bool GDA_MarkEdgeRecord( GDI_EdgeHolder edge ) {
+  uint8_t *metadata, *label;
+  GDA_LightweightEdgesGetMetadataPointerWithOffset( &metadata, edge->origin, edge->origin_lightweight_edge_offset );
+  GDA_LightweightEdgesGetLabelPointerWithOffset( &label, edge->origin, edge->origin_lightweight_edge_offset );
+  uint8_t orientation = *metadata & GDA_LIGHTWEIGHT_EDGES_ORIENTATION;
+
+  /**
+    the entries of a self-loop are both stored with the origin vertex,
+    so neither of them counts as a parallel edge
+   */
+  uint32_t other_skip_offset = 0;
+  if( edge->origin == edge->target ) {
+    other_skip_offset = edge->target_lightweight_edge_offset;
+  }
+  uint16_t used = GDA_LightweightEdgesUsedRecordIndexes( orientation, *(GDA_DPointer*) edge->target->blocks->data, *label, edge->origin_lightweight_edge_offset, other_skip_offset, edge->origin );
+  if( used == UINT16_MAX ) {
+    return false;
+  }
+
+  uint8_t record_bits = GDA_LIGHTWEIGHT_EDGES_RECORD | (uint8_t) (__builtin_ctz( ~(uint32_t) used ) << GDA_LIGHTWEIGHT_EDGES_RECORD_INDEX_SHIFT);
+
+  *metadata = orientation | record_bits;
+  GDA_LightweightEdgesMarkDirty( metadata, 1, edge->origin );
+  GDA_LightweightEdgesGetMetadataPointerWithOffset( &metadata, edge->target, edge->target_lightweight_edge_offset );
+  *metadata = (*metadata & GDA_LIGHTWEIGHT_EDGES_ORIENTATION) | record_bits;
+  GDA_LightweightEdgesMarkDirty( metadata, 1, edge->target );
+
+  return true;
+}
+
+
+void GDA_LoadEdgeRecord( GDI_EdgeHolder edge ) {
+  if( edge->record != NULL ) {
+    return;
+  }
+
+  GDI_Database graph_db = edge->transaction->db;
+
+  /**
+    the property data of the edge is kept in a vertex object, so that the
+    property functions of the vertices can be used: only the property
+    data fields, the blocks of the record, the transaction and the write
+    flag are used
+   */
+  GDI_VertexHolder record = malloc( sizeof(GDI_VertexHolder_desc_t) );
+  assert( record != NULL );
+  memset( record, 0, sizeof(GDI_VertexHolder_desc_t) );
+  record->transaction = edge->transaction;
+  record->write_flag = false;
+  GDA_vector_create( &(record->blocks), sizeof(GDA_DPointer), 2 /* initial capacity */ );
+
+  edge->record = record;
+  edge->record_key = GDA_EdgeRecordKeyOfEdge( edge );
+
+  bool found_flag = false;
+  uint64_t value, incarnation;
+  if( GDA_EdgeHasRecord( edge ) ) {
+    GDA_FindElementInRMAHashMap( edge->record_key, edge->record_key, &value, &incarnation, &found_flag, graph_db->edge_records );
+  }
+
+  if( !found_flag ) {
+    GDA_LinearScanningInitPropertyList( record );
+    return;
+  }
+
+  /**
+    fetch the chain of blocks
+   */
+  uint64_t block_size = graph_db->block_size;
+  char* buf = malloc( block_size );
+  assert( buf != NULL );
+
+  GDA_DPointer dpointer = value;
+  GDA_GetBlock( buf, dpointer, graph_db );
+  GDA_Yield();
+  RMA_Win_flush_all( graph_db->win_blocks );
+  GDA_vector_push_back( record->blocks, &dpointer );
+
+  uint64_t stored_property_size = *(uint64_t*)(buf+GDA_EDGE_RECORD_OFFSET_SIZE_PROPERTY_DATA);
+  uint64_t unused_space = *(uint64_t*)(buf+GDA_EDGE_RECORD_OFFSET_SIZE_UNUSED_SPACE);
+  uint64_t remaining_property_data = stored_property_size & ~GDA_PROPERTY_STORED_VARINT;
+  char* property_data = malloc( remaining_property_data );
+  assert( property_data != NULL );
+
+  uint64_t chunk = block_size - GDA_EDGE_RECORD_METADATA_SIZE;
+  char* target_address = property_data;
+  char* source_address = buf + GDA_EDGE_RECORD_METADATA_SIZE;
+
+  while( true ) {
+    if( chunk > remaining_property_data ) {
+      chunk = remaining_property_data;
+    }
+    memcpy( target_address, source_address, chunk );
+    target_address += chunk;
+    remaining_property_data -= chunk;
+
+    dpointer = *(GDA_DPointer*)(buf+GDA_EDGE_RECORD_OFFSET_NEXT_BLOCK);
+    if( remaining_property_data == 0 ) {
+      break;
+    }
+
+    assert( dpointer != GDA_DPOINTER_NULL );
+    GDA_GetBlock( buf, dpointer, graph_db );
+    GDA_Yield();
+    RMA_Win_flush_all( graph_db->win_blocks );
+    GDA_vector_push_back( record->blocks, &dpointer );
+
+    chunk = block_size - sizeof(GDA_DPointer);
+    source_address = buf + sizeof(GDA_DPointer);
+  }
+  assert( dpointer == GDA_DPOINTER_NULL );
+
+  GDA_LoadPropertyList( property_data, stored_property_size, unused_space, record );
+
+  free( buf );
+}
+
+
+void GDA_RemoveEdgeRecord( uint64_t key, GDI_Transaction transaction ) {
+  if( transaction->removed_edge_records == NULL ) {
+    GDA_vector_create( &(transaction->removed_edge_records), sizeof(uint64_t), 8 /* initial capacity */ );
+  }
+  GDA_vector_push_back( transaction->removed_edge_records, &key );
+}
+
+
+/**
+  writes the record of the edge into its blocks, which are adjusted to
+  the size of the property data first
+
+  returns the buffer, that has to be freed after the next flush
+ */
+static char* GDA_PutEdgeRecord( GDI_EdgeHolder edge ) {
+  GDI_Database graph_db = edge->transaction->db;
+  GDI_VertexHolder record = edge->record;
+  uint64_t block_size = graph_db->block_size;
+  uint64_t payload_size = block_size - sizeof(GDA_DPointer);
+  char* property_data = malloc( GDA_StoredPropertyListSize( record ) );
+  assert( property_data != NULL );
+  uint64_t property_size = GDA_StorePropertyList( property_data, record );
+  uint64_t total_size = GDA_EDGE_RECORD_METADATA_SIZE - sizeof(GDA_DPointer) + property_size;
+  size_t num_blocks = (total_size + payload_size - 1) / payload_size;
+
+  /**
+    new records are placed on the process, that stores the origin vertex,
+    and the first block of a record never changes, since the hash table
+    refers to it
+   */
+  uint64_t offset, target_rank;
+  if( record->blocks->size == 0 ) {
+    GDA_GetDPointer( &offset, &target_rank, *(GDA_DPointer*) edge->origin->blocks->data );
+  } else {
+    GDA_GetDPointer( &offset, &target_rank, *(GDA_DPointer*) record->blocks->data );
+  }
+
+  while( record->blocks->size < num_blocks ) {
+    GDA_DPointer dpointer = GDA_AllocateBlock( target_rank, graph_db );
+    if( dpointer == GDA_DPOINTER_NULL ) {
+      /**
+        couldn't acquire enough resources
+       */
+      // TODO
+      assert( 0 );
+    }
+    GDA_vector_push_back( record->blocks, &dpointer );
+  }
+  while( record->blocks->size > num_blocks ) {
+    GDA_DPointer* dp_ptr = GDA_vector_at( record->blocks, record->blocks->size-1 );
+    GDA_DeallocateBlock( *dp_ptr, graph_db );
+    GDA_vector_pop_back( record->blocks );
+  }
+
+  char* buf = malloc( num_blocks * block_size );
+  assert( buf != NULL );
+
+  GDA_DPointer* dp = record->blocks->data;
+  *(uint64_t*)(buf+GDA_EDGE_RECORD_OFFSET_SIZE_PROPERTY_DATA) = property_size | GDA_PROPERTY_STORED_VARINT;
+  *(uint64_t*)(buf+GDA_EDGE_RECORD_OFFSET_SIZE_UNUSED_SPACE) = 0; /* only used by the in-memory format */
+
+  uint64_t remaining_property_data = property_size;
+  char* source_address = property_data;
+
+  for( size_t i=0 ; i<num_blocks ; i++ ) {
+    char* block = buf + i * block_size;
+    *(GDA_DPointer*)(block+GDA_EDGE_RECORD_OFFSET_NEXT_BLOCK) = (i+1 < num_blocks) ? dp[i+1] : GDA_DPOINTER_NULL;
+
+    uint64_t header_size = (i == 0) ? GDA_EDGE_RECORD_METADATA_SIZE : sizeof(GDA_DPointer);
+    uint64_t chunk = block_size - header_size;
+    if( chunk > remaining_property_data ) {
+      chunk = remaining_property_data;
+    }
+    memcpy( block + header_size, source_address, chunk );
+    source_address += chunk;
+    remaining_property_data -= chunk;
+
+    GDA_PutBlock( block, dp[i], graph_db );
+  }
+  assert( remaining_property_data == 0 );
+  free( property_data );
+
+  return buf;
+}
+
+
+/**
+  called during the commit of a transaction, before the vertices are
+  written back
+ */
+void GDA_StoreEdgeRecords( GDI_Transaction transaction ) {
+  GDI_Database graph_db = transaction->db;
+  size_t num_edges = transaction->edges->size;
+
+  /**
+    records of deleted edges, that were found under a different key than
+    the current one of the edge
+   */
+  for( size_t i=0 ; i<num_edges ; i++ ) {
+    GDI_EdgeHolder edge = *(GDI_EdgeHolder*)GDA_vector_at( transaction->edges, i );
+    if( edge->delete_flag && (edge->record != NULL) && (edge->record->blocks->size > 0) ) {
+      GDA_RemoveEdgeRecord( edge->record_key, transaction );
+    }
+  }
+
+  char* buf = malloc( graph_db->block_size );
+  assert( buf != NULL );
+
+  if( transaction->removed_edge_records != NULL ) {
+    for( size_t i=0 ; i<transaction->removed_edge_records->size ; i++ ) {
+      uint64_t key = *(uint64_t*)GDA_vector_at( transaction->removed_edge_records, i );
+      uint64_t value, incarnation;
+      bool found_flag;
+
+      /**
+        the same record might be requested several times for removal
+       */
+      GDA_FindElementInRMAHashMap( key, key, &value, &incarnation, &found_flag, graph_db->edge_records );
+      if( !found_flag || !GDA_RemoveElementWithValueFromRMAHashMap( key, key, value, graph_db->edge_records ) ) {
+        continue;
+      }
+
+      GDA_DPointer dpointer = value;
+      while( dpointer != GDA_DPOINTER_NULL ) {
+        GDA_GetBlock( buf, dpointer, graph_db );
+        GDA_Yield();
+        RMA_Win_flush_all( graph_db->win_blocks );
+        GDA_DeallocateBlock( dpointer, graph_db );
+        dpointer = *(GDA_DPointer*)(buf+GDA_EDGE_RECORD_OFFSET_NEXT_BLOCK);
+      }
+    }
+  }
+
+  free( buf );
+
+  GDA_Vector* buffers;
+  GDA_vector_create( &buffers, sizeof(char*), 8 /* initial capacity */ );
+
+  for( size_t i=0 ; i<num_edges ; i++ ) {
+    GDI_EdgeHolder edge = *(GDI_EdgeHolder*)GDA_vector_at( transaction->edges, i );
+    if( edge->delete_flag || (edge->record == NULL) ) {
+      continue;
+    }
+
+    GDI_VertexHolder record = edge->record;
+    bool new_flag = (record->blocks->size == 0);
+    if( new_flag && !(record->write_flag) ) {
+      /**
+        properties were only read
+       */
+      continue;
+    }
+
+    if( record->write_flag ) {
+      char* record_buf = GDA_PutEdgeRecord( edge );
+      GDA_vector_push_back( buffers, &record_buf );
+    }
+
+    uint64_t key = GDA_EdgeRecordKeyOfEdge( edge );
+    GDA_DPointer dpointer = *(GDA_DPointer*) record->blocks->data;
+    if( new_flag ) {
+      GDA_InsertElementIntoRMAHashMap( key, key, dpointer, 0 /* incarnation */, graph_db->edge_records );
+    } else {
+      if( key != edge->record_key ) {
+        /**
+          label, direction type or vertices of the edge changed
+         */
+        GDA_RemoveElementWithValueFromRMAHashMap( edge->record_key, edge->record_key, dpointer, graph_db->edge_records );
+        GDA_InsertElementIntoRMAHashMap( key, key, dpointer, 0 /* incarnation */, graph_db->edge_records );
+      }
+    }
+  }
+
+  GDA_Yield();
+  RMA_Win_flush_all( graph_db->win_blocks );
+
+  for( size_t i=0 ; i<buffers->size ; i++ ) {
+    free( *(char**)GDA_vector_at( buffers, i ) );
+  }
+  GDA_vector_free( &buffers );
+}
+
+
+void GDA_FreeEdgeRecord( GDI_EdgeHolder edge ) {
+  if( edge->record != NULL ) {
+    GDA_LinearScanningFreePropertyList( edge->record );
+    GDA_vector_free( &(edge->record->blocks) );
+    free( edge->record );
+    edge->record = NULL;
+  }
+}
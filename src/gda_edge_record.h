@@ -0,0 +1,83 @@
+// Copyright (c) 2023 ETH Zurich.
+//                    All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef __GDA_EDGE_RECORD_H
+#define __GDA_EDGE_RECORD_H
+
+#include "gdi.h"
+
+/**
+  The properties of an edge (heavyweight edge) are not stored in the
+  blocks of its vertices, but in a separate record, so that they don't
+  have to be transferred, when only the adjacency of a vertex is needed.
+
+  A record is a chain of blocks: each block starts with the DPointer of
+  the next block (GDA_DPOINTER_NULL for the last one), the first block
+  continues with the size of the property data and the size of the
+  unused space in it, followed by the property data itself, which has
+  the same stored format as the property data of a vertex
+  (gda_property.h).
+
+  Both lightweight entries of an edge with a record have the
+  GDA_LIGHTWEIGHT_EDGES_RECORD bit and the same record index set in
+  their metadata. The record is found through a distributed hash table
+  (edge_records of the database), whose key is computed from the UIDs of
+  both vertices, the label, the direction type and the record index of
+  the edge, and is only fetched, once the properties of an edge object
+  are accessed. Parallel edges (same vertices, direction type and label)
+  get different record indexes, so each of them has its own record, and
+  at most GDA_LIGHTWEIGHT_EDGES_MAX_RECORDS of them can have properties.
+
+  Records are written, moved to a new key (after a change of the label,
+  the direction type or the vertices of the edge) and removed during the
+  commit of a transaction.
+ */
+
+
+/**
+  constant definitions
+ */
+
+#define GDA_EDGE_RECORD_OFFSET_NEXT_BLOCK         0
+#define GDA_EDGE_RECORD_OFFSET_SIZE_PROPERTY_DATA (GDA_EDGE_RECORD_OFFSET_NEXT_BLOCK+8)
+#define GDA_EDGE_RECORD_OFFSET_SIZE_UNUSED_SPACE  (GDA_EDGE_RECORD_OFFSET_SIZE_PROPERTY_DATA+8)
+#define GDA_EDGE_RECORD_METADATA_SIZE             (GDA_EDGE_RECORD_OFFSET_SIZE_UNUSED_SPACE+8)
+
+
+/**
+  function prototypes
+ */
+
+void GDA_CreateEdgeRecords( GDI_Database graph_db );
+void GDA_FreeEdgeRecords( GDI_Database graph_db );
+void GDA_MaintainEdgeRecords( GDI_Database graph_db );
+
+/**
+  key of the record of an edge with the given lightweight entry
+  (metadata and label) in the edges of vertex
+ */
+uint64_t GDA_EdgeRecordKey( GDA_DPointer vertex, GDA_DPointer other_vertex, uint8_t metadata, uint8_t label_int_handle );
+
+uint64_t GDA_EdgeRecordKeyOfEdge( GDI_EdgeHolder edge );
+
+bool GDA_EdgeHasRecord( GDI_EdgeHolder edge );
+bool GDA_MarkEdgeRecord( GDI_EdgeHolder edge );
+
+/**
+  makes the property data of the edge available in edge->record, which
+  is an empty property list, if the edge doesn't have a record yet
+ */
+void GDA_LoadEdgeRecord( GDI_EdgeHolder edge );
+
+/**
+  removes the record with the key, once the transaction is committed
+ */
+void GDA_RemoveEdgeRecord( uint64_t key, GDI_Transaction transaction );
+
+void GDA_StoreEdgeRecords( GDI_Transaction transaction );
+void GDA_FreeEdgeRecord( GDI_EdgeHolder edge );
+
+#endif // #ifndef __GDA_EDGE_RECORD_H
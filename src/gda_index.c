@@ -0,0 +1,984 @@
+// Copyright (c) 2023 ETH Zurich.
+//                    All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gda_dictionary.h"
+#include "gda_index.h"
+#include "gda_lightweight_edges.h"
+#include "gda_lock.h"
+#include "gda_property.h"
+
+/**
+  maps a double to an unsigned integer with the same order
+ */
+static inline uint64_t GDA_EncodeDouble( double value ) {
+  uint64_t bits;
+  memcpy( &bits, &value, sizeof(uint64_t) );
+
+  if( bits & 0x8000000000000000 ) {
+    /**
+      negative numbers: reverse the order of the magnitudes
+     */
+    return ~bits;
+  }
+  return bits | 0x8000000000000000;
+}
+
+
+/**
+  packs the first 8 characters of a string into an unsigned integer,
+  so that the order of the integers matches the lexicographic order of
+  the prefixes
+
+  shorter strings are padded with the given padding Byte
+ */
+static inline uint64_t GDA_EncodePrefix( const void* value, size_t count, unsigned char padding ) {
+  const unsigned char* chars = value;
+  uint64_t key = 0;
+  for( size_t i=0 ; i<8 ; i++ ) {
+    key <<= 8;
+    key |= (i < count) ? chars[i] : padding;
+  }
+  return key;
+}
+
+
+/**
+  checks whether all values of the property type can be encoded
+  exactly in 64 bits: a single element of a datatype, that occupies at
+  most 8 Bytes (GDI_CHAR is excluded, since it is used for strings)
+ */
+bool GDA_IsExactPropertyType( GDI_PropertyType ptype ) {
+  return (ptype->dtype >= GDI_INT8_T) && (ptype->dtype <= GDI_DATETIME) && (ptype->stype != GDI_NO_SIZE_LIMIT) && (ptype->count == 1);
+}
+
+
+/**
+  computes the key of a property value (count elements of the datatype
+  of the property type)
+
+  returns false, if the value has no key, which is the case for empty
+  values of an exact index
+ */
+bool GDA_EncodeIndexKey( uint64_t* key, const void* value, size_t count, GDI_Index index ) {
+  if( index->itype == GDI_INDEX_PREFIX ) {
+    *key = GDA_EncodePrefix( value, count, 0x00 );
+    return true;
+  }
+
+  if( !(index->exact_flag) ) {
+    size_t dsize;
+    GDI_GetSizeOfDatatype( &dsize, index->ptype->dtype );
+    if( index->dictionary_flag ) {
+      *key = GDA_DictionaryCode( value, count * dsize );
+    } else {
+      *key = GDA_hash_property_id( value, count * dsize, index->ptype->int_handle );
+    }
+    return true;
+  }
+
+  if( count != 1 ) {
+    return false;
+  }
+
+  /**
+    property data is not aligned, so all values are copied first
+
+    signed integers are shifted by flipping the sign bit, so that the
+    order of the keys matches the order of the values
+   */
+  switch( index->ptype->dtype ) {
+    case GDI_INT8_T: {
+      int8_t temp;
+      memcpy( &temp, value, sizeof(int8_t) );
+      *key = (uint64_t)(int64_t)temp ^ 0x8000000000000000;
+      break;
+    }
+    case GDI_UINT8_T:
+    case GDI_BOOL:
+    case GDI_BYTE: {
+      uint8_t temp;
+      memcpy( &temp, value, sizeof(uint8_t) );
+      *key = temp;
+      break;
+    }
+    case GDI_INT16_T: {
+      int16_t temp;
+      memcpy( &temp, value, sizeof(int16_t) );
+      *key = (uint64_t)(int64_t)temp ^ 0x8000000000000000;
+      break;
+    }
+    case GDI_UINT16_T: {
+      uint16_t temp;
+      memcpy( &temp, value, sizeof(uint16_t) );
+      *key = temp;
+      break;
+    }
+    case GDI_INT32_T: {
+      int32_t temp;
+      memcpy( &temp, value, sizeof(int32_t) );
+      *key = (uint64_t)(int64_t)temp ^ 0x8000000000000000;
+      break;
+    }
+    case GDI_UINT32_T:
+    case GDI_DATE:
+    case GDI_TIME: {
+      uint32_t temp;
+      memcpy( &temp, value, sizeof(uint32_t) );
+      *key = temp;
+      break;
+    }
+    case GDI_FLOAT: {
+      float temp;
+      memcpy( &temp, value, sizeof(float) );
+      *key = GDA_EncodeDouble( temp );
+      break;
+    }
+    case GDI_INT64_T: {
+      int64_t temp;
+      memcpy( &temp, value, sizeof(int64_t) );
+      *key = (uint64_t)temp ^ 0x8000000000000000;
+      break;
+    }
+    case GDI_UINT64_T:
+    case GDI_DATETIME: {
+      memcpy( key, value, sizeof(uint64_t) );
+      break;
+    }
+    case GDI_DOUBLE: {
+      double temp;
+      memcpy( &temp, value, sizeof(double) );
+      *key = GDA_EncodeDouble( temp );
+      break;
+    }
+    default:
+      assert( 0 );
+  }
+
+  return true;
+}
+
+
+/**
+  computes the range of keys of all strings, that start with the given
+  prefix of length characters
+
+  prefixes longer than 8 characters are cut, so that the candidates of
+  such a range have to be verified
+ */
+void GDA_EncodeIndexPrefixRange( uint64_t* key_min, uint64_t* key_max, const void* prefix, size_t length ) {
+  *key_min = GDA_EncodePrefix( prefix, length, 0x00 );
+  *key_max = GDA_EncodePrefix( prefix, length, 0xFF );
+}
+
+
+/**
+  number of low order bits of a key, that are dropped to determine the
+  range of keys, that is stored under the same hashed key (0 for hash
+  indexes)
+ */
+static inline unsigned GDA_IndexRangeShift( GDI_Index index ) {
+  if( index->itype == GDI_INDEX_ORDERED ) {
+    return index->range_shift;
+  }
+  if( index->itype == GDI_INDEX_PREFIX ) {
+    return 64 - 8 * GDA_INDEX_PREFIX_BUCKET_CHARS;
+  }
+  return 0;
+}
+
+
+/**
+  computes the hashed key, under which an element with the given key is
+  stored in the hash table of the index
+ */
+static inline uint64_t GDA_IndexHashedKey( uint64_t key, GDI_Index index ) {
+  if( (index->itype == GDI_INDEX_HASH) && !(index->exact_flag) ) {
+    /**
+      key is already a hash
+     */
+    return key;
+  }
+
+  key >>= GDA_IndexRangeShift( index );
+
+  return GDA_hash_property_id( (const unsigned char*)&key, sizeof(uint64_t), index->ptype->int_handle );
+}
+
+
+/**
+  collective call
+ */
+void GDA_CreateIndex( uint8_t itype, GDI_Label label, GDI_PropertyType ptype, GDI_Database graph_db, GDI_Index* index ) {
+  /**
+    calculate the total number of blocks in the database first
+   */
+  size_t num_blocks = graph_db->memsize / graph_db->block_size * graph_db->commsize;
+
+  *index = malloc( sizeof(GDI_Index_desc_t) );
+  assert( *index != NULL );
+
+  (*index)->db = graph_db;
+  (*index)->label = label;
+  (*index)->ptype = ptype;
+  (*index)->itype = itype;
+
+  (*index)->dictionary_flag = false;
+
+  if( itype == GDI_INDEX_BITMAP ) {
+    (*index)->exact_flag = true;
+    (*index)->hashmap = NULL;
+    if( label == GDI_LABEL_NONE ) {
+      /**
+        the database already keeps track of all vertices
+       */
+      (*index)->bitmap = graph_db->vertex_bitmap;
+    } else {
+      GDA_CreateRMABitmap( graph_db->win_blocks_size / graph_db->block_size, graph_db->comm, &((*index)->bitmap) );
+    }
+  } else {
+    (*index)->exact_flag = GDA_IsExactPropertyType( ptype );
+    (*index)->dictionary_flag = ptype->dictionary_flag && !((*index)->exact_flag) && (itype != GDI_INDEX_PREFIX);
+    (*index)->bitmap = NULL;
+
+    if( itype == GDI_INDEX_ORDERED ) {
+      if( (ptype->dtype == GDI_FLOAT) || (ptype->dtype == GDI_DOUBLE) ) {
+        (*index)->range_shift = GDA_INDEX_ORDERED_FLOAT_RANGE_BITS;
+      } else {
+        (*index)->range_shift = GDA_INDEX_ORDERED_RANGE_BITS;
+      }
+
+      /**
+        the bounds start out empty
+       */
+      size_t bounds_size = (graph_db->commrank == 0) ? 2 * sizeof(uint64_t) : 0;
+      RMA_Win_allocate( bounds_size, sizeof(uint64_t), MPI_INFO_NULL, graph_db->comm, &((*index)->bounds), &((*index)->win_bounds) );
+      if( graph_db->commrank == 0 ) {
+        (*index)->bounds[0] = UINT64_MAX;
+        (*index)->bounds[1] = 0;
+      }
+      RMA_Win_lock_all( 0 /* assert */, (*index)->win_bounds );
+      (*index)->known_bounds[0] = UINT64_MAX;
+      (*index)->known_bounds[1] = 0;
+    }
+
+    /**
+      the hash table grows on demand, so it starts with a fraction of the
+      size of the internal index
+     */
+    GDA_CreateRMAHashMap( num_blocks/4 /* table size */, num_blocks/4 /* heap size */, graph_db->comm, &((*index)->hashmap) );
+  }
+
+  (*index)->db_listptr = GDA_list_push_back( graph_db->indexes, index );
+}
+
+
+/**
+  frees the distributed data structures of an index
+
+  collective call
+ */
+static void GDA_FreeIndexStructures( GDI_Index index ) {
+  if( index->hashmap != NULL ) {
+    GDA_FreeRMAHashMap( &(index->hashmap) );
+  }
+  if( (index->bitmap != NULL) && (index->label != GDI_LABEL_NONE) ) {
+    GDA_FreeRMABitmap( &(index->bitmap) );
+  }
+  if( index->itype == GDI_INDEX_ORDERED ) {
+    RMA_Win_unlock_all( index->win_bounds );
+    RMA_Win_free( &(index->win_bounds) );
+  }
+}
+
+
+/**
+  collective call
+ */
+void GDA_FreeIndex( GDI_Index* index ) {
+  GDI_Database graph_db = (*index)->db;
+
+  GDA_list_erase_single( graph_db->indexes, (*index)->db_listptr );
+  GDA_FreeIndexStructures( *index );
+
+  free( *index );
+  *index = GDI_INDEX_NULL;
+}
+
+
+/**
+  collective call
+ */
+void GDA_FreeAllIndexes( GDI_Database graph_db ) {
+  GDA_Node* node = graph_db->indexes->head;
+  while( node != NULL ) {
+    GDI_Index index = *(GDI_Index*)(node->value);
+    GDA_FreeIndexStructures( index );
+    free( index );
+    node = node->next;
+  }
+  GDA_list_free( &(graph_db->indexes) );
+}
+
+
+/**
+  collective call
+
+  no process accesses the indexes at this point, so that their hash
+  tables can be resized
+ */
+void GDA_MaintainIndexes( GDI_Database graph_db ) {
+  GDA_Node* node = graph_db->indexes->head;
+  while( node != NULL ) {
+    GDI_Index index = *(GDI_Index*)(node->value);
+    if( index->hashmap != NULL ) {
+      GDA_MaintainRMAHashMap( index->hashmap );
+    }
+    if( index->itype == GDI_INDEX_ORDERED ) {
+      GDA_AdaptIndexBuckets( index );
+    }
+    node = node->next;
+  }
+}
+
+
+/**
+  fetches the bounds of the keys of an ordered index from process 0
+ */
+static void GDA_GetIndexBounds( uint64_t bounds[2], GDI_Index index ) {
+  RMA_Get( bounds, 2, MPI_UINT64_T, 0, 0, 2, MPI_UINT64_T, index->win_bounds );
+  RMA_Win_flush_local( 0, index->win_bounds );
+
+  index->known_bounds[0] = bounds[0];
+  index->known_bounds[1] = bounds[1];
+}
+
+
+/**
+  makes sure, that the key lies within the bounds of an ordered index,
+  before the element is inserted
+
+  usually the key already lies within the bounds, that the process has
+  seen last, so that no communication is needed
+ */
+static void GDA_ExtendIndexBounds( uint64_t key, GDI_Index index ) {
+  uint64_t result;
+
+  if( key < index->known_bounds[0] ) {
+    RMA_Fetch_and_op( &key, &result, MPI_UINT64_T, 0, 0 /* disp */, RMA_MIN, index->win_bounds );
+    RMA_Win_flush( 0, index->win_bounds );
+    index->known_bounds[0] = (result < key) ? result : key;
+  }
+
+  if( key > index->known_bounds[1] ) {
+    RMA_Fetch_and_op( &key, &result, MPI_UINT64_T, 0, 1 /* disp */, RMA_MAX, index->win_bounds );
+    RMA_Win_flush( 0, index->win_bounds );
+    index->known_bounds[1] = (result > key) ? result : key;
+  }
+}
+
+
+/**
+  width of the buckets (in bits of the key), so that the buckets between
+  the bounds hold about GDA_INDEX_ORDERED_BUCKET_ELEMENTS elements each,
+  if the keys are spread evenly
+ */
+static uint8_t GDA_IndexRangeShiftForKeys( uint64_t key_min, uint64_t key_max, uint64_t num_elements ) {
+  uint64_t num_buckets = num_elements / GDA_INDEX_ORDERED_BUCKET_ELEMENTS;
+  if( num_buckets == 0 ) {
+    num_buckets = 1;
+  }
+
+  uint64_t span = key_max - key_min;
+  uint8_t shift = 0;
+  while( (shift < 63) && ((span >> shift) >= num_buckets) ) {
+    shift++;
+  }
+  return shift;
+}
+
+
+/**
+  adapts the width of the buckets of an ordered index to the number of
+  elements and the bounds of their keys
+
+  If the width changes by a factor of 2^GDA_INDEX_ORDERED_SHIFT_SLACK or
+  more, each process moves the elements, whose chains start in its table
+  slots, into a new hash table, and the bounds are reset to the exact
+  bounds of the remaining keys.
+
+  collective call: no process accesses the index at this point
+ */
+void GDA_AdaptIndexBuckets( GDI_Index index ) {
+  assert( index->itype == GDI_INDEX_ORDERED );
+
+  GDI_Database graph_db = index->db;
+
+  int64_t num_elements = GDA_NumLocalElementsOfRMAHashMap( index->hashmap );
+  MPI_Allreduce( MPI_IN_PLACE, &num_elements, 1, MPI_INT64_T, MPI_SUM, graph_db->comm );
+
+  uint64_t bounds[2];
+  GDA_GetIndexBounds( bounds, index );
+
+  if( (num_elements <= 0) || (bounds[0] > bounds[1]) ) {
+    return;
+  }
+
+  uint8_t shift = GDA_IndexRangeShiftForKeys( bounds[0], bounds[1], num_elements );
+  if( abs( (int)shift - (int)(index->range_shift) ) < GDA_INDEX_ORDERED_SHIFT_SLACK ) {
+    return;
+  }
+
+  GDA_Vector* elements;
+  GDA_vector_create( &elements, sizeof(GDA_RMAHashMap_Element), 64 /* initial capacity */ );
+  GDA_CollectLocalElementsInRMAHashMap( elements, index->hashmap );
+
+  /**
+    removed elements don't shrink the bounds in between, so use the
+    exact bounds for the new width
+   */
+  uint64_t local_bounds[2] = { UINT64_MAX, 0 };
+  for( size_t i=0 ; i<elements->size ; i++ ) {
+    GDA_RMAHashMap_Element* element = GDA_vector_at( elements, i );
+    if( element->key < local_bounds[0] ) {
+      local_bounds[0] = element->key;
+    }
+    if( element->key > local_bounds[1] ) {
+      local_bounds[1] = element->key;
+    }
+  }
+  MPI_Allreduce( &(local_bounds[0]), &(bounds[0]), 1, MPI_UINT64_T, MPI_MIN, graph_db->comm );
+  MPI_Allreduce( &(local_bounds[1]), &(bounds[1]), 1, MPI_UINT64_T, MPI_MAX, graph_db->comm );
+
+  if( graph_db->commrank == 0 ) {
+    RMA_Put( bounds, 2, MPI_UINT64_T, 0, 0, 2, MPI_UINT64_T, index->win_bounds );
+    RMA_Win_flush( 0, index->win_bounds );
+  }
+  index->known_bounds[0] = bounds[0];
+  index->known_bounds[1] = bounds[1];
+
+  if( bounds[0] <= bounds[1] ) {
+    index->range_shift = GDA_IndexRangeShiftForKeys( bounds[0], bounds[1], num_elements );
+  }
+
+  GDA_RMAHashMap hashmap;
+  GDA_CreateRMAHashMap( index->hashmap->table_size_total /* table size */, index->hashmap->table_size_total /* heap size */, graph_db->comm, &hashmap );
+  /**
+    make sure that the new hash table is initialized everywhere, before
+    any process inserts into it
+   */
+  MPI_Barrier( graph_db->comm );
+
+  for( size_t i=0 ; i<elements->size ; i++ ) {
+    GDA_RMAHashMap_Element* element = GDA_vector_at( elements, i );
+    GDA_InsertElementIntoRMAHashMap( GDA_IndexHashedKey( element->key, index ), element->key, element->value, element->incarnation, hashmap );
+  }
+  GDA_vector_free( &elements );
+
+  /**
+    all processes have to finish reading the old hash table and
+    inserting into the new one
+   */
+  MPI_Barrier( graph_db->comm );
+
+  GDA_FreeRMAHashMap( &(index->hashmap) );
+  index->hashmap = hashmap;
+}
+
+
+static int GDA_CompareUIDs( const void* a, const void* b ) {
+  uint64_t x = *(const uint64_t*)a;
+  uint64_t y = *(const uint64_t*)b;
+  return (x > y) - (x < y);
+}
+
+
+/**
+  appends the UIDs of all vertices, whose key lies within
+  [key_min, key_max], to uids
+
+  hash indexes only support key_min == key_max
+
+  the UIDs are sorted and each UID is reported only once
+ */
+void GDA_FindInIndex( uint64_t key_min, uint64_t key_max, GDA_Vector* uids, GDI_Index index ) {
+  GDA_Vector* elements;
+  GDA_vector_create( &elements, sizeof(GDA_RMAHashMap_Element), 16 /* initial capacity */ );
+
+  if( index->itype == GDI_INDEX_HASH ) {
+    assert( key_min == key_max );
+    GDA_CollectElementsInRMAHashMap( GDA_IndexHashedKey( key_min, index ), key_min, key_max, elements, index->hashmap );
+  } else {
+    if( index->itype == GDI_INDEX_ORDERED ) {
+      /**
+        clip the range to the keys in the index
+       */
+      uint64_t bounds[2];
+      GDA_GetIndexBounds( bounds, index );
+      if( key_min < bounds[0] ) {
+        key_min = bounds[0];
+      }
+      if( key_max > bounds[1] ) {
+        key_max = bounds[1];
+      }
+      if( key_min > key_max ) {
+        GDA_vector_free( &elements );
+        return;
+      }
+    }
+
+    unsigned shift = GDA_IndexRangeShift( index );
+    uint64_t range_min = key_min >> shift;
+    uint64_t range_max = key_max >> shift;
+
+    if( (range_max - range_min) < index->hashmap->table_size_total ) {
+      /**
+        visit the chain of every range
+       */
+      for( uint64_t range=range_min ; ; range++ ) {
+        GDA_CollectElementsInRMAHashMap( GDA_IndexHashedKey( range << shift, index ), key_min, key_max, elements, index->hashmap );
+        if( range == range_max ) {
+          break;
+        }
+      }
+    } else {
+      GDA_CollectAllElementsInRMAHashMap( key_min, key_max, elements, index->hashmap );
+    }
+  }
+
+  size_t start_size = uids->size;
+  for( size_t i=0 ; i<elements->size ; i++ ) {
+    GDA_RMAHashMap_Element* element = GDA_vector_at( elements, i );
+    GDA_vector_push_back( uids, &(element->value) );
+  }
+  GDA_vector_free( &elements );
+
+  /**
+    remove duplicates: ranges can share a table slot, elements can be
+    seen twice during a rehash and a vertex can carry the same value
+    more than once
+   */
+  uint64_t* data = (uint64_t*)(uids->data) + start_size;
+  size_t num_uids = uids->size - start_size;
+  if( num_uids > 1 ) {
+    qsort( data, num_uids, sizeof(uint64_t), GDA_CompareUIDs );
+    size_t num_unique = 1;
+    for( size_t i=1 ; i<num_uids ; i++ ) {
+      if( data[i] != data[num_unique-1] ) {
+        data[num_unique++] = data[i];
+      }
+    }
+    uids->size = start_size + num_unique;
+  }
+}
+
+
+/**
+  retrieves all labels of the vertex
+
+  the caller has to free labels
+ */
+static void GDA_GetLabelsOfVertex( GDI_VertexHolder vertex, GDI_Label** labels, size_t* num_labels ) {
+  *labels = malloc( 10 * sizeof(GDI_Label) );
+  assert( *labels != NULL );
+  int ret = GDA_LinearScanningFindAllLabels( vertex, *labels, 10, num_labels );
+
+  if( ret == GDI_ERROR_TRUNCATE ) {
+    GDA_LinearScanningNumLabels( vertex, num_labels );
+    *labels = realloc( *labels, *num_labels * sizeof(GDI_Label) );
+    assert( *labels != NULL );
+
+    ret = GDA_LinearScanningFindAllLabels( vertex, *labels, *num_labels, num_labels );
+  }
+  assert( ret == GDI_SUCCESS );
+}
+
+
+/**
+  computes the entries of the vertex in a single secondary index based on
+  its current labels and properties
+ */
+static void GDA_ComputeEntriesOfIndex( GDI_VertexHolder vertex, const GDI_Label* labels, size_t num_labels, GDI_Index index, GDA_Vector* entries ) {
+  if( index->label != GDI_LABEL_NONE ) {
+    bool found_flag = false;
+    for( size_t i=0 ; i<num_labels ; i++ ) {
+      if( labels[i] == index->label ) {
+        found_flag = true;
+        break;
+      }
+    }
+    if( !found_flag ) {
+      return;
+    }
+  }
+
+  if( index->itype == GDI_INDEX_BITMAP ) {
+    if( index->label != GDI_LABEL_NONE ) {
+      /**
+        the bitmap of all vertices is maintained separately
+       */
+      GDA_IndexEntry entry;
+      entry.index = index;
+      entry.key = 0;
+      GDA_vector_push_back( entries, &entry );
+    }
+    return;
+  }
+
+  if( index->dictionary_flag ) {
+    /**
+      the keys are the codes, so encoded values are not decoded
+     */
+    GDA_PropertyCursor cursor;
+    GDA_LinearScanningInitPropertyCursor( &cursor, index->ptype, vertex );
+
+    const char* value;
+    uint64_t size, code;
+    while( GDA_LinearScanningNextPropertyCode( &value, &size, &code, &cursor ) ) {
+      GDA_IndexEntry entry;
+      entry.index = index;
+      entry.key = (value == NULL) ? code : GDA_DictionaryCode( value, size );
+      GDA_vector_push_back( entries, &entry );
+    }
+    return;
+  }
+
+  /**
+    retrieve all values of the property type
+   */
+  size_t num_values;
+  size_t num_elements;
+  GDA_LinearScanningNumProperties( vertex, index->ptype, &num_values, &num_elements );
+  if( num_values == 0 ) {
+    return;
+  }
+
+  size_t dsize;
+  GDI_GetSizeOfDatatype( &dsize, index->ptype->dtype );
+  char* buf = malloc( num_elements * dsize + 1 /* avoid a zero sized allocation */ );
+  assert( buf != NULL );
+  size_t* offsets = malloc( (num_values + 1) * sizeof(size_t) );
+  assert( offsets != NULL );
+
+  size_t buf_resultcount;
+  size_t offset_resultcount;
+  int ret = GDA_LinearScanningFindAllProperties( buf, num_elements, &buf_resultcount, offsets, num_values + 1, &offset_resultcount, index->ptype, vertex );
+  assert( ret == GDI_SUCCESS );
+
+  for( size_t i=0 ; i<num_values ; i++ ) {
+    GDA_IndexEntry entry;
+    entry.index = index;
+    if( GDA_EncodeIndexKey( &(entry.key), buf + offsets[i] * dsize, offsets[i+1] - offsets[i], index ) ) {
+      GDA_vector_push_back( entries, &entry );
+    }
+  }
+
+  free( offsets );
+  free( buf );
+}
+
+
+/**
+  computes all entries of the vertex in the secondary indexes based on
+  its current labels and properties
+ */
+static void GDA_ComputeIndexEntries( GDI_VertexHolder vertex, GDA_Vector* entries ) {
+  GDI_Label* labels;
+  size_t num_labels;
+  GDA_GetLabelsOfVertex( vertex, &labels, &num_labels );
+
+  for( GDA_Node* node = vertex->transaction->db->indexes->head ; node != NULL ; node = node->next ) {
+    GDA_ComputeEntriesOfIndex( vertex, labels, num_labels, *(GDI_Index*)(node->value), entries );
+  }
+
+  free( labels );
+}
+
+
+/**
+  adds (insert_flag == true) or removes a single entry of the vertex with
+  the given UID
+ */
+static void GDA_ApplyIndexEntry( const GDA_IndexEntry* entry, uint64_t uid, uint32_t incarnation, bool insert_flag, GDI_Database graph_db ) {
+  GDI_Index index = entry->index;
+
+  if( index->itype == GDI_INDEX_BITMAP ) {
+    uint64_t offset, target_rank;
+    GDA_GetDPointer( &offset, &target_rank, uid );
+    if( insert_flag ) {
+      GDA_SetBitInRMABitmap( offset / graph_db->block_size, target_rank, index->bitmap );
+    } else {
+      GDA_ClearBitInRMABitmap( offset / graph_db->block_size, target_rank, index->bitmap );
+    }
+    return;
+  }
+
+  if( insert_flag ) {
+    if( index->itype == GDI_INDEX_ORDERED ) {
+      GDA_ExtendIndexBounds( entry->key, index );
+    }
+    GDA_InsertElementIntoRMAHashMap( GDA_IndexHashedKey( entry->key, index ), entry->key, uid, incarnation, index->hashmap );
+  } else {
+    /**
+      the removal might fail, if the entry was created before the
+      index existed
+     */
+    GDA_RemoveElementWithValueFromRMAHashMap( GDA_IndexHashedKey( entry->key, index ), entry->key, uid, index->hashmap );
+  }
+}
+
+
+/**
+  records the entries of the vertex in the secondary indexes, before its
+  labels or properties are changed for the first time in the transaction
+
+  has to be called by every function, that changes labels or properties
+  of a vertex, before the change is applied
+ */
+void GDA_SnapshotIndexEntries( GDI_VertexHolder vertex ) {
+  if( vertex->creation_flag || (vertex->index_entries != NULL) || (vertex->transaction->db->indexes->size == 0) ) {
+    /**
+      vertex has no entries yet, they were already recorded, or there
+      are no indexes
+     */
+    return;
+  }
+
+  GDA_vector_create( &(vertex->index_entries), sizeof(GDA_IndexEntry), 4 /* initial capacity */ );
+  GDA_ComputeIndexEntries( vertex, vertex->index_entries );
+}
+
+
+static int GDA_CompareIndexEntries( const void* a, const void* b ) {
+  const GDA_IndexEntry* x = a;
+  const GDA_IndexEntry* y = b;
+
+  if( x->index != y->index ) {
+    return ((uintptr_t)(x->index) > (uintptr_t)(y->index)) ? 1 : -1;
+  }
+  return (x->key > y->key) - (x->key < y->key);
+}
+
+
+/**
+  brings the secondary indexes up to date with the changes to the
+  vertex during the transaction
+
+  only the difference between the recorded and the current entries is
+  applied, so that unrelated changes don't touch the indexes
+
+  called during the commit of a single process transaction
+ */
+void GDA_UpdateIndexes( GDI_VertexHolder vertex ) {
+  if( vertex->transaction->db->indexes->size == 0 ) {
+    return;
+  }
+
+  if( vertex->creation_flag && vertex->delete_flag ) {
+    /**
+      vertex never became visible
+     */
+    return;
+  }
+
+  if( !(vertex->creation_flag) && (vertex->index_entries == NULL) ) {
+    /**
+      neither labels nor properties were changed
+     */
+    return;
+  }
+
+  GDA_Vector* new_entries;
+  GDA_vector_create( &new_entries, sizeof(GDA_IndexEntry), 4 /* initial capacity */ );
+  if( !(vertex->delete_flag) ) {
+    GDA_ComputeIndexEntries( vertex, new_entries );
+  }
+
+  GDA_IndexEntry* old_data = NULL;
+  size_t num_old = 0;
+  if( vertex->index_entries != NULL ) {
+    old_data = vertex->index_entries->data;
+    num_old = vertex->index_entries->size;
+  }
+  GDA_IndexEntry* new_data = new_entries->data;
+  size_t num_new = new_entries->size;
+
+  if( num_old > 1 ) {
+    qsort( old_data, num_old, sizeof(GDA_IndexEntry), GDA_CompareIndexEntries );
+  }
+  if( num_new > 1 ) {
+    qsort( new_data, num_new, sizeof(GDA_IndexEntry), GDA_CompareIndexEntries );
+  }
+
+  /**
+    distributed pointer to the primary block
+   */
+  uint64_t uid = *(uint64_t*)(vertex->blocks->data);
+
+  size_t i = 0;
+  size_t j = 0;
+  while( (i < num_old) || (j < num_new) ) {
+    int cmp;
+    if( i == num_old ) {
+      cmp = 1;
+    } else {
+      if( j == num_new ) {
+        cmp = -1;
+      } else {
+        cmp = GDA_CompareIndexEntries( &(old_data[i]), &(new_data[j]) );
+      }
+    }
+
+    if( cmp < 0 ) {
+      /**
+        entry is gone
+       */
+      GDA_ApplyIndexEntry( &(old_data[i]), uid, vertex->incarnation, false, vertex->transaction->db );
+      i++;
+    } else {
+      if( cmp > 0 ) {
+        /**
+          entry is new
+         */
+        GDA_ApplyIndexEntry( &(new_data[j]), uid, vertex->incarnation, true, vertex->transaction->db );
+        j++;
+      } else {
+        /**
+          entry is unchanged
+         */
+        i++;
+        j++;
+      }
+    }
+  }
+
+  GDA_vector_free( &new_entries );
+}
+
+
+void GDA_FreeIndexEntries( GDI_VertexHolder vertex ) {
+  if( vertex->index_entries != NULL ) {
+    GDA_vector_free( &(vertex->index_entries) );
+  }
+}
+
+
+/**
+  sets the bit of a created vertex and clears the bit of a deleted vertex
+  in the bitmap of all vertices
+
+  called during the commit of a single process transaction, for deleted
+  vertices before their blocks are released
+ */
+void GDA_UpdateVertexBitmap( GDI_VertexHolder vertex ) {
+  if( vertex->creation_flag == vertex->delete_flag ) {
+    /**
+      vertex either never became visible or remains in the database
+     */
+    return;
+  }
+
+  uint64_t offset, target_rank;
+  GDA_GetDPointer( &offset, &target_rank, *(uint64_t*)(vertex->blocks->data) );
+
+  GDI_Database db = vertex->transaction->db;
+  if( vertex->creation_flag ) {
+    GDA_SetBitInRMABitmap( offset / db->block_size, target_rank, db->vertex_bitmap );
+  } else {
+    GDA_ClearBitInRMABitmap( offset / db->block_size, target_rank, db->vertex_bitmap );
+  }
+}
+
+
+/**
+  appends the UIDs of all vertices of a bitmap index, whose primary
+  blocks are stored on the local process, to uids in ascending order
+ */
+void GDA_CollectLocalVerticesOfIndex( GDA_Vector* uids, GDI_Index index ) {
+  assert( index->itype == GDI_INDEX_BITMAP );
+
+  GDI_Database graph_db = index->db;
+
+  size_t start_size = uids->size;
+  GDA_CollectLocalBitsOfRMABitmap( uids, index->bitmap );
+
+  /**
+    translate the block numbers into vertex UIDs
+   */
+  uint64_t* data = uids->data;
+  for( size_t i=start_size ; i<uids->size ; i++ ) {
+    GDA_SetDPointer( data[i] * graph_db->block_size, graph_db->commrank, &(data[i]) );
+  }
+}
+
+
+/**
+  adds the entries of all vertices, whose primary blocks are stored on
+  the local process, to a newly created index
+
+  each vertex is released right after its entries are added, so that
+  the transaction doesn't accumulate the whole local graph
+
+  has to be called inside a collective transaction
+ */
+void GDA_BackfillIndex( GDI_Index index, GDI_Transaction transaction ) {
+  assert( transaction->type == GDI_COLLECTIVE_TRANSACTION );
+
+  if( (index->itype == GDI_INDEX_BITMAP) && (index->label == GDI_LABEL_NONE) ) {
+    /**
+      index shares the bitmap of all vertices
+     */
+    return;
+  }
+
+  GDI_Database graph_db = transaction->db;
+
+  GDA_Vector* uids;
+  GDA_vector_create( &uids, sizeof(uint64_t), 64 /* initial capacity */ );
+  GDA_CollectLocalBitsOfRMABitmap( uids, graph_db->vertex_bitmap );
+
+  GDA_Vector* entries;
+  GDA_vector_create( &entries, sizeof(GDA_IndexEntry), 4 /* initial capacity */ );
+
+  for( size_t i=0 ; i<uids->size ; i++ ) {
+    GDI_Vertex_uid uid;
+    GDA_SetDPointer( *(uint64_t*)GDA_vector_at( uids, i ) * graph_db->block_size, graph_db->commrank, &uid );
+
+    GDI_VertexHolder vertex;
+    int ret = GDI_AssociateVertex( uid, transaction, &vertex );
+    assert( ret == GDI_SUCCESS );
+    GDA_ReadVertexIncarnation( vertex );
+
+    GDI_Label* labels;
+    size_t num_labels;
+    GDA_GetLabelsOfVertex( vertex, &labels, &num_labels );
+
+    entries->size = 0;
+    GDA_ComputeEntriesOfIndex( vertex, labels, num_labels, index, entries );
+    for( size_t j=0 ; j<entries->size ; j++ ) {
+      GDA_ApplyIndexEntry( GDA_vector_at( entries, j ), uid, vertex->incarnation, true, graph_db );
+    }
+
+    free( labels );
+
+    /**
+      release the vertex object again
+     */
+    GDA_vector_pop_back( transaction->vertices );
+    GDA_hashmap_erase( transaction->v_translate_d2l, &uid );
+    GDA_LinearScanningFreePropertyList( vertex );
+    GDA_LightweightEdgesFree( vertex );
+    GDA_list_free( &(vertex->edges) );
+    GDA_vector_free( &(vertex->blocks) );
+    free( vertex );
+  }
+
+  GDA_vector_free( &entries );
+  GDA_vector_free( &uids );
+}
@@ -0,0 +1,97 @@
+// Copyright (c) 2023 ETH Zurich.
+//                    All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef __GDA_INDEX_H
+#define __GDA_INDEX_H
+
+#include "gdi.h"
+
+/**
+  maintenance and lookup code of the secondary indexes (GDI_Index)
+
+  Each index stores an element per indexed property value in a
+  distributed hash table: the key is the encoded property value and the
+  value is the UID of the vertex.
+
+  GDI_INDEX_HASH stores the elements under the key itself, while
+  GDI_INDEX_ORDERED stores them under the bucket of 2^range_shift
+  consecutive keys, that contains the key. A range lookup is first
+  clipped to the smallest and largest key in the index, and then visits
+  one chain per covered bucket, or scans the whole index, if the range
+  covers more buckets than the index has table slots.
+
+  The width of the buckets starts with a guess per datatype and is
+  adapted to the keys at every collective maintenance point (and once
+  after the index is filled by GDI_CreateIndex): assuming that the keys
+  are spread evenly between the bounds, the width is chosen such that
+  a bucket holds about GDA_INDEX_ORDERED_BUCKET_ELEMENTS elements, and
+  all elements are moved into a new hash table, if the width changes by
+  a factor of 2^GDA_INDEX_ORDERED_SHIFT_SLACK or more.
+
+  GDI_INDEX_PREFIX uses the ordered scheme for strings: the key packs the
+  first 8 characters, and elements are stored under the first
+  GDA_INDEX_PREFIX_BUCKET_CHARS characters, so that a prefix lookup only
+  visits the chains of the matching buckets.
+
+  GDI_INDEX_BITMAP doesn't use a hash table, but sets the bit of the
+  primary block of each indexed vertex in a distributed bitmap, so that
+  every process can enumerate its local vertices.
+ */
+
+
+/**
+  constant definitions
+ */
+
+/**
+  initial width of the buckets of ordered indexes (in bits of the key):
+  integers start with small buckets, while floating point numbers start
+  with 2^8 buckets per power of two
+ */
+#define GDA_INDEX_ORDERED_RANGE_BITS       4
+#define GDA_INDEX_ORDERED_FLOAT_RANGE_BITS 44
+#define GDA_INDEX_ORDERED_BUCKET_ELEMENTS  16
+#define GDA_INDEX_ORDERED_SHIFT_SLACK      2
+#define GDA_INDEX_PREFIX_BUCKET_CHARS 2
+
+
+/**
+  data type definitions
+ */
+
+/**
+  single entry of a vertex in a secondary index
+ */
+typedef struct GDA_IndexEntry_desc {
+  GDI_Index index;
+  uint64_t key;
+} GDA_IndexEntry;
+
+
+/**
+  function prototypes
+ */
+
+void GDA_CreateIndex( uint8_t itype, GDI_Label label, GDI_PropertyType ptype, GDI_Database graph_db, GDI_Index* index );
+void GDA_FreeIndex( GDI_Index* index );
+void GDA_FreeAllIndexes( GDI_Database graph_db );
+void GDA_MaintainIndexes( GDI_Database graph_db );
+void GDA_AdaptIndexBuckets( GDI_Index index );
+
+bool GDA_IsExactPropertyType( GDI_PropertyType ptype );
+bool GDA_EncodeIndexKey( uint64_t* key, const void* value, size_t count, GDI_Index index );
+void GDA_EncodeIndexPrefixRange( uint64_t* key_min, uint64_t* key_max, const void* prefix, size_t length );
+void GDA_FindInIndex( uint64_t key_min, uint64_t key_max, GDA_Vector* uids, GDI_Index index );
+
+void GDA_SnapshotIndexEntries( GDI_VertexHolder vertex );
+void GDA_UpdateIndexes( GDI_VertexHolder vertex );
+void GDA_FreeIndexEntries( GDI_VertexHolder vertex );
+
+void GDA_UpdateVertexBitmap( GDI_VertexHolder vertex );
+void GDA_CollectLocalVerticesOfIndex( GDA_Vector* uids, GDI_Index index );
+void GDA_BackfillIndex( GDI_Index index, GDI_Transaction transaction );
+
+#endif // #ifndef __GDA_INDEX_H
@@ -0,0 +1,238 @@
+// Copyright (c) 2023 ETH Zurich.
+//                    All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <assert.h>
+
+#include "gda_internal_index.h"
+
+/**
+  collective call
+ */
+void GDA_CreateInternalIndex( uint8_t index_type, bool filter_flag, GDI_Database graph_db ) {
+  /**
+    calculate the total number of blocks in the database first
+   */
+  size_t num_blocks = graph_db->memsize / graph_db->block_size * graph_db->commsize;
+
+  graph_db->internal_index_type = index_type;
+  graph_db->internal_index = NULL;
+  graph_db->internal_bucket_index = NULL;
+  graph_db->internal_index_filter = NULL;
+
+  GDA_CreateTranslationCache( GDA_TRANSLATION_CACHE_ENTRIES, &(graph_db->translation_cache) );
+
+  if( filter_flag ) {
+    /**
+      one block of GDA_BLOOM_BLOCK_COUNTERS counters per four database
+      blocks, which leaves at least eight counters per vertex
+     */
+    GDA_CreateRMABloomFilter( num_blocks/4 /* number of blocks */, graph_db->comm, &(graph_db->internal_index_filter) );
+  }
+
+  if( index_type == GDA_INTERNAL_INDEX_BUCKETS ) {
+    /**
+      one bucket with GDA_BUCKET_ENTRIES entries per block, the entries
+      of full buckets go into the overflow table
+     */
+    GDA_CreateRMABucketHashMap( num_blocks /* number of buckets */, graph_db->comm, &(graph_db->internal_bucket_index) );
+  } else {
+    assert( index_type == GDA_INTERNAL_INDEX_CHAINED );
+    GDA_CreateRMAHashMap( num_blocks/3 /* table size */, 2 * num_blocks /* heap size */, graph_db->comm, &(graph_db->internal_index) );
+  }
+}
+
+
+/**
+  collective call
+ */
+void GDA_FreeInternalIndex( GDI_Database graph_db ) {
+  GDA_FreeTranslationCache( &(graph_db->translation_cache) );
+
+  if( graph_db->internal_index_filter != NULL ) {
+    GDA_FreeRMABloomFilter( &(graph_db->internal_index_filter) );
+  }
+
+  if( graph_db->internal_index_type == GDA_INTERNAL_INDEX_BUCKETS ) {
+    GDA_FreeRMABucketHashMap( &(graph_db->internal_bucket_index) );
+  } else {
+    GDA_FreeRMAHashMap( &(graph_db->internal_index) );
+  }
+}
+
+
+/**
+  process, that owns the table slot of a key, which also holds the block
+  of the key in the filter
+ */
+static inline uint64_t GDA_RankOfKeyInInternalIndex( uint64_t hashed_key, GDI_Database graph_db ) {
+  if( graph_db->internal_index_type == GDA_INTERNAL_INDEX_BUCKETS ) {
+    return GDA_RankOfKeyInRMABucketHashMap( hashed_key, graph_db->internal_bucket_index );
+  }
+  return GDA_RankOfKeyInRMAHashMap( hashed_key, graph_db->internal_index );
+}
+
+
+void GDA_InsertIntoInternalIndex( uint64_t hashed_key, uint64_t key, uint64_t value, uint64_t incarnation, GDI_Database graph_db ) {
+  if( graph_db->internal_index_filter != NULL ) {
+    GDA_AddToRMABloomFilter( GDA_RankOfKeyInInternalIndex( hashed_key, graph_db ), hashed_key, key, graph_db->internal_index_filter );
+  }
+
+  if( graph_db->internal_index_type == GDA_INTERNAL_INDEX_BUCKETS ) {
+    GDA_InsertElementIntoRMABucketHashMap( hashed_key, key, value, incarnation, graph_db->internal_bucket_index );
+  } else {
+    GDA_InsertElementIntoRMAHashMap( hashed_key, key, value, incarnation, graph_db->internal_index );
+  }
+
+  /**
+    the creating process is likely to translate the ID soon
+   */
+  GDA_UpdateTranslationCache( hashed_key, key, value, incarnation, graph_db->translation_cache );
+}
+
+
+void GDA_FindInInternalIndex( uint64_t hashed_key, uint64_t key, uint64_t* value, uint64_t* incarnation, bool* found_flag, GDI_Database graph_db ) {
+  if( graph_db->internal_index_filter != NULL ) {
+    if( !GDA_QueryRMABloomFilter( GDA_RankOfKeyInInternalIndex( hashed_key, graph_db ), hashed_key, key, graph_db->internal_index_filter ) ) {
+      *found_flag = false;
+      *value = GDA_DPOINTER_NULL;
+      return;
+    }
+  }
+
+  if( graph_db->internal_index_type == GDA_INTERNAL_INDEX_BUCKETS ) {
+    GDA_FindElementInRMABucketHashMap( hashed_key, key, value, incarnation, found_flag, graph_db->internal_bucket_index );
+  } else {
+    GDA_FindElementInRMAHashMap( hashed_key, key, value, incarnation, found_flag, graph_db->internal_index );
+  }
+}
+
+
+static void GDA_FindManyInIndex( size_t count, const uint64_t* hashed_keys, const uint64_t* keys, uint64_t* values, uint64_t* incarnations, bool* found_flags, GDI_Database graph_db ) {
+  if( graph_db->internal_index_type == GDA_INTERNAL_INDEX_BUCKETS ) {
+    GDA_FindElementsInRMABucketHashMap( count, hashed_keys, keys, values, incarnations, found_flags, graph_db->internal_bucket_index );
+  } else {
+    GDA_FindElementsInRMAHashMap( count, hashed_keys, keys, values, incarnations, found_flags, graph_db->internal_index );
+  }
+}
+
+
+void GDA_FindManyInInternalIndex( size_t count, const uint64_t* hashed_keys, const uint64_t* keys, uint64_t* values, uint64_t* incarnations, bool* found_flags, GDI_Database graph_db ) {
+  if( (graph_db->internal_index_filter == NULL) || (count == 0) ) {
+    GDA_FindManyInIndex( count, hashed_keys, keys, values, incarnations, found_flags, graph_db );
+    return;
+  }
+
+  /**
+    query the filter for all keys, and only look up those keys in the
+    index, that might be present
+   */
+  uint64_t* ranks = malloc( count * sizeof(uint64_t) );
+  assert( ranks != NULL );
+  for( size_t i=0 ; i<count ; i++ ) {
+    ranks[i] = GDA_RankOfKeyInInternalIndex( hashed_keys[i], graph_db );
+  }
+  GDA_QueryManyRMABloomFilter( count, ranks, hashed_keys, keys, found_flags, graph_db->internal_index_filter );
+  free( ranks );
+
+  size_t num_candidates = 0;
+  for( size_t i=0 ; i<count ; i++ ) {
+    if( found_flags[i] ) {
+      num_candidates++;
+    }
+  }
+
+  if( num_candidates == count ) {
+    GDA_FindManyInIndex( count, hashed_keys, keys, values, incarnations, found_flags, graph_db );
+    return;
+  }
+
+  size_t* positions = NULL;
+  uint64_t* c_hashed_keys = NULL;
+  uint64_t* c_keys = NULL;
+  uint64_t* c_values = NULL;
+  uint64_t* c_incarnations = NULL;
+  bool* c_found_flags = NULL;
+
+  if( num_candidates > 0 ) {
+    positions = malloc( num_candidates * sizeof(size_t) );
+    assert( positions != NULL );
+    c_hashed_keys = malloc( num_candidates * sizeof(uint64_t) );
+    assert( c_hashed_keys != NULL );
+    c_keys = malloc( num_candidates * sizeof(uint64_t) );
+    assert( c_keys != NULL );
+    c_values = malloc( num_candidates * sizeof(uint64_t) );
+    assert( c_values != NULL );
+    c_incarnations = malloc( num_candidates * sizeof(uint64_t) );
+    assert( c_incarnations != NULL );
+    c_found_flags = malloc( num_candidates * sizeof(bool) );
+    assert( c_found_flags != NULL );
+  }
+
+  size_t pos = 0;
+  for( size_t i=0 ; i<count ; i++ ) {
+    if( found_flags[i] ) {
+      positions[pos] = i;
+      c_hashed_keys[pos] = hashed_keys[i];
+      c_keys[pos] = keys[i];
+      pos++;
+    }
+    found_flags[i] = false;
+    values[i] = GDA_DPOINTER_NULL;
+  }
+
+  GDA_FindManyInIndex( num_candidates, c_hashed_keys, c_keys, c_values, c_incarnations, c_found_flags, graph_db );
+
+  for( size_t i=0 ; i<num_candidates ; i++ ) {
+    found_flags[positions[i]] = c_found_flags[i];
+    values[positions[i]] = c_values[i];
+    incarnations[positions[i]] = c_incarnations[i];
+  }
+
+  free( c_found_flags );
+  free( c_incarnations );
+  free( c_values );
+  free( c_keys );
+  free( c_hashed_keys );
+  free( positions );
+}
+
+
+bool GDA_RemoveFromInternalIndex( uint64_t hashed_key, uint64_t key, GDI_Database graph_db ) {
+  bool found_flag;
+  if( graph_db->internal_index_type == GDA_INTERNAL_INDEX_BUCKETS ) {
+    found_flag = GDA_RemoveElementFromRMABucketHashMap( hashed_key, key, graph_db->internal_bucket_index );
+  } else {
+    found_flag = GDA_RemoveElementFromRMAHashMap( hashed_key, key, graph_db->internal_index );
+  }
+
+  /**
+    caches of other processes are validated lazily by the incarnation
+   */
+  GDA_InvalidateTranslationCache( hashed_key, key, graph_db->translation_cache );
+
+  if( found_flag && (graph_db->internal_index_filter != NULL) ) {
+    GDA_RemoveFromRMABloomFilter( GDA_RankOfKeyInInternalIndex( hashed_key, graph_db ), hashed_key, key, graph_db->internal_index_filter );
+  }
+
+  return found_flag;
+}
+
+
+/**
+  collective call, that may only be issued, while no process accesses the
+  internal index (see GDI_StartCollectiveTransaction)
+
+  the chained hashtable (or the overflow table of the bucket hashtable)
+  finishes the rehash of the local part of its table and frees table
+  generations, that are not used anymore
+ */
+void GDA_MaintainInternalIndex( GDI_Database graph_db ) {
+  if( graph_db->internal_index_type == GDA_INTERNAL_INDEX_BUCKETS ) {
+    GDA_MaintainRMABucketHashMap( graph_db->internal_bucket_index );
+  } else {
+    GDA_MaintainRMAHashMap( graph_db->internal_index );
+  }
+}
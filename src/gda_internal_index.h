@@ -0,0 +1,39 @@
+// Copyright (c) 2023 ETH Zurich.
+//                    All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef __GDA_INTERNAL_INDEX_H
+#define __GDA_INTERNAL_INDEX_H
+
+#include "gdi.h"
+
+/**
+  This header provides the functions to access the internal index, which
+  translates application-level IDs into vertex UIDs. The calls are
+  forwarded to the hashtable implementation, that was selected at
+  GDI_CreateDatabase (internal_index_type).
+
+  If the Bloom filter is enabled, inserts add the key to the filter
+  first and removals take it out afterwards, so that lookups may skip
+  the index for all keys, that the filter rules out.
+
+  The translation cache of the local process is kept up to date with
+  inserts and removals issued by this process.
+ */
+
+
+/**
+  function prototypes
+ */
+
+void GDA_CreateInternalIndex( uint8_t index_type, bool filter_flag, GDI_Database graph_db );
+void GDA_FreeInternalIndex( GDI_Database graph_db );
+void GDA_InsertIntoInternalIndex( uint64_t hashed_key, uint64_t key, uint64_t value, uint64_t incarnation, GDI_Database graph_db );
+void GDA_FindInInternalIndex( uint64_t hashed_key, uint64_t key, uint64_t* value, uint64_t* incarnation, bool* found_flag, GDI_Database graph_db );
+void GDA_FindManyInInternalIndex( size_t count, const uint64_t* hashed_keys, const uint64_t* keys, uint64_t* values, uint64_t* incarnations, bool* found_flags, GDI_Database graph_db );
+bool GDA_RemoveFromInternalIndex( uint64_t hashed_key, uint64_t key, GDI_Database graph_db );
+void GDA_MaintainInternalIndex( GDI_Database graph_db );
+
+#endif // #ifndef __GDA_INTERNAL_INDEX_H
@@ -10,14 +10,107 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 #include "gda_lightweight_edges.h"
+#include "gda_varint.h"
 
 #define GDA_EDGE_EMPTY                          0
 
 
+/**
+  adds delta to the degree counter of the orientation of an edge with
+  the given metadata
+ */
+static inline void GDA_LightweightEdgesCountEdge( uint8_t metadata, int delta, GDI_VertexHolder vertex ) {
+  vertex->lightweight_edge_degrees[__builtin_ctz( metadata & GDA_LIGHTWEIGHT_EDGES_ORIENTATION )] += delta;
+}
+
+
+/**
+  marks all lightweight edge data as changed, e.g. after edges were
+  moved
+ */
+static inline void GDA_LightweightEdgesMarkAllDirty( GDI_VertexHolder vertex ) {
+  vertex->lightweight_edge_dirty_offset = 0;
+}
+
+
+/**
+  size in Bytes of a buffer of the arrays layout with the given capacity
+ */
+static inline size_t GDA_LightweightEdgesArraysSize( uint64_t capacity ) {
+  return (GDA_LIGHTWEIGHT_EDGES_ARRAYS_HEADER_SIZE + capacity) * sizeof(GDA_DPointer) + 2 * capacity /* metadata and label data */;
+}
+
+
+/**
+  changes the capacity of a buffer of the arrays layout, which has to
+  be large enough for all edge slots in use
+
+  Growing reallocates the buffer and moves the label data and then the
+  metadata to their new positions, while shrinking only moves them down
+  in place, so that the stored part of the buffer is compact.
+ */
+static void GDA_LightweightEdgesResizeArrays( uint64_t capacity, GDI_VertexHolder vertex ) {
+  uint64_t old_capacity = vertex->lightweight_edge_data[0];
+  assert( capacity % GDA_LIGHTWEIGHT_EDGES_ARRAYS_CHUNK == 0 );
+  assert( capacity >= vertex->lightweight_edge_insert_offset - 2 );
+
+  if( capacity > old_capacity ) {
+    vertex->lightweight_edge_size = GDA_LightweightEdgesArraysSize( capacity );
+    vertex->lightweight_edge_data = realloc( vertex->lightweight_edge_data, vertex->lightweight_edge_size );
+    assert( vertex->lightweight_edge_data != NULL );
+
+    uint8_t* arrays = (uint8_t*) (vertex->lightweight_edge_data + GDA_LIGHTWEIGHT_EDGES_ARRAYS_HEADER_SIZE);
+    memmove( arrays + 9 * capacity, arrays + 9 * old_capacity, old_capacity ); /* label data */
+    memmove( arrays + 8 * capacity, arrays + 8 * old_capacity, old_capacity ); /* metadata */
+    /**
+      new slots are unused (= 0) and have the label GDI_LABEL_NONE (= 0)
+     */
+    memset( arrays + 8 * capacity + old_capacity, 0, capacity - old_capacity );
+    memset( arrays + 9 * capacity + old_capacity, 0, capacity - old_capacity );
+  } else {
+    if( capacity < old_capacity ) {
+      uint8_t* arrays = (uint8_t*) (vertex->lightweight_edge_data + GDA_LIGHTWEIGHT_EDGES_ARRAYS_HEADER_SIZE);
+      memmove( arrays + 8 * capacity, arrays + 8 * old_capacity, capacity ); /* metadata */
+      memmove( arrays + 9 * capacity, arrays + 9 * old_capacity, capacity ); /* label data */
+    }
+  }
+
+  if( capacity != old_capacity ) {
+    GDA_LightweightEdgesMarkAllDirty( vertex );
+  }
+  vertex->lightweight_edge_data[0] = capacity;
+}
+
+
 void GDA_LightweightEdgesInit( GDI_VertexHolder vertex ) {
   assert( vertex != NULL );
 
+  vertex->lightweight_edge_encoded = NULL;
+  vertex->lightweight_edge_encoded_size = 0;
+  vertex->lightweight_edge_sorted_slots = 0;
+  for( int j=0 ; j<3 ; j++ ) {
+    vertex->lightweight_edge_degrees[j] = 0;
+  }
+  vertex->lightweight_edge_stored_size = 0;
+  vertex->lightweight_edge_dirty_pages = NULL;
+  vertex->lightweight_edge_num_dirty_pages = 0;
+  GDA_LightweightEdgesMarkAllDirty( vertex );
+
+  if( GDA_LightweightEdgesUseArrays( vertex ) ) {
+    /**
+      empty header, the first chunk of slots is allocated by the resize
+     */
+    vertex->lightweight_edge_data = malloc( GDA_LightweightEdgesArraysSize( 0 ) );
+    assert( vertex->lightweight_edge_data != NULL );
+    vertex->lightweight_edge_data[0] = 0; /* capacity */
+    vertex->lightweight_edge_data[1] = 0; /* number of edge slots */
+    vertex->lightweight_edge_insert_offset = 2;
+    GDA_LightweightEdgesResizeArrays( GDA_LIGHTWEIGHT_EDGES_ARRAYS_CHUNK, vertex );
+    return;
+  }
+
   vertex->lightweight_edge_data = malloc( GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE_BYTES );
   vertex->lightweight_edge_size = GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE_BYTES;
   /**
@@ -41,17 +134,43 @@ void GDA_LightweightEdgesAddEdge( int edge_orientation, GDA_DPointer dpointer, G
   assert( edge_offset != NULL );
   assert( (edge_orientation == GDI_EDGE_INCOMING) || (edge_orientation == GDI_EDGE_OUTGOING) || (edge_orientation == GDI_EDGE_UNDIRECTED) );
 
+  GDA_LightweightEdgesEnsureDecoded( vertex );
+
+  uint8_t* metadata;
+  if( GDA_LightweightEdgesUseArrays( vertex ) ) {
+    /**
+      double the capacity, if all slots are in use
+     */
+    uint64_t capacity = vertex->lightweight_edge_data[0];
+    if( vertex->lightweight_edge_insert_offset - 2 == capacity ) {
+      GDA_LightweightEdgesResizeArrays( (capacity > 0) ? (capacity << 1) : GDA_LIGHTWEIGHT_EDGES_ARRAYS_CHUNK, vertex );
+    }
+
+    GDA_LightweightEdgesGetMetadataPointerWithOffset( &metadata, vertex, vertex->lightweight_edge_insert_offset );
+    *metadata = (uint8_t) edge_orientation;
+    GDA_LightweightEdgesCountEdge( *metadata, 1, vertex );
+    vertex->lightweight_edge_data[vertex->lightweight_edge_insert_offset] = dpointer;
+    vertex->lightweight_edge_data[1]++;
+    GDA_LightweightEdgesMarkDirty( metadata, 1, vertex );
+    GDA_LightweightEdgesMarkDirty( vertex->lightweight_edge_data + vertex->lightweight_edge_insert_offset, sizeof(GDA_DPointer), vertex );
+    GDA_LightweightEdgesMarkDirty( vertex->lightweight_edge_data + 1, sizeof(uint64_t), vertex );
+    *edge_offset = vertex->lightweight_edge_insert_offset++;
+    return;
+  }
+
   /**
     calculate offset of metadata
    */
-  uint8_t* metadata;
   GDA_LightweightEdgesGetMetadataPointerWithOffset( &metadata, vertex, vertex->lightweight_edge_insert_offset );
   *metadata = (uint8_t) edge_orientation;
+  GDA_LightweightEdgesCountEdge( *metadata, 1, vertex );
+  GDA_LightweightEdgesMarkDirty( metadata, 1, vertex );
 
   /**
     insert the actual edge and update the return buffer
    */
   vertex->lightweight_edge_data[vertex->lightweight_edge_insert_offset] = dpointer;
+  GDA_LightweightEdgesMarkDirty( vertex->lightweight_edge_data + vertex->lightweight_edge_insert_offset, sizeof(GDA_DPointer), vertex );
   *edge_offset = vertex->lightweight_edge_insert_offset++;
 
   /**
@@ -67,6 +186,7 @@ void GDA_LightweightEdgesAddEdge( int edge_orientation, GDA_DPointer dpointer, G
       unused (= 0) and the integer handles of the label data to
       GDI_LABEL_NONE (= 0)
      */
+    GDA_LightweightEdgesMarkDirty( vertex->lightweight_edge_data + vertex->lightweight_edge_insert_offset, 2 * sizeof(uint64_t), vertex );
     vertex->lightweight_edge_data[vertex->lightweight_edge_insert_offset++] = GDA_EDGE_EMPTY;
     vertex->lightweight_edge_data[vertex->lightweight_edge_insert_offset++] = 0;
   }
@@ -79,8 +199,7 @@ void GDA_LightweightEdgesRemove( uint32_t edge_offset, GDI_VertexHolder vertex,
    */
   assert( vertex != NULL );
   assert( removed_flag != NULL );
-  assert( (edge_offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE != 0) && (edge_offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE != 1) );
-  assert( edge_offset < vertex->lightweight_edge_insert_offset );
+  assert( GDA_LightweightEdgesIsEdgeOffset( edge_offset, vertex ) );
 
   /**
     calculate offset of metadata
@@ -95,7 +214,9 @@ void GDA_LightweightEdgesRemove( uint32_t edge_offset, GDI_VertexHolder vertex,
     but as they are currently not used they always will be 0
    */
   if( *metadata ) {
+    GDA_LightweightEdgesCountEdge( *metadata, -1, vertex );
     *metadata = GDA_EDGE_EMPTY;
+    GDA_LightweightEdgesMarkDirty( metadata, 1, vertex );
     *removed_flag = true;
   } else {
     *removed_flag = false;
@@ -111,8 +232,7 @@ void GDA_LightweightEdgesGetEdge( GDA_DPointer* dpointer, int* edge_orientation,
   assert( edge_orientation != NULL );
   assert( vertex != NULL );
   assert( found_flag != NULL );
-  assert( (edge_offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE != 0) && (edge_offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE != 1) );
-  assert( edge_offset < vertex->lightweight_edge_insert_offset );
+  assert( GDA_LightweightEdgesIsEdgeOffset( edge_offset, vertex ) );
 
   /**
     calculate offset of metadata
@@ -126,7 +246,7 @@ void GDA_LightweightEdgesGetEdge( GDA_DPointer* dpointer, int* edge_orientation,
    */
   if( *metadata ) {
     *found_flag = true;
-    *edge_orientation = ((int) *metadata) + 256u;
+    *edge_orientation = ((int) (*metadata & GDA_LIGHTWEIGHT_EDGES_ORIENTATION)) + 256u;
     *dpointer = vertex->lightweight_edge_data[edge_offset];
   } else {
     *found_flag = false;
@@ -141,8 +261,7 @@ void GDA_LightweightEdgesGetLabel( uint8_t* label_int_handle, uint32_t edge_offs
   assert( label_int_handle != NULL );
   assert( vertex != NULL );
   assert( found_flag != NULL );
-  assert( (edge_offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE != 0) && (edge_offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE != 1) );
-  assert( edge_offset < vertex->lightweight_edge_insert_offset );
+  assert( GDA_LightweightEdgesIsEdgeOffset( edge_offset, vertex ) );
 
   /**
     calculate offset of metadata
@@ -154,8 +273,10 @@ void GDA_LightweightEdgesGetLabel( uint8_t* label_int_handle, uint32_t edge_offs
     retrieval of the edge label
    */
   if( *metadata ) {
+    uint8_t* label;
+    GDA_LightweightEdgesGetLabelPointerWithOffset( &label, vertex, edge_offset );
     *found_flag = true;
-    *label_int_handle = *(metadata+8);
+    *label_int_handle = *label;
   } else {
     *found_flag = false;
   }
@@ -164,119 +285,259 @@ void GDA_LightweightEdgesGetLabel( uint8_t* label_int_handle, uint32_t edge_offs
 
 void GDA_LightweightEdgesShrink( GDI_VertexHolder vertex ) {
   /**
-  input validation
- */
+    input validation
+   */
   assert( vertex != NULL );
 
-  uint32_t offset, forward_offset, backward_offset, forward_block, backward_block;
-  uint8_t *start_of_edge_array, *end_of_edge_array, *forward_iterator, *backward_iterator;
+  GDA_LightweightEdgesEnsureDecoded( vertex );
+
+  uint32_t num_slots = GDA_LightweightEdgesNumSlots( vertex );
+  uint32_t num_edges = 0;
+  uint32_t num_sorted_edges = 0;
 
   /**
-    initialisation
-   */
-  offset = vertex->lightweight_edge_insert_offset;
-  /**
-    offsets inside a block
+    main loop: move the edges to the front (keeping their order)
    */
-  forward_offset = 0;
+  for( uint32_t i=0 ; i<num_slots ; i++ ) {
+    uint8_t *metadata, *label;
+    uint32_t offset = GDA_LightweightEdgesSlotOffset( i, vertex );
+    GDA_LightweightEdgesGetMetadataPointerWithOffset( &metadata, vertex, offset );
+    if( *metadata == GDA_EDGE_EMPTY ) {
+      continue;
+    }
+    if( i != num_edges ) {
+      uint8_t *free_metadata, *free_label;
+      uint32_t free_offset = GDA_LightweightEdgesSlotOffset( num_edges, vertex );
+      GDA_LightweightEdgesGetMetadataPointerWithOffset( &free_metadata, vertex, free_offset );
+      GDA_LightweightEdgesGetLabelPointerWithOffset( &free_label, vertex, free_offset );
+      GDA_LightweightEdgesGetLabelPointerWithOffset( &label, vertex, offset );
+      *free_metadata = *metadata;
+      *free_label = *label;
+      vertex->lightweight_edge_data[free_offset] = vertex->lightweight_edge_data[offset];
+    }
+    num_edges++;
+    if( i < vertex->lightweight_edge_sorted_slots ) {
+      num_sorted_edges = num_edges;
+    }
+  }
+
   /**
-    offset mod 10
+    the slots behind the edges are unused (= 0) and have the label
+    GDI_LABEL_NONE (= 0), since they are reused by new edges
    */
-  backward_offset = offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE;
+  for( uint32_t i=num_edges ; i<num_slots ; i++ ) {
+    uint8_t *metadata, *label;
+    uint32_t offset = GDA_LightweightEdgesSlotOffset( i, vertex );
+    GDA_LightweightEdgesGetMetadataPointerWithOffset( &metadata, vertex, offset );
+    GDA_LightweightEdgesGetLabelPointerWithOffset( &label, vertex, offset );
+    *metadata = GDA_EDGE_EMPTY;
+    *label = 0;
+  }
+
+  vertex->lightweight_edge_insert_offset = GDA_LightweightEdgesSlotOffset( num_edges, vertex );
+  if( GDA_LightweightEdgesUseArrays( vertex ) ) {
+    vertex->lightweight_edge_data[1] = num_edges;
+  }
+  vertex->lightweight_edge_sorted_slots = num_sorted_edges;
+  GDA_LightweightEdgesMarkAllDirty( vertex );
+}
 
-  forward_block = 0;
+
+/**
+  block kernels
+
+  The filter functions don't walk the metadata byte by byte, but compute
+  a mask per chunk of 8 edge slots instead (a block in the blocked
+  layout, 8 consecutive slots in the arrays layout): bit i of the mask
+  is set, if the edge in slot i of the chunk meets the constraints. The
+  offsets are then emitted by iterating over the set bits of the mask
+  and the counts are computed with a popcount.
+
+  The orientation test works on the whole metadata word at once. The
+  label constraints are turned into a set of 256 bits (one per label
+  integer handle), so that the label test doesn't depend on the length
+  of the white-/blacklist. The label kernel is selected at runtime by
+  CPU feature detection: on x86 processors with SSSE3 the 8 metadata
+  bytes and the 8 label bytes of a chunk are tested with a single set
+  of vector instructions, otherwise the portable scalar kernel is used.
+ */
+
+#define GDA_LIGHTWEIGHT_EDGES_BYTES_01 0x0101010101010101ULL
+#define GDA_LIGHTWEIGHT_EDGES_BYTES_7F 0x7F7F7F7F7F7F7F7FULL
+
+static inline uint64_t GDA_LightweightEdgesLoadWord( const uint8_t* word ) {
   /**
-    offset div 10
+    the metadata and label bytes are written through uint8_t pointers,
+    so read them with memcpy to stay within the aliasing rules
    */
-  backward_block = offset / GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE;
+  uint64_t value;
+  memcpy( &value, word, sizeof(uint64_t) );
+  return value;
+}
+
+
+/**
+  returns the mask of the slots in the chunk, whose metadata byte has a
+  bit in common with orientation
+ */
+static inline uint8_t GDA_LightweightEdgesOrientationMask( const uint8_t* metadata, uint8_t orientation ) {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+  uint64_t word = GDA_LightweightEdgesLoadWord( metadata ) & (orientation * GDA_LIGHTWEIGHT_EDGES_BYTES_01);
   /**
-    need to cast to a uint8_t* as we iterate over Bytes
+    set the highest bit of every non-zero byte (without carries between
+    the bytes) and gather those bits into the lowest byte
    */
-  start_of_edge_array = (uint8_t *) vertex->lightweight_edge_data;
+  word = (((word & GDA_LIGHTWEIGHT_EDGES_BYTES_7F) + GDA_LIGHTWEIGHT_EDGES_BYTES_7F) | word) & ~GDA_LIGHTWEIGHT_EDGES_BYTES_7F;
+  return (uint8_t) (((word >> 7) * 0x0102040810204080ULL) >> 56);
+#else
+  uint8_t mask = 0;
+  for( int i=0 ; i<8 ; i++ ) {
+    if( orientation & metadata[i] ) {
+      mask |= (uint8_t) (1 << i);
+    }
+  }
+  return mask;
+#endif
+}
+
+
+static uint8_t GDA_LightweightEdgesLabelMaskScalar( const uint8_t* metadata, const uint8_t* labels, uint8_t orientation, const uint64_t label_set[4] ) {
+  uint8_t candidates = GDA_LightweightEdgesOrientationMask( metadata, orientation );
+  uint8_t mask = 0;
+
   /**
-    end_of_edge_array points to the metadata of the last edge. It can be 0.
+    only look up the labels of the edges with a fitting orientation
    */
-  end_of_edge_array = start_of_edge_array + (backward_block * GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE_BYTES) + backward_offset;
-  forward_iterator = start_of_edge_array;
-  backward_iterator = end_of_edge_array;
+  while( candidates != 0 ) {
+    int i = __builtin_ctz( candidates );
+    uint8_t label = labels[i];
+    if( (label_set[label >> 6] >> (label & 63)) & 1 ) {
+      mask |= (uint8_t) (1 << i);
+    }
+    candidates &= candidates - 1;
+  }
+  return mask;
+}
+
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <tmmintrin.h>
+
+/**
+  tests the metadata bytes and the label bytes of a chunk at once
+
+  The label set is used as a table of 32 bytes: pshufb looks up byte
+  (label >> 3) in both 16 byte halves of the table and the correct half
+  is selected with a comparison, while a second pshufb turns (label & 7)
+  into the bit within that byte.
+ */
+__attribute__((target("ssse3")))
+static uint8_t GDA_LightweightEdgesLabelMaskSSSE3( const uint8_t* metadata, const uint8_t* labels, uint8_t orientation, const uint64_t label_set[4] ) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i low_nibble = _mm_set1_epi8( 0x0F );
+  const __m128i bits = _mm_setr_epi8( 1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128 );
+
+  __m128i metadata_bytes = _mm_loadl_epi64( (const __m128i*) metadata );
+  __m128i label_bytes = _mm_loadl_epi64( (const __m128i*) labels );
 
   /**
-    main loop
+    the upper halves are zero, so mask them out of the results
    */
-  while( forward_iterator < backward_iterator ) {
-    uint8_t forward_element = *forward_iterator;
-    /**
-      go forwards and find a free slot
-     */
-    while( (forward_iterator < end_of_edge_array) && (forward_element & (uint8_t) (GDI_EDGE_INCOMING | GDI_EDGE_OUTGOING | GDI_EDGE_UNDIRECTED) /* last three bits are not 0 so not a free slot */) ) {
-      if( forward_offset == 7 ) {
-        /**
-          go to the next block
-         */
-        forward_offset = 0;
-        forward_block++;
-      } else {
-        forward_offset++;
-      }
-      forward_iterator = start_of_edge_array + (forward_block * GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE_BYTES) + forward_offset;
-      forward_element = *forward_iterator;
-    }
+  __m128i orientation_hits = _mm_and_si128( metadata_bytes, _mm_set1_epi8( (char) orientation ) );
+  int orientation_mask = ~_mm_movemask_epi8( _mm_cmpeq_epi8( orientation_hits, zero ) );
+
+  __m128i table_low = _mm_loadu_si128( (const __m128i*) label_set );
+  __m128i table_high = _mm_loadu_si128( (const __m128i*) (label_set + 2) );
+  __m128i byte_index = _mm_and_si128( _mm_srli_epi16( label_bytes, 3 ), _mm_set1_epi8( 0x1F ) );
+  __m128i high_half = _mm_cmpgt_epi8( byte_index, low_nibble );
+  byte_index = _mm_and_si128( byte_index, low_nibble );
+  __m128i set_bytes = _mm_or_si128( _mm_andnot_si128( high_half, _mm_shuffle_epi8( table_low, byte_index ) ), _mm_and_si128( high_half, _mm_shuffle_epi8( table_high, byte_index ) ) );
+  __m128i bit_values = _mm_shuffle_epi8( bits, _mm_and_si128( label_bytes, _mm_set1_epi8( 0x07 ) ) );
+  int label_mask = ~_mm_movemask_epi8( _mm_cmpeq_epi8( _mm_and_si128( set_bytes, bit_values ), zero ) );
+
+  return (uint8_t) (orientation_mask & label_mask & 0xFF);
+}
+#endif
 
-    /**
-      go backwards and find an edge
-     */
-    uint8_t backward_element = *backward_iterator;
-    while( (backward_iterator > start_of_edge_array) && !(backward_element & (uint8_t) (GDI_EDGE_INCOMING | GDI_EDGE_OUTGOING | GDI_EDGE_UNDIRECTED))) {
-      if( backward_offset == 0 ) {
-        /**
-          go to the previous block
-         */
-        backward_offset = 7;
-        backward_block--;
-      } else {
-        backward_offset--;
-      }
-      backward_iterator = start_of_edge_array + (backward_block * GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE_BYTES) + backward_offset;
-      backward_element = *backward_iterator;
-    }
 
-    /**
-      check if after iterator adjustment we are still performing a valid move
-     */
-    if( forward_iterator < backward_iterator ) {
-      uint64_t *edge, *free_slot;
+static uint8_t GDA_LightweightEdgesLabelMaskSelect( const uint8_t* metadata, const uint8_t* labels, uint8_t orientation, const uint64_t label_set[4] );
 
-      /**
-        move the meta data into the free slot
-       */
-      *forward_iterator = *backward_iterator;
-      /**
-        move the label data into the free slot
-       */
-      *(forward_iterator+8) = *(backward_iterator+8);
-      /**
-        move pointer into the free slot
-       */
-      edge = (uint64_t *) start_of_edge_array + (backward_block * GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE) + backward_offset + 2;
-      free_slot = (uint64_t *) start_of_edge_array + (forward_block * GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE) + forward_offset + 2;
-      *free_slot = *edge;
-      /**
-        delete old edge meta data
-        needed for correctness of the algorithm, otherwise the backward_iterator is not adjusted
-       */
-      *backward_iterator = 0;
-    }
+/**
+  points to the resolver until the first call, which replaces it with
+  the best kernel for the processor (concurrent first calls store the
+  same value)
+ */
+static uint8_t (*GDA_LightweightEdgesLabelMask)( const uint8_t* metadata, const uint8_t* labels, uint8_t orientation, const uint64_t label_set[4] ) = GDA_LightweightEdgesLabelMaskSelect;
+
+static uint8_t GDA_LightweightEdgesLabelMaskSelect( const uint8_t* metadata, const uint8_t* labels, uint8_t orientation, const uint64_t label_set[4] ) {
+  GDA_LightweightEdgesLabelMask = GDA_LightweightEdgesLabelMaskScalar;
+#if (defined(__x86_64__) || defined(__i386__)) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+  __builtin_cpu_init();
+  if( __builtin_cpu_supports( "ssse3" ) ) {
+    GDA_LightweightEdgesLabelMask = GDA_LightweightEdgesLabelMaskSSSE3;
   }
+#endif
+  return GDA_LightweightEdgesLabelMask( metadata, labels, orientation, label_set );
+}
 
-  /**
-    size in number of blocks
-    for Bytes multiply with a factor of GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE_BYTES
-    for number of edges multiply with a factor of 8
 
-    using forward_block instead of backward_block ensures there is still
-    space left to insert new edges
-   */
-  vertex->lightweight_edge_insert_offset = forward_block * GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE + forward_offset + 2;
+/**
+  chunk of 8 edge slots: pointers to the metadata and label data and
+  the offset of the first slot
+ */
+typedef struct GDA_LightweightEdgesChunk_desc {
+  const uint8_t* metadata;
+  const uint8_t* labels;
+  uint32_t first_offset;
+} GDA_LightweightEdgesChunk;
+
+
+static inline uint32_t GDA_LightweightEdgesNumChunks( GDI_VertexHolder vertex ) {
+  return (GDA_LightweightEdgesNumSlots( vertex ) + 7 /* round up */) / 8;
+}
+
+
+static inline void GDA_LightweightEdgesGetChunk( GDA_LightweightEdgesChunk* chunk, uint32_t chunk_index, GDI_VertexHolder vertex ) {
+  GDA_LightweightEdgesEnsureDecoded( vertex );
+  if( GDA_LightweightEdgesUseArrays( vertex ) ) {
+    uint64_t capacity = vertex->lightweight_edge_data[0];
+    chunk->metadata = ((const uint8_t*) (vertex->lightweight_edge_data + GDA_LIGHTWEIGHT_EDGES_ARRAYS_HEADER_SIZE + capacity)) + chunk_index * 8;
+    chunk->labels = chunk->metadata + capacity;
+    chunk->first_offset = 2 + chunk_index * 8;
+  } else {
+    chunk->metadata = (const uint8_t*) (vertex->lightweight_edge_data + chunk_index * GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE);
+    chunk->labels = chunk->metadata + 8;
+    chunk->first_offset = 2 + chunk_index * GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE;
+  }
+}
+
+
+/**
+  mask of the slots of the chunk with chunk_index, that are in use
+ */
+static inline uint8_t GDA_LightweightEdgesValidMask( uint32_t chunk_index, uint32_t num_slots ) {
+  uint32_t num_chunk_slots = num_slots - chunk_index * 8;
+  if( num_chunk_slots >= 8 ) {
+    return 0xFF;
+  }
+  return (uint8_t) ((1 << num_chunk_slots) - 1);
+}
+
+
+/**
+  appends the offsets of the set bits of mask to array_of_offsets
+
+  returns either GDI_SUCCESS or GDI_ERROR_TRUNCATE
+ */
+static inline int GDA_LightweightEdgesEmitOffsets( uint8_t mask, uint32_t first_offset, uint32_t array_of_offsets[], size_t count, size_t* resultcount ) {
+  while( mask != 0 ) {
+    if( *resultcount == count ) {
+      return GDI_ERROR_TRUNCATE;
+    }
+    array_of_offsets[(*resultcount)++] = first_offset + __builtin_ctz( mask );
+    mask &= mask - 1;
+  }
+  return GDI_SUCCESS;
 }
 
 
@@ -296,35 +557,20 @@ int GDA_LightweightEdgesFilterEdges( uint32_t array_of_offsets[], size_t count,
   /**
     initialisation
    */
-  uint8_t* metadata_iterator;
-  uint8_t orientation;
-  uint32_t offset, max_offset;
+  uint32_t num_slots = GDA_LightweightEdgesNumSlots( vertex );
+  uint32_t num_chunks = GDA_LightweightEdgesNumChunks( vertex );
+  uint8_t orientation = (uint8_t) edge_orientation;
+  GDA_LightweightEdgesChunk chunk;
   *resultcount = 0;
-  offset = 2;
-  max_offset = vertex->lightweight_edge_insert_offset;
-  metadata_iterator = (uint8_t*) vertex->lightweight_edge_data;
-  orientation = (uint8_t) edge_orientation;
 
   /**
     main loop
    */
-  while( offset < max_offset ) {
-    if( orientation & *metadata_iterator ) {
-      if( *resultcount < count ) {
-        array_of_offsets[*resultcount] = offset;
-        (*resultcount)++;
-      } else {
-        return GDI_ERROR_TRUNCATE;
-      }
-    }
-    offset++;
-    metadata_iterator++;
-    if( offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE == 0 ) {
-      /**
-        go to the next block
-       */
-      offset += 2;
-      metadata_iterator += GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE_BYTES - sizeof(GDA_DPointer);
+  for( uint32_t i=0 ; i<num_chunks ; i++ ) {
+    GDA_LightweightEdgesGetChunk( &chunk, i, vertex );
+    uint8_t mask = GDA_LightweightEdgesOrientationMask( chunk.metadata, orientation ) & GDA_LightweightEdgesValidMask( i, num_slots );
+    if( GDA_LightweightEdgesEmitOffsets( mask, chunk.first_offset, array_of_offsets, count, resultcount ) != GDI_SUCCESS ) {
+      return GDI_ERROR_TRUNCATE;
     }
   }
 
@@ -343,94 +589,51 @@ void GDA_LightweightEdgesNumEdges( size_t* resultcount, int edge_orientation, GD
   /**
     initialisation
    */
-  uint8_t* metadata_iterator;
-  uint8_t orientation;
-  uint32_t offset, max_offset;
+  uint32_t num_slots = GDA_LightweightEdgesNumSlots( vertex );
+  uint32_t num_chunks = GDA_LightweightEdgesNumChunks( vertex );
+  uint8_t orientation = (uint8_t) edge_orientation;
+  GDA_LightweightEdgesChunk chunk;
   *resultcount = 0;
-  offset = 2;
-  max_offset = vertex->lightweight_edge_insert_offset;
-  metadata_iterator = (uint8_t*) vertex->lightweight_edge_data;
-  orientation = (uint8_t) edge_orientation;
 
   /**
     main loop
    */
-  while( offset < max_offset ) {
-    if( orientation & *metadata_iterator ) {
-      (*resultcount)++;
-    }
-    offset++;
-    metadata_iterator++;
-    if( offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE == 0 ) {
-      /**
-        go to the next block
-       */
-      offset += 2;
-      metadata_iterator += GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE_BYTES - sizeof(GDA_DPointer);
-    }
+  for( uint32_t i=0 ; i<num_chunks ; i++ ) {
+    GDA_LightweightEdgesGetChunk( &chunk, i, vertex );
+    uint8_t mask = GDA_LightweightEdgesOrientationMask( chunk.metadata, orientation ) & GDA_LightweightEdgesValidMask( i, num_slots );
+    *resultcount += __builtin_popcount( mask );
   }
 }
 
 
-int GDA_LightweightEdgesFilterEdgesWithLabelWhitelist( uint32_t array_of_offsets[], size_t count, size_t* resultcount, int edge_orientation, uint8_t label_whitelist[], size_t list_size, GDI_VertexHolder vertex ) {
+int GDA_LightweightEdgesFilterEdgesWithLabelSet( uint32_t array_of_offsets[], size_t count, size_t* resultcount, int edge_orientation, const uint64_t label_set[4], GDI_VertexHolder vertex ) {
   /**
     input validation
    */
   assert( array_of_offsets != NULL );
   assert( resultcount != NULL );
-  assert( label_whitelist != NULL );
+  assert( label_set != NULL );
   assert( vertex != NULL );
   assert( count > 0 );
-  assert( list_size > 0 );
   assert( ((uint8_t) edge_orientation > 0) && ((uint8_t) edge_orientation < 8) );
 
   /**
     initialisation
    */
-  uint8_t* metadata_iterator;
-  uint8_t orientation;
-  uint32_t offset, max_offset;
+  uint32_t num_slots = GDA_LightweightEdgesNumSlots( vertex );
+  uint32_t num_chunks = GDA_LightweightEdgesNumChunks( vertex );
+  uint8_t orientation = (uint8_t) edge_orientation;
+  GDA_LightweightEdgesChunk chunk;
   *resultcount = 0;
-  offset = 2;
-  max_offset = vertex->lightweight_edge_insert_offset;
-  metadata_iterator = (uint8_t*) vertex->lightweight_edge_data;
-  orientation = (uint8_t) edge_orientation;
 
   /**
     main loop
    */
-  while( offset < max_offset ) {
-    if( orientation & *metadata_iterator ) {
-      /**
-        edge orientation fits
-       */
-      uint8_t label = *(metadata_iterator+8);
-      for( size_t i=0 ; i<list_size ; i++ ) {
-        if( label == label_whitelist[i] ) {
-          /**
-            edge fits constraint
-           */
-          if( *resultcount < count ) {
-            array_of_offsets[*resultcount] = offset;
-            (*resultcount)++;
-          } else {
-            return GDI_ERROR_TRUNCATE;
-          }
-          /**
-            don't need to check the rest of the list
-           */
-          break;
-        }
-      }
-    }
-    offset++;
-    metadata_iterator++;
-    if( offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE == 0 ) {
-      /**
-        go to the next block
-       */
-      offset += 2;
-      metadata_iterator += GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE_BYTES - sizeof(GDA_DPointer);
+  for( uint32_t i=0 ; i<num_chunks ; i++ ) {
+    GDA_LightweightEdgesGetChunk( &chunk, i, vertex );
+    uint8_t mask = GDA_LightweightEdgesLabelMask( chunk.metadata, chunk.labels, orientation, label_set ) & GDA_LightweightEdgesValidMask( i, num_slots );
+    if( GDA_LightweightEdgesEmitOffsets( mask, chunk.first_offset, array_of_offsets, count, resultcount ) != GDI_SUCCESS ) {
+      return GDI_ERROR_TRUNCATE;
     }
   }
 
@@ -438,189 +641,129 @@ int GDA_LightweightEdgesFilterEdgesWithLabelWhitelist( uint32_t array_of_offsets
 }
 
 
-void GDA_LightweightEdgesNumEdgesWithLabelWhitelist( size_t* resultcount, int edge_orientation, uint8_t label_whitelist[], size_t list_size, GDI_VertexHolder vertex ) {
+void GDA_LightweightEdgesNumEdgesWithLabelSet( size_t* resultcount, int edge_orientation, const uint64_t label_set[4], GDI_VertexHolder vertex ) {
   /**
     input validation
    */
   assert( resultcount != NULL );
-  assert( label_whitelist != NULL );
+  assert( label_set != NULL );
   assert( vertex != NULL );
-  assert( list_size > 0 );
   assert( ((uint8_t) edge_orientation > 0) && ((uint8_t) edge_orientation < 8) );
 
   /**
     initialisation
    */
-  uint8_t* metadata_iterator;
-  uint8_t orientation;
-  uint32_t offset, max_offset;
+  uint32_t num_slots = GDA_LightweightEdgesNumSlots( vertex );
+  uint32_t num_chunks = GDA_LightweightEdgesNumChunks( vertex );
+  uint8_t orientation = (uint8_t) edge_orientation;
+  GDA_LightweightEdgesChunk chunk;
   *resultcount = 0;
-  offset = 2;
-  max_offset = vertex->lightweight_edge_insert_offset;
-  metadata_iterator = (uint8_t*) vertex->lightweight_edge_data;
-  orientation = (uint8_t) edge_orientation;
 
   /**
     main loop
    */
-  while( offset < max_offset ) {
-    if( orientation & *metadata_iterator ) {
-      /**
-        edge orientation fits
-       */
-      uint8_t label = *(metadata_iterator+8);
-      for( size_t i=0 ; i<list_size ; i++ ) {
-        if( label == label_whitelist[i] ) {
-          /**
-            edge fits constraint
-           */
-          (*resultcount)++;
-          /**
-            don't need to check the rest of the list
-           */
-          break;
-        }
-      }
-    }
-    offset++;
-    metadata_iterator++;
-    if( offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE == 0 ) {
-      /**
-        go to the next block
-       */
-      offset += 2;
-      metadata_iterator += GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE_BYTES - sizeof(GDA_DPointer);
+  for( uint32_t i=0 ; i<num_chunks ; i++ ) {
+    GDA_LightweightEdgesGetChunk( &chunk, i, vertex );
+    uint8_t mask = GDA_LightweightEdgesLabelMask( chunk.metadata, chunk.labels, orientation, label_set ) & GDA_LightweightEdgesValidMask( i, num_slots );
+    *resultcount += __builtin_popcount( mask );
+  }
+}
+
+
+void GDA_LightweightEdgesMarkDirty( const void* address, size_t size, GDI_VertexHolder vertex ) {
+  uint64_t offset = (const uint8_t*) address - (const uint8_t*) vertex->lightweight_edge_data;
+  if( offset >= vertex->lightweight_edge_dirty_offset ) {
+    return;
+  }
+
+  uint64_t page_size = vertex->transaction->db->block_size;
+  uint64_t first_page = offset / page_size;
+  uint64_t last_page = (offset + size - 1) / page_size;
+
+  if( last_page >= vertex->lightweight_edge_num_dirty_pages ) {
+    /**
+      grow the bitmap (in words of 64 pages)
+     */
+    uint32_t num_words = (vertex->lightweight_edge_num_dirty_pages + 63) / 64;
+    uint32_t new_num_words = num_words > 0 ? num_words : 1;
+    while( new_num_words * 64 <= last_page ) {
+      new_num_words <<= 1;
     }
+    vertex->lightweight_edge_dirty_pages = realloc( vertex->lightweight_edge_dirty_pages, new_num_words * sizeof(uint64_t) );
+    assert( vertex->lightweight_edge_dirty_pages != NULL );
+    memset( vertex->lightweight_edge_dirty_pages + num_words, 0, (new_num_words - num_words) * sizeof(uint64_t) );
+    vertex->lightweight_edge_num_dirty_pages = new_num_words * 64;
+  }
+
+  for( uint64_t page=first_page ; page<=last_page ; page++ ) {
+    vertex->lightweight_edge_dirty_pages[page >> 6] |= (uint64_t) 1 << (page & 63);
   }
 }
 
 
-int GDA_LightweightEdgesFilterEdgesWithLabelBlacklist( uint32_t array_of_offsets[], size_t count, size_t* resultcount, int edge_orientation, uint8_t label_blacklist[], size_t list_size, GDI_VertexHolder vertex ) {
+void GDA_LightweightEdgesInitCursor( GDI_NeighborIterator* iterator, int edge_orientation, const uint64_t label_set[4], GDI_VertexHolder vertex ) {
   /**
     input validation
    */
-  assert( array_of_offsets != NULL );
-  assert( resultcount != NULL );
-  assert( label_blacklist != NULL );
+  assert( iterator != NULL );
   assert( vertex != NULL );
-  assert( count > 0 );
-  assert( list_size > 0 );
   assert( ((uint8_t) edge_orientation > 0) && ((uint8_t) edge_orientation < 8) );
 
-  /**
-    initialisation
-   */
-  uint8_t* metadata_iterator;
-  uint8_t orientation;
-  uint32_t offset, max_offset;
-  *resultcount = 0;
-  offset = 2;
-  max_offset = vertex->lightweight_edge_insert_offset;
-  metadata_iterator = (uint8_t*) vertex->lightweight_edge_data;
-  orientation = (uint8_t) edge_orientation;
+  iterator->vertex = vertex;
+  iterator->label_flag = (label_set != NULL);
+  if( iterator->label_flag ) {
+    memcpy( iterator->label_set, label_set, sizeof(iterator->label_set) );
+  }
+  iterator->orientation = (uint8_t) edge_orientation;
+  iterator->mask = 0;
+  iterator->first_offset = 0;
+  iterator->chunk_index = 0;
+  iterator->num_chunks = GDA_LightweightEdgesNumChunks( vertex );
+  iterator->num_slots = GDA_LightweightEdgesNumSlots( vertex );
+}
+
+
+void GDA_LightweightEdgesCursorNext( uint32_t* edge_offset, bool* found_flag, GDI_NeighborIterator* iterator ) {
+  GDA_LightweightEdgesChunk chunk;
 
   /**
-    main loop
+    move on to the next chunk with a hit, once the hits of the current
+    chunk are used up
    */
-  while( offset < max_offset ) {
-    if( orientation & *metadata_iterator ) {
-      /**
-        edge orientation fits
-       */
-      uint8_t label = *(metadata_iterator+8);
-      bool copy_flag = true;
-      for( size_t i=0 ; i<list_size ; i++ ) {
-        if( label == label_blacklist[i] ) {
-          /**
-            edge fits constraint
-           */
-          copy_flag = false;
-          /**
-            don't need to check the rest of the list
-           */
-          break;
-        }
-      }
-      if( copy_flag ) {
-        if( *resultcount < count ) {
-          array_of_offsets[*resultcount] = offset;
-          (*resultcount)++;
-        } else {
-          return GDI_ERROR_TRUNCATE;
-        }
-      }
+  while( iterator->mask == 0 ) {
+    if( iterator->chunk_index == iterator->num_chunks ) {
+      *found_flag = false;
+      return;
     }
-    offset++;
-    metadata_iterator++;
-    if( offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE == 0 ) {
-      /**
-        go to the next block
-       */
-      offset += 2;
-      metadata_iterator += GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE_BYTES - sizeof(GDA_DPointer);
+    GDA_LightweightEdgesGetChunk( &chunk, iterator->chunk_index, iterator->vertex );
+    if( iterator->label_flag ) {
+      iterator->mask = GDA_LightweightEdgesLabelMask( chunk.metadata, chunk.labels, iterator->orientation, iterator->label_set );
+    } else {
+      iterator->mask = GDA_LightweightEdgesOrientationMask( chunk.metadata, iterator->orientation );
     }
+    iterator->mask &= GDA_LightweightEdgesValidMask( iterator->chunk_index, iterator->num_slots );
+    iterator->first_offset = chunk.first_offset;
+    iterator->chunk_index++;
   }
 
-  return GDI_SUCCESS;
+  *edge_offset = iterator->first_offset + __builtin_ctz( iterator->mask );
+  iterator->mask &= iterator->mask - 1;
+  *found_flag = true;
 }
 
 
-void GDA_LightweightEdgesNumEdgesWithLabelBlacklist( size_t* resultcount, int edge_orientation, uint8_t label_blacklist[], size_t list_size, GDI_VertexHolder vertex ) {
+void GDA_LightweightEdgesDegree( size_t* degree, int edge_orientation, GDI_VertexHolder vertex ) {
   /**
     input validation
    */
-  assert( resultcount != NULL );
-  assert( label_blacklist != NULL );
+  assert( degree != NULL );
   assert( vertex != NULL );
-  assert( list_size > 0 );
   assert( ((uint8_t) edge_orientation > 0) && ((uint8_t) edge_orientation < 8) );
 
-  /**
-    initialisation
-   */
-  uint8_t* metadata_iterator;
-  uint8_t orientation;
-  uint32_t offset, max_offset;
-  *resultcount = 0;
-  offset = 2;
-  max_offset = vertex->lightweight_edge_insert_offset;
-  metadata_iterator = (uint8_t*) vertex->lightweight_edge_data;
-  orientation = (uint8_t) edge_orientation;
-
-  /**
-    main loop
-   */
-  while( offset < max_offset ) {
-    if( orientation & *metadata_iterator ) {
-      /**
-        edge orientation fits
-       */
-      uint8_t label = *(metadata_iterator+8);
-      bool count_flag = true;
-      for( size_t i=0 ; i<list_size ; i++ ) {
-        if( label == label_blacklist[i] ) {
-          /**
-            edge fits constraint
-           */
-          count_flag = false;
-          /**
-            don't need to check the rest of the list
-           */
-          break;
-        }
-      }
-      if( count_flag ) {
-        (*resultcount)++;
-      }
-    }
-    offset++;
-    metadata_iterator++;
-    if( offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE == 0 ) {
-      /**
-        go to the next block
-       */
-      offset += 2;
-      metadata_iterator += GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE_BYTES - sizeof(GDA_DPointer);
+  *degree = 0;
+  for( int j=0 ; j<3 ; j++ ) {
+    if( edge_orientation & (1 << j) ) {
+      *degree += vertex->lightweight_edge_degrees[j];
     }
   }
 }
@@ -631,8 +774,7 @@ void GDA_LightweightEdgesSetEdgeOrientation( int edge_orientation, uint32_t edge
     input validation
    */
   assert( vertex != NULL );
-  assert( (edge_offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE != 0) && (edge_offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE != 1) );
-  assert( edge_offset < vertex->lightweight_edge_insert_offset );
+  assert( GDA_LightweightEdgesIsEdgeOffset( edge_offset, vertex ) );
   assert( (edge_orientation == GDI_EDGE_UNDIRECTED) || (edge_orientation == GDI_EDGE_INCOMING) || (edge_orientation == GDI_EDGE_OUTGOING) );
 
   uint8_t* metadata;
@@ -643,9 +785,12 @@ void GDA_LightweightEdgesSetEdgeOrientation( int edge_orientation, uint32_t edge
   assert( *metadata != 0 );
 
   /**
-    passed all tests
+    passed all tests, keep the record bit and the record index
    */
-  *metadata = (uint8_t) edge_orientation;
+  GDA_LightweightEdgesCountEdge( *metadata, -1, vertex );
+  *metadata = (uint8_t) edge_orientation | (*metadata & ~GDA_LIGHTWEIGHT_EDGES_ORIENTATION);
+  GDA_LightweightEdgesCountEdge( *metadata, 1, vertex );
+  GDA_LightweightEdgesMarkDirty( metadata, 1, vertex );
 }
 
 
@@ -654,8 +799,7 @@ void GDA_LightweightEdgesSetDPointer( GDA_DPointer dpointer, uint32_t edge_offse
     input validation
    */
   assert( vertex != NULL );
-  assert( (edge_offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE != 0) && (edge_offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE != 1) );
-  assert( edge_offset < vertex->lightweight_edge_insert_offset );
+  assert( GDA_LightweightEdgesIsEdgeOffset( edge_offset, vertex ) );
 
 #ifndef NDEBUG
   uint8_t* metadata;
@@ -669,7 +813,14 @@ void GDA_LightweightEdgesSetDPointer( GDA_DPointer dpointer, uint32_t edge_offse
   /**
     passed all tests
    */
+  GDA_LightweightEdgesEnsureDecoded( vertex );
   vertex->lightweight_edge_data[edge_offset] = dpointer;
+  GDA_LightweightEdgesMarkDirty( vertex->lightweight_edge_data + edge_offset, sizeof(GDA_DPointer), vertex );
+
+  uint32_t slot_index = GDA_LightweightEdgesSlotIndex( edge_offset, vertex );
+  if( slot_index < vertex->lightweight_edge_sorted_slots ) {
+    vertex->lightweight_edge_sorted_slots = slot_index;
+  }
 }
 
 
@@ -678,8 +829,7 @@ void GDA_LightweightEdgesSetLabel( uint8_t label_int_handle, uint32_t edge_offse
     input validation
    */
   assert( vertex != NULL );
-  assert( (edge_offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE != 0) && (edge_offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE != 1) );
-  assert( edge_offset < vertex->lightweight_edge_insert_offset );
+  assert( GDA_LightweightEdgesIsEdgeOffset( edge_offset, vertex ) );
 
   uint8_t* metadata;
   GDA_LightweightEdgesGetMetadataPointerWithOffset( &metadata, vertex, edge_offset );
@@ -691,7 +841,10 @@ void GDA_LightweightEdgesSetLabel( uint8_t label_int_handle, uint32_t edge_offse
   /**
     passed all tests
    */
-  *(metadata+8) = label_int_handle;
+  uint8_t* label;
+  GDA_LightweightEdgesGetLabelPointerWithOffset( &label, vertex, edge_offset );
+  *label = label_int_handle;
+  GDA_LightweightEdgesMarkDirty( label, 1, vertex );
 }
 
 
@@ -699,17 +852,18 @@ void GDA_LightweightEdgesSetLabel( uint8_t label_int_handle, uint32_t edge_offse
   find an edge in the lightweight edge data structure of the other
   vertex
 
-  return the first index that matches the edge orientation, label and
-  the distributed address of the other vertex
+  return the first index that matches the edge orientation, label, record
+  bits and the distributed address of the other vertex
 
   returns zero in case no matching edge is found
  */
-uint32_t GDA_LightweightEdgesFindEdge( int original_edge_orientation, GDA_DPointer other_vertex, uint8_t label_int_handle, GDI_VertexHolder vertex ) {
+uint32_t GDA_LightweightEdgesFindEdge( int original_edge_orientation, GDA_DPointer other_vertex, uint8_t label_int_handle, uint8_t record_bits, GDI_VertexHolder vertex ) {
   /**
     input validation
    */
   assert( vertex != NULL );
   assert( (original_edge_orientation == GDI_EDGE_UNDIRECTED) || (original_edge_orientation == GDI_EDGE_INCOMING) || (original_edge_orientation == GDI_EDGE_OUTGOING) );
+  assert( (record_bits & GDA_LIGHTWEIGHT_EDGES_ORIENTATION) == 0 );
 
   uint8_t edge_orientation;
   if( original_edge_orientation == GDI_EDGE_UNDIRECTED ) {
@@ -725,29 +879,61 @@ uint32_t GDA_LightweightEdgesFindEdge( int original_edge_orientation, GDA_DPoint
     }
   }
 
-  uint8_t* metadata_iterator = (uint8_t*) vertex->lightweight_edge_data;
-  GDA_DPointer* dp_iterator =  &(vertex->lightweight_edge_data[2]);
-  GDA_DPointer* max = &(vertex->lightweight_edge_data[vertex->lightweight_edge_insert_offset]);
+  /**
+    only the edges with the label are candidates, so reuse the label
+    kernel of the filter functions
+   */
+  GDA_LightweightEdgesEnsureDecoded( vertex );
 
   /**
-    main loop
+    binary search for the first sorted slot with the DPointer of the
+    other vertex, and check the slots with the same DPointer
    */
-  uint8_t metadata_offset = 0;
-  while( dp_iterator < max ) {
-    if( (edge_orientation & *metadata_iterator) && (*dp_iterator == other_vertex) && (*(metadata_iterator+8) == label_int_handle) ) {
-      return ((char*)dp_iterator - (char*)vertex->lightweight_edge_data) / sizeof(GDA_DPointer);
-    }
-    dp_iterator++;
-    metadata_iterator++;
-    if( metadata_offset == 7 ) {
-      /**
-        go to the next block
-       */
-      dp_iterator += 2;
-      metadata_iterator += GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE_BYTES - sizeof(GDA_DPointer);
-      metadata_offset = 0;
+  uint32_t sorted_slots = vertex->lightweight_edge_sorted_slots;
+  uint32_t low = 0, high = sorted_slots;
+  while( low < high ) {
+    uint32_t middle = low + (high - low) / 2;
+    if( vertex->lightweight_edge_data[GDA_LightweightEdgesSlotOffset( middle, vertex )] < other_vertex ) {
+      low = middle + 1;
     } else {
-      metadata_offset++;
+      high = middle;
+    }
+  }
+  for( ; low<sorted_slots ; low++ ) {
+    uint32_t offset = GDA_LightweightEdgesSlotOffset( low, vertex );
+    if( vertex->lightweight_edge_data[offset] != other_vertex ) {
+      break;
+    }
+    uint8_t *metadata, *label;
+    GDA_LightweightEdgesGetMetadataPointerWithOffset( &metadata, vertex, offset );
+    GDA_LightweightEdgesGetLabelPointerWithOffset( &label, vertex, offset );
+    if( (*metadata & edge_orientation) && ((*metadata & ~GDA_LIGHTWEIGHT_EDGES_ORIENTATION) == record_bits) && (*label == label_int_handle) ) {
+      return offset;
+    }
+  }
+
+  uint64_t label_set[4] = { 0, 0, 0, 0 };
+  label_set[label_int_handle >> 6] = 1ULL << (label_int_handle & 63);
+
+  uint32_t num_slots = GDA_LightweightEdgesNumSlots( vertex );
+  uint32_t num_chunks = GDA_LightweightEdgesNumChunks( vertex );
+  GDA_LightweightEdgesChunk chunk;
+
+  /**
+    main loop over the unsorted slots
+   */
+  for( uint32_t i=sorted_slots/8 ; i<num_chunks ; i++ ) {
+    GDA_LightweightEdgesGetChunk( &chunk, i, vertex );
+    uint8_t mask = GDA_LightweightEdgesLabelMask( chunk.metadata, chunk.labels, edge_orientation, label_set ) & GDA_LightweightEdgesValidMask( i, num_slots );
+    if( i == sorted_slots/8 ) {
+      mask &= (uint8_t) (0xFF << (sorted_slots % 8));
+    }
+    while( mask != 0 ) {
+      uint32_t offset = chunk.first_offset + __builtin_ctz( mask );
+      if( (vertex->lightweight_edge_data[offset] == other_vertex) && ((chunk.metadata[__builtin_ctz( mask )] & ~GDA_LIGHTWEIGHT_EDGES_ORIENTATION) == record_bits) ) {
+        return offset;
+      }
+      mask &= mask - 1;
     }
   }
 
@@ -755,46 +941,501 @@ uint32_t GDA_LightweightEdgesFindEdge( int original_edge_orientation, GDA_DPoint
 }
 
 
-void GDA_LightweightEdgesPrint( GDI_VertexHolder vertex ) {
+uint16_t GDA_LightweightEdgesUsedRecordIndexes( uint8_t edge_orientation, GDA_DPointer other_vertex, uint8_t label_int_handle, uint32_t skip_offset, uint32_t other_skip_offset, GDI_VertexHolder vertex ) {
   /**
     input validation
    */
   assert( vertex != NULL );
+  assert( (edge_orientation == (uint8_t) GDI_EDGE_UNDIRECTED) || (edge_orientation == (uint8_t) GDI_EDGE_INCOMING) || (edge_orientation == (uint8_t) GDI_EDGE_OUTGOING) );
+
+  GDA_LightweightEdgesEnsureDecoded( vertex );
+
+  uint16_t used = 0;
 
   /**
-    initialisation
+    same search as in GDA_LightweightEdgesFindEdge, but all matching
+    entries are visited
    */
-  uint8_t* metadata_iterator;
-  uint32_t offset, max_offset;
-  offset = 2;
-  max_offset = vertex->lightweight_edge_insert_offset;
-  metadata_iterator = (uint8_t*) vertex->lightweight_edge_data;
+  uint32_t sorted_slots = vertex->lightweight_edge_sorted_slots;
+  uint32_t low = 0, high = sorted_slots;
+  while( low < high ) {
+    uint32_t middle = low + (high - low) / 2;
+    if( vertex->lightweight_edge_data[GDA_LightweightEdgesSlotOffset( middle, vertex )] < other_vertex ) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  for( ; low<sorted_slots ; low++ ) {
+    uint32_t offset = GDA_LightweightEdgesSlotOffset( low, vertex );
+    if( vertex->lightweight_edge_data[offset] != other_vertex ) {
+      break;
+    }
+    uint8_t *metadata, *label;
+    GDA_LightweightEdgesGetMetadataPointerWithOffset( &metadata, vertex, offset );
+    GDA_LightweightEdgesGetLabelPointerWithOffset( &label, vertex, offset );
+    if( (offset != skip_offset) && (offset != other_skip_offset) && (*metadata & edge_orientation) && (*metadata & GDA_LIGHTWEIGHT_EDGES_RECORD) && (*label == label_int_handle) ) {
+      used |= (uint16_t) (1 << (*metadata >> GDA_LIGHTWEIGHT_EDGES_RECORD_INDEX_SHIFT));
+    }
+  }
+
+  uint64_t label_set[4] = { 0, 0, 0, 0 };
+  label_set[label_int_handle >> 6] = 1ULL << (label_int_handle & 63);
+
+  uint32_t num_slots = GDA_LightweightEdgesNumSlots( vertex );
+  uint32_t num_chunks = GDA_LightweightEdgesNumChunks( vertex );
+  GDA_LightweightEdgesChunk chunk;
+
+  for( uint32_t i=sorted_slots/8 ; i<num_chunks ; i++ ) {
+    GDA_LightweightEdgesGetChunk( &chunk, i, vertex );
+    uint8_t mask = GDA_LightweightEdgesLabelMask( chunk.metadata, chunk.labels, edge_orientation, label_set ) & GDA_LightweightEdgesValidMask( i, num_slots );
+    if( i == sorted_slots/8 ) {
+      mask &= (uint8_t) (0xFF << (sorted_slots % 8));
+    }
+    while( mask != 0 ) {
+      uint8_t metadata = chunk.metadata[__builtin_ctz( mask )];
+      uint32_t offset = chunk.first_offset + __builtin_ctz( mask );
+      if( (offset != skip_offset) && (offset != other_skip_offset) && (metadata & GDA_LIGHTWEIGHT_EDGES_RECORD) && (vertex->lightweight_edge_data[offset] == other_vertex) ) {
+        used |= (uint16_t) (1 << (metadata >> GDA_LIGHTWEIGHT_EDGES_RECORD_INDEX_SHIFT));
+      }
+      mask &= mask - 1;
+    }
+  }
+
+  return used;
+}
+
+
+void GDA_LightweightEdgesPrint( GDI_VertexHolder vertex ) {
+  /**
+    input validation
+   */
+  assert( vertex != NULL );
 
   /**
     main loop
    */
-  while( offset < max_offset ) {
-    if( *metadata_iterator == 0 ) {
-      printf("%5i|EMP|%3u|%20lu\n", vertex->transaction->db->commrank, *(metadata_iterator+8), vertex->lightweight_edge_data[offset]);
+  for( uint32_t offset=2 ; offset<vertex->lightweight_edge_insert_offset ; offset=GDA_LightweightEdgesNextOffset( offset, vertex ) ) {
+    uint8_t *metadata, *label;
+    GDA_LightweightEdgesGetMetadataPointerWithOffset( &metadata, vertex, offset );
+    GDA_LightweightEdgesGetLabelPointerWithOffset( &label, vertex, offset );
+    uint8_t orientation = *metadata & GDA_LIGHTWEIGHT_EDGES_ORIENTATION;
+
+    if( orientation == 0 ) {
+      printf("%5i|EMP|%3u|%20lu\n", vertex->transaction->db->commrank, *label, vertex->lightweight_edge_data[offset]);
     }
-    if( *metadata_iterator == 1 ) {
-      printf("%5i|INC|%3u|%20lu\n", vertex->transaction->db->commrank, *(metadata_iterator+8), vertex->lightweight_edge_data[offset]);
+    if( orientation == 1 ) {
+      printf("%5i|INC|%3u|%20lu\n", vertex->transaction->db->commrank, *label, vertex->lightweight_edge_data[offset]);
     }
-    if( *metadata_iterator == 2 ) {
-      printf("%5i|OUT|%3u|%20lu\n", vertex->transaction->db->commrank, *(metadata_iterator+8), vertex->lightweight_edge_data[offset]);
+    if( orientation == 2 ) {
+      printf("%5i|OUT|%3u|%20lu\n", vertex->transaction->db->commrank, *label, vertex->lightweight_edge_data[offset]);
     }
-    if( *metadata_iterator == 3 ) {
-      printf("%5i|UND|%3u|%20lu\n", vertex->transaction->db->commrank, *(metadata_iterator+8), vertex->lightweight_edge_data[offset]);
+    if( orientation == 3 ) {
+      printf("%5i|UND|%3u|%20lu\n", vertex->transaction->db->commrank, *label, vertex->lightweight_edge_data[offset]);
     }
+  }
+}
+
+
+static inline uint64_t GDA_LightweightEdgesArraysCapacity( uint64_t num_edges ) {
+  return (num_edges + GDA_LIGHTWEIGHT_EDGES_ARRAYS_CHUNK - 1) / GDA_LIGHTWEIGHT_EDGES_ARRAYS_CHUNK * GDA_LIGHTWEIGHT_EDGES_ARRAYS_CHUNK /* round up */;
+}
+
+
+/**
+  allocates a zeroed lightweight edge buffer for num_edges edge slots
+  (which are all unused) and sets the insert offset behind them
+ */
+static void GDA_LightweightEdgesAllocate( uint32_t num_edges, GDI_VertexHolder vertex ) {
+  vertex->lightweight_edge_insert_offset = GDA_LightweightEdgesSlotOffset( num_edges, vertex );
+
+  if( GDA_LightweightEdgesUseArrays( vertex ) ) {
+    uint64_t capacity = GDA_LightweightEdgesArraysCapacity( num_edges );
+    vertex->lightweight_edge_size = GDA_LightweightEdgesArraysSize( capacity );
+    vertex->lightweight_edge_data = calloc( vertex->lightweight_edge_size, 1 );
+    assert( vertex->lightweight_edge_data != NULL );
+    vertex->lightweight_edge_data[0] = capacity;
+    vertex->lightweight_edge_data[1] = num_edges;
+    return;
+  }
+
+  /**
+    we have to round up because we always have to allocate enough memory
+    for a complete lightweight edge block
+
+    add one more lightweight edge block, so that we don't have to immediately
+    reallocate (in case the current lightweight edge block is completely full,
+    there will two completely empty lightweight edge blocks at the end)
+   */
+  vertex->lightweight_edge_size = (num_edges / (GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE-2) + 1 /* round up */ + 1 /* one additional block of edges */) * GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE * sizeof(GDA_DPointer);
+  vertex->lightweight_edge_data = calloc( vertex->lightweight_edge_size, 1 );
+  assert( vertex->lightweight_edge_data != NULL );
+}
+
+
+/**
+  number of Bytes of lightweight_edge_data, that are stored without
+  compression
+ */
+static uint64_t GDA_LightweightEdgesStoredSize( GDI_VertexHolder vertex ) {
+  if( GDA_LightweightEdgesUseArrays( vertex ) ) {
+    return GDA_LightweightEdgesArraysSize( GDA_LightweightEdgesArraysCapacity( vertex->lightweight_edge_insert_offset - 2 ) );
+  }
+
+  uint64_t size = vertex->lightweight_edge_insert_offset * sizeof(GDA_DPointer);
+  if( ((vertex->lightweight_edge_insert_offset - 2) % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE) == 0 ) {
+    /**
+      omit the lightweight edge meta and label data of the next block
+     */
+    size -= 2 * sizeof(GDA_DPointer);
+  }
+  return size;
+}
+
+
+/**
+  edge as it is sorted for the compressed form and the sorted adjacency
+ */
+typedef struct GDA_LightweightEdgesSortEntry_desc {
+  GDA_DPointer dpointer;
+  uint8_t metadata;
+  uint8_t label;
+} GDA_LightweightEdgesSortEntry;
+
+
+static int GDA_CompareLightweightEdgesSortEntries( const void* a, const void* b ) {
+  const GDA_LightweightEdgesSortEntry* edge_a = a;
+  const GDA_LightweightEdgesSortEntry* edge_b = b;
+  if( edge_a->dpointer != edge_b->dpointer ) {
+    return (edge_a->dpointer < edge_b->dpointer) ? -1 : 1;
+  }
+  /**
+    keep edges with the same metadata and label together, so that they
+    form longer runs
+   */
+  if( edge_a->metadata != edge_b->metadata ) {
+    return (int) edge_a->metadata - (int) edge_b->metadata;
+  }
+  return (int) edge_a->label - (int) edge_b->label;
+}
+
 
-    offset++;
-    metadata_iterator++;
-    if( offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE == 0 ) {
+/**
+  collects all edges, that are not removed, in sorted order: only the
+  unsorted slots are sorted, and then merged with the sorted slots
+
+  returns the number of edges, *sorted_edges has to be freed by the caller
+ */
+static uint32_t GDA_LightweightEdgesCollectSorted( GDA_LightweightEdgesSortEntry** sorted_edges, GDI_VertexHolder vertex ) {
+  GDA_LightweightEdgesSortEntry* edges = malloc( (GDA_LightweightEdgesNumSlots( vertex ) + 1) * sizeof(GDA_LightweightEdgesSortEntry) );
+  assert( edges != NULL );
+  uint32_t num_edges = 0;
+  uint32_t num_sorted_edges = 0;
+  uint32_t slot_index = 0;
+  for( uint32_t offset=2 ; offset<vertex->lightweight_edge_insert_offset ; offset=GDA_LightweightEdgesNextOffset( offset, vertex ) ) {
+    uint8_t *metadata, *label;
+    GDA_LightweightEdgesGetMetadataPointerWithOffset( &metadata, vertex, offset );
+    if( *metadata ) {
+      GDA_LightweightEdgesGetLabelPointerWithOffset( &label, vertex, offset );
+      edges[num_edges].dpointer = vertex->lightweight_edge_data[offset];
+      edges[num_edges].metadata = *metadata;
+      edges[num_edges].label = *label;
+      num_edges++;
+      if( slot_index < vertex->lightweight_edge_sorted_slots ) {
+        num_sorted_edges = num_edges;
+      }
+    }
+    slot_index++;
+  }
+
+  uint32_t num_unsorted_edges = num_edges - num_sorted_edges;
+  qsort( edges + num_sorted_edges, num_unsorted_edges, sizeof(GDA_LightweightEdgesSortEntry), GDA_CompareLightweightEdgesSortEntries );
+
+  if( (num_sorted_edges == 0) || (num_unsorted_edges == 0) ) {
+    *sorted_edges = edges;
+    return num_edges;
+  }
+
+  /**
+    merge both sorted parts
+   */
+  GDA_LightweightEdgesSortEntry* merged_edges = malloc( num_edges * sizeof(GDA_LightweightEdgesSortEntry) );
+  assert( merged_edges != NULL );
+  uint32_t i = 0, j = num_sorted_edges, k = 0;
+  while( (i < num_sorted_edges) && (j < num_edges) ) {
+    if( GDA_CompareLightweightEdgesSortEntries( &edges[j], &edges[i] ) < 0 ) {
+      merged_edges[k++] = edges[j++];
+    } else {
+      merged_edges[k++] = edges[i++];
+    }
+  }
+  while( i < num_sorted_edges ) {
+    merged_edges[k++] = edges[i++];
+  }
+  while( j < num_edges ) {
+    merged_edges[k++] = edges[j++];
+  }
+  free( edges );
+
+  *sorted_edges = merged_edges;
+  return num_edges;
+}
+
+
+/**
+  replaces the lightweight edge buffer with a new one, that only holds
+  the given sorted edges
+ */
+static void GDA_LightweightEdgesFillSorted( const GDA_LightweightEdgesSortEntry* edges, uint32_t num_edges, GDI_VertexHolder vertex ) {
+  free( vertex->lightweight_edge_data );
+  GDA_LightweightEdgesAllocate( num_edges, vertex );
+
+  uint32_t offset = 2;
+  for( uint32_t i=0 ; i<num_edges ; i++ ) {
+    uint8_t *metadata, *label;
+    GDA_LightweightEdgesGetMetadataPointerWithOffset( &metadata, vertex, offset );
+    GDA_LightweightEdgesGetLabelPointerWithOffset( &label, vertex, offset );
+    vertex->lightweight_edge_data[offset] = edges[i].dpointer;
+    *metadata = edges[i].metadata;
+    *label = edges[i].label;
+    offset = GDA_LightweightEdgesNextOffset( offset, vertex );
+  }
+  vertex->lightweight_edge_sorted_slots = num_edges;
+}
+
+
+/**
+  encodes the edges of the vertex into the compressed form
+  (lightweight_edge_encoded) and returns the number of encoded edges
+ */
+static uint32_t GDA_LightweightEdgesEncode( GDI_VertexHolder vertex ) {
+  uint64_t block_size = vertex->transaction->db->block_size;
+
+  GDA_LightweightEdgesSortEntry* edges;
+  uint32_t num_edges = GDA_LightweightEdgesCollectSorted( &edges, vertex );
+
+  /**
+    upper bound: number of groups, and per edge a group header of two
+    varints, a varint for the block index and a run of length one
+   */
+  uint8_t* buf = malloc( GDA_VARINT_MAX_SIZE + (uint64_t) num_edges * (4 * GDA_VARINT_MAX_SIZE + 2) );
+  assert( buf != NULL );
+  size_t size = 0;
+
+  uint64_t num_groups = 0;
+  uint64_t offset, rank, previous_rank = GDA_DPOINTER_NULL;
+  for( uint32_t i=0 ; i<num_edges ; i++ ) {
+    GDA_GetDPointer( &offset, &rank, edges[i].dpointer );
+    if( rank != previous_rank ) {
+      num_groups++;
+      previous_rank = rank;
+    }
+  }
+  size += GDA_EncodeVarint( num_groups, buf+size );
+
+  /**
+    target vertices grouped by rank
+   */
+  previous_rank = 0;
+  uint32_t i = 0;
+  while( i < num_edges ) {
+    uint64_t group_rank;
+    GDA_GetDPointer( &offset, &group_rank, edges[i].dpointer );
+    uint32_t group_end = i;
+    do {
+      group_end++;
+      if( group_end < num_edges ) {
+        GDA_GetDPointer( &offset, &rank, edges[group_end].dpointer );
+      }
+    } while( (group_end < num_edges) && (rank == group_rank) );
+
+    size += GDA_EncodeVarint( group_rank - previous_rank, buf+size );
+    size += GDA_EncodeVarint( group_end - i, buf+size );
+    previous_rank = group_rank;
+
+    uint64_t previous_index = 0;
+    for( ; i<group_end ; i++ ) {
+      GDA_GetDPointer( &offset, &rank, edges[i].dpointer );
+      assert( offset % block_size == 0 );
+      size += GDA_EncodeVarint( offset / block_size - previous_index, buf+size );
+      previous_index = offset / block_size;
+    }
+  }
+
+  /**
+    runs of metadata and label data
+   */
+  i = 0;
+  while( i < num_edges ) {
+    uint32_t run_end = i + 1;
+    while( (run_end < num_edges) && (edges[run_end].metadata == edges[i].metadata) && (edges[run_end].label == edges[i].label) ) {
+      run_end++;
+    }
+    size += GDA_EncodeVarint( run_end - i, buf+size );
+    buf[size++] = edges[i].metadata;
+    buf[size++] = edges[i].label;
+    i = run_end;
+  }
+
+  free( edges );
+
+  vertex->lightweight_edge_encoded = realloc( buf, size );
+  assert( vertex->lightweight_edge_encoded != NULL );
+  vertex->lightweight_edge_encoded_size = size;
+
+  return num_edges;
+}
+
+
+void GDA_LightweightEdgesDecode( GDI_VertexHolder vertex ) {
+  assert( vertex->lightweight_edge_data == NULL );
+  assert( vertex->lightweight_edge_encoded != NULL );
+
+  uint64_t block_size = vertex->transaction->db->block_size;
+  uint32_t num_edges = GDA_LightweightEdgesNumSlots( vertex );
+  const uint8_t* encoded = vertex->lightweight_edge_encoded;
+  uint64_t value, num_groups, rank = 0;
+
+  GDA_LightweightEdgesAllocate( num_edges, vertex );
+
+  /**
+    target vertices
+   */
+  uint32_t offset = 2;
+  encoded += GDA_DecodeVarint( &num_groups, encoded );
+  for( uint64_t i=0 ; i<num_groups ; i++ ) {
+    uint64_t group_size, index = 0;
+    encoded += GDA_DecodeVarint( &value, encoded );
+    rank += value;
+    encoded += GDA_DecodeVarint( &group_size, encoded );
+    for( uint64_t j=0 ; j<group_size ; j++ ) {
+      encoded += GDA_DecodeVarint( &value, encoded );
+      index += value;
+      GDA_SetDPointer( index * block_size, rank, &(vertex->lightweight_edge_data[offset]) );
+      offset = GDA_LightweightEdgesNextOffset( offset, vertex );
+    }
+  }
+  assert( offset == vertex->lightweight_edge_insert_offset );
+
+  /**
+    metadata and label data
+   */
+  offset = 2;
+  while( offset < vertex->lightweight_edge_insert_offset ) {
+    uint64_t run_length;
+    encoded += GDA_DecodeVarint( &run_length, encoded );
+    uint8_t metadata = *encoded++;
+    uint8_t label = *encoded++;
+    for( uint64_t j=0 ; j<run_length ; j++ ) {
+      uint8_t *metadata_pointer, *label_pointer;
+      GDA_LightweightEdgesGetMetadataPointerWithOffset( &metadata_pointer, vertex, offset );
+      GDA_LightweightEdgesGetLabelPointerWithOffset( &label_pointer, vertex, offset );
+      *metadata_pointer = metadata;
+      *label_pointer = label;
+      offset = GDA_LightweightEdgesNextOffset( offset, vertex );
+    }
+  }
+  assert( encoded == vertex->lightweight_edge_encoded + vertex->lightweight_edge_encoded_size );
+
+  free( vertex->lightweight_edge_encoded );
+  vertex->lightweight_edge_encoded = NULL;
+  vertex->lightweight_edge_encoded_size = 0;
+}
+
+
+uint64_t GDA_LightweightEdgesPrepareStore( uint8_t** data, uint32_t* num_edges, GDI_VertexHolder vertex ) {
+  assert( data != NULL );
+  assert( num_edges != NULL );
+  assert( vertex != NULL );
+
+  if( vertex->transaction->db->edge_compression ) {
+    if( vertex->lightweight_edge_data != NULL ) {
+      assert( vertex->lightweight_edge_encoded == NULL );
+      /**
+        the encoding of unchanged edges is the same as the loaded one
+       */
+      if( (vertex->lightweight_edge_num_dirty_pages > 0) || (vertex->lightweight_edge_dirty_offset != UINT64_MAX) ) {
+        GDA_LightweightEdgesMarkAllDirty( vertex );
+      }
+      *num_edges = GDA_LightweightEdgesEncode( vertex );
+    } else {
       /**
-        go to the next block
+        edges weren't accessed, so store them as they were loaded
        */
-      offset += 2;
-      metadata_iterator += GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE_BYTES - sizeof(GDA_DPointer);
+      *num_edges = GDA_LightweightEdgesNumSlots( vertex );
     }
+    *data = vertex->lightweight_edge_encoded;
+    return vertex->lightweight_edge_encoded_size;
   }
+
+  uint32_t num_slots = GDA_LightweightEdgesNumSlots( vertex );
+  if( vertex->transaction->db->edge_sorted && (vertex->lightweight_edge_sorted_slots < num_slots) ) {
+    /**
+      merge the edges added during the transaction into the sorted ones,
+      which also drops the removed edges
+     */
+    GDA_LightweightEdgesSortEntry* edges;
+    uint32_t num_sorted_edges = GDA_LightweightEdgesCollectSorted( &edges, vertex );
+    GDA_LightweightEdgesFillSorted( edges, num_sorted_edges, vertex );
+    GDA_LightweightEdgesMarkAllDirty( vertex );
+    free( edges );
+  } else {
+    /**
+      removed edges stay in place as tombstones, so that only the
+      changed blocks have to be written, until they take up a
+      considerable part of the slots
+     */
+    uint32_t num_tombstones = GDA_LightweightEdgesNumTombstones( vertex );
+    if( (num_tombstones > 0) && ((uint64_t) num_tombstones * GDA_LIGHTWEIGHT_EDGES_COMPACTION_RATIO >= num_slots) ) {
+      GDA_LightweightEdgesShrink( vertex );
+    }
+  }
+
+  if( GDA_LightweightEdgesUseArrays( vertex ) ) {
+    GDA_LightweightEdgesResizeArrays( GDA_LightweightEdgesArraysCapacity( vertex->lightweight_edge_insert_offset - 2 ), vertex );
+  }
+
+  *data = (uint8_t*) vertex->lightweight_edge_data;
+  *num_edges = GDA_LightweightEdgesNumSlots( vertex );
+  return GDA_LightweightEdgesStoredSize( vertex );
+}
+
+
+uint8_t* GDA_LightweightEdgesPrepareLoad( uint32_t num_edges, uint64_t size, GDI_VertexHolder vertex ) {
+  assert( vertex != NULL );
+
+  vertex->lightweight_edge_encoded = NULL;
+  vertex->lightweight_edge_encoded_size = 0;
+  vertex->lightweight_edge_sorted_slots = GDA_LightweightEdgesStoreSorted( vertex ) ? num_edges : 0;
+  vertex->lightweight_edge_stored_size = size;
+  vertex->lightweight_edge_dirty_pages = NULL;
+  vertex->lightweight_edge_num_dirty_pages = 0;
+  vertex->lightweight_edge_dirty_offset = UINT64_MAX;
+
+  if( vertex->transaction->db->edge_compression ) {
+    /**
+      keep the compressed form until the edges are accessed
+     */
+    vertex->lightweight_edge_insert_offset = GDA_LightweightEdgesSlotOffset( num_edges, vertex );
+    vertex->lightweight_edge_data = NULL;
+    vertex->lightweight_edge_size = 0;
+    vertex->lightweight_edge_encoded = malloc( size );
+    assert( vertex->lightweight_edge_encoded != NULL );
+    vertex->lightweight_edge_encoded_size = size;
+    return vertex->lightweight_edge_encoded;
+  }
+
+  GDA_LightweightEdgesAllocate( num_edges, vertex );
+  assert( size == GDA_LightweightEdgesStoredSize( vertex ) );
+  return (uint8_t*) vertex->lightweight_edge_data;
+}
+
+
+void GDA_LightweightEdgesFree( GDI_VertexHolder vertex ) {
+  free( vertex->lightweight_edge_data );
+  vertex->lightweight_edge_data = NULL;
+  free( vertex->lightweight_edge_encoded );
+  vertex->lightweight_edge_encoded = NULL;
+  free( vertex->lightweight_edge_dirty_pages );
+  vertex->lightweight_edge_dirty_pages = NULL;
 }
@@ -18,6 +18,21 @@
 #define GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE 10
 #define GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE_BYTES  (GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE * sizeof(GDA_DPointer))
 
+/**
+  The lowest three bits of the metadata Byte of an edge hold its
+  orientation (zero for a removed edge), and GDA_LIGHTWEIGHT_EDGES_RECORD
+  is set, if the properties of the edge are stored in a separate record
+  (gda_edge_record.h). The upper four bits hold the index of that record
+  among the records of parallel edges, which have the same vertices,
+  orientation and label, so that both the entries and the records of
+  such edges can be told apart.
+ */
+#define GDA_LIGHTWEIGHT_EDGES_ORIENTATION        0x07
+#define GDA_LIGHTWEIGHT_EDGES_RECORD             0x08
+#define GDA_LIGHTWEIGHT_EDGES_RECORD_INDEX       0xF0
+#define GDA_LIGHTWEIGHT_EDGES_RECORD_INDEX_SHIFT 4
+#define GDA_LIGHTWEIGHT_EDGES_MAX_RECORDS        16
+
 /**
   Definition Block:
   80 Bytes of the labeled lightweight edges data structure meaning 8
@@ -25,6 +40,61 @@
   data are called a block.
  */
 
+/**
+  Definition Arrays (GDA_EDGE_LAYOUT_ARRAYS):
+  A header of two words (capacity C and number of edge slots) is
+  followed by three contiguous arrays: C DPointers, C Bytes of metadata
+  and C Bytes of label data. C is always a multiple of
+  GDA_LIGHTWEIGHT_EDGES_ARRAYS_CHUNK, so that the metadata and label
+  data can be scanned 8 Bytes at a time without a tail.
+
+  The header has the same size as the metadata and label data in front
+  of the first block, so that in both layouts the first edge has the
+  offset 2 and the DPointer of the edge at offset o is
+  lightweight_edge_data[o]. The edge offsets of the arrays layout are
+  contiguous.
+
+  The layout is selected per database (edge_layout of GDA_Init_params).
+ */
+
+/**
+  Definition Compressed (edge_compression of GDA_Init_params):
+  The edges are stored in the blocks of a vertex in the following form,
+  with all integers encoded as varints (gda_varint.h):
+  - number of groups of edges with the same target rank
+  - per group: rank (difference to the previous group), number of
+    edges, block index of the first target vertex and the differences
+    between the block indices of consecutive target vertices, which are
+    sorted in ascending order
+  - runs of edges with the same metadata and label data in the same
+    order: run length, followed by the metadata Byte and the label Byte
+
+  Removed edges are dropped, so the edge offsets change, when the edges
+  of a vertex are stored. The compressed form is only decoded into one
+  of the layouts above, once the edges of the vertex are accessed.
+ */
+
+/**
+  Sorted adjacency (edge_sorted of GDA_Init_params, implied by
+  edge_compression):
+  The edges are stored sorted by (DPointer, metadata, label), and the
+  tombstones of removed edges keep their position, until the edges are
+  compacted. The first lightweight_edge_sorted_slots slots of a loaded
+  vertex are therefore sorted, while edges added during the transaction
+  are appended behind them. The sorted slots are searched with a binary
+  search, and the unsorted slots are sorted and merged with the sorted
+  ones (dropping the tombstones), when the edges are stored again.
+ */
+#define GDA_LIGHTWEIGHT_EDGES_ARRAYS_HEADER_SIZE 2
+#define GDA_LIGHTWEIGHT_EDGES_ARRAYS_CHUNK       8
+
+/**
+  the edges of a vertex are compacted, when the commit of a transaction
+  finds at least 1/GDA_LIGHTWEIGHT_EDGES_COMPACTION_RATIO of the edge
+  slots unused
+ */
+#define GDA_LIGHTWEIGHT_EDGES_COMPACTION_RATIO   4
+
 /**
   Use the GDA_Vector to allocate one block and zero out the metadata.
   Using only 1 block should not be a problem as the dynamic resizing of
@@ -67,14 +137,8 @@ void GDA_LightweightEdgesGetEdge( GDA_DPointer* dpointer, int* edge_orientation,
 void GDA_LightweightEdgesGetLabel( uint8_t* label_int_handle, uint32_t edge_offset, GDI_VertexHolder vertex, bool* found_flag );
 
 /**
-  Use two iterators that go over all the meta data: one from the front
-  and one from the back. The forward iterator looks for free space (e.g.
-  Bytes in the meta data that are zero). The backwards iterator looks
-  for edges from the end.
-  Once both iterators meet the respective condition, the edge from the
-  backwards iterator gets copied to the forward iterator, meaning the
-  meta and label data and the actual pointer get copied. This process
-  continues until the two iterators cross over.
+  Moves all edges to the front of the edge slots, keeping their order,
+  so that the slots of removed edges (tombstones) are freed.
 
   The data structure is not actually shrunk, since this function is only
   called during the closing of a transaction, after which the data
@@ -82,6 +146,48 @@ void GDA_LightweightEdgesGetLabel( uint8_t* label_int_handle, uint32_t edge_offs
  */
 void GDA_LightweightEdgesShrink( GDI_VertexHolder vertex );
 
+/**
+  Records that the size Bytes of the lightweight edge data at address
+  were changed, so that only the blocks, which contain them, have to be
+  written, when the transaction is committed (gdi_transaction.c).
+ */
+void GDA_LightweightEdgesMarkDirty( const void* address, size_t size, GDI_VertexHolder vertex );
+
+/**
+  Returns the number of Bytes starting at *data, that have to be stored
+  in the blocks of the vertex, and the number of stored edge slots.
+
+  Removed edges are kept as tombstones (unused slots), until they make
+  up at least 1/GDA_LIGHTWEIGHT_EDGES_COMPACTION_RATIO of the slots (or
+  until the sorted edges are merged with new ones), so that the offsets
+  of the other edges and most of the stored data stay unchanged.
+
+  Without compression, data points to lightweight_edge_data and the
+  arrays layout is compacted to the smallest capacity first, so that
+  the stored data is a valid arrays buffer by itself. With compression,
+  data points to the compressed form, which is reused, if the edges
+  haven't been decoded.
+ */
+uint64_t GDA_LightweightEdgesPrepareStore( uint8_t** data, uint32_t* num_edges, GDI_VertexHolder vertex );
+
+/**
+  Prepares the lightweight edges of a vertex with num_edges stored edge
+  slots, that take up size Bytes in the blocks, and returns the address
+  to which these Bytes have to be copied.
+ */
+uint8_t* GDA_LightweightEdgesPrepareLoad( uint32_t num_edges, uint64_t size, GDI_VertexHolder vertex );
+
+/**
+  Decodes the compressed form of the edges into lightweight_edge_data.
+  Called through GDA_LightweightEdgesEnsureDecoded.
+ */
+void GDA_LightweightEdgesDecode( GDI_VertexHolder vertex );
+
+/**
+  frees the lightweight edge buffers of a vertex
+ */
+void GDA_LightweightEdgesFree( GDI_VertexHolder vertex );
+
 /**
   Iterate over the whole meta data and filter out the edges that have
   the correct orientation. Fill in the offsets in array_of_offsets[].
@@ -100,41 +206,48 @@ int GDA_LightweightEdgesFilterEdges( uint32_t array_of_offsets[], size_t count,
 void GDA_LightweightEdgesNumEdges( size_t* resultcount, int edge_orientation, GDI_VertexHolder vertex );
 
 /**
-  Iterate over the whole meta data and filter out the edges that have
-  the correct orientation and a label in the whitelist. Fill in the
+  Iterate over the whole meta and label data and filter out the edges
+  that have the correct orientation and a label, whose bit is set in
+  label_set (indexed by the integer handle of the label). Fill in the
   offsets in array_of_offsets[]. Stop if array_of_offsets[] would
   overflow and return the GDI_ERROR_TRUNCATE. Else just go over
   everything and return GDI_SUCCESS.
 
   returns only GDI_SUCCESS and GDI_ERROR_TRUNCATE
  */
-int GDA_LightweightEdgesFilterEdgesWithLabelWhitelist( uint32_t array_of_offsets[], size_t count, size_t* resultcount, int edge_orientation, uint8_t label_whitelist[], size_t list_size, GDI_VertexHolder vertex );
+int GDA_LightweightEdgesFilterEdgesWithLabelSet( uint32_t array_of_offsets[], size_t count, size_t* resultcount, int edge_orientation, const uint64_t label_set[4], GDI_VertexHolder vertex );
 
 /**
   Iterate over the whole meta and label data and filter out the edges
-  that have the correct orientation and a label in the whitelist. If a
-  edge meets the conditions, increment the count.
+  that have the correct orientation and a label in label_set. If a edge
+  meets the conditions, increment the count.
  */
-void GDA_LightweightEdgesNumEdgesWithLabelWhitelist( size_t* resultcount, int edge_orientation, uint8_t label_whitelist[], size_t list_size, GDI_VertexHolder vertex );
+void GDA_LightweightEdgesNumEdgesWithLabelSet( size_t* resultcount, int edge_orientation, const uint64_t label_set[4], GDI_VertexHolder vertex );
 
 /**
-  Iterate over the whole meta data and filter out the edges that have
-  the correct orientation and a label not on the blacklist. Fill in the
-  offsets in array_of_offsets[]. Stop if array_of_offsets[] would
-  overflow and return the GDI_ERROR_TRUNCATE. Else just go over
-  everything and return GDI_SUCCESS.
+  Prepares the iterator for the edge slots of the vertex, that have the
+  correct orientation and a label in label_set (all labels pass, if
+  label_set is NULL).
 
-  returns only GDI_SUCCESS and GDI_ERROR_TRUNCATE
+  Only the edge slots, that exist when the iterator is prepared, are
+  visited, and the edges must not be removed or changed while iterating.
  */
-int GDA_LightweightEdgesFilterEdgesWithLabelBlacklist( uint32_t array_of_offsets[], size_t count, size_t* resultcount, int edge_orientation, uint8_t label_blacklist[], size_t list_size, GDI_VertexHolder vertex );
+void GDA_LightweightEdgesInitCursor( GDI_NeighborIterator* iterator, int edge_orientation, const uint64_t label_set[4], GDI_VertexHolder vertex );
 
+/**
+  Returns the offset of the next edge of the iterator and sets
+  found_flag to true, or sets found_flag to false, once all edges have
+  been visited. The metadata and label data are filtered a chunk of 8
+  edge slots at a time, as in the filter functions above.
+ */
+void GDA_LightweightEdgesCursorNext( uint32_t* edge_offset, bool* found_flag, GDI_NeighborIterator* iterator );
 
 /**
-  Iterate over the whole meta and label data and filter out the edges
-  that have the correct orientation and a label not on the blacklist.
-  If a edge meets the conditions, increment the count.
+  Returns the number of edges with one of the orientations in
+  edge_orientation from the counters of the vertex, which are
+  maintained by the functions that add, remove and change edges.
  */
-void GDA_LightweightEdgesNumEdgesWithLabelBlacklist( size_t* resultcount, int edge_orientation, uint8_t label_blacklist[], size_t list_size, GDI_VertexHolder vertex );
+void GDA_LightweightEdgesDegree( size_t* degree, int edge_orientation, GDI_VertexHolder vertex );
 
 /**
   Change the meta data of the edge found at edge_offset to
@@ -154,9 +267,19 @@ void GDA_LightweightEdgesSetLabel( uint8_t label_int_handle, uint32_t edge_offse
 
 /**
   find the offset of an edge in the lightweight edge data structure of
-  the other vertex
+  the other vertex, record_bits are the bits of the metadata apart from
+  the orientation (record bit and record index), which have to match as
+  well
  */
-uint32_t GDA_LightweightEdgesFindEdge( int original_edge_orientation, GDA_DPointer other_vertex, uint8_t label_int_handle, GDI_VertexHolder vertex );
+uint32_t GDA_LightweightEdgesFindEdge( int original_edge_orientation, GDA_DPointer other_vertex, uint8_t label_int_handle, uint8_t record_bits, GDI_VertexHolder vertex );
+
+/**
+  returns the bitmap of the record indexes used by the edges with a
+  record, that have the orientation (metadata without the record bits),
+  the label and the other vertex, apart from the edges at skip_offset
+  and other_skip_offset
+ */
+uint16_t GDA_LightweightEdgesUsedRecordIndexes( uint8_t edge_orientation, GDA_DPointer other_vertex, uint8_t label_int_handle, uint32_t skip_offset, uint32_t other_skip_offset, GDI_VertexHolder vertex );
 
 /**
   prints the edge orientation and the vertex UID of the second vertex
@@ -173,6 +296,87 @@ uint32_t GDA_LightweightEdgesFindEdge( int original_edge_orientation, GDA_DPoint
  */
 void GDA_LightweightEdgesPrint( GDI_VertexHolder vertex );
 
+static inline bool GDA_LightweightEdgesUseArrays( GDI_VertexHolder vertex ) {
+  return vertex->transaction->db->edge_layout == GDA_EDGE_LAYOUT_ARRAYS;
+}
+
+/**
+  has to be called before lightweight_edge_data is accessed, unless the
+  access is preceded by a call of another function of this header
+ */
+static inline void GDA_LightweightEdgesEnsureDecoded( GDI_VertexHolder vertex ) {
+  if( vertex->lightweight_edge_data == NULL ) {
+    GDA_LightweightEdgesDecode( vertex );
+  }
+}
+
+/**
+  index of the edge slot at edge_offset (counting from zero)
+ */
+static inline uint32_t GDA_LightweightEdgesSlotIndex( uint32_t edge_offset, GDI_VertexHolder vertex ) {
+  uint32_t offset = edge_offset - 2;
+  if( GDA_LightweightEdgesUseArrays( vertex ) ) {
+    return offset;
+  }
+  return offset / GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE * (GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE-2) + offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE;
+}
+
+/**
+  offset of the edge slot with index slot_index (inverse of
+  GDA_LightweightEdgesSlotIndex)
+ */
+static inline uint32_t GDA_LightweightEdgesSlotOffset( uint32_t slot_index, GDI_VertexHolder vertex ) {
+  if( GDA_LightweightEdgesUseArrays( vertex ) ) {
+    return slot_index + 2;
+  }
+  return slot_index / (GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE-2) * GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE + slot_index % (GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE-2) + 2;
+}
+
+/**
+  number of edge slots (including removed edges)
+ */
+static inline uint32_t GDA_LightweightEdgesNumSlots( GDI_VertexHolder vertex ) {
+  return GDA_LightweightEdgesSlotIndex( vertex->lightweight_edge_insert_offset, vertex );
+}
+
+/**
+  number of unused edge slots (tombstones of removed edges)
+ */
+static inline uint32_t GDA_LightweightEdgesNumTombstones( GDI_VertexHolder vertex ) {
+  return GDA_LightweightEdgesNumSlots( vertex ) - (vertex->lightweight_edge_degrees[0] + vertex->lightweight_edge_degrees[1] + vertex->lightweight_edge_degrees[2]);
+}
+
+/**
+  whether the edges are stored sorted by (DPointer, metadata, label)
+ */
+static inline bool GDA_LightweightEdgesStoreSorted( GDI_VertexHolder vertex ) {
+  return vertex->transaction->db->edge_sorted || vertex->transaction->db->edge_compression;
+}
+
+/**
+  checks whether edge_offset addresses an edge slot
+ */
+static inline bool GDA_LightweightEdgesIsEdgeOffset( uint32_t edge_offset, GDI_VertexHolder vertex ) {
+  if( (edge_offset < 2) || (edge_offset >= vertex->lightweight_edge_insert_offset) ) {
+    return false;
+  }
+  return GDA_LightweightEdgesUseArrays( vertex ) || (edge_offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE >= 2);
+}
+
+/**
+  offset of the edge slot after edge_offset
+ */
+static inline uint32_t GDA_LightweightEdgesNextOffset( uint32_t edge_offset, GDI_VertexHolder vertex ) {
+  edge_offset++;
+  if( !GDA_LightweightEdgesUseArrays( vertex ) && (edge_offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE == 0) ) {
+    /**
+      skip the meta and label data of the next block
+     */
+    edge_offset += 2;
+  }
+  return edge_offset;
+}
+
 /**
   Helper function that gives back the pointer to the metadata of an edge
   at edge_offset. Globaly visible as it gets used in the testing
@@ -180,9 +384,27 @@ void GDA_LightweightEdgesPrint( GDI_VertexHolder vertex );
  */
 static inline void GDA_LightweightEdgesGetMetadataPointerWithOffset( uint8_t** metadata_pointer, GDI_VertexHolder vertex, uint32_t edge_offset ) {
   uint32_t block_start_offset, offset;
+  GDA_LightweightEdgesEnsureDecoded( vertex );
+  if( GDA_LightweightEdgesUseArrays( vertex ) ) {
+    uint64_t capacity = vertex->lightweight_edge_data[0];
+    *metadata_pointer = ((uint8_t*) (vertex->lightweight_edge_data + GDA_LIGHTWEIGHT_EDGES_ARRAYS_HEADER_SIZE + capacity)) + (edge_offset - 2);
+    return;
+  }
   block_start_offset = (edge_offset / GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE) * GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE /* round to the next integer divisible by GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE */;
   offset = edge_offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE - 2;
   *metadata_pointer = ((uint8_t*) (vertex->lightweight_edge_data+block_start_offset)) + offset;
 }
 
+/**
+  gives back the pointer to the label data of an edge at edge_offset
+ */
+static inline void GDA_LightweightEdgesGetLabelPointerWithOffset( uint8_t** label_pointer, GDI_VertexHolder vertex, uint32_t edge_offset ) {
+  GDA_LightweightEdgesGetMetadataPointerWithOffset( label_pointer, vertex, edge_offset );
+  if( GDA_LightweightEdgesUseArrays( vertex ) ) {
+    *label_pointer += vertex->lightweight_edge_data[0];
+  } else {
+    *label_pointer += 8;
+  }
+}
+
 #endif //#ifndef GDA_LIGHTWEIGHTEDGES_H
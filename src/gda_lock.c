@@ -9,6 +9,7 @@
 #include <assert.h>
 
 #include "gda_lock.h"
+#include "gda_yield.h"
 #include "rma.h"
 
 /**
@@ -69,8 +70,15 @@ void GDA_AcquireVertexReadLock( GDI_VertexHolder vertex ) {
     Try to acquire a read lock
    */
   RMA_Fetch_and_op( &value, &result, MPI_INT64_T, target_rank, offset, RMA_SUM, vertex->transaction->db->win_system );
+  GDA_Yield();
   RMA_Win_flush( target_rank, vertex->transaction->db->win_system );
 
+  /**
+    The incarnation is reported even if the lock can't be acquired, so that
+    the calling function can detect a vertex UID that was reused in the meantime.
+   */
+  vertex->incarnation = result >> 32;
+
   if( result & LOCK_WRITER_MASK ) {
     /**
       There is an active writer - we can't read, so revert changes
@@ -78,6 +86,7 @@ void GDA_AcquireVertexReadLock( GDI_VertexHolder vertex ) {
     value = -LOCK_READER_INCREMENT_VALUE;
     RMA_Fetch_and_op( &value, &result, MPI_INT64_T, target_rank, offset, RMA_SUM,
                       vertex->transaction->db->win_system );
+    GDA_Yield();
     RMA_Win_flush( target_rank, vertex->transaction->db->win_system );
     return;
   }
@@ -86,7 +95,6 @@ void GDA_AcquireVertexReadLock( GDI_VertexHolder vertex ) {
     Success - read lock acquired
    */
   vertex->lock_type = GDA_READ_LOCK;
-  vertex->incarnation = result >> 32;
 }
 
 
@@ -122,6 +130,7 @@ void GDA_UpdateToVertexWriteLock( GDI_VertexHolder vertex ) {
    */
   RMA_Compare_and_swap( &replace_value, &compare_value, &result, MPI_INT64_T, target_rank, offset,
                         vertex->transaction->db->win_system );
+  GDA_Yield();
   RMA_Win_flush( target_rank, vertex->transaction->db->win_system );
 
   if( (result & 0x00000000FFFFFFFF /* ignore incarnation */) == LOCK_SINGLE_READER ) {
@@ -155,6 +164,7 @@ void GDA_SetVertexWriteLock( GDI_VertexHolder vertex ) {
     Try to acquire a write lock
    */
   RMA_Fetch_and_op( &value, &result, MPI_INT64_T, target_rank, offset, RMA_SUM, vertex->transaction->db->win_system );
+  GDA_Yield();
   RMA_Win_flush( target_rank, vertex->transaction->db->win_system );
 
   /**
@@ -197,6 +207,7 @@ void GDA_ReleaseVertexLock( GDI_VertexHolder vertex ) {
     Atomically decrement the number of readers or number of writers
    */
   RMA_Fetch_and_op( &value, &result, MPI_INT64_T, target_rank, offset, RMA_SUM, vertex->transaction->db->win_system );
+  GDA_Yield();
   RMA_Win_flush( target_rank, vertex->transaction->db->win_system );
 
   vertex->lock_type = GDA_NO_LOCK;
@@ -206,3 +217,26 @@ void GDA_ReleaseVertexLock( GDI_VertexHolder vertex ) {
     calling code as well
    */
 }
+
+
+/**
+  Reads the incarnation field of the lock of the vertex associated with the given VertexHolder without acquiring the
+  lock.
+ */
+void GDA_ReadVertexIncarnation( GDI_VertexHolder vertex ) {
+  /**
+    Find DPointer to the primary block
+   */
+  uint64_t target_rank;
+  uint64_t offset;
+  FindPrimaryBlock( vertex, &target_rank, &offset );
+
+  int64_t value = 0; /* value not used */
+  int64_t result;
+
+  RMA_Fetch_and_op( &value, &result, MPI_INT64_T, target_rank, offset, RMA_NO_OP, vertex->transaction->db->win_system );
+  GDA_Yield();
+  RMA_Win_flush( target_rank, vertex->transaction->db->win_system );
+
+  vertex->incarnation = result >> 32;
+}
@@ -32,5 +32,11 @@ void GDA_UpdateToVertexWriteLock( GDI_VertexHolder vertex );
  */
 void GDA_SetVertexWriteLock( GDI_VertexHolder vertex );
 void GDA_ReleaseVertexLock( GDI_VertexHolder vertex );
+/**
+  GDA_ReadVertexIncarnation doesn't acquire a lock, so it should only be
+  used, when no single process transaction can change the vertex (e.g.
+  during a collective transaction)
+ */
+void GDA_ReadVertexIncarnation( GDI_VertexHolder vertex );
 
 #endif // __GDA_LOCK_H
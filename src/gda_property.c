@@ -15,7 +15,9 @@
 #include <string.h>
 
 #include "gdi.h"
+#include "gda_dictionary.h"
 #include "gda_property.h"
+#include "gda_varint.h"
 
 /**
   linear scanning:
@@ -33,13 +35,26 @@
   1 = last record
   2 = label
   3 = GDI_PROPERTY_TYPE_ID
-  4... = user-defined property types
+  4 = property slots (GDA_PropertySchema)
+  5... = user-defined property types
 
   GDI_PROPERTY_TYPE_DEGREE, GDI_PROPERTY_TYPE_INDEGREE and GDI_PROPERTY_TYPE_OUTDEGREE have to be handled differently
 
   size = size of the data in Bytes, 0 is a valid size
 
   The position of the next record is position of the current record + meta data size + size.
+
+  A directory (GDA_PropertyDirectory) records the offset of the first
+  record and the number of records of each property type and the labels
+  of the vertex, so that lookups don't have to scan the list from its
+  start. Records never move in the list (a realloc keeps their offsets),
+  so the directory only has to be updated, when records are added or
+  removed.
+
+  The properties in the slots of a vertex (GDA_PropertySchema) are
+  handled by the GDA_PropertySlot functions instead: their directory
+  entry has at most one "record", which is the offset of the value in
+  the slot record.
  */
 
 
@@ -53,121 +68,438 @@ static inline char* GDA_NextPropertyRecord( char* pos ) {
 }
 
 
-void GDA_LinearScanningInitPropertyList( GDI_VertexHolder vertex ) {
-  vertex->property_size = 32;
-  vertex->property_data = malloc( 32 );
-  vertex->unused_space = vertex->property_size - GDA_PROPERTY_OFFSET_PRIMARY - GDA_PROPERTY_METADATA_SIZE /* for the last record */;
-  *(GDA_PropertyHandle*) ((vertex->property_data) + GDA_PROPERTY_OFFSET_PRIMARY) = GDA_PROPERTY_LAST;
+/**
+  property directory
+ */
+
+/**
+  makes sure that the directory has entries up to the property type
+  with int_handle and label bits up to the label with label_int_handle
+ */
+static void GDA_PropertyDirectoryReserve( GDA_PropertyDirectory* dir, uint32_t int_handle, uint32_t label_int_handle ) {
+  if( int_handle >= dir->num_entries ) {
+    uint32_t num_entries = int_handle + 1;
+    dir->entries = realloc( dir->entries, num_entries * sizeof(GDA_PropertyDirectoryEntry) );
+    assert( dir->entries != NULL );
+    memset( dir->entries + dir->num_entries, 0, (num_entries - dir->num_entries) * sizeof(GDA_PropertyDirectoryEntry) );
+    dir->num_entries = num_entries;
+  }
+  if( (label_int_handle >> 6) >= dir->num_label_words ) {
+    uint32_t num_label_words = (label_int_handle >> 6) + 1;
+    dir->label_bitmap = realloc( dir->label_bitmap, num_label_words * sizeof(uint64_t) );
+    assert( dir->label_bitmap != NULL );
+    memset( dir->label_bitmap + dir->num_label_words, 0, (num_label_words - dir->num_label_words) * sizeof(uint64_t) );
+    dir->num_label_words = num_label_words;
+  }
+}
+
+
+static void GDA_PropertyDirectoryCountRecord( GDA_PropertyDirectory* dir, GDA_PropertyHandle phandle, uint64_t offset ) {
+  GDA_PropertyDirectoryReserve( dir, phandle, 0 );
+  GDA_PropertyDirectoryEntry* entry = dir->entries + phandle;
+  if( entry->num_records == 0 ) {
+    entry->first_offset = offset;
+    if( (phandle > GDA_PROPERTY_LABEL) && (phandle != GDA_PROPERTY_SLOTS) ) {
+      dir->num_ptypes++;
+    }
+  } else {
+    if( offset < entry->first_offset ) {
+      entry->first_offset = offset;
+    }
+  }
+  entry->num_records++;
+}
+
+
+static void GDA_PropertyDirectoryCountLabel( GDA_PropertyDirectory* dir, uint32_t label_int_handle, bool present ) {
+  GDA_PropertyDirectoryReserve( dir, 0, label_int_handle );
+  uint64_t bit = (uint64_t) 1 << (label_int_handle & 63);
+  uint64_t* word = dir->label_bitmap + (label_int_handle >> 6);
+  if( present && !(*word & bit) ) {
+    *word |= bit;
+    dir->num_labels++;
+  }
+  if( !present && (*word & bit) ) {
+    *word &= ~bit;
+    dir->num_labels--;
+  }
 }
 
 
 /**
-  assumes that label is not GDI_LABEL_NONE and GDI_LABEL_NULL
+  returns the schema of the label with label_int_handle (NULL, if it
+  doesn't have one)
+ */
+static inline GDA_PropertySchema* GDA_LabelPropertySchema( uint32_t label_int_handle, GDI_Database graph_db ) {
+  if( label_int_handle >= graph_db->labels->num_schemas ) {
+    return NULL;
+  }
+  return graph_db->labels->schemas[label_int_handle];
+}
 
-  found_flag is returned, in case the caller wants to keep skip updating indexes and indicates
-  whether the label was already present on the vertex:
-  true  = label was already present
-  false = label was added by this function call
 
-  updates the unused_space counter
+/**
+  returns the directory of the vertex and builds it with a single scan
+  over the records, if the properties weren't accessed before
  */
-void GDA_LinearScanningInsertLabel( GDI_Label label, GDI_VertexHolder vertex, bool* found_flag ) {
+static GDA_PropertyDirectory* GDA_GetPropertyDirectory( GDI_VertexHolder vertex ) {
+  if( vertex->property_directory != NULL ) {
+    return vertex->property_directory;
+  }
+
+  GDA_PropertyDirectory* dir = malloc( sizeof(GDA_PropertyDirectory) );
+  assert( dir != NULL );
+  dir->entries = NULL;
+  dir->num_entries = 0;
+  dir->num_ptypes = 0;
+  dir->label_bitmap = NULL;
+  dir->num_label_words = 0;
+  dir->num_labels = 0;
+  dir->schema = NULL;
+  GDA_PropertyDirectoryReserve( dir, vertex->transaction->db->ptypes->ptype_max - 1, vertex->transaction->db->labels->label_max - 1 );
+
   char* pos = vertex->property_data;
   GDA_PropertyHandle phandle = *(GDA_PropertyHandle*) pos;
-  GDA_PropertyRecordSize label_entry_size = sizeof(uint32_t);
-  char* insert_pos = NULL;
-
-  /**
-    first check whether the label is already present on the vertex
-   */
   while( phandle != GDA_PROPERTY_LAST ) {
     if( phandle == GDA_PROPERTY_LABEL ) {
-      uint32_t record_entry = *(uint32_t*) (pos+GDA_PROPERTY_METADATA_SIZE);
-      if( record_entry == label->int_handle ) {
-        *found_flag = true;
-        return;
-      }
+      GDA_PropertyDirectoryCountLabel( dir, *(uint32_t*) (pos+GDA_PROPERTY_METADATA_SIZE), true );
     } else {
-      if( phandle == GDA_PROPERTY_EMPTY ) {
-        GDA_PropertyRecordSize record_size = *(GDA_PropertyRecordSize*) (pos+GDA_PROPERTY_HANDLE_SIZE);
-        if( (record_size == label_entry_size) || (record_size >= (label_entry_size + GDA_PROPERTY_METADATA_SIZE)) ) {
-          /**
-            found a record entry that is empty and big enough
-           */
-          insert_pos = pos;
-          /**
-            check the remaining list to ensure that the label is not already there
-           */
-          pos = GDA_NextPropertyRecord( pos );
-          phandle = *(GDA_PropertyHandle*) pos;
-          while( phandle != GDA_PROPERTY_LAST ) {
-            if( phandle == GDA_PROPERTY_LABEL ) {
-              uint32_t record_entry = *(uint32_t*) (pos+GDA_PROPERTY_METADATA_SIZE);
-              if( record_entry == label->int_handle ) {
-                *found_flag = true;
-                return;
-              }
-            }
-            pos = GDA_NextPropertyRecord( pos );
-            phandle = *(GDA_PropertyHandle*) pos;
+      if( phandle != GDA_PROPERTY_EMPTY ) {
+        GDA_PropertyDirectoryCountRecord( dir, phandle, pos - vertex->property_data );
+      }
+      if( phandle == GDA_PROPERTY_SLOTS ) {
+        /**
+          every property in a slot counts as a record of its property type
+         */
+        char* data = pos + GDA_PROPERTY_METADATA_SIZE;
+        dir->schema = GDA_LabelPropertySchema( *(uint32_t*) (data+GDA_PROPERTY_SLOTS_OFFSET_LABEL), vertex->transaction->db );
+        assert( dir->schema != NULL );
+        for( uint32_t i=0 ; i<dir->schema->num_slots ; i++ ) {
+          if( (data[GDA_PROPERTY_SLOTS_OFFSET_BITMAP + (i >> 3)] >> (i & 7)) & 1 ) {
+            GDA_PropertyDirectoryCountRecord( dir, dir->schema->int_handles[i], data + dir->schema->slot_offsets[i] - vertex->property_data );
           }
-          /**
-            we are already finished with traversing the list,
-            so we break from the outer loop
-           */
-          break;
         }
       }
     }
-    /**
-      advance to the next record in the list
-     */
     pos = GDA_NextPropertyRecord( pos );
     phandle = *(GDA_PropertyHandle*) pos;
   }
 
-  /**
-    didn't find the label, so we insert it now
-   */
-  *found_flag = false;
+  vertex->property_directory = dir;
+  return dir;
+}
 
-  if( insert_pos != NULL ) {
+
+/**
+  has to be called, after a record of a property type was added at
+  the position record
+ */
+static inline void GDA_PropertyDirectoryAddRecord( GDA_PropertyHandle phandle, const char* record, GDI_VertexHolder vertex ) {
+  if( vertex->property_directory != NULL ) {
+    GDA_PropertyDirectoryCountRecord( vertex->property_directory, phandle, record - vertex->property_data );
+  }
+}
+
+
+/**
+  has to be called, before the record of a property type at the
+  position record is turned into an empty record
+ */
+static void GDA_PropertyDirectoryRemoveRecord( char* record, GDI_VertexHolder vertex ) {
+  GDA_PropertyDirectory* dir = vertex->property_directory;
+  if( dir == NULL ) {
+    return;
+  }
+
+  GDA_PropertyHandle phandle = *(GDA_PropertyHandle*) record;
+  assert( (phandle < dir->num_entries) && (dir->entries[phandle].num_records > 0) );
+  GDA_PropertyDirectoryEntry* entry = dir->entries + phandle;
+  entry->num_records--;
+  if( entry->num_records == 0 ) {
+    if( (phandle > GDA_PROPERTY_LABEL) && (phandle != GDA_PROPERTY_SLOTS) ) {
+      dir->num_ptypes--;
+    }
+    return;
+  }
+
+  if( entry->first_offset == (uint64_t) (record - vertex->property_data) ) {
     /**
-      already found an sufficient sized empty record entry during the find operation
+      the other records of the property type follow the removed one
      */
-    GDA_PropertyRecordSize record_size = *(GDA_PropertyRecordSize*) (insert_pos+GDA_PROPERTY_HANDLE_SIZE);
-    if( record_size == label_entry_size ) {
+    char* pos = GDA_NextPropertyRecord( record );
+    while( *(GDA_PropertyHandle*) pos != phandle ) {
+      assert( *(GDA_PropertyHandle*) pos != GDA_PROPERTY_LAST );
+      pos = GDA_NextPropertyRecord( pos );
+    }
+    entry->first_offset = pos - vertex->property_data;
+  }
+}
+
+
+/**
+  returns the first record of the property type with int_handle and
+  the number of its records (NULL and 0, if there is none)
+ */
+static inline char* GDA_PropertyDirectoryFind( uint8_t int_handle, uint32_t* num_records, GDI_VertexHolder vertex ) {
+  GDA_PropertyDirectory* dir = GDA_GetPropertyDirectory( vertex );
+  if( (int_handle >= dir->num_entries) || (dir->entries[int_handle].num_records == 0) ) {
+    *num_records = 0;
+    return NULL;
+  }
+  *num_records = dir->entries[int_handle].num_records;
+  return vertex->property_data + dir->entries[int_handle].first_offset;
+}
+
+
+/**
+  returns whether the label with label_int_handle is present on the vertex
+ */
+static inline bool GDA_PropertyDirectoryHasLabel( uint32_t label_int_handle, GDI_VertexHolder vertex ) {
+  GDA_PropertyDirectory* dir = GDA_GetPropertyDirectory( vertex );
+  if( (label_int_handle >> 6) >= dir->num_label_words ) {
+    return false;
+  }
+  return (dir->label_bitmap[label_int_handle >> 6] >> (label_int_handle & 63)) & 1;
+}
+
+
+/**
+  property slots
+ */
+
+GDA_PropertySchema* GDA_CreatePropertySchema( const GDI_PropertyType* ptypes, size_t count ) {
+  GDA_PropertySchema* schema = malloc( sizeof(GDA_PropertySchema) );
+  assert( schema != NULL );
+  schema->num_slots = count;
+  schema->int_handles = malloc( count * sizeof(uint32_t) );
+  assert( schema->int_handles != NULL );
+  schema->slot_offsets = malloc( count * sizeof(uint64_t) );
+  assert( schema->slot_offsets != NULL );
+  schema->slot_sizes = malloc( count * sizeof(uint64_t) );
+  assert( schema->slot_sizes != NULL );
+
+  schema->num_handles = 0;
+  for( size_t i=0 ; i<count ; i++ ) {
+    if( ptypes[i]->int_handle >= schema->num_handles ) {
+      schema->num_handles = ptypes[i]->int_handle + 1;
+    }
+  }
+  schema->slot_index = malloc( schema->num_handles * sizeof(int32_t) );
+  assert( schema->slot_index != NULL );
+  for( uint32_t i=0 ; i<schema->num_handles ; i++ ) {
+    schema->slot_index[i] = -1;
+  }
+
+  /**
+    the values follow the label and the presence bitmap
+   */
+  uint64_t offset = GDA_PROPERTY_SLOTS_OFFSET_BITMAP + ((count + 7) >> 3);
+  for( size_t i=0 ; i<count ; i++ ) {
+    size_t dsize;
+    GDI_GetSizeOfDatatype( &dsize, ptypes[i]->dtype );
+    schema->int_handles[i] = ptypes[i]->int_handle;
+    schema->slot_offsets[i] = offset;
+    schema->slot_sizes[i] = ptypes[i]->count * dsize;
+    schema->slot_index[ptypes[i]->int_handle] = i;
+    offset += schema->slot_sizes[i];
+  }
+  schema->record_size = offset;
+
+  return schema;
+}
+
+
+void GDA_FreePropertySchema( GDA_PropertySchema* schema ) {
+  free( schema->int_handles );
+  free( schema->slot_offsets );
+  free( schema->slot_sizes );
+  free( schema->slot_index );
+  free( schema );
+}
+
+
+/**
+  returns the slot of the property type in the slot record of the
+  vertex (-1, if the property type isn't stored in a slot)
+ */
+static inline int32_t GDA_PropertySlot( GDI_PropertyType ptype, GDI_VertexHolder vertex ) {
+  GDA_PropertySchema* schema = GDA_GetPropertyDirectory( vertex )->schema;
+  if( (schema == NULL) || (ptype->int_handle >= schema->num_handles) ) {
+    return -1;
+  }
+  return schema->slot_index[ptype->int_handle];
+}
+
+
+/**
+  assumes that the vertex has a slot record
+ */
+static inline uint8_t* GDA_PropertySlotsData( GDI_VertexHolder vertex ) {
+  return (uint8_t*) (vertex->property_data + vertex->property_directory->entries[GDA_PROPERTY_SLOTS].first_offset + GDA_PROPERTY_METADATA_SIZE);
+}
+
+
+static inline bool GDA_PropertySlotPresent( int32_t slot, GDI_VertexHolder vertex ) {
+  return (GDA_PropertySlotsData( vertex )[GDA_PROPERTY_SLOTS_OFFSET_BITMAP + (slot >> 3)] >> (slot & 7)) & 1;
+}
+
+
+static inline char* GDA_PropertySlotValue( int32_t slot, GDI_VertexHolder vertex ) {
+  return (char*) GDA_PropertySlotsData( vertex ) + vertex->property_directory->schema->slot_offsets[slot];
+}
+
+
+/**
+  sets or clears the presence bit of the slot and keeps the directory
+  entry of its property type up to date
+ */
+static void GDA_SetPropertySlotPresent( int32_t slot, bool present, GDI_VertexHolder vertex ) {
+  GDA_PropertyDirectory* dir = vertex->property_directory;
+  uint8_t* byte = GDA_PropertySlotsData( vertex ) + GDA_PROPERTY_SLOTS_OFFSET_BITMAP + (slot >> 3);
+  uint8_t bit = 1 << (slot & 7);
+  uint32_t int_handle = dir->schema->int_handles[slot];
+
+  if( present && !(*byte & bit) ) {
+    *byte |= bit;
+    GDA_PropertyDirectoryCountRecord( dir, int_handle, GDA_PropertySlotValue( slot, vertex ) - vertex->property_data );
+  }
+  if( !present && (*byte & bit) ) {
+    *byte &= ~bit;
+    dir->entries[int_handle].num_records = 0;
+    dir->num_ptypes--;
+  }
+}
+
+
+/**
+  records of dictionary encoded values, that were loaded as their code
+  (property_codes of the vertex): the first 8 Bytes of the data of such a
+  record hold the code, while the size of the record is the one of the
+  value, so that the value can be decoded in place
+
+  a vertex only has a few of them, so the list is searched linearly
+ */
+static inline int64_t GDA_FindCodedPropertyRecord( const char* record, GDI_VertexHolder vertex ) {
+  if( vertex->property_codes == NULL ) {
+    return -1;
+  }
+  uint64_t offset = record - vertex->property_data;
+  uint64_t* offsets = vertex->property_codes->data;
+  for( size_t i=0 ; i<vertex->property_codes->size ; i++ ) {
+    if( offsets[i] == offset ) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+
+static inline uint64_t GDA_PropertyRecordCode( const char* record ) {
+  uint64_t code;
+  memcpy( &code, record+GDA_PROPERTY_METADATA_SIZE, sizeof(uint64_t) );
+  return code;
+}
+
+
+/**
+  replaces the code in the record with its value, if the record is still
+  encoded
+ */
+static void GDA_DecodePropertyRecord( char* record, GDI_VertexHolder vertex ) {
+  int64_t i = GDA_FindCodedPropertyRecord( record, vertex );
+  if( i < 0 ) {
+    return;
+  }
+
+  GDA_PropertyRecordSize record_size = *(GDA_PropertyRecordSize*) (record+GDA_PROPERTY_HANDLE_SIZE);
+  memcpy( record+GDA_PROPERTY_METADATA_SIZE, GDA_DictionaryDecode( GDA_PropertyRecordCode( record ), record_size, vertex->transaction->db ), record_size );
+
+  GDA_Vector* codes = vertex->property_codes;
+  uint64_t* offsets = codes->data;
+  offsets[i] = offsets[codes->size-1];
+  GDA_vector_pop_back( codes );
+  if( codes->size == 0 ) {
+    GDA_vector_free( &(vertex->property_codes) );
+  }
+}
+
+
+/**
+  decodes all records of the property type, before they are changed or
+  compared by the functions below, which only work on values
+ */
+static void GDA_DecodePropertyRecords( uint8_t int_handle, GDI_VertexHolder vertex ) {
+  size_t i = 0;
+  while( (vertex->property_codes != NULL) && (i < vertex->property_codes->size) ) {
+    char* record = vertex->property_data + *(uint64_t*)GDA_vector_at( vertex->property_codes, i );
+    if( *(GDA_PropertyHandle*) record == int_handle ) {
       /**
-        empty record fits perfectly, so we don't have to update the size part of the meta data
+        the entry is replaced by the last one
        */
-      *(GDA_PropertyHandle*) insert_pos = GDA_PROPERTY_LABEL;
-      *(uint32_t*) (insert_pos+GDA_PROPERTY_METADATA_SIZE) = label->int_handle;
+      GDA_DecodePropertyRecord( record, vertex );
     } else {
+      i++;
+    }
+  }
+}
+
+
+/**
+  inserts a record with phandle and a data size of entry_size into the
+  first empty record, that is big enough, or at the end of the list and
+  returns its position
+
+  the caller writes the data and updates the directory
+
+  updates the unused_space counter
+ */
+static char* GDA_InsertPropertyRecord( GDA_PropertyHandle phandle, GDA_PropertyRecordSize entry_size, GDI_VertexHolder vertex ) {
+  char* pos = vertex->property_data;
+  GDA_PropertyHandle record_handle = *(GDA_PropertyHandle*) pos;
+  char* insert_pos = NULL;
+
+  while( record_handle != GDA_PROPERTY_LAST ) {
+    if( record_handle == GDA_PROPERTY_EMPTY ) {
+      GDA_PropertyRecordSize record_size = *(GDA_PropertyRecordSize*) (pos+GDA_PROPERTY_HANDLE_SIZE);
+      if( (record_size == entry_size) || (record_size >= (entry_size + GDA_PROPERTY_METADATA_SIZE)) ) {
+        /**
+          found a record entry that is empty and big enough
+         */
+        insert_pos = pos;
+        break;
+      }
+    }
+    /**
+      advance to the next record in the list
+     */
+    pos = GDA_NextPropertyRecord( pos );
+    record_handle = *(GDA_PropertyHandle*) pos;
+  }
+
+  if( insert_pos != NULL ) {
+    GDA_PropertyRecordSize record_size = *(GDA_PropertyRecordSize*) (insert_pos+GDA_PROPERTY_HANDLE_SIZE);
+    *(GDA_PropertyHandle*) insert_pos = phandle;
+    if( record_size != entry_size ) {
       /**
         we already know that the empty record is at least big enough to hold the new
-        label record and an empty record, so no need to check again
-
-        first set the new label record
+        record and an empty record, so no need to check again
        */
-      *(GDA_PropertyHandle*) insert_pos = GDA_PROPERTY_LABEL;
-      *(GDA_PropertyRecordSize*) (insert_pos+GDA_PROPERTY_HANDLE_SIZE) = label_entry_size;
-      *(uint32_t*) (insert_pos+GDA_PROPERTY_METADATA_SIZE) = label->int_handle;
+      *(GDA_PropertyRecordSize*) (insert_pos+GDA_PROPERTY_HANDLE_SIZE) = entry_size;
       /**
         set a new empty record
        */
-      insert_pos = insert_pos + GDA_PROPERTY_METADATA_SIZE + label_entry_size;
-      *(GDA_PropertyHandle*) insert_pos = GDA_PROPERTY_EMPTY;
-      *(GDA_PropertyRecordSize*) (insert_pos+GDA_PROPERTY_HANDLE_SIZE) = record_size - (label_entry_size + GDA_PROPERTY_METADATA_SIZE);
+      char* empty_pos = insert_pos + GDA_PROPERTY_METADATA_SIZE + entry_size;
+      *(GDA_PropertyHandle*) empty_pos = GDA_PROPERTY_EMPTY;
+      *(GDA_PropertyRecordSize*) (empty_pos+GDA_PROPERTY_HANDLE_SIZE) = record_size - (entry_size + GDA_PROPERTY_METADATA_SIZE);
     }
   } else {
-    assert( *(GDA_PropertyHandle*) pos == GDA_PROPERTY_LAST );
     /**
       have to insert a record at the end
 
       pos points to the last record (= special record at the end of the list)
      */
     size_t new_list_size = pos + GDA_PROPERTY_METADATA_SIZE - vertex->property_data /* absolute size of the used memory */
-      + GDA_PROPERTY_METADATA_SIZE + sizeof(uint32_t) /* size of the new record (including meta data) */;
+      + GDA_PROPERTY_METADATA_SIZE + entry_size /* size of the new record (including meta data) */;
     if( new_list_size > vertex->property_size ) {
       /**
         allocated memory is not sufficient
@@ -180,21 +512,304 @@ void GDA_LinearScanningInsertLabel( GDI_Label label, GDI_VertexHolder vertex, bo
       vertex->property_data = realloc( vertex->property_data, vertex->property_size );
       pos = vertex->property_data + temp_pos;
     }
-    *(GDA_PropertyHandle*) pos = GDA_PROPERTY_LABEL;
-    *(GDA_PropertyRecordSize*) (pos+GDA_PROPERTY_HANDLE_SIZE) = label_entry_size;
-    *(uint32_t*) (pos+GDA_PROPERTY_METADATA_SIZE) = label->int_handle;
-    /**
-      set a new last record
-     */
-    pos = pos + GDA_PROPERTY_METADATA_SIZE + label_entry_size;
-    *(GDA_PropertyHandle*) pos = GDA_PROPERTY_LAST;
+    insert_pos = pos;
+    *(GDA_PropertyHandle*) insert_pos = phandle;
+    *(GDA_PropertyRecordSize*) (insert_pos+GDA_PROPERTY_HANDLE_SIZE) = entry_size;
+    /**
+      set a new last record
+     */
+    pos = insert_pos + GDA_PROPERTY_METADATA_SIZE + entry_size;
+    *(GDA_PropertyHandle*) pos = GDA_PROPERTY_LAST;
+  }
+
+  /**
+    update the unused space counter
+   */
+  assert( vertex->unused_space >= (entry_size + GDA_PROPERTY_METADATA_SIZE) );
+  vertex->unused_space -= entry_size + GDA_PROPERTY_METADATA_SIZE;
+
+  return insert_pos;
+}
+
+
+/**
+  adds the slot record of the schema of the label with label_int_handle
+  to the vertex and moves the properties of the schema, that the vertex
+  already has, from their records into the slots
+ */
+static void GDA_CreatePropertySlots( GDA_PropertySchema* schema, uint32_t label_int_handle, GDI_VertexHolder vertex ) {
+  char* slots = calloc( schema->record_size, 1 );
+  assert( slots != NULL );
+  *(uint32_t*) (slots+GDA_PROPERTY_SLOTS_OFFSET_LABEL) = label_int_handle;
+
+  GDI_Database graph_db = vertex->transaction->db;
+  for( uint32_t i=0 ; i<schema->num_slots ; i++ ) {
+    uint32_t num_records;
+    char* pos = GDA_PropertyDirectoryFind( schema->int_handles[i], &num_records, vertex );
+    if( num_records > 0 ) {
+      assert( *(GDA_PropertyRecordSize*) (pos+GDA_PROPERTY_HANDLE_SIZE) == schema->slot_sizes[i] );
+      GDA_DecodePropertyRecord( pos, vertex );
+      memcpy( slots + schema->slot_offsets[i], pos + GDA_PROPERTY_METADATA_SIZE, schema->slot_sizes[i] );
+      slots[GDA_PROPERTY_SLOTS_OFFSET_BITMAP + (i >> 3)] |= 1 << (i & 7);
+      /**
+        simplification of GDA_IntHandleToPropertyType
+        since we don't need the additional input validation
+       */
+      GDA_Node** node = GDA_hashmap_get( graph_db->ptypes->handle_to_address, schema->int_handles + i );
+      assert( node != NULL );
+      bool found_flag;
+      GDA_LinearScanningRemoveProperties( *(GDI_PropertyType*)((*node)->value), vertex, &found_flag );
+    }
+  }
+
+  char* pos = GDA_InsertPropertyRecord( GDA_PROPERTY_SLOTS, schema->record_size, vertex );
+  GDA_PropertyDirectoryAddRecord( GDA_PROPERTY_SLOTS, pos, vertex );
+  memcpy( pos+GDA_PROPERTY_METADATA_SIZE, slots, schema->record_size );
+  free( slots );
+
+  GDA_PropertyDirectory* dir = vertex->property_directory;
+  dir->schema = schema;
+  for( uint32_t i=0 ; i<schema->num_slots ; i++ ) {
+    if( GDA_PropertySlotPresent( i, vertex ) ) {
+      GDA_PropertyDirectoryCountRecord( dir, schema->int_handles[i], GDA_PropertySlotValue( i, vertex ) - vertex->property_data );
+    }
+  }
+}
+
+
+void GDA_LinearScanningInitPropertyList( GDI_VertexHolder vertex ) {
+  vertex->property_size = 32;
+  vertex->property_data = malloc( 32 );
+  vertex->unused_space = vertex->property_size - GDA_PROPERTY_OFFSET_PRIMARY - GDA_PROPERTY_METADATA_SIZE /* for the last record */;
+  *(GDA_PropertyHandle*) ((vertex->property_data) + GDA_PROPERTY_OFFSET_PRIMARY) = GDA_PROPERTY_LAST;
+  vertex->property_directory = NULL;
+  vertex->property_codes = NULL;
+}
+
+
+void GDA_LinearScanningFreePropertyList( GDI_VertexHolder vertex ) {
+  free( vertex->property_data );
+  vertex->property_data = NULL;
+  if( vertex->property_directory != NULL ) {
+    free( vertex->property_directory->entries );
+    free( vertex->property_directory->label_bitmap );
+    free( vertex->property_directory );
+    vertex->property_directory = NULL;
+  }
+  if( vertex->property_codes != NULL ) {
+    GDA_vector_free( &(vertex->property_codes) );
+  }
+}
+
+
+/**
+  stored format (see gda_property.h):
+   -------- ------ --------   -------- ------ ---   --------
+  | handle | size |  data ... | handle | size |...| handle |
+   -------- ------ --------   -------- ------ ---   --------
+  size = varint, the list ends with the handle of the last record
+  values of dictionary encoded property types are replaced by their code
+ */
+
+uint64_t GDA_StoredPropertyListSize( GDI_VertexHolder vertex ) {
+  uint64_t size = GDA_PROPERTY_HANDLE_SIZE /* last record */;
+  char* pos = vertex->property_data;
+  GDA_PropertyHandle phandle = *(GDA_PropertyHandle*) pos;
+
+  while( phandle != GDA_PROPERTY_LAST ) {
+    if( phandle != GDA_PROPERTY_EMPTY ) {
+      GDA_PropertyRecordSize record_size = *(GDA_PropertyRecordSize*) (pos+GDA_PROPERTY_HANDLE_SIZE);
+      size += GDA_PROPERTY_HANDLE_SIZE + GDA_VarintSize( record_size ) + record_size;
+    }
+    pos = GDA_NextPropertyRecord( pos );
+    phandle = *(GDA_PropertyHandle*) pos;
+  }
+
+  return size;
+}
+
+
+/**
+  whether the records with the handle are dictionary encoded, which
+  only applies to values, that are longer than their code and marker
+ */
+static bool GDA_IsDictionaryEncoded( GDA_PropertyHandle phandle, GDA_PropertyRecordSize record_size, GDI_Database graph_db ) {
+  if( (phandle <= GDA_PROPERTY_SLOTS) || (record_size <= GDA_PROPERTY_HANDLE_SIZE + sizeof(uint64_t)) ) {
+    return false;
+  }
+
+  uint32_t int_handle = phandle;
+  GDA_Node** node = GDA_hashmap_get( graph_db->ptypes->handle_to_address, &int_handle );
+  if( node == NULL ) {
+    /**
+      property type was already freed
+     */
+    return false;
+  }
+  return (*(GDI_PropertyType*)((*node)->value))->dictionary_flag;
+}
+
+
+uint64_t GDA_StorePropertyList( char* buf, GDI_VertexHolder vertex ) {
+  GDI_Database graph_db = vertex->transaction->db;
+  char* start = buf;
+  char* pos = vertex->property_data;
+  GDA_PropertyHandle phandle = *(GDA_PropertyHandle*) pos;
+
+  while( phandle != GDA_PROPERTY_LAST ) {
+    if( phandle != GDA_PROPERTY_EMPTY ) {
+      GDA_PropertyRecordSize record_size = *(GDA_PropertyRecordSize*) (pos+GDA_PROPERTY_HANDLE_SIZE);
+      char* value = pos+GDA_PROPERTY_METADATA_SIZE;
+      uint64_t code;
+      bool code_flag = (GDA_FindCodedPropertyRecord( pos, vertex ) >= 0);
+      if( code_flag ) {
+        /**
+          the value was never decoded
+         */
+        code = GDA_PropertyRecordCode( pos );
+      } else {
+        code_flag = GDA_IsDictionaryEncoded( phandle, record_size, graph_db ) && GDA_DictionaryEncode( &code, value, record_size, graph_db );
+      }
+      if( code_flag ) {
+        *(GDA_PropertyHandle*) buf = GDA_PROPERTY_DICT_CODE;
+        buf += GDA_PROPERTY_HANDLE_SIZE;
+        *(GDA_PropertyHandle*) buf = phandle;
+        buf += GDA_PROPERTY_HANDLE_SIZE;
+        buf += GDA_EncodeVarint( record_size, (uint8_t*) buf );
+        memcpy( buf, &code, sizeof(uint64_t) );
+        buf += sizeof(uint64_t);
+      } else {
+        *(GDA_PropertyHandle*) buf = phandle;
+        buf += GDA_PROPERTY_HANDLE_SIZE;
+        buf += GDA_EncodeVarint( record_size, (uint8_t*) buf );
+        memcpy( buf, value, record_size );
+        buf += record_size;
+      }
+    }
+    pos = GDA_NextPropertyRecord( pos );
+    phandle = *(GDA_PropertyHandle*) pos;
+  }
+  *(GDA_PropertyHandle*) buf = GDA_PROPERTY_LAST;
+
+  return buf + GDA_PROPERTY_HANDLE_SIZE - start;
+}
+
+
+void GDA_LoadPropertyList( char* data, uint64_t stored_size, uint64_t unused_space, GDI_VertexHolder vertex ) {
+  vertex->property_directory = NULL;
+  vertex->property_codes = NULL;
+
+  if( !(stored_size & GDA_PROPERTY_STORED_VARINT) ) {
+    /**
+      the data is already in the in-memory format, make sure that it is
+      converted, when the vertex is written back
+     */
+    vertex->property_data = data;
+    vertex->property_size = stored_size;
+    vertex->unused_space = unused_space;
+    vertex->property_write_flag = true;
+    return;
+  }
+
+  /**
+    first determine the size of the records in memory
+   */
+  uint64_t used_size = GDA_PROPERTY_METADATA_SIZE /* last record */;
+  const char* pos = data;
+  GDA_PropertyHandle phandle = *(GDA_PropertyHandle*) pos;
+  while( phandle != GDA_PROPERTY_LAST ) {
+    uint64_t record_size;
+    bool code_flag = (phandle == GDA_PROPERTY_DICT_CODE);
+    if( code_flag ) {
+      pos += GDA_PROPERTY_HANDLE_SIZE;
+    }
+    pos += GDA_PROPERTY_HANDLE_SIZE;
+    pos += GDA_DecodeVarint( &record_size, (const uint8_t*) pos );
+    pos += code_flag ? sizeof(uint64_t) : record_size;
+    used_size += GDA_PROPERTY_METADATA_SIZE + record_size;
+    phandle = *(GDA_PropertyHandle*) pos;
+  }
+  assert( (uint64_t) (pos + GDA_PROPERTY_HANDLE_SIZE - data) == (stored_size & ~GDA_PROPERTY_STORED_VARINT) );
+
+  /**
+    same growth as for a list, that was built in memory
+   */
+  vertex->property_size = 32;
+  while( vertex->property_size < used_size ) {
+    vertex->property_size = vertex->property_size << 1;
+  }
+  vertex->property_data = malloc( vertex->property_size );
+  assert( vertex->property_data != NULL );
+  vertex->unused_space = vertex->property_size - used_size;
+
+  char* target = vertex->property_data;
+  pos = data;
+  phandle = *(GDA_PropertyHandle*) pos;
+  while( phandle != GDA_PROPERTY_LAST ) {
+    uint64_t record_size;
+    bool code_flag = (phandle == GDA_PROPERTY_DICT_CODE);
+    if( code_flag ) {
+      pos += GDA_PROPERTY_HANDLE_SIZE;
+      phandle = *(GDA_PropertyHandle*) pos;
+    }
+    pos += GDA_PROPERTY_HANDLE_SIZE;
+    pos += GDA_DecodeVarint( &record_size, (const uint8_t*) pos );
+    *(GDA_PropertyHandle*) target = phandle;
+    *(GDA_PropertyRecordSize*) (target+GDA_PROPERTY_HANDLE_SIZE) = record_size;
+    if( code_flag ) {
+      /**
+        keep the code, the value is decoded on its first read
+       */
+      assert( record_size > sizeof(uint64_t) );
+      memcpy( target+GDA_PROPERTY_METADATA_SIZE, pos, sizeof(uint64_t) );
+      pos += sizeof(uint64_t);
+      if( vertex->property_codes == NULL ) {
+        GDA_vector_create( &(vertex->property_codes), sizeof(uint64_t), 4 /* initial capacity */ );
+      }
+      uint64_t offset = target - vertex->property_data;
+      GDA_vector_push_back( vertex->property_codes, &offset );
+    } else {
+      memcpy( target+GDA_PROPERTY_METADATA_SIZE, pos, record_size );
+      pos += record_size;
+    }
+    target += GDA_PROPERTY_METADATA_SIZE + record_size;
+    phandle = *(GDA_PropertyHandle*) pos;
+  }
+  *(GDA_PropertyHandle*) target = GDA_PROPERTY_LAST;
+
+  free( data );
+}
+
+
+/**
+  assumes that label is not GDI_LABEL_NONE and GDI_LABEL_NULL
+
+  found_flag is returned, in case the caller wants to keep skip updating indexes and indicates
+  whether the label was already present on the vertex:
+  true  = label was already present
+  false = label was added by this function call
+
+  updates the unused_space counter
+ */
+void GDA_LinearScanningInsertLabel( GDI_Label label, GDI_VertexHolder vertex, bool* found_flag ) {
+  if( GDA_PropertyDirectoryHasLabel( label->int_handle, vertex ) ) {
+    *found_flag = true;
+    return;
   }
 
   /**
-    update the unused space counter
+    didn't find the label, so we insert it now
    */
-  assert( vertex->unused_space >= (label_entry_size + GDA_PROPERTY_METADATA_SIZE) );
-  vertex->unused_space -= label_entry_size + GDA_PROPERTY_METADATA_SIZE;
+  *found_flag = false;
+  GDA_PropertyDirectoryCountLabel( vertex->property_directory, label->int_handle, true );
+
+  char* pos = GDA_InsertPropertyRecord( GDA_PROPERTY_LABEL, sizeof(uint32_t), vertex );
+  *(uint32_t*) (pos+GDA_PROPERTY_METADATA_SIZE) = label->int_handle;
+
+  GDA_PropertySchema* schema = GDA_LabelPropertySchema( label->int_handle, vertex->transaction->db );
+  if( (schema != NULL) && (vertex->property_directory->schema == NULL) ) {
+    GDA_CreatePropertySlots( schema, label->int_handle, vertex );
+  }
 }
 
 
@@ -209,6 +824,11 @@ void GDA_LinearScanningInsertLabel( GDI_Label label, GDI_VertexHolder vertex, bo
   updates the unused_space counter
  */
 void GDA_LinearScanningRemoveLabel( GDI_Label label, GDI_VertexHolder vertex, bool* found_flag ) {
+  if( !GDA_PropertyDirectoryHasLabel( label->int_handle, vertex ) ) {
+    *found_flag = false;
+    return;
+  }
+
   char* pos = vertex->property_data;
   char* previous_record = NULL;
   GDA_PropertyHandle phandle = *(GDA_PropertyHandle*) pos;
@@ -220,6 +840,7 @@ void GDA_LinearScanningRemoveLabel( GDI_Label label, GDI_VertexHolder vertex, bo
         /**
           found the label that we are looking for
          */
+        GDA_PropertyDirectoryCountLabel( vertex->property_directory, label->int_handle, false );
         *(GDA_PropertyHandle*) pos = GDA_PROPERTY_EMPTY;
         /**
           introduced a new empty record, so update the appropriate counter
@@ -271,19 +892,7 @@ void GDA_LinearScanningRemoveLabel( GDI_Label label, GDI_VertexHolder vertex, bo
   assumes that label is not GDI_LABEL_NONE and GDI_LABEL_NULL
  */
 void GDA_LinearScanningNumLabels( GDI_VertexHolder vertex, size_t* resultcount ) {
-  size_t num_labels = 0;
-  char* pos = vertex->property_data;
-  GDA_PropertyHandle phandle = *(GDA_PropertyHandle*) pos;
-
-  while( phandle != GDA_PROPERTY_LAST ) {
-    if( phandle == GDA_PROPERTY_LABEL ) {
-      num_labels++;
-    }
-    pos = GDA_NextPropertyRecord( pos );
-    phandle = *(GDA_PropertyHandle*) pos;
-  }
-
-  *resultcount = num_labels;
+  *resultcount = GDA_GetPropertyDirectory( vertex )->num_labels;
 }
 
 
@@ -295,12 +904,17 @@ void GDA_LinearScanningNumLabels( GDI_VertexHolder vertex, size_t* resultcount )
   return code is either GDI_SUCCESS or GDI_ERROR_TRUNCATE
  */
 int GDA_LinearScanningFindAllLabels( GDI_VertexHolder vertex, GDI_Label* labels, size_t count, size_t* resultcount ) {
+  GDA_PropertyDirectory* dir = GDA_GetPropertyDirectory( vertex );
   size_t num_labels = 0;
-  char* pos = vertex->property_data;
-  GDA_PropertyHandle phandle = *(GDA_PropertyHandle*) pos;
 
-  while( phandle != GDA_PROPERTY_LAST ) {
-    if( phandle == GDA_PROPERTY_LABEL ) {
+  /**
+    labels are returned in the order of their integer handles
+   */
+  for( uint32_t i=0 ; i<dir->num_label_words ; i++ ) {
+    uint64_t word = dir->label_bitmap[i];
+    while( word != 0 ) {
+      uint32_t label_int_handle = (i << 6) + __builtin_ctzll( word );
+      word &= word - 1;
       if( num_labels == count ) {
         /**
           found more labels than can be returned
@@ -312,12 +926,10 @@ int GDA_LinearScanningFindAllLabels( GDI_VertexHolder vertex, GDI_Label* labels,
         simplification of GDA_IntHandleToLabel
         since we don't need the additional input validation
        */
-      GDA_Node** node = GDA_hashmap_get( vertex->transaction->db->labels->handle_to_address, pos+GDA_PROPERTY_METADATA_SIZE );
+      GDA_Node** node = GDA_hashmap_get( vertex->transaction->db->labels->handle_to_address, &label_int_handle );
       assert( node != NULL );
       labels[num_labels++] = *(GDI_Label*)((*node)->value);
     }
-    pos = GDA_NextPropertyRecord( pos );
-    phandle = *(GDA_PropertyHandle*) pos;
   }
 
   *resultcount = num_labels;
@@ -325,6 +937,11 @@ int GDA_LinearScanningFindAllLabels( GDI_VertexHolder vertex, GDI_Label* labels,
 }
 
 
+bool GDA_LinearScanningHasLabel( uint32_t label_int_handle, GDI_VertexHolder vertex ) {
+  return GDA_PropertyDirectoryHasLabel( label_int_handle, vertex );
+}
+
+
 /**
   should only be used for GDI AddPropertyToVertex
   returns three possible values:
@@ -335,6 +952,8 @@ int GDA_LinearScanningFindAllLabels( GDI_VertexHolder vertex, GDI_Label* labels,
   updates the unused_space counter
  */
 int GDA_LinearScanningAddProperty( GDI_PropertyType ptype, const void* value, size_t count, GDI_VertexHolder vertex ) {
+  GDA_DecodePropertyRecords( ptype->int_handle, vertex );
+
   char* pos = vertex->property_data;
   GDA_PropertyHandle phandle = *(GDA_PropertyHandle*) pos;
   /**
@@ -353,6 +972,21 @@ int GDA_LinearScanningAddProperty( GDI_PropertyType ptype, const void* value, si
     assert( property_entry_size < 65536 );
    */
 
+  int32_t slot = GDA_PropertySlot( ptype, vertex );
+  if( slot >= 0 ) {
+    char* slot_value = GDA_PropertySlotValue( slot, vertex );
+    if( GDA_PropertySlotPresent( slot, vertex ) ) {
+      if( (property_entry_size == vertex->property_directory->schema->slot_sizes[slot]) && (memcmp( value, slot_value, property_entry_size ) == 0) ) {
+        return GDI_ERROR_PROPERTY_EXISTS;
+      }
+      return GDI_ERROR_PROPERTY_TYPE_EXISTS;
+    }
+    assert( property_entry_size == vertex->property_directory->schema->slot_sizes[slot] );
+    memcpy( slot_value, value, property_entry_size );
+    GDA_SetPropertySlotPresent( slot, true, vertex );
+    return GDI_SUCCESS;
+  }
+
   char* insert_pos = NULL;
 
   if( ptype->etype == GDI_SINGLE_ENTITY ) {
@@ -582,6 +1216,7 @@ int GDA_LinearScanningAddProperty( GDI_PropertyType ptype, const void* value, si
         empty record fits perfectly, so we don't have to update the size part of the meta data
        */
       *(GDA_PropertyHandle*) insert_pos = ptype->int_handle;
+      GDA_PropertyDirectoryAddRecord( ptype->int_handle, insert_pos, vertex );
       memcpy( insert_pos+GDA_PROPERTY_METADATA_SIZE, value, property_entry_size );
     } else {
       /**
@@ -591,6 +1226,7 @@ int GDA_LinearScanningAddProperty( GDI_PropertyType ptype, const void* value, si
         first insert the new property record
        */
       *(GDA_PropertyHandle*) insert_pos = ptype->int_handle;
+      GDA_PropertyDirectoryAddRecord( ptype->int_handle, insert_pos, vertex );
       *(GDA_PropertyRecordSize*) (insert_pos+GDA_PROPERTY_HANDLE_SIZE) = property_entry_size;
       memcpy( insert_pos+GDA_PROPERTY_METADATA_SIZE, value, property_entry_size );
       /**
@@ -622,6 +1258,7 @@ int GDA_LinearScanningAddProperty( GDI_PropertyType ptype, const void* value, si
       pos = vertex->property_data + temp_pos;
     }
     *(GDA_PropertyHandle*) pos = ptype->int_handle;
+    GDA_PropertyDirectoryAddRecord( ptype->int_handle, pos, vertex );
     *(GDA_PropertyRecordSize*) (pos+GDA_PROPERTY_HANDLE_SIZE) = property_entry_size;
     memcpy( pos+GDA_PROPERTY_METADATA_SIZE, value, property_entry_size );
     /**
@@ -648,39 +1285,7 @@ int GDA_LinearScanningAddProperty( GDI_PropertyType ptype, const void* value, si
   a single occurrence, as we are counting only property types.
  */
 void GDA_LinearScanningNumPropertyTypes( GDI_VertexHolder vertex, size_t* resultcount ) {
-
-  uint32_t ptype_max = vertex->transaction->db->ptypes->ptype_max;
-
-  bool ptypes[ptype_max];
-  for( uint32_t i=0 ; i<ptype_max; i++ ) {
-    ptypes[i] = false;
-  }
-
-  char* pos = vertex->property_data;
-  GDA_PropertyHandle phandle = *(GDA_PropertyHandle*) pos;
-
-  while( phandle != GDA_PROPERTY_LAST ) {
-    assert( phandle < ptype_max );
-    /**
-      ignores GDA_PROPERTY_EMPTY, GDA_PROPERTY_LAST and GDA_PROPERTY_LABEL
-      assumes that these values occupy the first three spots
-     */
-    if( phandle > GDA_PROPERTY_LABEL ) {
-      ptypes[phandle] = true;
-    }
-
-    pos = GDA_NextPropertyRecord( pos );
-    phandle = *(GDA_PropertyHandle*) pos;
-  }
-
-  uint32_t num_ptypes = 0;
-  for( uint32_t i=3 /* start with GDI_PROPERTY_TYPE_ID */ ; i<ptype_max; i++ ) {
-    if( ptypes[i] ) {
-      num_ptypes++;
-    }
-  }
-
-  *resultcount = num_ptypes;
+  *resultcount = GDA_GetPropertyDirectory( vertex )->num_ptypes;
 }
 
 
@@ -699,42 +1304,15 @@ int GDA_LinearScanningFindAllPropertyTypes( GDI_VertexHolder vertex, GDI_Propert
    */
   assert( count > 0 );
 
-  /**
-    first part uses the same algorithm as GDA_LinearScanningNumPropertyTypes
-   */
-  uint32_t ptype_max = graph_db->ptypes->ptype_max;
-
-  bool present_ptypes[ptype_max];
-  for( uint32_t i=0 ; i<ptype_max; i++ ) {
-    present_ptypes[i] = false;
-  }
-
-  char* pos = vertex->property_data;
-  GDA_PropertyHandle phandle = *(GDA_PropertyHandle*) pos;
-
-  while( phandle != GDA_PROPERTY_LAST ) {
-    assert( phandle < ptype_max );
-    /**
-      ignores GDA_PROPERTY_EMPTY, GDA_PROPERTY_LAST and GDA_PROPERTY_LABEL
-      assumes that these values occupy the first three spots
-     */
-    if( phandle > GDA_PROPERTY_LABEL ) {
-      present_ptypes[phandle] = true;
-    }
-
-    pos = GDA_NextPropertyRecord( pos );
-    phandle = *(GDA_PropertyHandle*) pos;
-  }
+  GDA_PropertyDirectory* dir = GDA_GetPropertyDirectory( vertex );
 
+  uint32_t num_ptypes = 0;
   /**
-    second part: fill the array
+    ignores GDA_PROPERTY_EMPTY, GDA_PROPERTY_LAST and GDA_PROPERTY_LABEL
+    assumes that these values occupy the first three spots
    */
-  uint32_t num_ptypes = 0;
-  if( present_ptypes[3 /* = GDI_PROPERTY_TYPE_ID */] ) {
-    ptypes[num_ptypes++] = GDI_PROPERTY_TYPE_ID;
-  }
-  for( uint32_t i=4 /* first user-defined property type */ ; i<ptype_max ; i++ ) {
-    if( present_ptypes[i] ) {
+  for( uint32_t i=3 /* = GDI_PROPERTY_TYPE_ID */ ; i<dir->num_entries ; i++ ) {
+    if( (dir->entries[i].num_records > 0) && (i != GDA_PROPERTY_SLOTS) ) {
       if( num_ptypes == count ) {
         /**
           found more property types than can be returned
@@ -742,13 +1320,17 @@ int GDA_LinearScanningFindAllPropertyTypes( GDI_VertexHolder vertex, GDI_Propert
         *resultcount = num_ptypes;
         return GDI_ERROR_TRUNCATE;
       }
-      /**
-        simplification of GDA_IntHandleToPropertyType
-        since we don't need the additional input validation
-       */
-      GDA_Node** node = GDA_hashmap_get( graph_db->ptypes->handle_to_address, &i );
-      assert( node != NULL );
-      ptypes[num_ptypes++] = *(GDI_PropertyType*)((*node)->value);
+      if( i == 3 ) {
+        ptypes[num_ptypes++] = GDI_PROPERTY_TYPE_ID;
+      } else {
+        /**
+          simplification of GDA_IntHandleToPropertyType
+          since we don't need the additional input validation
+         */
+        GDA_Node** node = GDA_hashmap_get( graph_db->ptypes->handle_to_address, &i );
+        assert( node != NULL );
+        ptypes[num_ptypes++] = *(GDI_PropertyType*)((*node)->value);
+      }
     }
   }
 
@@ -771,37 +1353,36 @@ void GDA_LinearScanningNumProperties( GDI_VertexHolder vertex, GDI_PropertyType
   size_t dsize; /* size of one element in Bytes */
   GDI_GetSizeOfDatatype( &dsize, ptype->dtype );
 
-  size_t num_properties = 0;
+  int32_t slot = GDA_PropertySlot( ptype, vertex );
+  if( slot >= 0 ) {
+    if( GDA_PropertySlotPresent( slot, vertex ) ) {
+      *resultcount = 1;
+      *element_resultcount = vertex->property_directory->schema->slot_sizes[slot] / dsize;
+    } else {
+      *resultcount = 0;
+      *element_resultcount = 0;
+    }
+    return;
+  }
+
   size_t num_bytes = 0;
 
-  char* pos = vertex->property_data;
-  GDA_PropertyHandle phandle = *(GDA_PropertyHandle*) pos;
+  /**
+    start at the first record of the property type and stop after the
+    last one
+   */
+  uint32_t num_records;
+  char* pos = GDA_PropertyDirectoryFind( int_handle, &num_records, vertex );
 
-  if( ptype->etype == GDI_SINGLE_ENTITY ) {
-    while( phandle != GDA_PROPERTY_LAST ) {
-      if( phandle == int_handle ) {
-        *resultcount = 1;
-        *element_resultcount = (*(GDA_PropertyRecordSize*) (pos+GDA_PROPERTY_HANDLE_SIZE)) /* size in Bytes */ / dsize; /* determine number of elements */
-        return;
-      }
-      pos = GDA_NextPropertyRecord( pos );
-      phandle = *(GDA_PropertyHandle*) pos;
-    }
-  } else {
-    /**
-      multi entity type, so we also have to check the whole list
-     */
-    while( phandle != GDA_PROPERTY_LAST ) {
-      if( phandle == int_handle ) {
-        num_properties++;
-        num_bytes += (*(GDA_PropertyRecordSize*) (pos+GDA_PROPERTY_HANDLE_SIZE)) /* size in Bytes */;
-      }
+  for( uint32_t i=0 ; i<num_records ; i++ ) {
+    while( *(GDA_PropertyHandle*) pos != int_handle ) {
       pos = GDA_NextPropertyRecord( pos );
-      phandle = *(GDA_PropertyHandle*) pos;
     }
+    num_bytes += (*(GDA_PropertyRecordSize*) (pos+GDA_PROPERTY_HANDLE_SIZE)) /* size in Bytes */;
+    pos = GDA_NextPropertyRecord( pos );
   }
 
-  *resultcount = num_properties;
+  *resultcount = num_records;
   *element_resultcount = num_bytes / dsize; /* determine number of elements */
 }
 
@@ -836,79 +1417,87 @@ int GDA_LinearScanningFindAllProperties( void* buf, size_t buf_count, size_t* bu
 
   size_t val_size;
 
-  char* pos = vertex->property_data;
-  GDA_PropertyHandle phandle = *(GDA_PropertyHandle*)pos;
+  uint32_t num_records;
+  char* pos = GDA_PropertyDirectoryFind( int_handle, &num_records, vertex );
 
   if( ptype->etype == GDI_SINGLE_ENTITY ) {
-    while( phandle != GDA_PROPERTY_LAST ) {
-      if( phandle == int_handle ) {
+    if( num_records > 0 ) {
+      char* value;
+      int32_t slot = GDA_PropertySlot( ptype, vertex );
+      if( slot >= 0 ) {
+        /**
+          pos already points to the value in the slot record
+         */
+        val_size = vertex->property_directory->schema->slot_sizes[slot] / dsize;
+        value = pos;
+      } else {
+        GDA_DecodePropertyRecord( pos, vertex );
         val_size = ( *(GDA_PropertyRecordSize*)( pos + GDA_PROPERTY_HANDLE_SIZE ) ) / dsize;
+        value = pos + GDA_PROPERTY_METADATA_SIZE;
+      }
 
-        if( val_size <= buf_count ) {
-          memcpy( buf, pos + GDA_PROPERTY_METADATA_SIZE, val_size * dsize );
-          *buf_resultcount = val_size;
-        } else {
-          buf_overflow = true;
-        }
+      if( val_size <= buf_count ) {
+        memcpy( buf, value, val_size * dsize );
+        *buf_resultcount = val_size;
+      } else {
+        buf_overflow = true;
+      }
 
-        array_of_offsets[0] = 0;
+      array_of_offsets[0] = 0;
+      ++*offset_resultcount;
+      if( offset_count >= 2 ) {
+        array_of_offsets[1] = val_size;
         ++*offset_resultcount;
-        if( offset_count >= 2 ) {
-          array_of_offsets[1] = val_size;
-          ++*offset_resultcount;
-        } else {
-          offset_overflow = true;
-        }
-        break;
+      } else {
+        offset_overflow = true;
       }
-
-      pos = GDA_NextPropertyRecord( pos );
-      phandle = *(GDA_PropertyHandle*)pos;
     }
   } else {
     /**
-      multi entity type, so we also have to check the whole list
+      multi entity type, so we have to visit all records of the property
+      type, which start at the first one
      */
-    while( phandle != GDA_PROPERTY_LAST ) {
-      if( phandle == int_handle ) {
-        val_size = ( *(GDA_PropertyRecordSize*)( pos + GDA_PROPERTY_HANDLE_SIZE ) ) /* size in Bytes */
-                   / dsize;
-
-        if( !buf_overflow ) {
-          if( *buf_resultcount + val_size <= buf_count ) {
-            memcpy( (char*)buf + ( *buf_resultcount ) * dsize, pos + GDA_PROPERTY_METADATA_SIZE, val_size * dsize );
-            *buf_resultcount += val_size;
-          } else {
-            buf_overflow = true;
-          }
-        }
-        if( !offset_overflow ) {
-          /**
-            Write the first offset (only once per function call).
-            It is always safe, as offset_count must be >= 1 (otherwise size trick would be used and this function
-            wouldn't be called at all).
-           */
-          if( *offset_resultcount == 0 ) {
-            array_of_offsets[0] = 0;
-            ++*offset_resultcount;
-          }
-          if( *offset_resultcount + 1 <= offset_count ) {
-            array_of_offsets[*offset_resultcount] = array_of_offsets[*offset_resultcount - 1] + val_size;
-            ++*offset_resultcount;
-          } else {
-            offset_overflow = true;
-          }
+    for( uint32_t i=0 ; i<num_records ; i++ ) {
+      while( *(GDA_PropertyHandle*)pos != int_handle ) {
+        pos = GDA_NextPropertyRecord( pos );
+      }
+      val_size = ( *(GDA_PropertyRecordSize*)( pos + GDA_PROPERTY_HANDLE_SIZE ) ) /* size in Bytes */
+                 / dsize;
+
+      if( !buf_overflow ) {
+        if( *buf_resultcount + val_size <= buf_count ) {
+          GDA_DecodePropertyRecord( pos, vertex );
+          memcpy( (char*)buf + ( *buf_resultcount ) * dsize, pos + GDA_PROPERTY_METADATA_SIZE, val_size * dsize );
+          *buf_resultcount += val_size;
+        } else {
+          buf_overflow = true;
         }
+      }
+      if( !offset_overflow ) {
         /**
-          If there is an overflow on both buffers we can stop immediately
+          Write the first offset (only once per function call).
+          It is always safe, as offset_count must be >= 1 (otherwise size trick would be used and this function
+          wouldn't be called at all).
          */
-        if( buf_overflow && offset_overflow ) {
-          break;
+        if( *offset_resultcount == 0 ) {
+          array_of_offsets[0] = 0;
+          ++*offset_resultcount;
+        }
+        if( *offset_resultcount + 1 <= offset_count ) {
+          array_of_offsets[*offset_resultcount] = array_of_offsets[*offset_resultcount - 1] + val_size;
+          ++*offset_resultcount;
+        } else {
+          offset_overflow = true;
         }
       }
+      /**
+        If there is an overflow on both buffers we can stop immediately
+       */
+      if( buf_overflow && offset_overflow ) {
+        break;
+      }
 
       pos = GDA_NextPropertyRecord( pos );
-      phandle = *(GDA_PropertyHandle*)pos;
     }
   }
 
@@ -919,6 +1508,103 @@ int GDA_LinearScanningFindAllProperties( void* buf, size_t buf_count, size_t* bu
 }
 
 
+/**
+  assumes that ptype is not GDI_PROPERTY_TYPE_NULL, GDI_PROPERTY_TYPE_DEGREE, GDI_PROPERTY_TYPE_INDEGREE and GDI_PROPERTY_TYPE_OUTDEGREE
+
+  the cursor becomes invalid, if the properties of the vertex are changed
+ */
+void GDA_LinearScanningInitPropertyCursor( GDA_PropertyCursor* cursor, GDI_PropertyType ptype, GDI_VertexHolder vertex ) {
+  assert( ptype->int_handle < 256 );
+  cursor->vertex = vertex;
+  cursor->int_handle = ptype->int_handle;
+  cursor->pos = GDA_PropertyDirectoryFind( cursor->int_handle, &(cursor->num_records), vertex );
+
+  int32_t slot = GDA_PropertySlot( ptype, vertex );
+  if( slot >= 0 ) {
+    /**
+      pos already points to the value in the slot record
+     */
+    cursor->slot_size = vertex->property_directory->schema->slot_sizes[slot];
+  } else {
+    cursor->slot_size = -1;
+  }
+}
+
+
+bool GDA_LinearScanningNextPropertyCode( const char** value, uint64_t* size, uint64_t* code, GDA_PropertyCursor* cursor ) {
+  if( cursor->num_records == 0 ) {
+    return false;
+  }
+  cursor->num_records--;
+
+  if( cursor->slot_size >= 0 ) {
+    *value = cursor->pos;
+    *size = cursor->slot_size;
+    return true;
+  }
+
+  char* pos = cursor->pos;
+  while( *(GDA_PropertyHandle*) pos != cursor->int_handle ) {
+    pos = GDA_NextPropertyRecord( pos );
+  }
+  *size = *(GDA_PropertyRecordSize*) (pos+GDA_PROPERTY_HANDLE_SIZE);
+  if( GDA_FindCodedPropertyRecord( pos, cursor->vertex ) >= 0 ) {
+    *value = NULL;
+    *code = GDA_PropertyRecordCode( pos );
+  } else {
+    *value = pos + GDA_PROPERTY_METADATA_SIZE;
+  }
+  cursor->pos = GDA_NextPropertyRecord( pos );
+  return true;
+}
+
+
+bool GDA_LinearScanningNextProperty( const char** value, uint64_t* size, GDA_PropertyCursor* cursor ) {
+  char* pos = cursor->pos;
+  uint64_t code;
+  if( !GDA_LinearScanningNextPropertyCode( value, size, &code, cursor ) ) {
+    return false;
+  }
+
+  if( *value == NULL ) {
+    while( *(GDA_PropertyHandle*) pos != cursor->int_handle ) {
+      pos = GDA_NextPropertyRecord( pos );
+    }
+    GDA_DecodePropertyRecord( pos, cursor->vertex );
+    *value = pos + GDA_PROPERTY_METADATA_SIZE;
+  }
+  return true;
+}
+
+
+bool GDA_LinearScanningHasPropertyValue( const void* value, uint64_t size, uint64_t code, GDI_PropertyType ptype, GDI_VertexHolder vertex ) {
+  GDA_PropertyCursor cursor;
+  GDA_LinearScanningInitPropertyCursor( &cursor, ptype, vertex );
+
+  const char* record_value;
+  uint64_t record_size, record_code = 0;
+  while( GDA_LinearScanningNextPropertyCode( &record_value, &record_size, &record_code, &cursor ) ) {
+    if( record_size != size ) {
+      continue;
+    }
+    if( record_value == NULL ) {
+      /**
+        a code stands for the value it was computed from, so only a
+        matching code has to be confirmed with the value
+       */
+      if( record_code != code ) {
+        continue;
+      }
+      record_value = GDA_DictionaryDecode( record_code, record_size, vertex->transaction->db );
+    }
+    if( memcmp( record_value, value, size ) == 0 ) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
 /**
   assumes that ptype is not GDI_PROPERTY_TYPE_NULL, GDI_PROPERTY_TYPE_DEGREE, GDI_PROPERTY_TYPE_INDEGREE and GDI_PROPERTY_TYPE_OUTDEGREE
 
@@ -937,6 +1623,22 @@ void GDA_LinearScanningRemoveProperties( GDI_PropertyType ptype, GDI_VertexHolde
    */
   assert( ptype->int_handle < 256 );
 
+  GDA_DecodePropertyRecords( ptype->int_handle, vertex );
+
+  uint32_t num_records;
+  GDA_PropertyDirectoryFind( ptype->int_handle, &num_records, vertex );
+  if( num_records == 0 ) {
+    *found_flag = false;
+    return;
+  }
+
+  int32_t slot = GDA_PropertySlot( ptype, vertex );
+  if( slot >= 0 ) {
+    GDA_SetPropertySlotPresent( slot, false, vertex );
+    *found_flag = true;
+    return;
+  }
+
   char* pos = vertex->property_data;
   GDA_PropertyHandle phandle = *(GDA_PropertyHandle*) pos;
 
@@ -948,6 +1650,7 @@ void GDA_LinearScanningRemoveProperties( GDI_PropertyType ptype, GDI_VertexHolde
         /**
           found a property of the type that we are looking for
          */
+        GDA_PropertyDirectoryRemoveRecord( pos, vertex );
         *(GDA_PropertyHandle*) pos = GDA_PROPERTY_EMPTY;
         /**
           introduced a new empty record, so update the appropriate counter
@@ -1002,6 +1705,7 @@ void GDA_LinearScanningRemoveProperties( GDI_PropertyType ptype, GDI_VertexHolde
         /**
           found a property of the type that we are looking for
          */
+        GDA_PropertyDirectoryRemoveRecord( pos, vertex );
         *(GDA_PropertyHandle*) pos = GDA_PROPERTY_EMPTY;
         /**
           introduced a new empty record, so update the appropriate counter
@@ -1061,8 +1765,14 @@ void GDA_LinearScanningRemoveProperties( GDI_PropertyType ptype, GDI_VertexHolde
   updates the unused_space counter
  */
 void GDA_LinearScanningRemoveSpecificProperty( GDI_PropertyType ptype, const void* value, size_t count, GDI_VertexHolder vertex, bool* found_flag ) {
-  char* pos = vertex->property_data;
-  GDA_PropertyHandle phandle = *(GDA_PropertyHandle*) pos;
+  GDA_DecodePropertyRecords( ptype->int_handle, vertex );
+
+  uint32_t num_records;
+  char* pos = GDA_PropertyDirectoryFind( ptype->int_handle, &num_records, vertex );
+  if( num_records == 0 ) {
+    *found_flag = false;
+    return;
+  }
 
   /**
     determine the buffer size for the property value
@@ -1071,6 +1781,21 @@ void GDA_LinearScanningRemoveSpecificProperty( GDI_PropertyType ptype, const voi
   GDI_GetSizeOfDatatype( &dsize, ptype->dtype );
   size_t property_entry_size = count * dsize;
 
+  int32_t slot = GDA_PropertySlot( ptype, vertex );
+  if( slot >= 0 ) {
+    /**
+      pos already points to the value in the slot record
+     */
+    *found_flag = (property_entry_size == vertex->property_directory->schema->slot_sizes[slot]) && (memcmp( value, pos, property_entry_size ) == 0);
+    if( *found_flag ) {
+      GDA_SetPropertySlotPresent( slot, false, vertex );
+    }
+    return;
+  }
+
+  pos = vertex->property_data;
+  GDA_PropertyHandle phandle = *(GDA_PropertyHandle*) pos;
+
   /**
     input checking
    */
@@ -1090,6 +1815,7 @@ void GDA_LinearScanningRemoveSpecificProperty( GDI_PropertyType ptype, const voi
             /**
               found the property
              */
+            GDA_PropertyDirectoryRemoveRecord( pos, vertex );
             *(GDA_PropertyHandle*) pos = GDA_PROPERTY_EMPTY;
             /**
               introduced a new empty record, so update the appropriate counter
@@ -1146,6 +1872,7 @@ void GDA_LinearScanningRemoveSpecificProperty( GDI_PropertyType ptype, const voi
               /**
                 found the property
                */
+              GDA_PropertyDirectoryRemoveRecord( pos, vertex );
               *(GDA_PropertyHandle*) pos = GDA_PROPERTY_EMPTY;
               /**
                 introduced a new empty record, so update the appropriate counter
@@ -1200,6 +1927,7 @@ void GDA_LinearScanningRemoveSpecificProperty( GDI_PropertyType ptype, const voi
             /**
               found the property
              */
+            GDA_PropertyDirectoryRemoveRecord( pos, vertex );
             *(GDA_PropertyHandle*) pos = GDA_PROPERTY_EMPTY;
             /**
               introduced a new empty record, so update the appropriate counter
@@ -1254,6 +1982,7 @@ void GDA_LinearScanningRemoveSpecificProperty( GDI_PropertyType ptype, const voi
               /**
                 found the property
                */
+              GDA_PropertyDirectoryRemoveRecord( pos, vertex );
               *(GDA_PropertyHandle*) pos = GDA_PROPERTY_EMPTY;
               /**
                 introduced a new empty record, so update the appropriate counter
@@ -1316,6 +2045,8 @@ void GDA_LinearScanningRemoveSpecificProperty( GDI_PropertyType ptype, const voi
   updates the unused_space counter
  */
 int GDA_LinearScanningUpdateSingleEntityProperty( GDI_PropertyType ptype, const void* value, size_t count, GDI_VertexHolder vertex ) {
+  GDA_DecodePropertyRecords( ptype->int_handle, vertex );
+
   char* pos = vertex->property_data;
   GDA_PropertyHandle phandle = *(GDA_PropertyHandle*) pos;
 
@@ -1337,6 +2068,16 @@ int GDA_LinearScanningUpdateSingleEntityProperty( GDI_PropertyType ptype, const
     assert( property_entry_size < 65536 );
    */
 
+  int32_t slot = GDA_PropertySlot( ptype, vertex );
+  if( slot >= 0 ) {
+    if( !GDA_PropertySlotPresent( slot, vertex ) ) {
+      return GDI_ERROR_NO_PROPERTY;
+    }
+    assert( property_entry_size == vertex->property_directory->schema->slot_sizes[slot] );
+    memcpy( GDA_PropertySlotValue( slot, vertex ), value, property_entry_size );
+    return GDI_SUCCESS;
+  }
+
   char* previous_record = NULL;
   char* insert_pos = NULL; /* remove compiler warning */
 
@@ -1352,6 +2093,7 @@ int GDA_LinearScanningUpdateSingleEntityProperty( GDI_PropertyType ptype, const
           first we remove that property and do merging, if necessary
          */
         found_flag = true;
+        GDA_PropertyDirectoryRemoveRecord( pos, vertex );
         *(GDA_PropertyHandle*) pos = GDA_PROPERTY_EMPTY;
         /**
           introduced a new empty record, so update the appropriate counter
@@ -1418,6 +2160,7 @@ int GDA_LinearScanningUpdateSingleEntityProperty( GDI_PropertyType ptype, const
                   we remove that property and do merging, if necessary
                  */
                 found_flag = true;
+                GDA_PropertyDirectoryRemoveRecord( pos, vertex );
                 *(GDA_PropertyHandle*) pos = GDA_PROPERTY_EMPTY;
                 /**
                   introduced a new empty record, so update the appropriate counter
@@ -1489,6 +2232,7 @@ int GDA_LinearScanningUpdateSingleEntityProperty( GDI_PropertyType ptype, const
         can always be sure, that we have enough space, because we just removed a property of the same size
        */
       *(GDA_PropertyHandle*) insert_pos = ptype->int_handle;
+      GDA_PropertyDirectoryAddRecord( ptype->int_handle, insert_pos, vertex );
       *(GDA_PropertyRecordSize*) (insert_pos+GDA_PROPERTY_HANDLE_SIZE) = property_entry_size;
       memcpy( insert_pos+GDA_PROPERTY_METADATA_SIZE, value, property_entry_size );
       /**
@@ -1504,6 +2248,7 @@ int GDA_LinearScanningUpdateSingleEntityProperty( GDI_PropertyType ptype, const
           empty record fits perfectly, so we don't have to update the size part of the meta data
          */
         *(GDA_PropertyHandle*) insert_pos = ptype->int_handle;
+        GDA_PropertyDirectoryAddRecord( ptype->int_handle, insert_pos, vertex );
         memcpy( insert_pos+GDA_PROPERTY_METADATA_SIZE, value, property_entry_size );
       } else {
         /**
@@ -1513,6 +2258,7 @@ int GDA_LinearScanningUpdateSingleEntityProperty( GDI_PropertyType ptype, const
           first insert the new property record
          */
         *(GDA_PropertyHandle*) insert_pos = ptype->int_handle;
+        GDA_PropertyDirectoryAddRecord( ptype->int_handle, insert_pos, vertex );
         *(GDA_PropertyRecordSize*) (insert_pos+GDA_PROPERTY_HANDLE_SIZE) = property_entry_size;
         memcpy( insert_pos+GDA_PROPERTY_METADATA_SIZE, value, property_entry_size );
         /**
@@ -1543,6 +2289,7 @@ int GDA_LinearScanningUpdateSingleEntityProperty( GDI_PropertyType ptype, const
           first we remove that property and do merging, if necessary
          */
         found_flag = true;
+        GDA_PropertyDirectoryRemoveRecord( pos, vertex );
         *(GDA_PropertyHandle*) pos = GDA_PROPERTY_EMPTY;
         /**
           introduced a new empty record, so update the appropriate counter
@@ -1642,6 +2389,7 @@ int GDA_LinearScanningUpdateSingleEntityProperty( GDI_PropertyType ptype, const
                   we remove that property and do merging, if necessary
                  */
                 found_flag = true;
+                GDA_PropertyDirectoryRemoveRecord( pos, vertex );
                 *(GDA_PropertyHandle*) pos = GDA_PROPERTY_EMPTY;
                 /**
                   introduced a new empty record, so update the appropriate counter
@@ -1717,6 +2465,7 @@ int GDA_LinearScanningUpdateSingleEntityProperty( GDI_PropertyType ptype, const
           empty record fits perfectly, so we don't have to update the size part of the meta data
          */
         *(GDA_PropertyHandle*) insert_pos = ptype->int_handle;
+        GDA_PropertyDirectoryAddRecord( ptype->int_handle, insert_pos, vertex );
         memcpy( insert_pos+GDA_PROPERTY_METADATA_SIZE, value, property_entry_size );
       } else {
         /**
@@ -1726,6 +2475,7 @@ int GDA_LinearScanningUpdateSingleEntityProperty( GDI_PropertyType ptype, const
           first insert the new property record
          */
         *(GDA_PropertyHandle*) insert_pos = ptype->int_handle;
+        GDA_PropertyDirectoryAddRecord( ptype->int_handle, insert_pos, vertex );
         *(GDA_PropertyRecordSize*) (insert_pos+GDA_PROPERTY_HANDLE_SIZE) = property_entry_size;
         memcpy( insert_pos+GDA_PROPERTY_METADATA_SIZE, value, property_entry_size );
         /**
@@ -1757,6 +2507,7 @@ int GDA_LinearScanningUpdateSingleEntityProperty( GDI_PropertyType ptype, const
         pos = vertex->property_data + temp_pos;
       }
       *(GDA_PropertyHandle*) pos = ptype->int_handle;
+      GDA_PropertyDirectoryAddRecord( ptype->int_handle, pos, vertex );
       *(GDA_PropertyRecordSize*) (pos+GDA_PROPERTY_HANDLE_SIZE) = property_entry_size;
       memcpy( pos+GDA_PROPERTY_METADATA_SIZE, value, property_entry_size );
       /**
@@ -1784,6 +2535,8 @@ int GDA_LinearScanningUpdateSingleEntityProperty( GDI_PropertyType ptype, const
   updates the unused_space counter
  */
 int GDA_LinearScanningUpdateSpecificProperty( GDI_PropertyType ptype, const void* old_value, size_t old_count, const void* new_value, size_t new_count, GDI_VertexHolder vertex ) {
+  GDA_DecodePropertyRecords( ptype->int_handle, vertex );
+
   char* pos = vertex->property_data;
   GDA_PropertyHandle phandle = *(GDA_PropertyHandle*) pos;
 
@@ -1805,6 +2558,18 @@ int GDA_LinearScanningUpdateSpecificProperty( GDI_PropertyType ptype, const void
     assert( new_property_entry_size < 65536 );
    */
 
+  int32_t slot = GDA_PropertySlot( ptype, vertex );
+  if( slot >= 0 ) {
+    char* slot_value = GDA_PropertySlotValue( slot, vertex );
+    if( !GDA_PropertySlotPresent( slot, vertex ) || (old_property_entry_size != vertex->property_directory->schema->slot_sizes[slot])
+        || (memcmp( old_value, slot_value, old_property_entry_size ) != 0) ) {
+      return GDI_ERROR_NO_PROPERTY;
+    }
+    assert( new_property_entry_size == vertex->property_directory->schema->slot_sizes[slot] );
+    memcpy( slot_value, new_value, new_property_entry_size );
+    return GDI_SUCCESS;
+  }
+
   char* previous_record = NULL;
   char* insert_pos = NULL;
 
@@ -1825,6 +2590,7 @@ int GDA_LinearScanningUpdateSpecificProperty( GDI_PropertyType ptype, const void
 
               first we remove that property and do merging, if necessary
              */
+            GDA_PropertyDirectoryRemoveRecord( pos, vertex );
             *(GDA_PropertyHandle*) pos = GDA_PROPERTY_EMPTY;
             removed_property = true;
             /**
@@ -1898,6 +2664,7 @@ int GDA_LinearScanningUpdateSpecificProperty( GDI_PropertyType ptype, const void
 
                       we remove that property and do merging, if necessary
                      */
+                    GDA_PropertyDirectoryRemoveRecord( pos, vertex );
                     *(GDA_PropertyHandle*) pos = GDA_PROPERTY_EMPTY;
                     removed_property = true;
                     /**
@@ -1973,6 +2740,7 @@ int GDA_LinearScanningUpdateSpecificProperty( GDI_PropertyType ptype, const void
           can always be sure, that we have enough space, because we just removed a property of the same size
          */
         *(GDA_PropertyHandle*) insert_pos = ptype->int_handle;
+        GDA_PropertyDirectoryAddRecord( ptype->int_handle, insert_pos, vertex );
         *(GDA_PropertyRecordSize*) (insert_pos+GDA_PROPERTY_HANDLE_SIZE) = new_property_entry_size;
         memcpy( insert_pos+GDA_PROPERTY_METADATA_SIZE, new_value, new_property_entry_size );
         /**
@@ -1988,6 +2756,7 @@ int GDA_LinearScanningUpdateSpecificProperty( GDI_PropertyType ptype, const void
             empty record fits perfectly, so we don't have to update the size part of the meta data
            */
           *(GDA_PropertyHandle*) insert_pos = ptype->int_handle;
+          GDA_PropertyDirectoryAddRecord( ptype->int_handle, insert_pos, vertex );
           memcpy( insert_pos+GDA_PROPERTY_METADATA_SIZE, new_value, new_property_entry_size );
         } else {
           /**
@@ -1997,6 +2766,7 @@ int GDA_LinearScanningUpdateSpecificProperty( GDI_PropertyType ptype, const void
             first insert the new property record
            */
           *(GDA_PropertyHandle*) insert_pos = ptype->int_handle;
+          GDA_PropertyDirectoryAddRecord( ptype->int_handle, insert_pos, vertex );
           *(GDA_PropertyRecordSize*) (insert_pos+GDA_PROPERTY_HANDLE_SIZE) = new_property_entry_size;
           memcpy( insert_pos+GDA_PROPERTY_METADATA_SIZE, new_value, new_property_entry_size );
           /**
@@ -2032,6 +2802,7 @@ int GDA_LinearScanningUpdateSpecificProperty( GDI_PropertyType ptype, const void
 
                 first we remove that property and do merging, if necessary
                */
+              GDA_PropertyDirectoryRemoveRecord( pos, vertex );
               *(GDA_PropertyHandle*) pos = GDA_PROPERTY_EMPTY;
               removed_property = true;
               /**
@@ -2145,6 +2916,7 @@ int GDA_LinearScanningUpdateSpecificProperty( GDI_PropertyType ptype, const void
 
                         first we remove that property and do merging, if necessary
                        */
+                      GDA_PropertyDirectoryRemoveRecord( pos, vertex );
                       *(GDA_PropertyHandle*) pos = GDA_PROPERTY_EMPTY;
                       removed_property = true;
                       /**
@@ -2228,6 +3000,7 @@ int GDA_LinearScanningUpdateSpecificProperty( GDI_PropertyType ptype, const void
             empty record fits perfectly, so we don't have to update the size part of the meta data
            */
           *(GDA_PropertyHandle*) insert_pos = ptype->int_handle;
+          GDA_PropertyDirectoryAddRecord( ptype->int_handle, insert_pos, vertex );
           memcpy( insert_pos+GDA_PROPERTY_METADATA_SIZE, new_value, new_property_entry_size );
         } else {
           /**
@@ -2237,6 +3010,7 @@ int GDA_LinearScanningUpdateSpecificProperty( GDI_PropertyType ptype, const void
             first insert the new property record
            */
           *(GDA_PropertyHandle*) insert_pos = ptype->int_handle;
+          GDA_PropertyDirectoryAddRecord( ptype->int_handle, insert_pos, vertex );
           *(GDA_PropertyRecordSize*) (insert_pos+GDA_PROPERTY_HANDLE_SIZE) = new_property_entry_size;
           memcpy( insert_pos+GDA_PROPERTY_METADATA_SIZE, new_value, new_property_entry_size );
           /**
@@ -2268,6 +3042,7 @@ int GDA_LinearScanningUpdateSpecificProperty( GDI_PropertyType ptype, const void
           pos = vertex->property_data + temp_pos;
         }
         *(GDA_PropertyHandle*) pos = ptype->int_handle;
+        GDA_PropertyDirectoryAddRecord( ptype->int_handle, pos, vertex );
         *(GDA_PropertyRecordSize*) (pos+GDA_PROPERTY_HANDLE_SIZE) = new_property_entry_size;
         memcpy( pos+GDA_PROPERTY_METADATA_SIZE, new_value, new_property_entry_size );
         /**
@@ -2437,6 +3212,7 @@ int GDA_LinearScanningUpdateSpecificProperty( GDI_PropertyType ptype, const void
 
           first we remove the old property value record and do merging, if necessary
          */
+        GDA_PropertyDirectoryRemoveRecord( remove_pos, vertex );
         *(GDA_PropertyHandle*) remove_pos = GDA_PROPERTY_EMPTY;
         /**
           introduced a new empty record, so update the appropriate counter
@@ -2480,6 +3256,7 @@ int GDA_LinearScanningUpdateSpecificProperty( GDI_PropertyType ptype, const void
           can always be sure, that we have enough space, because we just removed a property of the same size
          */
         *(GDA_PropertyHandle*) insert_pos = ptype->int_handle;
+        GDA_PropertyDirectoryAddRecord( ptype->int_handle, insert_pos, vertex );
         *(GDA_PropertyRecordSize*) (insert_pos+GDA_PROPERTY_HANDLE_SIZE) = new_property_entry_size;
         memcpy( insert_pos+GDA_PROPERTY_METADATA_SIZE, new_value, new_property_entry_size );
         /**
@@ -2495,6 +3272,7 @@ int GDA_LinearScanningUpdateSpecificProperty( GDI_PropertyType ptype, const void
             empty record fits perfectly, so we don't have to update the size part of the meta data
            */
           *(GDA_PropertyHandle*) insert_pos = ptype->int_handle;
+          GDA_PropertyDirectoryAddRecord( ptype->int_handle, insert_pos, vertex );
           memcpy( insert_pos+GDA_PROPERTY_METADATA_SIZE, new_value, new_property_entry_size );
         } else {
           /**
@@ -2504,6 +3282,7 @@ int GDA_LinearScanningUpdateSpecificProperty( GDI_PropertyType ptype, const void
             first insert the new property record
            */
           *(GDA_PropertyHandle*) insert_pos = ptype->int_handle;
+          GDA_PropertyDirectoryAddRecord( ptype->int_handle, insert_pos, vertex );
           *(GDA_PropertyRecordSize*) (insert_pos+GDA_PROPERTY_HANDLE_SIZE) = new_property_entry_size;
           memcpy( insert_pos+GDA_PROPERTY_METADATA_SIZE, new_value, new_property_entry_size );
           /**
@@ -2763,6 +3542,7 @@ int GDA_LinearScanningUpdateSpecificProperty( GDI_PropertyType ptype, const void
 
           first we remove the old property value record and do merging, if necessary
          */
+        GDA_PropertyDirectoryRemoveRecord( remove_pos, vertex );
         *(GDA_PropertyHandle*) remove_pos = GDA_PROPERTY_EMPTY;
         /**
           introduced a new empty record, so update the appropriate counter
@@ -2810,6 +3590,7 @@ int GDA_LinearScanningUpdateSpecificProperty( GDI_PropertyType ptype, const void
             empty record fits perfectly, so we don't have to update the size part of the meta data
            */
           *(GDA_PropertyHandle*) insert_pos = ptype->int_handle;
+          GDA_PropertyDirectoryAddRecord( ptype->int_handle, insert_pos, vertex );
           memcpy( insert_pos+GDA_PROPERTY_METADATA_SIZE, new_value, new_property_entry_size );
         } else {
           /**
@@ -2819,6 +3600,7 @@ int GDA_LinearScanningUpdateSpecificProperty( GDI_PropertyType ptype, const void
             first insert the new property record
            */
           *(GDA_PropertyHandle*) insert_pos = ptype->int_handle;
+          GDA_PropertyDirectoryAddRecord( ptype->int_handle, insert_pos, vertex );
           *(GDA_PropertyRecordSize*) (insert_pos+GDA_PROPERTY_HANDLE_SIZE) = new_property_entry_size;
           memcpy( insert_pos+GDA_PROPERTY_METADATA_SIZE, new_value, new_property_entry_size );
           /**
@@ -2849,6 +3631,7 @@ int GDA_LinearScanningUpdateSpecificProperty( GDI_PropertyType ptype, const void
           pos = vertex->property_data + temp_pos;
         }
         *(GDA_PropertyHandle*) pos = ptype->int_handle;
+        GDA_PropertyDirectoryAddRecord( ptype->int_handle, pos, vertex );
         *(GDA_PropertyRecordSize*) (pos+GDA_PROPERTY_HANDLE_SIZE) = new_property_entry_size;
         memcpy( pos+GDA_PROPERTY_METADATA_SIZE, new_value, new_property_entry_size );
         /**
@@ -2890,6 +3673,8 @@ int GDA_LinearScanningUpdateSpecificProperty( GDI_PropertyType ptype, const void
   updates the unused_space counter
  */
 void GDA_LinearScanningSetSingleEntityProperty( GDI_PropertyType ptype, const void* value, size_t count, GDI_VertexHolder vertex, bool* found_flag ) {
+  GDA_DecodePropertyRecords( ptype->int_handle, vertex );
+
   char* pos = vertex->property_data;
   GDA_PropertyHandle phandle = *(GDA_PropertyHandle*) pos;
 
@@ -2911,6 +3696,15 @@ void GDA_LinearScanningSetSingleEntityProperty( GDI_PropertyType ptype, const vo
     assert( property_entry_size < 65536 );
    */
 
+  int32_t slot = GDA_PropertySlot( ptype, vertex );
+  if( slot >= 0 ) {
+    *found_flag = GDA_PropertySlotPresent( slot, vertex );
+    assert( property_entry_size == vertex->property_directory->schema->slot_sizes[slot] );
+    memcpy( GDA_PropertySlotValue( slot, vertex ), value, property_entry_size );
+    GDA_SetPropertySlotPresent( slot, true, vertex );
+    return;
+  }
+
   char* previous_record = NULL;
   char* insert_pos = NULL; /* remove compiler warning */
 
@@ -2926,6 +3720,7 @@ void GDA_LinearScanningSetSingleEntityProperty( GDI_PropertyType ptype, const vo
           first we remove that property and do merging, if necessary
          */
         *found_flag = true;
+        GDA_PropertyDirectoryRemoveRecord( pos, vertex );
         *(GDA_PropertyHandle*) pos = GDA_PROPERTY_EMPTY;
         /**
           introduced a new empty record, so update the appropriate counter
@@ -2998,6 +3793,7 @@ void GDA_LinearScanningSetSingleEntityProperty( GDI_PropertyType ptype, const vo
                   we remove that property and do merging, if necessary
                  */
                 *found_flag = true;
+                GDA_PropertyDirectoryRemoveRecord( pos, vertex );
                 *(GDA_PropertyHandle*) pos = GDA_PROPERTY_EMPTY;
                 /**
                   introduced a new empty record, so update the appropriate counter
@@ -3069,6 +3865,7 @@ void GDA_LinearScanningSetSingleEntityProperty( GDI_PropertyType ptype, const vo
           first we remove that property and do merging, if necessary
          */
         *found_flag = true;
+        GDA_PropertyDirectoryRemoveRecord( pos, vertex );
         *(GDA_PropertyHandle*) pos = GDA_PROPERTY_EMPTY;
         /**
           introduced a new empty record, so update the appropriate counter
@@ -3170,6 +3967,7 @@ void GDA_LinearScanningSetSingleEntityProperty( GDI_PropertyType ptype, const vo
                   we remove that property and do merging, if necessary
                  */
                 *found_flag = true;
+                GDA_PropertyDirectoryRemoveRecord( pos, vertex );
                 *(GDA_PropertyHandle*) pos = GDA_PROPERTY_EMPTY;
                 /**
                   introduced a new empty record, so update the appropriate counter
@@ -3242,6 +4040,7 @@ void GDA_LinearScanningSetSingleEntityProperty( GDI_PropertyType ptype, const vo
         empty record fits perfectly, so we don't have to update the size part of the meta data
        */
       *(GDA_PropertyHandle*) insert_pos = ptype->int_handle;
+      GDA_PropertyDirectoryAddRecord( ptype->int_handle, insert_pos, vertex );
       memcpy( insert_pos+GDA_PROPERTY_METADATA_SIZE, value, property_entry_size );
     } else {
       /**
@@ -3251,6 +4050,7 @@ void GDA_LinearScanningSetSingleEntityProperty( GDI_PropertyType ptype, const vo
         first insert the new property record
        */
       *(GDA_PropertyHandle*) insert_pos = ptype->int_handle;
+      GDA_PropertyDirectoryAddRecord( ptype->int_handle, insert_pos, vertex );
       *(GDA_PropertyRecordSize*) (insert_pos+GDA_PROPERTY_HANDLE_SIZE) = property_entry_size;
       memcpy( insert_pos+GDA_PROPERTY_METADATA_SIZE, value, property_entry_size );
       /**
@@ -3282,6 +4082,7 @@ void GDA_LinearScanningSetSingleEntityProperty( GDI_PropertyType ptype, const vo
       pos = vertex->property_data + temp_pos;
     }
     *(GDA_PropertyHandle*) pos = ptype->int_handle;
+    GDA_PropertyDirectoryAddRecord( ptype->int_handle, pos, vertex );
     *(GDA_PropertyRecordSize*) (pos+GDA_PROPERTY_HANDLE_SIZE) = property_entry_size;
     memcpy( pos+GDA_PROPERTY_METADATA_SIZE, value, property_entry_size );
     /**
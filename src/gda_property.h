@@ -30,9 +30,151 @@ typedef uint64_t  GDA_PropertyRecordSize;
 #define GDA_PROPERTY_OFFSET_PRIMARY   0
 #define GDA_PROPERTY_OFFSET_BLOCK     0
 
+/**
+  The property data is stored in the blocks of a vertex (and of an edge
+  record) in a more compact format than in memory: empty records are
+  left out and the size of each record is a varint (gda_varint.h), so
+  that the meta data of a small record takes two instead of nine Bytes.
+
+  The stored size field of the property data has
+  GDA_PROPERTY_STORED_VARINT set for this format. Property data without
+  it was written in the in-memory format and is taken over as is, when
+  it is loaded, and converted with the next write.
+
+  The value of a record of a dictionary encoded property type
+  (gda_dictionary.h) is replaced by its code, unless the value is too
+  short to benefit:
+   ------------------------ -------- ------ ------
+  | GDA_PROPERTY_DICT_CODE | handle | size | code |
+   ------------------------ -------- ------ ------
+  size = varint, size of the decoded value
+  code = uint64_t
+  The marker is the handle of an empty record, since those are not
+  stored, so that the record doesn't depend on the current flag of the
+  property type.
+
+  Such a record keeps its code in memory, when the property data is
+  loaded (property_codes of the vertex): the functions, that return
+  values, decode it on the first read, while the functions, that change
+  or compare the values of the property type, decode all of its records
+  first. GDA_LinearScanningNextPropertyCode and
+  GDA_LinearScanningHasPropertyValue work on the codes themselves, and a
+  record, that was never decoded, is written back with its code.
+ */
+#define GDA_PROPERTY_STORED_VARINT  ((uint64_t) 1 << 63)
+#define GDA_PROPERTY_DICT_CODE      0
+
 #define GDA_PROPERTY_EMPTY    0
 #define GDA_PROPERTY_LAST     1
 #define GDA_PROPERTY_LABEL    2
+#define GDA_PROPERTY_SLOTS    4
+
+/**
+  schema of a label (GDI_SetPropertyTypesOfLabel): fixed size single
+  entity property types, that vertices with the label store in fixed
+  slots
+
+  A vertex, that gets a label with a schema, stores these properties in
+  a single record (handle GDA_PROPERTY_SLOTS) instead of one record per
+  property:
+   ---------- ----------------- -------- -------- ---
+  | label    | presence bitmap | slot 0 | slot 1 |...
+   ---------- ----------------- -------- -------- ---
+  label = integer handle of the label (uint32_t), whose schema is used
+  presence bitmap = one bit per slot, set if the property is present
+
+  The value of a slot is found at a fixed offset, so it doesn't need
+  any meta data of its own. Only the first label with a schema, that is
+  added to a vertex, determines its slots, all other properties are
+  stored in records as before.
+ */
+typedef struct GDA_PropertySchema_desc {
+  uint32_t num_slots;
+  /**
+    integer handle of the property type of each slot
+   */
+  uint32_t* int_handles;
+  /**
+    offset of the value of each slot in the data of the slot record and
+    its size in Bytes
+   */
+  uint64_t* slot_offsets;
+  uint64_t* slot_sizes;
+  /**
+    slot of each property type, indexed by its integer handle (-1 if
+    the property type has no slot)
+   */
+  int32_t* slot_index;
+  uint32_t num_handles;
+  /**
+    size in Bytes of the data of the slot record
+   */
+  uint64_t record_size;
+} GDA_PropertySchema;
+
+#define GDA_PROPERTY_SLOTS_OFFSET_LABEL   0
+#define GDA_PROPERTY_SLOTS_OFFSET_BITMAP  (GDA_PROPERTY_SLOTS_OFFSET_LABEL+4)
+
+/**
+  directory of the records in the property data of a vertex, so that
+  the records of a property type and the labels can be found without
+  scanning the whole list
+
+  It is kept in memory only (the stored property data doesn't change),
+  built on the first access to the properties of a vertex object and
+  then updated by every function, that adds or removes a record.
+ */
+typedef struct GDA_PropertyDirectoryEntry_desc {
+  /**
+    offset of the first record of the property type in the property data
+   */
+  uint64_t first_offset;
+  /**
+    number of records of the property type
+   */
+  uint32_t num_records;
+} GDA_PropertyDirectoryEntry;
+
+typedef struct GDA_PropertyDirectory_desc {
+  /**
+    indexed by the integer handle of the property type
+   */
+  GDA_PropertyDirectoryEntry* entries;
+  uint32_t num_entries;
+  /**
+    number of property types with at least one record, that count for
+    GDI_GetAllPropertyTypesOfVertex (GDI_PROPERTY_TYPE_ID and up)
+   */
+  uint32_t num_ptypes;
+  /**
+    bitmap of the integer handles of the labels of the vertex
+   */
+  uint64_t* label_bitmap;
+  uint32_t num_label_words;
+  uint32_t num_labels;
+  /**
+    schema of the slot record of the vertex (NULL if there is none),
+    the entry of a property type with a slot has at most one "record",
+    whose offset is the one of its value in the slot record
+   */
+  GDA_PropertySchema* schema;
+} GDA_PropertyDirectory;
+
+/**
+  cursor over the values of a property type of a vertex, that returns
+  them in place instead of copying them (GDA_LinearScanningNextProperty)
+ */
+typedef struct GDA_PropertyCursor_desc {
+  GDI_VertexHolder vertex;
+  char* pos;
+  uint32_t num_records;
+  uint8_t int_handle;
+  /**
+    size in Bytes of the value, if the property type has a slot (-1
+    otherwise)
+   */
+  int64_t slot_size;
+} GDA_PropertyCursor;
 
 /**
   TODO: Also use a return type, where appropriate, for the label functions?
@@ -49,7 +191,48 @@ int GDA_LinearScanningUpdateSingleEntityProperty( GDI_PropertyType ptype, const
 int GDA_LinearScanningUpdateSpecificProperty( GDI_PropertyType ptype, const void* old_value, size_t old_count, const void* new_value, size_t new_count, GDI_VertexHolder vertex );
 
 int GDA_LinearScanningFindAllLabels( GDI_VertexHolder vertex, GDI_Label* labels, size_t count, size_t* resultcount );
+bool GDA_LinearScanningHasLabel( uint32_t label_int_handle, GDI_VertexHolder vertex );
+void GDA_LinearScanningInitPropertyCursor( GDA_PropertyCursor* cursor, GDI_PropertyType ptype, GDI_VertexHolder vertex );
+/**
+  returns the next value of the cursor and its size in Bytes, returns
+  false, once all values were returned
+ */
+bool GDA_LinearScanningNextProperty( const char** value, uint64_t* size, GDA_PropertyCursor* cursor );
+/**
+  same as GDA_LinearScanningNextProperty, but a value, that is still
+  dictionary encoded, is not decoded: value is NULL and code holds its
+  code (GDA_DictionaryCode) instead, size is the one of the value
+ */
+bool GDA_LinearScanningNextPropertyCode( const char** value, uint64_t* size, uint64_t* code, GDA_PropertyCursor* cursor );
+/**
+  whether the vertex has a value of the property type, that is equal to
+  value (size Bytes, with the dictionary code code), values, that are
+  still encoded, are only decoded, if their code is the same
+ */
+bool GDA_LinearScanningHasPropertyValue( const void* value, uint64_t size, uint64_t code, GDI_PropertyType ptype, GDI_VertexHolder vertex );
 void GDA_LinearScanningInitPropertyList( GDI_VertexHolder vertex );
+void GDA_LinearScanningFreePropertyList( GDI_VertexHolder vertex );
+
+/**
+  upper bound of the size in Bytes of the property data of the vertex
+  in the stored format
+ */
+uint64_t GDA_StoredPropertyListSize( GDI_VertexHolder vertex );
+/**
+  writes the property data of the vertex in the stored format to buf,
+  which has to hold GDA_StoredPropertyListSize Bytes, interns the values
+  of dictionary encoded property types and returns the actual size
+ */
+uint64_t GDA_StorePropertyList( char* buf, GDI_VertexHolder vertex );
+/**
+  sets the property data of the vertex from stored data, with the
+  stored size and unused space fields, and takes over the ownership of
+  data
+ */
+void GDA_LoadPropertyList( char* data, uint64_t stored_size, uint64_t unused_space, GDI_VertexHolder vertex );
+
+GDA_PropertySchema* GDA_CreatePropertySchema( const GDI_PropertyType* ptypes, size_t count );
+void GDA_FreePropertySchema( GDA_PropertySchema* schema );
 void GDA_LinearScanningInsertLabel( GDI_Label label, GDI_VertexHolder vertex, bool* found_flag );
 void GDA_LinearScanningNumLabels( GDI_VertexHolder vertex, size_t* resultcount );
 void GDA_LinearScanningRemoveLabel( GDI_Label label, GDI_VertexHolder vertex, bool* found_flag );
@@ -0,0 +1,77 @@
+// Copyright (c) 2023 ETH Zurich.
+//                    All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <assert.h>
+
+#include "gda_dpointer.h"
+#include "gda_translation_cache.h"
+
+
+static inline GDA_TranslationCache_Entry* CacheSlot( uint64_t hashed_key, uint64_t key, GDA_TranslationCache cache ) {
+  uint64_t h = hashed_key ^ (key * 0x9E3779B97F4A7C15ULL);
+  h ^= h >> 32;
+  return &(cache->entries[h % cache->num_entries]);
+}
+
+
+void GDA_CreateTranslationCache( size_t num_entries, GDA_TranslationCache* cache ) {
+  assert( num_entries > 0 );
+
+  GDA_TranslationCache internal_cache = malloc( sizeof(GDA_TranslationCache_desc_t) );
+  assert( internal_cache != NULL );
+
+  internal_cache->num_entries = num_entries;
+  internal_cache->entries = malloc( num_entries * sizeof(GDA_TranslationCache_Entry) );
+  assert( internal_cache->entries != NULL );
+
+  for( size_t i=0 ; i<num_entries ; i++ ) {
+    internal_cache->entries[i].value = GDA_DPOINTER_NULL;
+  }
+
+  *cache = internal_cache;
+}
+
+
+void GDA_FreeTranslationCache( GDA_TranslationCache* cache ) {
+  free( (*cache)->entries );
+  free( *cache );
+  *cache = NULL;
+}
+
+
+/**
+  returns true on a hit, the result still has to be validated
+ */
+bool GDA_LookupTranslationCache( uint64_t hashed_key, uint64_t key, uint64_t* value, uint64_t* incarnation, GDA_TranslationCache cache ) {
+  GDA_TranslationCache_Entry* entry = CacheSlot( hashed_key, key, cache );
+
+  if( (entry->value == GDA_DPOINTER_NULL) || (entry->hashed_key != hashed_key) || (entry->key != key) ) {
+    return false;
+  }
+
+  *value = entry->value;
+  *incarnation = entry->incarnation;
+  return true;
+}
+
+
+void GDA_UpdateTranslationCache( uint64_t hashed_key, uint64_t key, uint64_t value, uint64_t incarnation, GDA_TranslationCache cache ) {
+  GDA_TranslationCache_Entry* entry = CacheSlot( hashed_key, key, cache );
+
+  entry->hashed_key = hashed_key;
+  entry->key = key;
+  entry->value = value;
+  entry->incarnation = incarnation;
+}
+
+
+void GDA_InvalidateTranslationCache( uint64_t hashed_key, uint64_t key, GDA_TranslationCache cache ) {
+  GDA_TranslationCache_Entry* entry = CacheSlot( hashed_key, key, cache );
+
+  if( (entry->hashed_key == hashed_key) && (entry->key == key) ) {
+    entry->value = GDA_DPOINTER_NULL;
+  }
+}
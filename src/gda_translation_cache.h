@@ -0,0 +1,65 @@
+// Copyright (c) 2023 ETH Zurich.
+//                    All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef __GDA_TRANSLATION_CACHE_H
+#define __GDA_TRANSLATION_CACHE_H
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+  process-local cache, that remembers the result of recent translations
+  of application-level IDs into vertex UIDs
+
+  The cache is direct mapped and uses the same key as the internal index
+  (hashed key and key), so the number of entries is bounded and a new
+  entry simply replaces the old one in its slot. An entry may become
+  stale, once the vertex is deleted by another process: the users of
+  the cache have to validate the incarnation of each hit.
+ */
+
+
+/**
+  constant definitions
+ */
+
+#define GDA_TRANSLATION_CACHE_ENTRIES 4096
+
+
+/**
+  data type definitions
+ */
+
+typedef struct GDA_TranslationCache_Entry_desc {
+  uint64_t hashed_key;
+  uint64_t key;
+  /**
+    vertex UID (GDA_DPOINTER_NULL for an empty entry)
+   */
+  uint64_t value;
+  uint64_t incarnation;
+} GDA_TranslationCache_Entry;
+
+typedef struct GDA_TranslationCache_desc {
+  GDA_TranslationCache_Entry* entries;
+  size_t num_entries;
+} GDA_TranslationCache_desc_t;
+
+typedef GDA_TranslationCache_desc_t* GDA_TranslationCache;
+
+
+/**
+  function prototypes
+ */
+
+void GDA_CreateTranslationCache( size_t num_entries, GDA_TranslationCache* cache );
+void GDA_FreeTranslationCache( GDA_TranslationCache* cache );
+bool GDA_LookupTranslationCache( uint64_t hashed_key, uint64_t key, uint64_t* value, uint64_t* incarnation, GDA_TranslationCache cache );
+void GDA_UpdateTranslationCache( uint64_t hashed_key, uint64_t key, uint64_t value, uint64_t incarnation, GDA_TranslationCache cache );
+void GDA_InvalidateTranslationCache( uint64_t hashed_key, uint64_t key, GDA_TranslationCache cache );
+
+#endif // #ifndef __GDA_TRANSLATION_CACHE_H
@@ -0,0 +1,74 @@
+// Copyright (c) 2023 ETH Zurich.
+//                    All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef __GDA_VARINT_H
+#define __GDA_VARINT_H
+
+#include <inttypes.h>
+#include <stddef.h>
+
+/**
+  This header provides functions to encode and decode unsigned integers
+  with a variable number of Bytes (LEB128): each Byte holds 7 bits of
+  the value, starting with the lowest ones, and the highest bit is set
+  in all Bytes except the last one.
+
+  A 64 bit value needs at most GDA_VARINT_MAX_SIZE Bytes.
+ */
+
+
+/**
+  constant definitions
+ */
+
+#define GDA_VARINT_MAX_SIZE 10
+
+
+/**
+  function defintions
+ */
+
+/**
+  Returns the number of Bytes needed to encode value.
+ */
+static inline size_t GDA_VarintSize( uint64_t value ) {
+  size_t size = 1;
+  while( value >= 0x80 ) {
+    size++;
+    value >>= 7;
+  }
+  return size;
+}
+
+/**
+  Writes value to buf and returns the number of Bytes written.
+ */
+static inline size_t GDA_EncodeVarint( uint64_t value, uint8_t* buf ) {
+  size_t size = 0;
+  while( value >= 0x80 ) {
+    buf[size++] = (uint8_t) (value | 0x80);
+    value >>= 7;
+  }
+  buf[size++] = (uint8_t) value;
+  return size;
+}
+
+/**
+  Reads a value from buf and returns the number of Bytes read.
+ */
+static inline size_t GDA_DecodeVarint( uint64_t* value, const uint8_t* buf ) {
+  size_t size = 0;
+  unsigned int shift = 0;
+  *value = 0;
+  while( buf[size] & 0x80 ) {
+    *value |= ((uint64_t) (buf[size++] & 0x7F)) << shift;
+    shift += 7;
+  }
+  *value |= ((uint64_t) buf[size++]) << shift;
+  return size;
+}
+
+#endif // #ifndef __GDA_VARINT_H
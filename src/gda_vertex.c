@@ -12,12 +12,16 @@
 #include "gdi.h"
 #include "gda_block.h"
 #include "gda_lightweight_edges.h"
+#include "gda_property.h"
 #include "gda_vertex.h"
+#include "gda_yield.h"
 
 void GDA_AssociateVertex( GDI_Vertex_uid internal_uid, GDI_Transaction transaction, GDI_VertexHolder vertex ) {
   vertex->delete_flag = false;
   vertex->write_flag = false;
   vertex->creation_flag = false;
+  vertex->property_write_flag = false;
+  vertex->index_entries = NULL;
 
   GDA_vector_push_back( transaction->vertices, &vertex );
 
@@ -38,6 +42,7 @@ void GDA_AssociateVertex( GDI_Vertex_uid internal_uid, GDI_Transaction transacti
   char* source_address;
 
   GDA_GetBlock( buf, internal_uid, transaction->db );
+  GDA_Yield();
   RMA_Win_flush_all( transaction->db->win_blocks );
 
   /**
@@ -45,8 +50,10 @@ void GDA_AssociateVertex( GDI_Vertex_uid internal_uid, GDI_Transaction transacti
    */
   uint32_t num_blocks = *(uint32_t*)(buf+GDA_OFFSET_NUM_BLOCKS);
   uint32_t num_edges = *(uint32_t*)(buf+GDA_OFFSET_NUM_LIGHTWEIGHT_EDGES);
-  vertex->property_size = *(uint64_t*)(buf+GDA_OFFSET_SIZE_PROPERTY_DATA);
-  vertex->unused_space = *(uint64_t*)(buf+GDA_OFFSET_SIZE_UNUSED_SPACE);
+  uint64_t remaining_lightweight_edge_data = *(uint64_t*)(buf+GDA_OFFSET_SIZE_LIGHTWEIGHT_EDGES);
+  uint64_t stored_property_size = *(uint64_t*)(buf+GDA_OFFSET_SIZE_PROPERTY_DATA);
+  uint64_t unused_space = *(uint64_t*)(buf+GDA_OFFSET_SIZE_UNUSED_SPACE);
+  memcpy( vertex->lightweight_edge_degrees, buf+GDA_OFFSET_DEGREES, sizeof(vertex->lightweight_edge_degrees) );
 
   /**
     initialise the data structure that keeps track of blocks associated with this vertex
@@ -59,6 +66,7 @@ void GDA_AssociateVertex( GDI_Vertex_uid internal_uid, GDI_Transaction transacti
   vertex->blocks->capacity = num_blocks + 8;
   vertex->blocks->data = realloc(vertex->blocks->data, vertex->blocks->capacity * vertex->blocks->element_size );
   vertex->blocks->size = num_blocks;
+  vertex->num_stored_blocks = num_blocks;
 
   *(uint64_t*)(vertex->blocks->data) = internal_uid;
 
@@ -116,6 +124,7 @@ void GDA_AssociateVertex( GDI_Vertex_uid internal_uid, GDI_Transaction transacti
           fetched all possible blocks, so now we have to flush
           to get the next block addresses
          */
+        GDA_Yield();
         RMA_Win_flush_all( transaction->db->win_blocks );
 
         next_flush += ((next_flush - last_flush) * block_size) / sizeof(GDA_DPointer);
@@ -125,6 +134,7 @@ void GDA_AssociateVertex( GDI_Vertex_uid internal_uid, GDI_Transaction transacti
       GDA_GetBlock( target_address, dp[blk_cnt++], transaction->db );
       target_address += block_size;
     }
+    GDA_Yield();
     RMA_Win_flush_all( transaction->db->win_blocks );
 
     remaining_block_data -= num_block_data_blocks * block_size;
@@ -135,6 +145,7 @@ void GDA_AssociateVertex( GDI_Vertex_uid internal_uid, GDI_Transaction transacti
         (and maybe property data)
        */
       GDA_GetBlock( buf, dp[blk_cnt++], transaction->db );
+      GDA_Yield();
       RMA_Win_flush_all( transaction->db->win_blocks );
 
       /**
@@ -145,6 +156,7 @@ void GDA_AssociateVertex( GDI_Vertex_uid internal_uid, GDI_Transaction transacti
       source_address = buf+remaining_block_data;
       remaining_buf_data = block_size - remaining_block_data;
     } else {
+      GDA_Yield();
       RMA_Win_flush_all( transaction->db->win_blocks ); // TODO: Do we need this?
       remaining_buf_data = 0;
     }
@@ -153,38 +165,12 @@ void GDA_AssociateVertex( GDI_Vertex_uid internal_uid, GDI_Transaction transacti
   /**
     initialise the lightweight edge data
    */
-  vertex->lightweight_edge_insert_offset = num_edges / (GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE-2) * GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE + num_edges % (GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE-2) + 2;
-  /**
-    we have to round up because we always have to allocate enough memory
-    for a complete lightweight edge block
-
-    add one more lightweight edge block, so that we don't have to immediately
-    reallocate (in case the current lightweight edge block is completely full,
-    there will two completely empty lightweight edge blocks at the end)
-   */
-  vertex->lightweight_edge_size = (num_edges / (GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE-2) + 1 /* round up */ + 1 /* one additional block of edges */) * GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE * sizeof(GDA_DPointer);
-  vertex->lightweight_edge_data = malloc( vertex->lightweight_edge_size );
-
-  /**
-    number of Bytes that need to be copied/transfered for the lightweight edges
-   */
-  uint64_t remaining_lightweight_edge_data = vertex->lightweight_edge_insert_offset * sizeof(GDA_DPointer);
-
-  if( (num_edges % (GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE-2)) == 0 ) {
-    /**
-      have to initialise the next lightweight edge block
-     */
-    vertex->lightweight_edge_data[vertex->lightweight_edge_insert_offset-2] = 0; /* meta data */
-    vertex->lightweight_edge_data[vertex->lightweight_edge_insert_offset-1] = 0; /* label data */
-    remaining_lightweight_edge_data -= 2 * sizeof(GDA_DPointer);
-  }
+  char* target_address = (char*) GDA_LightweightEdgesPrepareLoad( num_edges, remaining_lightweight_edge_data, vertex );
 
   /**
     start copying/transfering the lightweight edge data
    */
   if( remaining_lightweight_edge_data > 0 ) {
-    char* target_address = (char*) (vertex->lightweight_edge_data);
-
     /**
       check whether we need to unpack anything from an already fetched block
      */
@@ -225,6 +211,7 @@ void GDA_AssociateVertex( GDI_Vertex_uid internal_uid, GDI_Transaction transacti
         with property data
        */
       GDA_GetBlock( buf, dp[blk_cnt++], transaction->db );
+      GDA_Yield();
       RMA_Win_flush_all( transaction->db->win_blocks );
 
       memcpy( target_address, buf, remaining_lightweight_edge_data );
@@ -235,18 +222,18 @@ void GDA_AssociateVertex( GDI_Vertex_uid internal_uid, GDI_Transaction transacti
   }
 
   /**
-    initialise the property data
+    fetch the stored property data, which is converted into the
+    in-memory format at the end
    */
-  vertex->property_data = malloc( vertex->property_size );
-
-  // TODO: not accurate
-  uint64_t remaining_property_data = vertex->property_size;
+  uint64_t remaining_property_data = stored_property_size & ~GDA_PROPERTY_STORED_VARINT;
+  char* property_data = malloc( remaining_property_data );
+  assert( property_data != NULL );
 
   /**
     start copying/transfering the property data
    */
   if( remaining_property_data > 0 ) {
-    char* target_address = (char*) (vertex->property_data);
+    char* target_address = property_data;
 
     /**
       check whether we need to unpack anything from an already fetched block
@@ -286,6 +273,7 @@ void GDA_AssociateVertex( GDI_Vertex_uid internal_uid, GDI_Transaction transacti
         last block is only partially filled with property data
        */
       GDA_GetBlock( buf, dp[blk_cnt++], transaction->db );
+      GDA_Yield();
       RMA_Win_flush_all( transaction->db->win_blocks );
 
       memcpy( target_address, buf, remaining_property_data );
@@ -297,7 +285,174 @@ void GDA_AssociateVertex( GDI_Vertex_uid internal_uid, GDI_Transaction transacti
   /**
     make sure that all data is properly in place
    */
+  GDA_Yield();
   RMA_Win_flush_all( transaction->db->win_blocks );
 
+  GDA_LoadPropertyList( property_data, stored_property_size, unused_space, vertex );
+
   free( buf );
 }
+
+
+/**
+  marks a block of a vertex in GDA_LoadVertexProperties, that was
+  requested, but not flushed yet
+ */
+static char GDA_pending_block;
+
+typedef struct GDA_PendingVertexBlock {
+  char** target;
+  char* buf;
+} GDA_PendingVertexBlock;
+
+
+/**
+  requests block k of a vertex (the blocks are numbered in the order of
+  the vertex data, the primary block is block 0), if its DPointer is
+  available, otherwise the block with its DPointer is requested first
+
+  returns true, if a request was issued, the buffer is assigned to the
+  block after the next flush
+ */
+static bool GDA_RequestVertexBlock( char** blocks, uint32_t k, GDA_Vector* pending, GDI_Database graph_db ) {
+  if( blocks[k] != NULL ) {
+    return false;
+  }
+
+  uint64_t block_size = graph_db->block_size;
+  uint64_t dpointer_offset = GDA_VERTEX_METADATA_SIZE + (k-1) * sizeof(GDA_DPointer);
+  uint32_t b = dpointer_offset / block_size;
+  if( blocks[b] == NULL ) {
+    return GDA_RequestVertexBlock( blocks, b, pending, graph_db );
+  }
+  if( blocks[b] == &GDA_pending_block ) {
+    return false;
+  }
+
+  char* buf = malloc( block_size );
+  assert( buf != NULL );
+  GDA_GetBlock( buf, *(GDA_DPointer*)(blocks[b] + dpointer_offset % block_size), graph_db );
+  blocks[k] = &GDA_pending_block;
+  GDA_PendingVertexBlock request = { blocks + k, buf };
+  GDA_vector_push_back( pending, &request );
+  return true;
+}
+
+
+void GDA_LoadVertexProperties( const GDI_Vertex_uid array_of_uids[], size_t count, GDI_Transaction transaction, GDI_VertexHolder_desc_t* vertices ) {
+  GDI_Database graph_db = transaction->db;
+  uint64_t block_size = graph_db->block_size;
+
+  /**
+    the primary blocks of all vertices are fetched together
+   */
+  char*** blocks = malloc( count * sizeof(char**) );
+  assert( blocks != NULL );
+  char** primary_blocks = malloc( count * sizeof(char*) );
+  assert( primary_blocks != NULL );
+  for( size_t i=0 ; i<count ; i++ ) {
+    primary_blocks[i] = malloc( block_size );
+    assert( primary_blocks[i] != NULL );
+    GDA_GetBlock( primary_blocks[i], array_of_uids[i], graph_db );
+  }
+  GDA_Yield();
+  RMA_Win_flush_all( graph_db->win_blocks );
+
+  /**
+    the property data follows the block addresses and the lightweight
+    edge data, so only the blocks with the property data (and those with
+    their block addresses) are needed
+   */
+  uint32_t* first_block = malloc( count * sizeof(uint32_t) );
+  assert( first_block != NULL );
+  uint32_t* last_block = malloc( count * sizeof(uint32_t) );
+  assert( last_block != NULL );
+  uint64_t* property_start = malloc( count * sizeof(uint64_t) );
+  assert( property_start != NULL );
+
+  for( size_t i=0 ; i<count ; i++ ) {
+    char* buf = primary_blocks[i];
+    uint32_t num_blocks = *(uint32_t*)(buf+GDA_OFFSET_NUM_BLOCKS);
+    uint64_t lightweight_edge_size = *(uint64_t*)(buf+GDA_OFFSET_SIZE_LIGHTWEIGHT_EDGES);
+    uint64_t property_size = *(uint64_t*)(buf+GDA_OFFSET_SIZE_PROPERTY_DATA) & ~GDA_PROPERTY_STORED_VARINT;
+
+    blocks[i] = calloc( num_blocks, sizeof(char*) );
+    assert( blocks[i] != NULL );
+    blocks[i][0] = buf;
+
+    property_start[i] = GDA_VERTEX_METADATA_SIZE + (num_blocks-1) * sizeof(GDA_DPointer) + lightweight_edge_size;
+    first_block[i] = property_start[i] / block_size;
+    last_block[i] = (property_size > 0) ? (property_start[i] + property_size - 1) / block_size : first_block[i];
+    assert( last_block[i] < num_blocks );
+
+    GDI_VertexHolder vertex = vertices + i;
+    vertex->transaction = transaction;
+    memcpy( vertex->lightweight_edge_degrees, buf+GDA_OFFSET_DEGREES, sizeof(vertex->lightweight_edge_degrees) );
+  }
+
+  /**
+    one round trip per round: the rounds beyond the first one are only
+    needed for vertices, whose block addresses don't fit into the
+    primary block
+   */
+  GDA_Vector* pending;
+  GDA_vector_create( &pending, sizeof(GDA_PendingVertexBlock), 64 /* initial capacity */ );
+  bool request_flag = true;
+  while( request_flag ) {
+    request_flag = false;
+    for( size_t i=0 ; i<count ; i++ ) {
+      for( uint32_t k=first_block[i] ; k<=last_block[i] ; k++ ) {
+        request_flag |= GDA_RequestVertexBlock( blocks[i], k, pending, graph_db );
+      }
+    }
+    if( !request_flag ) {
+      break;
+    }
+
+    GDA_Yield();
+    RMA_Win_flush_all( graph_db->win_blocks );
+
+    for( size_t j=0 ; j<pending->size ; j++ ) {
+      GDA_PendingVertexBlock* request = GDA_vector_at( pending, j );
+      *(request->target) = request->buf;
+    }
+    pending->size = 0;
+  }
+  GDA_vector_free( &pending );
+
+  for( size_t i=0 ; i<count ; i++ ) {
+    char* buf = blocks[i][0];
+    uint64_t stored_property_size = *(uint64_t*)(buf+GDA_OFFSET_SIZE_PROPERTY_DATA);
+    uint64_t unused_space = *(uint64_t*)(buf+GDA_OFFSET_SIZE_UNUSED_SPACE);
+    uint64_t remaining_property_data = stored_property_size & ~GDA_PROPERTY_STORED_VARINT;
+    uint32_t num_blocks = *(uint32_t*)(buf+GDA_OFFSET_NUM_BLOCKS);
+
+    char* property_data = malloc( remaining_property_data );
+    assert( property_data != NULL );
+    char* target_address = property_data;
+    uint64_t block_offset = property_start[i] % block_size;
+    for( uint32_t k=first_block[i] ; remaining_property_data > 0 ; k++ ) {
+      uint64_t chunk = block_size - block_offset;
+      if( chunk > remaining_property_data ) {
+        chunk = remaining_property_data;
+      }
+      memcpy( target_address, blocks[i][k] + block_offset, chunk );
+      target_address += chunk;
+      remaining_property_data -= chunk;
+      block_offset = 0;
+    }
+
+    GDA_LoadPropertyList( property_data, stored_property_size, unused_space, vertices + i );
+
+    for( uint32_t k=0 ; k<num_blocks ; k++ ) {
+      free( blocks[i][k] );
+    }
+    free( blocks[i] );
+  }
+
+  free( property_start );
+  free( last_block );
+  free( first_block );
+  free( primary_blocks );
+  free( blocks );
+}
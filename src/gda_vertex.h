@@ -13,12 +13,32 @@
 #define GDA_OFFSET_NUM_LIGHTWEIGHT_EDGES  (GDA_OFFSET_NUM_BLOCKS+4)
 #define GDA_OFFSET_SIZE_PROPERTY_DATA     (GDA_OFFSET_NUM_LIGHTWEIGHT_EDGES+4)
 #define GDA_OFFSET_SIZE_UNUSED_SPACE      (GDA_OFFSET_SIZE_PROPERTY_DATA+8)
+#define GDA_OFFSET_SIZE_LIGHTWEIGHT_EDGES (GDA_OFFSET_SIZE_UNUSED_SPACE+8)
+/**
+  number of incoming, outgoing and undirected edges (three 4 Byte
+  counters, followed by 4 unused Bytes)
+ */
+#define GDA_OFFSET_DEGREES                (GDA_OFFSET_SIZE_LIGHTWEIGHT_EDGES+8)
+
+/**
+  should be 48 Bytes
+ */
+#define GDA_VERTEX_METADATA_SIZE          (GDA_OFFSET_DEGREES+16)
 
 /**
-  should be 24 Bytes
+  number of vertices, whose blocks GDI_GetPropertiesOfVertices fetches
+  at the same time
  */
-#define GDA_VERTEX_METADATA_SIZE          (GDA_OFFSET_SIZE_UNUSED_SPACE+8)
+#define GDA_LOAD_VERTEX_PROPERTIES_BATCH  256
 
 void GDA_AssociateVertex( GDI_Vertex_uid internal_uid, GDI_Transaction transaction, GDI_VertexHolder vertex );
 
+/**
+  loads the property data and the degrees of the vertices into the given
+  vertex objects, of which only the fields for the property functions
+  are set: only the blocks with property data are fetched, and the
+  requests for all vertices are issued together
+ */
+void GDA_LoadVertexProperties( const GDI_Vertex_uid array_of_uids[], size_t count, GDI_Transaction transaction, GDI_VertexHolder_desc_t* vertices );
+
 #endif // #ifndef __GDA_VERTEX_H
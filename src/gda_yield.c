@@ -0,0 +1,16 @@
+// Copyright (c) 2023 ETH Zurich.
+//                    All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gda_yield.h"
+
+GDA_YieldFunction GDA_yield_function = NULL;
+void* GDA_yield_arg = NULL;
+
+
+void GDA_SetYieldFunction( GDA_YieldFunction func, void* arg ) {
+  GDA_yield_function = func;
+  GDA_yield_arg = arg;
+}
@@ -0,0 +1,64 @@
+// Copyright (c) 2023 ETH Zurich.
+//                    All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef __GDA_YIELD_H
+#define __GDA_YIELD_H
+
+#include <stdlib.h>
+
+/**
+  This header provides a hook that allows a caller to multiplex several
+  single process transactions on the same rank. The library calls
+  GDA_Yield() after it issued a remote operation and before it waits for
+  its completion (flush). A user level scheduler (e.g. a coroutine based
+  query executor) can register a function that switches to a different
+  transaction at that point, so that the remote operations of several
+  transactions are in flight at the same time.
+
+  The hook is process global and NULL by default, in which case
+  GDA_Yield() is a no-op. It is the responsibility of the registered
+  function to return immediately, if it is not called from within a
+  context that can be suspended.
+ */
+
+
+/**
+  data type definitions
+ */
+
+typedef void (*GDA_YieldFunction)( void* arg );
+
+
+/**
+  global variables
+ */
+
+extern GDA_YieldFunction GDA_yield_function;
+extern void* GDA_yield_arg;
+
+
+/**
+  function prototypes
+ */
+
+/**
+  registers the function, that is called by GDA_Yield (NULL to
+  deregister)
+ */
+void GDA_SetYieldFunction( GDA_YieldFunction func, void* arg );
+
+
+/**
+  function definitions
+ */
+
+static inline void GDA_Yield() {
+  if( GDA_yield_function != NULL ) {
+    GDA_yield_function( GDA_yield_arg );
+  }
+}
+
+#endif // #ifndef __GDA_YIELD_H
@@ -16,8 +16,12 @@
 #include "gdi_datatype.h"
 #include "gdi_label.h"
 #include "gdi_property_type.h"
+#include "gda_bitmap.h"
+#include "gda_bloom_filter.h"
+#include "gda_bucket_hashtable.h"
 #include "gda_distributed_hashtable.h"
 #include "gda_dpointer.h"
+#include "gda_translation_cache.h"
 #include "gda_vector.h"
 #include "gda_edge_uid.h"
 
@@ -51,6 +55,15 @@
 #define GDI_MAX_SIZE                      201
 #define GDI_NO_SIZE_LIMIT                 202
 
+/**
+  flag for the size limit argument of GDI_CreatePropertyType and
+  GDI_UpdatePropertyType (bitwise OR): the values of the property type
+  are stored dictionary encoded (gda_dictionary.h)
+
+  beyond the specification
+ */
+#define GDI_DICTIONARY_ENCODED          0x10000
+
 /**
   edge direction type (state parameter for some function calls)
 
@@ -79,6 +92,58 @@
 #define GDI_SINGLE_PROCESS_TRANSACTION    203
 #define GDI_COLLECTIVE_TRANSACTION        204
 
+/**
+  index type (state)
+
+  GDI_INDEX_HASH:    distributed hash table, answers lookups of a single
+                     value
+  GDI_INDEX_ORDERED: distributed table of value ranges, answers lookups
+                     of a single value and of value ranges
+  GDI_INDEX_PREFIX:  distributed table of string prefixes, answers lookups
+                     of a single value and of all values, that start
+                     with a prefix (GDI_CHAR only)
+  GDI_INDEX_BITMAP:  bitmap over the primary blocks of each process, that
+                     only tracks the label of the index (no property type)
+                     and enumerates the local vertices of a process
+
+  stored as uint8_t
+ */
+#define GDI_INDEX_HASH                    205
+#define GDI_INDEX_ORDERED                 206
+#define GDI_INDEX_BITMAP                  207
+#define GDI_INDEX_PREFIX                  208
+
+/**
+  type of the internal index (implementation specific parameter of
+  GDI_CreateDatabase, see GDA_Init_params)
+
+  GDA_INTERNAL_INDEX_CHAINED: table of DPointers into a heap of chained
+                              elements (gda_distributed_hashtable.h)
+  GDA_INTERNAL_INDEX_BUCKETS: cache line sized buckets, that hold the
+                              entries inline, full buckets spill into a
+                              chained overflow table
+                              (gda_bucket_hashtable.h)
+
+  stored as uint8_t
+ */
+#define GDA_INTERNAL_INDEX_CHAINED          0
+#define GDA_INTERNAL_INDEX_BUCKETS          1
+
+/**
+  layout of the labeled lightweight edges of the vertices
+  (implementation specific parameter of GDI_CreateDatabase, see
+  GDA_Init_params)
+
+  GDA_EDGE_LAYOUT_BLOCKS: blocks of 8 Bytes of metadata, 8 Bytes of
+                          label data and 8 DPointers
+  GDA_EDGE_LAYOUT_ARRAYS: contiguous arrays of DPointers, metadata and
+                          label data (gda_lightweight_edges.h)
+
+  stored as uint8_t
+ */
+#define GDA_EDGE_LAYOUT_BLOCKS              0
+#define GDA_EDGE_LAYOUT_ARRAYS              1
+
 /**
   error classses
 
@@ -181,6 +246,7 @@
 #define GDI_CONSTRAINT_NULL     NULL
 #define GDI_DATABASE_NULL       NULL
 #define GDI_EDGE_NULL           NULL
+#define GDI_INDEX_NULL          NULL
 #define GDI_LABEL_NULL          NULL
 #define GDI_PROPERTY_TYPE_NULL  NULL
 #define GDI_SUBCONSTRAINT_NULL  NULL
@@ -201,7 +267,60 @@ typedef struct GDI_Database_desc {
   GDI_Label_db_t* labels;
   GDI_Constraint_db_t* constraints;
   GDI_PropertyType_db_t* ptypes;
+  /**
+    internal index that translates application-level IDs to vertex
+    UIDs: only the member, that matches internal_index_type, is set up
+   */
+  uint8_t internal_index_type;
   GDA_RMAHashMap_desc_t* internal_index;
+  GDA_RMABucketHashMap_desc_t* internal_bucket_index;
+  /**
+    optional filter in front of the internal index, that answers
+    lookups of absent IDs without accessing the index (NULL if disabled)
+   */
+  GDA_RMABloomFilter_desc_t* internal_index_filter;
+  /**
+    process-local cache of recent translations from the internal index
+   */
+  GDA_TranslationCache_desc_t* translation_cache;
+  /**
+    layout of the labeled lightweight edges (GDA_EDGE_LAYOUT_*)
+   */
+  uint8_t edge_layout;
+  /**
+    whether the lightweight edges are stored compressed in the blocks
+   */
+  bool edge_compression;
+  /**
+    whether the lightweight edges are stored sorted by their DPointer
+   */
+  bool edge_sorted;
+  /**
+    number of blocks, above which the additional blocks of a vertex are
+    distributed over all processes (0 = disabled)
+   */
+  uint32_t hub_threshold;
+  /**
+    list of all secondary indexes (GDI_Index) of the database
+   */
+  GDA_List* indexes;
+  /**
+    bitmap with one bit per block, that is set for the primary blocks
+    of all vertices
+   */
+  GDA_RMABitmap_desc_t* vertex_bitmap;
+  /**
+    distributed hash table, that maps the edges with properties to the
+    first block of their record (gda_edge_record.h)
+   */
+  GDA_RMAHashMap_desc_t* edge_records;
+  /**
+    distributed hash table, that maps the codes of the dictionary
+    encoded property values to their first block, and the local cache
+    of the values (gda_dictionary.h)
+   */
+  GDA_RMAHashMap_desc_t* dictionary;
+  GDA_HashMap* dictionary_cache;
 
   /**
     list of all transactions that the local process
@@ -315,6 +434,12 @@ typedef struct GDI_Transaction_desc {
     structure and remove all elements at the end.
    */
   GDA_Vector* edges;
+  /**
+    keys of the edge records, that are removed during the commit
+
+    NULL if there are none
+   */
+  GDA_Vector* removed_edge_records;
   /**
     TODO: some sort of list/vector for all EdgeHolder
     objects associated with this object
@@ -365,14 +490,27 @@ typedef struct GDI_VertexHolder_desc {
     the first block serves as the primary block
    */
   GDA_Vector* blocks;
+  /**
+    number of blocks of the vertex, when it was loaded (0 for a vertex
+    created during this transaction)
+   */
+  uint32_t num_stored_blocks;
   /**
     pointer to the transaction that the vertex object is part of
    */
   GDI_Transaction transaction;
   /**
     pointer to the labeled lightweight edge buffer
+
+    NULL, while the edges are only available in the compressed form
    */
   uint64_t* lightweight_edge_data;
+  /**
+    compressed lightweight edges (NULL if there are none) and their
+    size in Bytes
+   */
+  uint8_t* lightweight_edge_encoded;
+  uint64_t lightweight_edge_encoded_size;
   /**
     pointer to the property/label data
    */
@@ -386,6 +524,16 @@ typedef struct GDI_VertexHolder_desc {
     (empty records, space after the last record)
    */
   uint64_t unused_space;
+  /**
+    directory of the property data (gda_property.h), NULL until the
+    properties are accessed for the first time
+   */
+  struct GDA_PropertyDirectory_desc* property_directory;
+  /**
+    offsets of the records in the property data, whose value is still
+    a dictionary code (gda_property.h), NULL if there are none
+   */
+  GDA_Vector* property_codes;
   /**
     size of the labeled lightweight edge buffer
    */
@@ -395,6 +543,33 @@ typedef struct GDI_VertexHolder_desc {
     only append at the back
    */
   uint32_t lightweight_edge_insert_offset;
+  /**
+    number of edge slots at the start, that are sorted by their DPointer
+   */
+  uint32_t lightweight_edge_sorted_slots;
+  /**
+    number of incoming, outgoing and undirected edges (indexed by the
+    position of the orientation bit in the metadata Byte), which are
+    stored in the primary block
+   */
+  uint32_t lightweight_edge_degrees[3];
+  /**
+    size in Bytes of the lightweight edge data in the blocks, when the
+    vertex was loaded
+   */
+  uint64_t lightweight_edge_stored_size;
+  /**
+    bitmap of the pages (block_size Bytes each) of the lightweight edge
+    data, that were changed during the transaction, and its size in
+    pages (NULL/0 if no page was changed)
+   */
+  uint64_t* lightweight_edge_dirty_pages;
+  uint32_t lightweight_edge_num_dirty_pages;
+  /**
+    all lightweight edge data from this offset (in Bytes) on was
+    changed (UINT64_MAX if there is no such offset)
+   */
+  uint64_t lightweight_edge_dirty_offset;
   /**
     incarnation field from the lock
    */
@@ -435,6 +610,19 @@ typedef struct GDI_VertexHolder_desc {
     false = vertex is already present in the database
    */
   bool creation_flag;
+  /**
+    flag to indicate, whether the labels or properties of the vertex
+    were changed during the transaction (write_flag is also set for
+    changes of the edges)
+   */
+  bool property_write_flag;
+  /**
+    entries (GDA_IndexEntry) of the vertex in the secondary indexes,
+    before its labels or properties were changed during this transaction
+
+    NULL if there are no such changes
+   */
+  GDA_Vector* index_entries;
 } GDI_VertexHolder_desc_t;
 
 typedef GDI_VertexHolder_desc_t* GDI_VertexHolder;
@@ -488,16 +676,141 @@ typedef struct GDI_EdgeHolder_desc {
    */
   uint32_t origin_lightweight_edge_offset;
   uint32_t target_lightweight_edge_offset;
+  /**
+    property data of the edge, which is kept in a separate record
+    (gda_edge_record.h), and the key, under which the record was looked
+    up
+
+    NULL until the properties of the edge are accessed
+   */
+  GDI_VertexHolder record;
+  uint64_t record_key;
 } GDI_EdgeHolder_desc_t;
 
 typedef GDI_EdgeHolder_desc_t* GDI_EdgeHolder;
 
 
+/**
+  secondary index data structure
+
+  An index maps the values of a single property type to the UIDs of all
+  vertices, that carry the value and the label of the index. A bitmap
+  index only keeps track of the vertices with the label of the index. It
+  is maintained when a transaction commits.
+ */
+typedef struct GDI_Index_desc {
+  /**
+    pointer to the associated database
+   */
+  void* db;
+  /**
+    only vertices with this label are indexed
+    (GDI_LABEL_NONE: all vertices)
+   */
+  GDI_Label label;
+  GDI_PropertyType ptype;
+  /**
+    distributed hash table, that holds an element per property value
+    (key: encoded value, value: vertex UID)
+
+    NULL for GDI_INDEX_BITMAP
+   */
+  GDA_RMAHashMap hashmap;
+  /**
+    bitmap with one bit per block, that is set for the primary blocks of
+    the indexed vertices (only GDI_INDEX_BITMAP)
+
+    shared with the database for GDI_LABEL_NONE
+   */
+  GDA_RMABitmap bitmap;
+  /**
+    Database keeps track of all indexes with a list.
+    Pointer to the element in the list that represents
+    the current index, so we can remove it in O(1).
+   */
+  GDA_Node* db_listptr;
+  /**
+    index type (GDI_INDEX_HASH, GDI_INDEX_ORDERED, GDI_INDEX_PREFIX or
+    GDI_INDEX_BITMAP)
+   */
+  uint8_t itype;
+  /**
+    flag to indicate, whether the keys are exact encodings of the
+    property values
+
+    true  = values fit into 64 bits, the key order is the value order
+    false = keys are hashes or prefixes of the values, so that the
+            results of a lookup have to be verified
+   */
+  bool exact_flag;
+  /**
+    the keys are the dictionary codes of the values (GDA_DictionaryCode)
+    instead of other hashes, so that the values of a dictionary encoded
+    property type don't have to be decoded to compute their keys
+   */
+  bool dictionary_flag;
+  /**
+    number of low order bits of a key, that are dropped to determine the
+    bucket of an element (only GDI_INDEX_ORDERED)
+
+    the same on all processes, it is only changed collectively, when the
+    buckets are adapted to the distribution of the keys
+   */
+  uint8_t range_shift;
+  /**
+    smallest and largest key in the index (only GDI_INDEX_ORDERED),
+    stored on process 0: the bounds only grow between two adaptations of
+    the buckets, and each process keeps the last bounds, that it has seen,
+    in known_bounds
+   */
+  RMA_Win win_bounds;
+  uint64_t* bounds;
+  uint64_t known_bounds[2];
+} GDI_Index_desc_t;
+
+typedef GDI_Index_desc_t* GDI_Index;
+
+
 typedef GDA_DPointer GDI_Vertex_uid;
 
 typedef GDA_Edge_uid GDI_Edge_uid;
 
 
+/**
+  iterator over the neighbors of a vertex (GDI_InitNeighborIterator),
+  that is usually allocated on the stack of the caller
+
+  all fields are internal
+ */
+typedef struct GDI_NeighborIterator_desc {
+  GDI_VertexHolder vertex;
+  /**
+    set of the label integer handles, that fulfill the constraint
+    (only used if label_flag is set)
+   */
+  uint64_t label_set[4];
+  bool label_flag;
+  uint8_t orientation;
+  /**
+    remaining hits in the current chunk of 8 edge slots
+   */
+  uint8_t mask;
+  uint32_t first_offset;
+  uint32_t chunk_index;
+  uint32_t num_chunks;
+  uint32_t num_slots;
+} GDI_NeighborIterator;
+
+
+/**
+  implementation specific parameters of GDI_CreateDatabase
+
+  The struct has to be zero-initialized (GDA_Init_params params = {0}),
+  before comm, memory_size and block_size are set: a value of 0 selects
+  the default of each of the other fields, which is the chained internal
+  index without a Bloom filter, the blocks layout of unsorted and
+  uncompressed lightweight edges and no distribution of hub vertices.
+ */
 typedef struct GDA_Init_params_struct {
   /**
     MPI communicator that identifies the processes
@@ -512,6 +825,40 @@ typedef struct GDA_Init_params_struct {
     size of the blocks used in the database (in Bytes)
    */
   uint32_t block_size;
+  /**
+    type of the internal index (GDA_INTERNAL_INDEX_CHAINED (default,
+    0) or GDA_INTERNAL_INDEX_BUCKETS)
+   */
+  uint8_t index_type;
+  /**
+    whether a Bloom filter is maintained in front of the internal index,
+    which speeds up the translation of IDs that do not exist (default:
+    false)
+   */
+  bool index_filter;
+  /**
+    layout of the labeled lightweight edges (GDA_EDGE_LAYOUT_BLOCKS
+    (default, 0) or GDA_EDGE_LAYOUT_ARRAYS)
+   */
+  uint8_t edge_layout;
+  /**
+    whether the lightweight edges are stored in a compressed form, that
+    is decoded on the first access to the edges of a vertex (default:
+    false)
+   */
+  bool edge_compression;
+  /**
+    whether the lightweight edges are stored sorted by their DPointer
+    (always the case with edge_compression, default: false)
+   */
+  bool edge_sorted;
+  /**
+    number of blocks, above which the additional blocks of a vertex
+    (hub vertex) are allocated round-robin on all processes instead of
+    the process of the primary block (default: 0, which disables the
+    distribution)
+   */
+  uint32_t hub_threshold;
 } GDA_Init_params;
 
 
@@ -531,6 +878,7 @@ int GDI_UpdateLabel( const char* name, GDI_Label label );
 int GDI_GetLabelFromName( GDI_Label* label, const char* name, GDI_Database graph_db );
 int GDI_GetNameOfLabel( char* name, size_t length, size_t* resultlength, GDI_Label label);
 int GDI_GetAllLabelsOfDatabase( GDI_Label array_of_labels[], size_t count, size_t* resultcount, GDI_Database graph_db );
+int GDI_SetPropertyTypesOfLabel( const GDI_PropertyType array_of_ptypes[], size_t count, GDI_Label label );
 
 /**
   constraint function prototypes
@@ -613,6 +961,8 @@ int GDI_AddPropertyToVertex( const void* value, size_t count, GDI_PropertyType p
 int GDI_GetAllPropertyTypesOfVertex( GDI_PropertyType array_of_ptypes[], size_t count, size_t* resultcount, GDI_VertexHolder vertex );
 int GDI_GetPropertiesOfVertex( void* buf, size_t buf_count, size_t* buf_resultcount, size_t array_of_offsets[], size_t offset_count,
   size_t* offset_resultcount, GDI_PropertyType ptype, GDI_VertexHolder vertex );
+int GDI_GetPropertiesOfVertices( void* array_of_bufs[], const size_t array_of_buf_counts[], size_t array_of_buf_resultcounts[], size_t* array_of_offsets[],
+  const GDI_PropertyType array_of_ptypes[], size_t num_ptypes, const GDI_Vertex_uid array_of_uids[], size_t count, GDI_Transaction transaction );
 int GDI_RemovePropertiesFromVertex( GDI_PropertyType ptype, GDI_VertexHolder vertex );
 int GDI_RemoveSpecificPropertyFromVertex( const void* value, size_t count, GDI_PropertyType ptype, GDI_VertexHolder vertex );
 int GDI_UpdatePropertyOfVertex( const void* value, size_t count, GDI_PropertyType ptype, GDI_VertexHolder vertex );
@@ -621,12 +971,28 @@ int GDI_SetPropertyOfVertex( const void* value, size_t count, GDI_PropertyType p
 
 /**
   edge function prototypes
+
+  GDI_AssociateEdge returns the edge object of an edge UID (see
+  GDI_GetEdgesOfVertex), whose labels and properties can then be
+  accessed. The properties of parallel edges (same vertices, direction
+  type and label) are kept apart by a record index with four bits, so at
+  most 16 of them can have properties: adding properties to a further
+  one, or moving an edge with properties into such a group (by changing
+  its vertices, direction type or label), returns
+  GDI_ERROR_TRANSACTION_CRITICAL.
  */
 int GDI_CreateEdge( int dtype, GDI_VertexHolder origin, GDI_VertexHolder target, GDI_EdgeHolder* edge );
+int GDI_AssociateEdge( GDI_Edge_uid internal_uid, GDI_Transaction transaction, GDI_EdgeHolder* edge );
 int GDI_FreeEdge( GDI_EdgeHolder* edge );
 
 int GDI_GetVerticesOfEdge( GDI_Vertex_uid* origin_uid, GDI_Vertex_uid* target_uid, GDI_EdgeHolder edge );
 int GDI_GetNeighborVerticesOfVertex( GDI_Vertex_uid array_of_uids[], size_t count, size_t* resultcount, GDI_Constraint constraint, int edge_orientation, GDI_VertexHolder vertex );
+int GDI_GetNeighborVerticesOfVertexWithTargetConstraint( GDI_Vertex_uid array_of_uids[], size_t count, size_t* resultcount, GDI_Constraint constraint,
+  GDI_Constraint target_constraint, int edge_orientation, GDI_VertexHolder vertex );
+int GDI_InitNeighborIterator( GDI_NeighborIterator* iterator, GDI_Constraint constraint, int edge_orientation, GDI_VertexHolder vertex );
+int GDI_NextNeighborVertex( GDI_Vertex_uid* uid, bool* found_flag, GDI_NeighborIterator* iterator );
+int GDI_GetDegreeOfVertex( size_t* degree, int edge_orientation, GDI_VertexHolder vertex );
+int GDI_GetNumCommonNeighborsOfVertices( size_t* resultcount, GDI_Constraint constraint, int edge_orientation, GDI_VertexHolder vertex1, GDI_VertexHolder vertex2 );
 int GDI_GetDirectionTypeOfEdge( int* dtype, GDI_EdgeHolder edge );
 int GDI_SetOriginVertexOfEdge( GDI_VertexHolder origin_vertex, GDI_EdgeHolder edge );
 int GDI_SetTargetVertexOfEdge( GDI_VertexHolder target_vertex, GDI_EdgeHolder edge );
@@ -637,6 +1003,9 @@ int GDI_RemoveLabelFromEdge( GDI_Label label, GDI_EdgeHolder edge );
 int GDI_GetAllLabelsOfEdge( GDI_Label array_of_labels[], size_t count, size_t* resultcount, GDI_EdgeHolder edge );
 
 int GDI_AddPropertyToEdge( const void* value, size_t count, GDI_PropertyType ptype, GDI_EdgeHolder edge );
+int GDI_GetAllPropertyTypesOfEdge( GDI_PropertyType array_of_ptypes[], size_t count, size_t* resultcount, GDI_EdgeHolder edge );
+int GDI_GetPropertiesOfEdge( void* buf, size_t buf_count, size_t* buf_resultcount, size_t array_of_offsets[], size_t offset_count,
+  size_t* offset_resultcount, GDI_PropertyType ptype, GDI_EdgeHolder edge );
 int GDI_RemovePropertiesFromEdge( GDI_PropertyType ptype, GDI_EdgeHolder edge );
 int GDI_RemoveSpecificPropertyFromEdge( const void* value, size_t count, GDI_PropertyType ptype, GDI_EdgeHolder edge );
 int GDI_UpdatePropertyOfEdge( const void* value, size_t count, GDI_PropertyType ptype, GDI_EdgeHolder edge );
@@ -647,6 +1016,18 @@ int GDI_SetPropertyOfEdge( const void* value, size_t count, GDI_PropertyType pty
   index function prototypes
  */
 int GDI_TranslateVertexID( bool* found_flag, GDI_Vertex_uid* internal_uid, GDI_Label label, const void* external_id, size_t size, GDI_Transaction transaction );
+int GDI_TranslateVertexIDs( bool array_of_found_flags[], GDI_Vertex_uid array_of_internal_uids[], const GDI_Label array_of_labels[], const void* array_of_external_ids, size_t size, size_t count, GDI_Transaction transaction );
+
+int GDI_CreateIndex( int itype, GDI_Label label, GDI_PropertyType ptype, GDI_Database graph_db, GDI_Index* index );
+int GDI_FreeIndex( GDI_Index* index );
+int GDI_GetTypeOfIndex( int* itype, GDI_Index index );
+int GDI_GetAllLabelsOfIndex( GDI_Label array_of_labels[], size_t count, size_t* resultcount, GDI_Index index );
+int GDI_GetAllPropertyTypesOfIndex( GDI_PropertyType array_of_ptypes[], size_t count, size_t* resultcount, GDI_Index index );
+int GDI_GetAllIndexesOfDatabase( GDI_Index array_of_indexes[], size_t count, size_t* resultcount, GDI_Database graph_db );
+int GDI_GetVerticesOfIndexByValue( GDI_Vertex_uid array_of_uids[], size_t count, size_t* resultcount, const void* value, size_t value_count, GDI_Index index, GDI_Transaction transaction );
+int GDI_GetVerticesOfIndexByRange( GDI_Vertex_uid array_of_uids[], size_t count, size_t* resultcount, const void* lower_value, const void* upper_value, GDI_Index index, GDI_Transaction transaction );
+int GDI_GetVerticesOfIndexByPrefix( GDI_Vertex_uid array_of_uids[], size_t count, size_t* resultcount, const void* prefix, size_t length, GDI_Index index, GDI_Transaction transaction );
+int GDI_GetLocalVerticesOfIndex( GDI_Vertex_uid array_of_uids[], size_t count, size_t* resultcount, GDI_Index index, GDI_Transaction transaction );
 
 /**
   database function prototypes
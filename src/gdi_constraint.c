@@ -95,6 +95,7 @@ int GDI_CreateConstraint( GDI_Database graph_db, GDI_Constraint* constraint ) {
   assert(constraint != NULL);
   (*constraint)->stale = GDA_CONSTRAINT_VALID;
   (*constraint)->db = graph_db;
+  (*constraint)->compiled = NULL;
 
   // register the constraint at the database
   GDA_list_create( &((*constraint)->subconstraints), sizeof(void*));
@@ -127,6 +128,7 @@ int GDI_FreeConstraint( GDI_Constraint* constraint ) {
   }
 
   GDA_list_free(&((*constraint)->subconstraints));
+  GDA_InvalidateCompiledConstraint(*constraint);
   free(*constraint);
   (*constraint) = GDI_CONSTRAINT_NULL;
   return GDI_SUCCESS;
@@ -331,6 +333,9 @@ int GDI_AddSubconstraintToConstraint( GDI_Subconstraint subconstraint,
   // add the subconstraint to the list
   GDA_list_push_back(constraint->subconstraints, &copy);
 
+  // the constraint has to be compiled again on its next use
+  GDA_InvalidateCompiledConstraint(constraint);
+
   // note: we do not need to store on the subconstraint a reference to the
   // list of subconstraints that the associated constraint holds,
   // since the subconstraint will only be removed when
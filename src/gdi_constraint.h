@@ -46,6 +46,9 @@
     - A reference to the graph database. That way one can efficiently
       check if objects belong to the same database.
     - A flag indicating if the constraint is stale or not.
+    - The compiled form of the constraint (gda_constraint.h), which is
+      built on the first use of the constraint and dropped, when a
+      subconstraint is added or the constraint becomes stale.
 
   A GDI_Subconstraint is a pointer to a struct (GDI_Subconstraint_desc_t) consisting of:
     - A list of label conditions (see below). It is needed to track the
@@ -133,6 +136,7 @@ typedef struct GDI_Constraint_desc {
   GDA_Node* node;
   void* db;
   uint8_t stale;
+  struct GDA_CompiledConstraint_desc* compiled;
 } GDI_Constraint_desc_t;
 
 /**
@@ -9,7 +9,13 @@
 #include "gdi.h"
 #include "gda_block.h"
 #include "gda_constraint.h"
+#include "gda_dictionary.h"
+#include "gda_edge_record.h"
+#include "gda_index.h"
+#include "gda_internal_index.h"
 #include "gda_label.h"
+#include "gda_lightweight_edges.h"
+#include "gda_property.h"
 #include "gda_property_type.h"
 #include "gda_vertex.h"
 
@@ -59,6 +65,14 @@ int GDI_CreateDatabase( void* params, size_t size, GDI_Database* graph_db ) {
     return GDI_ERROR_BLOCK_SIZE;
   }
 
+  if( (gda_params->index_type != GDA_INTERNAL_INDEX_CHAINED) && (gda_params->index_type != GDA_INTERNAL_INDEX_BUCKETS) ) {
+    return GDI_ERROR_ARGUMENT;
+  }
+
+  if( (gda_params->edge_layout != GDA_EDGE_LAYOUT_BLOCKS) && (gda_params->edge_layout != GDA_EDGE_LAYOUT_ARRAYS) ) {
+    return GDI_ERROR_ARGUMENT;
+  }
+
 #ifdef RMA_USE_FOMPI
   /**
     DMAPP requires a 4 Byte alignment for local and remote address and
@@ -87,6 +101,10 @@ int GDI_CreateDatabase( void* params, size_t size, GDI_Database* graph_db ) {
   assert(internal_graph_db != NULL);
   internal_graph_db->memsize = gda_params->memory_size;
   internal_graph_db->block_size = gda_params->block_size;
+  internal_graph_db->edge_layout = gda_params->edge_layout;
+  internal_graph_db->edge_compression = gda_params->edge_compression;
+  internal_graph_db->edge_sorted = gda_params->edge_sorted;
+  internal_graph_db->hub_threshold = gda_params->hub_threshold;
   /**
     duplicate the MPI communicator because of section 6.9.1 of the
     MPI standard
@@ -143,6 +161,11 @@ int GDI_CreateDatabase( void* params, size_t size, GDI_Database* graph_db ) {
    */
   GDA_InitBlock( *graph_db );
 
+  /**
+    bitmap of the primary blocks of all vertices
+   */
+  GDA_CreateRMABitmap( (*graph_db)->win_blocks_size / (*graph_db)->block_size, (*graph_db)->comm, &((*graph_db)->vertex_bitmap) );
+
   /**
     create the list that keeps track of all transactions,
     in which the local process takes part
@@ -154,6 +177,8 @@ int GDI_CreateDatabase( void* params, size_t size, GDI_Database* graph_db ) {
   (*graph_db)->labels = malloc( sizeof(GDI_Label_db_t) );
   assert( (*graph_db)->labels != NULL);
   (*graph_db)->labels->label_max = 1; // 0 is occupied by GDI_LABEL_NONE
+  (*graph_db)->labels->schemas = NULL;
+  (*graph_db)->labels->num_schemas = 0;
   GDA_list_create( &((*graph_db)->labels->labels), sizeof(void*));
   assert((*graph_db)->labels->labels != NULL);
   GDA_hashmap_create( &((*graph_db)->labels->name_to_address), sizeof(uint64_t), 16, sizeof(void*), &GDA_int64_to_int);
@@ -176,7 +201,7 @@ int GDI_CreateDatabase( void* params, size_t size, GDI_Database* graph_db ) {
   /* Property type data structures */
   (*graph_db)->ptypes = malloc( sizeof(GDI_PropertyType_db_t) );
   assert( (*graph_db)->ptypes != NULL);
-  (*graph_db)->ptypes->ptype_max = 4; // 0 to 3 is occupied by the predefined property types
+  (*graph_db)->ptypes->ptype_max = 5; // 0 to 3 is occupied by the predefined property types, 4 by the property slots (gda_property.h)
   GDA_list_create( &((*graph_db)->ptypes->ptypes), sizeof(void*));
   assert((*graph_db)->ptypes->ptypes != NULL);
   GDA_hashmap_create( &((*graph_db)->ptypes->name_to_address), sizeof(uint64_t), 16, sizeof(void*), &GDA_int64_to_int);
@@ -186,11 +211,23 @@ int GDI_CreateDatabase( void* params, size_t size, GDI_Database* graph_db ) {
 
   /**
     set up the distributed hashtable for the internal index
+   */
+  GDA_CreateInternalIndex( gda_params->index_type, gda_params->index_filter, internal_graph_db );
+
+  /**
+    list of the secondary indexes
+   */
+  GDA_list_create( &((*graph_db)->indexes), sizeof(GDI_Index) /* element size */ );
 
-    calculate the total number of blocks in the database first
+  /**
+    distributed hashtable for the records of the edge properties
    */
-  size_t num_blocks = internal_graph_db->memsize / internal_graph_db->block_size * internal_graph_db->commsize;
-  GDA_CreateRMAHashMap( num_blocks/3 /* table size */, 2 * num_blocks /* heap size */, internal_graph_db->comm, &(internal_graph_db->internal_index) );
+  GDA_CreateEdgeRecords( *graph_db );
+
+  /**
+    distributed hashtable for the dictionary encoded property values
+   */
+  GDA_CreateDictionary( *graph_db );
 
   /**
     ensure that all processes have set up and initialized their remote
@@ -215,7 +252,11 @@ int GDI_FreeDatabase( GDI_Database* graph_db ) {
   }
 
   GDA_FreeBlock( *graph_db );
-  GDA_FreeRMAHashMap( &((*graph_db)->internal_index) );
+  GDA_FreeInternalIndex( *graph_db );
+  GDA_FreeAllIndexes( *graph_db );
+  GDA_FreeEdgeRecords( *graph_db );
+  GDA_FreeDictionary( *graph_db );
+  GDA_FreeRMABitmap( &((*graph_db)->vertex_bitmap) );
 
   /**
     free duplicate of the original communicator
@@ -237,8 +278,9 @@ int GDI_FreeDatabase( GDI_Database* graph_db ) {
     for( size_t i=0 ; i<vec_size ; i++ ) {
       // TODO: might be additional work necessary
       GDI_VertexHolder vertex = *(GDI_VertexHolder*)GDA_vector_at( transaction->vertices, i );
-      free( vertex->property_data );
-      free( vertex->lightweight_edge_data );
+      GDA_FreeIndexEntries( vertex );
+      GDA_LinearScanningFreePropertyList( vertex );
+      GDA_LightweightEdgesFree( vertex );
       GDA_list_free( &(vertex->edges) );
       GDA_vector_free( &(vertex->blocks) );
       free( vertex );
@@ -251,9 +293,14 @@ int GDI_FreeDatabase( GDI_Database* graph_db ) {
     vec_size = transaction->edges->size;
     for( size_t i=0 ; i<vec_size ; i++ ) {
       // TODO: might be additional work necessary
-      free( *(GDI_EdgeHolder*)GDA_vector_at( transaction->edges, i ) );
+      GDI_EdgeHolder edge = *(GDI_EdgeHolder*)GDA_vector_at( transaction->edges, i );
+      GDA_FreeEdgeRecord( edge );
+      free( edge );
     }
     GDA_vector_free( &(transaction->edges) );
+    if( transaction->removed_edge_records != NULL ) {
+      GDA_vector_free( &(transaction->removed_edge_records) );
+    }
 
     /**
       free the vertex translation hash map
@@ -270,6 +317,12 @@ int GDI_FreeDatabase( GDI_Database* graph_db ) {
 
   /* Free all label data structures */
   GDA_FreeAllLabel(*graph_db);
+  for( uint32_t i=0 ; i<(*graph_db)->labels->num_schemas ; i++ ) {
+    if( (*graph_db)->labels->schemas[i] != NULL ) {
+      GDA_FreePropertySchema( (*graph_db)->labels->schemas[i] );
+    }
+  }
+  free((*graph_db)->labels->schemas);
   GDA_hashmap_free( &((*graph_db)->labels->name_to_address) );
   GDA_hashmap_free( &((*graph_db)->labels->handle_to_address ) );
   GDA_list_free( &((*graph_db)->labels->labels));
@@ -10,8 +10,49 @@
 #include <stdio.h>
 
 #include "gdi.h"
+#include "gda_edge_record.h"
 #include "gda_lightweight_edges.h"
 #include "gda_lock.h"
+#include "gda_property.h"
+
+/**
+  finds the lightweight entry of the edge at edge_offset of vertex in the
+  lightweight edges of other_vertex
+ */
+static uint32_t GDA_FindOtherLightweightEdge( uint32_t edge_offset, int edge_orientation, uint8_t label_int_handle, GDI_VertexHolder vertex, GDI_VertexHolder other_vertex );
+
+/**
+  the properties of an edge changed: the record is written during the
+  commit, while the vertices only have to be written back, if the edge
+  didn't have a record before
+
+  returns false, if all record indexes of the parallel edges are taken
+ */
+static bool GDA_SetEdgeRecordWriteFlags( GDI_EdgeHolder edge ) {
+  if( !GDA_EdgeHasRecord( edge ) ) {
+    /**
+      entries of parallel edges without a record can't be told apart, so
+      another edge object might have claimed the entry on the target
+      vertex already: pick the first one, that is still unmarked
+     */
+    uint8_t *metadata, *label;
+    GDA_LightweightEdgesGetMetadataPointerWithOffset( &metadata, edge->origin, edge->origin_lightweight_edge_offset );
+    GDA_LightweightEdgesGetLabelPointerWithOffset( &label, edge->origin, edge->origin_lightweight_edge_offset );
+    uint32_t target_offset = GDA_FindOtherLightweightEdge( edge->origin_lightweight_edge_offset, (*metadata & GDA_LIGHTWEIGHT_EDGES_ORIENTATION) + 256 /* GDI_EDGE_* */, *label, edge->origin, edge->target );
+    assert( target_offset != 0 );
+    edge->target_lightweight_edge_offset = target_offset;
+
+    if( !GDA_MarkEdgeRecord( edge ) ) {
+      return false;
+    }
+    edge->origin->write_flag = true;
+    edge->target->write_flag = true;
+  }
+  edge->record->write_flag = true;
+  edge->write_flag = true;
+  edge->transaction->write_flag = true;
+  return true;
+}
 
 int GDI_CreateEdge( int dtype, GDI_VertexHolder origin, GDI_VertexHolder target, GDI_EdgeHolder* edge ) {
   /**
@@ -74,6 +115,7 @@ int GDI_CreateEdge( int dtype, GDI_VertexHolder origin, GDI_VertexHolder target,
   (*edge)->transaction = origin->transaction;
   (*edge)->delete_flag = false;
   (*edge)->write_flag = true;
+  (*edge)->record = NULL;
   origin->write_flag = true;
   target->write_flag = true;
   origin->transaction->write_flag = true;
@@ -108,6 +150,151 @@ int GDI_CreateEdge( int dtype, GDI_VertexHolder origin, GDI_VertexHolder target,
   return GDI_SUCCESS;
 }
 
+static uint32_t GDA_FindOtherLightweightEdge( uint32_t edge_offset, int edge_orientation, uint8_t label_int_handle, GDI_VertexHolder vertex, GDI_VertexHolder other_vertex ) {
+  GDA_DPointer vertex_uid = *(GDA_DPointer*) vertex->blocks->data;
+
+  /**
+    both entries of an edge carry the same record bit and record index
+   */
+  uint8_t* edge_metadata;
+  GDA_LightweightEdgesGetMetadataPointerWithOffset( &edge_metadata, vertex, edge_offset );
+  uint8_t record_bits = *edge_metadata & ~GDA_LIGHTWEIGHT_EDGES_ORIENTATION;
+
+  if( vertex != other_vertex ) {
+    return GDA_LightweightEdgesFindEdge( edge_orientation, vertex_uid, label_int_handle, record_bits, other_vertex );
+  }
+
+  /**
+    self-loop: both entries are stored with the same vertex, so the entry
+    at edge_offset has to be skipped
+   */
+  uint8_t other_orientation;
+  if( edge_orientation == GDI_EDGE_UNDIRECTED ) {
+    other_orientation = (uint8_t) GDI_EDGE_UNDIRECTED;
+  } else {
+    if( edge_orientation == GDI_EDGE_INCOMING ) {
+      other_orientation = (uint8_t) GDI_EDGE_OUTGOING;
+    } else {
+      other_orientation = (uint8_t) GDI_EDGE_INCOMING;
+    }
+  }
+
+  uint32_t offset;
+  for( offset=2 ; offset<vertex->lightweight_edge_insert_offset ; offset=GDA_LightweightEdgesNextOffset( offset, vertex ) ) {
+    if( offset == edge_offset ) {
+      continue;
+    }
+    uint8_t *metadata, *label;
+    GDA_LightweightEdgesGetMetadataPointerWithOffset( &metadata, vertex, offset );
+    GDA_LightweightEdgesGetLabelPointerWithOffset( &label, vertex, offset );
+    if( (vertex->lightweight_edge_data[offset] == vertex_uid) && (*metadata & other_orientation) && ((*metadata & ~GDA_LIGHTWEIGHT_EDGES_ORIENTATION) == record_bits) && (*label == label_int_handle) ) {
+      return offset;
+    }
+  }
+
+  return 0;
+}
+
+
+int GDI_AssociateEdge( GDI_Edge_uid internal_uid, GDI_Transaction transaction, GDI_EdgeHolder* edge ) {
+  /**
+    check the input arguments
+   */
+  if( edge == NULL ) {
+    return GDI_ERROR_BUFFER;
+  }
+
+  if( transaction == GDI_TRANSACTION_NULL ) {
+    return GDI_ERROR_TRANSACTION;
+  }
+
+  GDA_DPointer vertex_uid;
+  uint32_t edge_offset;
+  GDA_UnpackEdgeUid( &vertex_uid, &edge_offset, internal_uid );
+
+  /**
+    GDI_AssociateVertex checks the vertex part of the uid
+   */
+  GDI_VertexHolder vertex;
+  int ret = GDI_AssociateVertex( vertex_uid, transaction, &vertex );
+  if( ret != GDI_SUCCESS ) {
+    return ret;
+  }
+
+  GDA_LightweightEdgesEnsureDecoded( vertex );
+  if( !GDA_LightweightEdgesIsEdgeOffset( edge_offset, vertex ) ) {
+    return GDI_ERROR_UID;
+  }
+
+  /**
+    check whether the edge is already associated with this transaction
+   */
+  GDA_Node* edge_node = vertex->edges->head;
+  while( edge_node != NULL ) {
+    GDI_EdgeHolder associated_edge = *(GDI_EdgeHolder*)(edge_node->value);
+    if( !(associated_edge->delete_flag) &&
+      (((associated_edge->origin == vertex) && (associated_edge->origin_lightweight_edge_offset == edge_offset)) ||
+       ((associated_edge->target == vertex) && (associated_edge->target_lightweight_edge_offset == edge_offset))) ) {
+      *edge = associated_edge;
+      return GDI_SUCCESS;
+    }
+    edge_node = edge_node->next;
+  }
+
+  GDA_DPointer other_uid;
+  int edge_orientation;
+  uint8_t label_int_handle;
+  bool found_flag;
+  GDA_LightweightEdgesGetEdge( &other_uid, &edge_orientation, edge_offset, vertex, &found_flag );
+  if( !found_flag ) {
+    /**
+      the edge was deleted
+     */
+    return GDI_ERROR_EDGE;
+  }
+  GDA_LightweightEdgesGetLabel( &label_int_handle, edge_offset, vertex, &found_flag );
+  assert( found_flag );
+
+  GDI_VertexHolder other_vertex;
+  ret = GDI_AssociateVertex( other_uid, transaction, &other_vertex );
+  if( ret != GDI_SUCCESS ) {
+    return ret;
+  }
+
+  uint32_t other_edge_offset = GDA_FindOtherLightweightEdge( edge_offset, edge_orientation, label_int_handle, vertex, other_vertex );
+  assert( other_edge_offset != 0 );
+
+  /**
+    passed all checks and the edge is not associated with this
+    transaction, so it is safe to create the output buffer
+   */
+  *edge = malloc( sizeof(GDI_EdgeHolder_desc_t) );
+  assert( *edge != NULL );
+
+  if( edge_orientation == GDI_EDGE_INCOMING ) {
+    (*edge)->origin = other_vertex;
+    (*edge)->target = vertex;
+    (*edge)->origin_lightweight_edge_offset = other_edge_offset;
+    (*edge)->target_lightweight_edge_offset = edge_offset;
+  } else {
+    (*edge)->origin = vertex;
+    (*edge)->target = other_vertex;
+    (*edge)->origin_lightweight_edge_offset = edge_offset;
+    (*edge)->target_lightweight_edge_offset = other_edge_offset;
+  }
+  (*edge)->transaction = transaction;
+  (*edge)->delete_flag = false;
+  (*edge)->write_flag = false;
+  (*edge)->record = NULL;
+
+  (*edge)->origin_elist_ptr = GDA_list_push_back( (*edge)->origin->edges, edge );
+  (*edge)->target_elist_ptr = GDA_list_push_back( (*edge)->target->edges, edge );
+
+  GDA_vector_push_back( transaction->edges, edge );
+
+  return GDI_SUCCESS;
+}
+
 
 int GDI_FreeEdge( GDI_EdgeHolder* edge ) {
   /**
@@ -166,6 +353,14 @@ int GDI_FreeEdge( GDI_EdgeHolder* edge ) {
     transaction is closed
    */
 
+  /**
+    the record is found through the lightweight entries, so its key has
+    to be determined before they are removed
+   */
+  if( GDA_EdgeHasRecord( *edge ) ) {
+    GDA_RemoveEdgeRecord( GDA_EdgeRecordKeyOfEdge( *edge ), (*edge)->transaction );
+  }
+
   /**
     delete the edge from the lightweight edge data structure of both vertices
    */
@@ -234,7 +429,7 @@ int GDI_GetDirectionTypeOfEdge( int* dtype, GDI_EdgeHolder edge ) {
    */
   uint8_t* edge_orientation;
   GDA_LightweightEdgesGetMetadataPointerWithOffset( &edge_orientation, edge->origin, edge->origin_lightweight_edge_offset );
-  if( *edge_orientation == 4 /* GDI_EDGE_UNDIRECTED - 256 */ ) {
+  if( (*edge_orientation & GDA_LIGHTWEIGHT_EDGES_ORIENTATION) == 4 /* GDI_EDGE_UNDIRECTED - 256 */ ) {
     *dtype = GDI_EDGE_UNDIRECTED;
   } else {
     *dtype = GDI_EDGE_DIRECTED;
@@ -318,12 +513,22 @@ int GDI_SetOriginVertexOfEdge( GDI_VertexHolder origin_vertex, GDI_EdgeHolder ed
   GDA_LightweightEdgesGetMetadataPointerWithOffset( &edge_orientation, edge->origin, edge->origin_lightweight_edge_offset );
 
   int orientation;
-  if( *edge_orientation == 4 /* GDI_EDGE_UNDIRECTED - 256 */ ) {
+  if( (*edge_orientation & GDA_LIGHTWEIGHT_EDGES_ORIENTATION) == 4 /* GDI_EDGE_UNDIRECTED - 256 */ ) {
     orientation = GDI_EDGE_UNDIRECTED;
   } else {
     orientation = GDI_EDGE_OUTGOING;
   }
 
+  /**
+    the key of the record changes with the origin vertex, so it has to be
+    fetched under the old one, and the new lightweight entry keeps the
+    record bit
+   */
+  bool record_flag = GDA_EdgeHasRecord( edge );
+  if( record_flag ) {
+    GDA_LoadEdgeRecord( edge );
+  }
+
   bool removed_flag;
   GDA_LightweightEdgesRemove( edge->origin_lightweight_edge_offset, edge->origin, &removed_flag );
   assert( removed_flag );
@@ -341,6 +546,11 @@ int GDI_SetOriginVertexOfEdge( GDI_VertexHolder origin_vertex, GDI_EdgeHolder ed
   origin_vertex->transaction->write_flag = true;
   edge->origin = origin_vertex;
 
+  if( record_flag && !GDA_MarkEdgeRecord( edge ) ) {
+    edge->transaction->critical_flag = true;
+    return GDI_ERROR_TRANSACTION_CRITICAL;
+  }
+
   return GDI_SUCCESS;
 }
 
@@ -419,12 +629,22 @@ int GDI_SetTargetVertexOfEdge( GDI_VertexHolder target_vertex, GDI_EdgeHolder ed
   GDA_LightweightEdgesGetMetadataPointerWithOffset( &edge_orientation, edge->target, edge->target_lightweight_edge_offset );
 
   int orientation;
-  if( *edge_orientation == 4 /* GDI_EDGE_UNDIRECTED - 256 */ ) {
+  if( (*edge_orientation & GDA_LIGHTWEIGHT_EDGES_ORIENTATION) == 4 /* GDI_EDGE_UNDIRECTED - 256 */ ) {
     orientation = GDI_EDGE_UNDIRECTED;
   } else {
     orientation = GDI_EDGE_INCOMING;
   }
 
+  /**
+    the key of the record changes with the target vertex, so it has to be
+    fetched under the old one, and the new lightweight entry keeps the
+    record bit
+   */
+  bool record_flag = GDA_EdgeHasRecord( edge );
+  if( record_flag ) {
+    GDA_LoadEdgeRecord( edge );
+  }
+
   bool removed_flag;
   GDA_LightweightEdgesRemove( edge->target_lightweight_edge_offset, edge->target, &removed_flag );
   assert( removed_flag );
@@ -442,6 +662,11 @@ int GDI_SetTargetVertexOfEdge( GDI_VertexHolder target_vertex, GDI_EdgeHolder ed
   target_vertex->transaction->write_flag = true;
   edge->target = target_vertex;
 
+  if( record_flag && !GDA_MarkEdgeRecord( edge ) ) {
+    edge->transaction->critical_flag = true;
+    return GDI_ERROR_TRANSACTION_CRITICAL;
+  }
+
   return GDI_SUCCESS;
 }
 
@@ -492,6 +717,13 @@ int GDI_SetDirectionTypeOfEdge( int dtype, GDI_EdgeHolder edge ) {
     }
   }
 
+  /**
+    the key of the record depends on the direction type
+   */
+  if( GDA_EdgeHasRecord( edge ) ) {
+    GDA_LoadEdgeRecord( edge );
+  }
+
   uint32_t origin_orientation, target_orientation;
   if( dtype == GDI_EDGE_UNDIRECTED ){
     origin_orientation = GDI_EDGE_UNDIRECTED;
@@ -504,6 +736,15 @@ int GDI_SetDirectionTypeOfEdge( int dtype, GDI_EdgeHolder edge ) {
   GDA_LightweightEdgesSetEdgeOrientation( origin_orientation, edge->origin_lightweight_edge_offset, edge->origin );
   GDA_LightweightEdgesSetEdgeOrientation( target_orientation, edge->target_lightweight_edge_offset, edge->target );
 
+  /**
+    the record index has to be unique among the parallel edges with the
+    new direction type
+   */
+  if( GDA_EdgeHasRecord( edge ) && !GDA_MarkEdgeRecord( edge ) ) {
+    edge->transaction->critical_flag = true;
+    return GDI_ERROR_TRANSACTION_CRITICAL;
+  }
+
   edge->write_flag = true;
   edge->origin->write_flag = true;
   edge->target->write_flag = true;
@@ -569,6 +810,13 @@ int GDI_AddLabelToEdge( GDI_Label label, GDI_EdgeHolder edge ) {
     }
   }
 
+  /**
+    the key of the record depends on the label
+   */
+  if( GDA_EdgeHasRecord( edge ) ) {
+    GDA_LoadEdgeRecord( edge );
+  }
+
   /**
     since we have only space for edge label right now,
     we will overwrite the existing one
@@ -576,6 +824,11 @@ int GDI_AddLabelToEdge( GDI_Label label, GDI_EdgeHolder edge ) {
   GDA_LightweightEdgesSetLabel( label->int_handle, edge->origin_lightweight_edge_offset, edge->origin );
   GDA_LightweightEdgesSetLabel( label->int_handle, edge->target_lightweight_edge_offset, edge->target );
 
+  if( GDA_EdgeHasRecord( edge ) && !GDA_MarkEdgeRecord( edge ) ) {
+    edge->transaction->critical_flag = true;
+    return GDI_ERROR_TRANSACTION_CRITICAL;
+  }
+
   // TODO: potential index updates
 
   edge->write_flag = true;
@@ -653,9 +906,18 @@ int GDI_RemoveLabelFromEdge( GDI_Label label, GDI_EdgeHolder edge ) {
     }
   }
 
+  if( GDA_EdgeHasRecord( edge ) ) {
+    GDA_LoadEdgeRecord( edge );
+  }
+
   GDA_LightweightEdgesSetLabel( GDI_LABEL_NONE->int_handle, edge->origin_lightweight_edge_offset, edge->origin );
   GDA_LightweightEdgesSetLabel( GDI_LABEL_NONE->int_handle, edge->target_lightweight_edge_offset, edge->target );
 
+  if( GDA_EdgeHasRecord( edge ) && !GDA_MarkEdgeRecord( edge ) ) {
+    edge->transaction->critical_flag = true;
+    return GDI_ERROR_TRANSACTION_CRITICAL;
+  }
+
   // TODO: update the index (maybe)
 
   edge->write_flag = true;
@@ -764,10 +1026,6 @@ int GDI_AddPropertyToEdge( const void* value, size_t count, GDI_PropertyType pty
     }
   }
 
-  // TODO: check for GDI_ERROR_PROPERTY_TYPE_EXISTS, if ptype->etype == GDI_SINGLE_ENTITY
-
-  // TODO: check whether property already exists on edge (GDI_ERROR_PROPERTY_EXISTS)
-
   /**
     passed all input checks
    */
@@ -794,14 +1052,129 @@ int GDI_AddPropertyToEdge( const void* value, size_t count, GDI_PropertyType pty
     }
   }
 
-  fprintf( stderr, "GDI_AddPropertyToEdge implements only input parsing and should not be used.\n" );
+  GDA_LoadEdgeRecord( edge );
+  int ret = GDA_LinearScanningAddProperty( ptype, value, count, edge->record );
 
-  // TODO: probably have to handle GDI_PROPERTY_TYPE_ID differently
+  if( ret == GDI_SUCCESS ) {
+    /**
+      a new property was inserted into the list
+     */
+    if( !GDA_SetEdgeRecordWriteFlags( edge ) ) {
+      edge->transaction->critical_flag = true;
+      return GDI_ERROR_TRANSACTION_CRITICAL;
+    }
+    // TODO: probably have to handle GDI_PROPERTY_TYPE_ID differently
+  } else {
+    if( ret == GDI_ERROR_PROPERTY_EXISTS ) {
+      /**
+        don't treat this as an error on the GDI level
+       */
+      ret = GDI_SUCCESS;
+    }
+  }
 
-  edge->write_flag = true; // TODO: only if the property is actually inserted
-  edge->origin->write_flag = true;
-  edge->target->write_flag = true;
-  edge->transaction->write_flag = true;
+  return ret;
+}
+
+
+int GDI_GetAllPropertyTypesOfEdge( GDI_PropertyType array_of_ptypes[], size_t count, size_t* resultcount, GDI_EdgeHolder edge ) {
+  /**
+    check the input arguments
+   */
+  if( edge == GDI_EDGE_NULL ) {
+    return GDI_ERROR_EDGE;
+  }
+
+  if( edge->delete_flag ) {
+    return GDI_ERROR_EDGE;
+  }
+
+  if( resultcount == NULL ) {
+    return GDI_ERROR_BUFFER;
+  }
+
+  if( (edge->record == NULL) && !GDA_EdgeHasRecord( edge ) ) {
+    /**
+      the edge doesn't have any properties, so there is no need to
+      set up an empty property list
+     */
+    *resultcount = 0;
+    return GDI_SUCCESS;
+  }
+
+  GDA_LoadEdgeRecord( edge );
+
+  if( (array_of_ptypes == NULL) || (count == 0) ) {
+    /**
+      size trick requested: only return in resultcount the number of property types that have properties present on this edge
+     */
+    GDA_LinearScanningNumPropertyTypes( edge->record, resultcount );
+  } else {
+    return GDA_LinearScanningFindAllPropertyTypes( edge->record, array_of_ptypes, count, resultcount );
+  }
+
+  return GDI_SUCCESS;
+}
+
+
+int GDI_GetPropertiesOfEdge( void* buf, size_t buf_count, size_t* buf_resultcount, size_t array_of_offsets[], size_t offset_count,
+  size_t* offset_resultcount, GDI_PropertyType ptype, GDI_EdgeHolder edge ) {
+  /**
+    check the input arguments
+   */
+  if( edge == GDI_EDGE_NULL ) {
+    return GDI_ERROR_EDGE;
+  }
+
+  if( edge->delete_flag ) {
+    return GDI_ERROR_EDGE;
+  }
+
+  if( ptype == GDI_PROPERTY_TYPE_NULL ) {
+    return GDI_ERROR_PROPERTY_TYPE;
+  }
+
+  if( (buf_resultcount == NULL) || (offset_resultcount == NULL) ) {
+    return GDI_ERROR_BUFFER;
+  }
+
+  /**
+    the degree property types only exist for vertices
+   */
+  if( (ptype == GDI_PROPERTY_TYPE_DEGREE) || (ptype == GDI_PROPERTY_TYPE_INDEGREE) || (ptype == GDI_PROPERTY_TYPE_OUTDEGREE) ) {
+    *buf_resultcount = 0;
+    *offset_resultcount = 0;
+    return GDI_SUCCESS;
+  }
+
+  if( (ptype != GDI_PROPERTY_TYPE_ID) && (edge->transaction->db != ptype->db) ) {
+    return GDI_ERROR_OBJECT_MISMATCH;
+  }
+
+  if( (edge->record == NULL) && !GDA_EdgeHasRecord( edge ) ) {
+    *buf_resultcount = 0;
+    *offset_resultcount = 0;
+    return GDI_SUCCESS;
+  }
+
+  GDA_LoadEdgeRecord( edge );
+
+  if( (buf == NULL) || (array_of_offsets == NULL) || (buf_count == 0) || (offset_count == 0) ) {
+    /**
+      size trick requested: only return the number of elements in buf_resultcount
+      and the number of offsets in offset_resultcount
+     */
+    GDA_LinearScanningNumProperties( edge->record, ptype, offset_resultcount, buf_resultcount );
+    if( *offset_resultcount > 0 ) {
+      /**
+        GDA_LinearScanningNumProperties only returns the number of properties of that property type,
+        so the number of offsets is one more
+       */
+      (*offset_resultcount)++;
+    }
+  } else {
+    return GDA_LinearScanningFindAllProperties( buf, buf_count, buf_resultcount, array_of_offsets, offset_count, offset_resultcount, ptype, edge->record );
+  }
 
   return GDI_SUCCESS;
 }
@@ -865,15 +1238,24 @@ int GDI_RemovePropertiesFromEdge( GDI_PropertyType ptype, GDI_EdgeHolder edge )
     }
   }
 
-  fprintf( stderr, "GDI_RemovePropertiesFromEdge implements only input parsing and should not be used.\n" );
+  if( !GDA_EdgeHasRecord( edge ) ) {
+    /**
+      the edge doesn't have any properties
+     */
+    return GDI_SUCCESS;
+  }
 
-  // TODO: remove properties from local edge object and update the index (maybe)
-  // TODO: probably have to handle GDI_PROPERTY_TYPE_ID differently
+  bool found_flag;
 
-  edge->write_flag = true; // TODO: if there are any properties to be removed
-  edge->origin->write_flag = true;
-  edge->target->write_flag = true;
-  edge->transaction->write_flag = true;
+  GDA_LoadEdgeRecord( edge );
+  GDA_LinearScanningRemoveProperties( ptype, edge->record, &found_flag );
+  if( found_flag ) {
+    if( !GDA_SetEdgeRecordWriteFlags( edge ) ) {
+      edge->transaction->critical_flag = true;
+      return GDI_ERROR_TRANSACTION_CRITICAL;
+    }
+    // TODO: probably have to handle GDI_PROPERTY_TYPE_ID differently
+  }
 
   return GDI_SUCCESS;
 }
@@ -953,15 +1335,24 @@ int GDI_RemoveSpecificPropertyFromEdge( const void* value, size_t count, GDI_Pro
     }
   }
 
-  fprintf( stderr, "GDI_RemoveSpecificPropertyFromEdge implements only input parsing and should not be used.\n" );
+  if( !GDA_EdgeHasRecord( edge ) ) {
+    /**
+      the edge doesn't have any properties
+     */
+    return GDI_SUCCESS;
+  }
 
-  // TODO: remove property from local edge object and update the index (maybe)
-  // TODO: probably have to handle GDI_PROPERTY_TYPE_ID differently
+  bool found_flag;
 
-  edge->write_flag = true; // TODO: if any property is removed
-  edge->origin->write_flag = true;
-  edge->target->write_flag = true;
-  edge->transaction->write_flag = true;
+  GDA_LoadEdgeRecord( edge );
+  GDA_LinearScanningRemoveSpecificProperty( ptype, value, count, edge->record, &found_flag );
+  if( found_flag ) {
+    if( !GDA_SetEdgeRecordWriteFlags( edge ) ) {
+      edge->transaction->critical_flag = true;
+      return GDI_ERROR_TRANSACTION_CRITICAL;
+    }
+    // TODO: probably have to handle GDI_PROPERTY_TYPE_ID differently
+  }
 
   return GDI_SUCCESS;
 }
@@ -1015,8 +1406,6 @@ int GDI_UpdatePropertyOfEdge( const void* value, size_t count, GDI_PropertyType
     }
   }
 
-  // TODO: return GDI_ERROR_NO_PROPERTY, if no property is found
-
   /**
     passed all input checks
    */
@@ -1043,17 +1432,18 @@ int GDI_UpdatePropertyOfEdge( const void* value, size_t count, GDI_PropertyType
     }
   }
 
-  fprintf( stderr, "GDI_UpdatePropertyOfEdge implements only input parsing and should not be used.\n" );
-
-  // TODO: update property from local edge object and update the index (maybe)
-  // TODO: probably have to handle GDI_PROPERTY_TYPE_ID differently
+  GDA_LoadEdgeRecord( edge );
+  int ret = GDA_LinearScanningUpdateSingleEntityProperty( ptype, value, count, edge->record );
 
-  edge->write_flag = true; // TODO: only if a property is updated
-  edge->origin->write_flag = true;
-  edge->target->write_flag = true;
-  edge->transaction->write_flag = true;
+  if( ret == GDI_SUCCESS ) {
+    if( !GDA_SetEdgeRecordWriteFlags( edge ) ) {
+      edge->transaction->critical_flag = true;
+      return GDI_ERROR_TRANSACTION_CRITICAL;
+    }
+    // TODO: probably have to handle GDI_PROPERTY_TYPE_ID differently
+  }
 
-  return GDI_SUCCESS;
+  return ret;
 }
 
 
@@ -1101,9 +1491,6 @@ int GDI_UpdateSpecificPropertyOfEdge( const void* old_value, size_t old_count, c
     }
   }
 
-  // TODO: return GDI_ERROR_NO_PROPERTY, if no property is found
-  // TODO: return GDI_ERROR_PROPERTY_EXISTS, if another property with the same value exists
-
   /**
     passed all input checks
    */
@@ -1130,17 +1517,18 @@ int GDI_UpdateSpecificPropertyOfEdge( const void* old_value, size_t old_count, c
     }
   }
 
-  fprintf( stderr, "GDI_UpdateSpecificPropertyOfEdge implements only input parsing and should not be used.\n" );
-
-  // TODO: update property from local edge object and update the index (maybe)
-  // TODO: probably have to handle GDI_PROPERTY_TYPE_ID differently
+  GDA_LoadEdgeRecord( edge );
+  int ret = GDA_LinearScanningUpdateSpecificProperty( ptype, old_value, old_count, new_value, new_count, edge->record );
 
-  edge->write_flag = true; // TODO: only if a property is updated
-  edge->origin->write_flag = true;
-  edge->target->write_flag = true;
-  edge->transaction->write_flag = true;
+  if( ret == GDI_SUCCESS ) {
+    if( !GDA_SetEdgeRecordWriteFlags( edge ) ) {
+      edge->transaction->critical_flag = true;
+      return GDI_ERROR_TRANSACTION_CRITICAL;
+    }
+    // TODO: probably have to handle GDI_PROPERTY_TYPE_ID differently
+  }
 
-  return GDI_SUCCESS;
+  return ret;
 }
 
 
@@ -1218,15 +1606,15 @@ int GDI_SetPropertyOfEdge( const void* value, size_t count, GDI_PropertyType pty
     }
   }
 
-  fprintf( stderr, "GDI_SetPropertyOfEdge implements only input parsing and should not be used.\n" );
+  bool found_flag;
 
-  // TODO: update property from local edge object and update the index (maybe)
-  // TODO: probably have to handle GDI_PROPERTY_TYPE_ID differently
+  GDA_LoadEdgeRecord( edge );
+  GDA_LinearScanningSetSingleEntityProperty( ptype, value, count, edge->record, &found_flag );
 
-  edge->write_flag = true; // TODO: only if there is a change
-  edge->origin->write_flag = true;
-  edge->target->write_flag = true;
-  edge->transaction->write_flag = true;
+  if( !GDA_SetEdgeRecordWriteFlags( edge ) ) {
+    edge->transaction->critical_flag = true;
+    return GDI_ERROR_TRANSACTION_CRITICAL;
+  }
 
   return GDI_SUCCESS;
 }
@@ -10,9 +10,163 @@
 #include <string.h>
 
 #include "gdi.h"
+#include "gda_dictionary.h"
+#include "gda_index.h"
+#include "gda_internal_index.h"
 #include "gda_lock.h"
+#include "gda_property.h"
 #include "gda_vertex.h"
 
+/**
+  computes the hashed key and the key, under which the vertex with the
+  given external ID and label is stored in the internal index
+
+  will also work with GDI_LABEL_NONE, since its integer handle is zero
+ */
+static inline void GDA_ComputeInternalIndexKey( uint64_t* hashed_key, uint64_t* key, GDI_Label label, const void* external_id, size_t size ) {
+  *hashed_key = GDA_hash_property_id( external_id, size, label->int_handle );
+
+  size_t minimum = 7;
+  if( size < minimum ) {
+    minimum = size;
+  }
+  *key = 0;
+  memcpy( key, external_id, minimum );
+
+  *key = (*key & 0x00FFFFFFFFFFFFFF) | ((uint64_t)(label->int_handle) << 56);
+}
+
+
+/**
+  associates a vertex, that was found in the internal index, with a
+  single process transaction (if it is not already associated)
+
+  stale_flag is NULL for results of the internal index. For results of
+  the translation cache, a mismatch of the incarnation is not an error:
+  the lock is released again and stale_flag is set, so that the caller
+  can fall back to the internal index.
+ */
+static int GDA_AssociateTranslatedVertex( GDI_Vertex_uid internal_uid, uint64_t incarnation, bool* stale_flag, GDI_Transaction transaction ) {
+  /**
+    check whether vertex is already associated with this transaction
+   */
+  GDI_VertexHolder* v_hashmap = GDA_hashmap_get( transaction->v_translate_d2l, &internal_uid );
+  if( v_hashmap != NULL ) {
+    /**
+      vertex is already associated with this transaction
+     */
+    if( (stale_flag != NULL) && ((incarnation & 0x00000000FFFFFFFF) != (*v_hashmap)->incarnation) ) {
+      *stale_flag = true;
+    }
+    return GDI_SUCCESS;
+  }
+
+  /**
+    vertex is not associated with this transaction:
+    1) acquire a read lock
+    2) check that there were no concurrent delete operations to that vertex
+    3) associate the vertex
+   */
+  GDI_VertexHolder vertex = malloc( sizeof(GDI_VertexHolder_desc_t) );
+  assert( vertex != NULL );
+
+  vertex->transaction = transaction;
+  vertex->lock_type = GDA_NO_LOCK;
+
+  /**
+    TODO: Workaround: set up (*vertex)->blocks->data before
+    GDA_AcquireVertexReadLock is called. The initialization of
+    (*vertex)->blocks and its fields is finished later.
+   */
+  vertex->blocks = malloc( sizeof( GDA_Vector ) );
+  vertex->blocks->data = malloc( sizeof( GDA_DPointer ) );
+  *(uint64_t*)(vertex->blocks->data) = internal_uid;
+
+  /**
+    try to acquire a read lock
+   */
+  GDA_AcquireVertexReadLock( vertex );
+  if( vertex->lock_type == GDA_NO_LOCK ) {
+    /**
+      acquisition of a read lock failed, so free the allocated memory
+      and return an error
+     */
+    bool reused_flag = ((incarnation & 0x00000000FFFFFFFF) != vertex->incarnation);
+    free( vertex->blocks->data );
+    free( vertex->blocks );
+    free( vertex );
+    if( (stale_flag != NULL) && reused_flag ) {
+      /**
+        the cached UID belongs to a different vertex by now, which is
+        not a conflict of this transaction
+       */
+      *stale_flag = true;
+      return GDI_SUCCESS;
+    }
+    transaction->critical_flag = true;
+    return GDI_ERROR_TRANSACTION_CRITICAL;
+  }
+
+  if( (incarnation & 0x00000000FFFFFFFF) != vertex->incarnation ) {
+    if( stale_flag != NULL ) {
+      /**
+        the cached translation belongs to a vertex, that was removed in
+        the meantime
+       */
+      vertex->delete_flag = false;
+      GDA_ReleaseVertexLock( vertex );
+      free( vertex->blocks->data );
+      free( vertex->blocks );
+      free( vertex );
+      *stale_flag = true;
+      return GDI_SUCCESS;
+    }
+
+    /**
+      the vertex in question was removed from the database, but the
+      internal index wasn't aware yet
+     */
+    free( vertex->blocks->data );
+    free( vertex->blocks );
+    free( vertex );
+    transaction->critical_flag = true;
+    return GDI_ERROR_TRANSACTION_CRITICAL;
+  }
+
+  GDA_AssociateVertex( internal_uid, transaction, vertex );
+
+  return GDI_SUCCESS;
+}
+
+
+/**
+  tries to answer a translation from the translation cache
+
+  only used for single process transactions, since the hit is validated
+  when the vertex is associated with the transaction
+
+  returns true, if the translation is finished (ret holds the return
+  code), and false, if the internal index has to be consulted
+ */
+static bool GDA_TranslateFromCache( uint64_t hashed_key, uint64_t key, GDI_Vertex_uid* internal_uid, int* ret, GDI_Transaction transaction ) {
+  uint64_t incarnation;
+
+  if( !GDA_LookupTranslationCache( hashed_key, key, internal_uid, &incarnation, transaction->db->translation_cache ) ) {
+    return false;
+  }
+
+  bool stale_flag = false;
+  *ret = GDA_AssociateTranslatedVertex( *internal_uid, incarnation, &stale_flag, transaction );
+
+  if( stale_flag ) {
+    GDA_InvalidateTranslationCache( hashed_key, key, transaction->db->translation_cache );
+    return false;
+  }
+
+  return true;
+}
+
+
 int GDI_TranslateVertexID( bool* found_flag, GDI_Vertex_uid* internal_uid, GDI_Label label, const void* external_id, size_t size, GDI_Transaction transaction ) {
   /**
     check the input arguments
@@ -41,89 +195,808 @@ int GDI_TranslateVertexID( bool* found_flag, GDI_Vertex_uid* internal_uid, GDI_L
     passed all checks
    */
 
+  uint64_t hashed_key;
+  uint64_t key;
+  GDA_ComputeInternalIndexKey( &hashed_key, &key, label, external_id, size );
+
+  if( transaction->type == GDI_SINGLE_PROCESS_TRANSACTION ) {
+    int ret;
+    if( GDA_TranslateFromCache( hashed_key, key, internal_uid, &ret, transaction ) ) {
+      *found_flag = true;
+      return ret;
+    }
+  }
+
+  uint64_t incarnation;
+
+  GDA_FindInInternalIndex( hashed_key, key, internal_uid, &incarnation, found_flag, transaction->db );
+
+  // TODO: GDI_WARNING_NON_UNIQUE_ID
+
+  if( *found_flag ) {
+    GDA_UpdateTranslationCache( hashed_key, key, *internal_uid, incarnation, transaction->db->translation_cache );
+
+    if( transaction->type == GDI_SINGLE_PROCESS_TRANSACTION ) {
+      return GDA_AssociateTranslatedVertex( *internal_uid, incarnation, NULL, transaction );
+    }
+  }
+
+  return GDI_SUCCESS;
+}
+
+
+/**
+  vector version of GDI_TranslateVertexID
+
+  translates count external IDs at once: the IDs are expected
+  consecutively in array_of_external_ids with a stride of size bytes,
+  array_of_labels holds the label for each ID
+
+  The lookups in the internal index are performed in rounds (see
+  GDA_FindManyInInternalIndex), so the latency of the call is bounded by
+  the longest hash chain instead of the sum of all lookups. In case of a
+  single process transaction, the translation cache is consulted first,
+  and all found vertices are associated with the transaction.
+ */
+int GDI_TranslateVertexIDs( bool array_of_found_flags[], GDI_Vertex_uid array_of_internal_uids[], const GDI_Label array_of_labels[], const void* array_of_external_ids, size_t size, size_t count, GDI_Transaction transaction ) {
   /**
-    will also work with GDI_LABEL_NONE, since its integer handle is zero
+    check the input arguments
    */
-  uint64_t hashed_key = GDA_hash_property_id( external_id, size, label->int_handle );
+  if( (count > 0) && ((array_of_found_flags == NULL) || (array_of_internal_uids == NULL) || (array_of_labels == NULL) || (array_of_external_ids == NULL)) ) {
+    return GDI_ERROR_BUFFER;
+  }
 
-  size_t minimum = 7;
-  if( size < minimum ) {
-    minimum = size;
+  if( transaction == GDI_TRANSACTION_NULL ) {
+    return GDI_ERROR_TRANSACTION;
   }
-  uint64_t key = 0;
-  memcpy( &key, external_id, minimum );
 
-  key = (key & 0x00FFFFFFFFFFFFFF) | ((uint64_t)(label->int_handle) << 56);
+  for( size_t i=0 ; i<count ; i++ ) {
+    if( array_of_labels[i] == GDI_LABEL_NULL ) {
+      return GDI_ERROR_LABEL;
+    }
 
-  uint64_t incarnation;
+    if( (array_of_labels[i] != GDI_LABEL_NONE) && (array_of_labels[i]->db != transaction->db) ) {
+      return GDI_ERROR_OBJECT_MISMATCH;
+    }
+  }
 
-  GDA_FindElementInRMAHashMap( hashed_key, key, internal_uid, &incarnation, found_flag, transaction->db->internal_index );
+  if( size == 0 ) {
+    return GDI_ERROR_SIZE;
+  }
+
+  /**
+    passed all checks
+   */
+
+  if( count == 0 ) {
+    return GDI_SUCCESS;
+  }
+
+  uint64_t* hashed_keys = malloc( count * sizeof(uint64_t) );
+  assert( hashed_keys != NULL );
+  uint64_t* keys = malloc( count * sizeof(uint64_t) );
+  assert( keys != NULL );
+  uint64_t* incarnations = malloc( count * sizeof(uint64_t) );
+  assert( incarnations != NULL );
+  size_t* positions = malloc( count * sizeof(size_t) );
+  assert( positions != NULL );
+  GDI_Vertex_uid* uids = malloc( count * sizeof(GDI_Vertex_uid) );
+  assert( uids != NULL );
+  bool* found_flags = malloc( count * sizeof(bool) );
+  assert( found_flags != NULL );
+
+  int ret = GDI_SUCCESS;
+
+  /**
+    answer as many translations as possible from the translation cache,
+    the remaining ones are compacted to the front of the key arrays
+   */
+  size_t num_misses = 0;
+  const char* external_id = array_of_external_ids;
+  for( size_t i=0 ; i<count ; i++ ) {
+    uint64_t hashed_key;
+    uint64_t key;
+    GDA_ComputeInternalIndexKey( &hashed_key, &key, array_of_labels[i], external_id, size );
+    external_id += size;
+
+    if( (transaction->type == GDI_SINGLE_PROCESS_TRANSACTION) && (ret == GDI_SUCCESS) ) {
+      if( GDA_TranslateFromCache( hashed_key, key, &(array_of_internal_uids[i]), &ret, transaction ) ) {
+        array_of_found_flags[i] = true;
+        continue;
+      }
+    }
+
+    hashed_keys[num_misses] = hashed_key;
+    keys[num_misses] = key;
+    positions[num_misses] = i;
+    num_misses++;
+  }
+
+  if( ret != GDI_SUCCESS ) {
+    /**
+      association of a cached translation failed, so there is no need to
+      look up the remaining IDs
+     */
+    for( size_t i=0 ; i<num_misses ; i++ ) {
+      array_of_found_flags[positions[i]] = false;
+    }
+    num_misses = 0;
+  }
+
+  GDA_FindManyInInternalIndex( num_misses, hashed_keys, keys, uids, incarnations, found_flags, transaction->db );
 
   // TODO: GDI_WARNING_NON_UNIQUE_ID
 
-  if( (*found_flag) && (transaction->type == GDI_SINGLE_PROCESS_TRANSACTION) ) {
+  for( size_t i=0 ; i<num_misses ; i++ ) {
+    array_of_found_flags[positions[i]] = found_flags[i];
+    array_of_internal_uids[positions[i]] = uids[i];
+
+    if( found_flags[i] ) {
+      GDA_UpdateTranslationCache( hashed_keys[i], keys[i], uids[i], incarnations[i], transaction->db->translation_cache );
+
+      if( (transaction->type == GDI_SINGLE_PROCESS_TRANSACTION) && (ret == GDI_SUCCESS) ) {
+        ret = GDA_AssociateTranslatedVertex( uids[i], incarnations[i], NULL, transaction );
+      }
+    }
+  }
+
+  free( found_flags );
+  free( uids );
+  free( positions );
+  free( incarnations );
+  free( keys );
+  free( hashed_keys );
+
+  return ret;
+}
+
+
+/**
+  creates a secondary index over the values of property type ptype of
+  all vertices with the given label (GDI_LABEL_NONE: all vertices)
+
+  The index is maintained when single process transactions commit.
+  Vertices, that were stored before the index was created, are added by
+  the call itself: every process indexes the vertices, whose primary
+  blocks it stores, inside of a collective transaction, which is why no
+  other transaction may be open on any process.
+
+  GDI_INDEX_ORDERED requires a property type, whose values consist of a
+  single element of at most 8 Bytes (apart from GDI_CHAR).
+
+  collective call
+ */
+int GDI_CreateIndex( int itype, GDI_Label label, GDI_PropertyType ptype, GDI_Database graph_db, GDI_Index* index ) {
+  /**
+    check the input arguments
+   */
+  if( index == NULL ) {
+    return GDI_ERROR_BUFFER;
+  }
+
+  if( graph_db == GDI_DATABASE_NULL ) {
+    return GDI_ERROR_DATABASE;
+  }
+
+  if( (itype != GDI_INDEX_HASH) && (itype != GDI_INDEX_ORDERED) && (itype != GDI_INDEX_PREFIX) && (itype != GDI_INDEX_BITMAP) ) {
+    return GDI_ERROR_STATE;
+  }
+
+  if( label == GDI_LABEL_NULL ) {
+    return GDI_ERROR_LABEL;
+  }
+
+  if( (label != GDI_LABEL_NONE) && (label->db != graph_db) ) {
+    return GDI_ERROR_OBJECT_MISMATCH;
+  }
+
+  if( itype == GDI_INDEX_BITMAP ) {
     /**
-      check whether vertex is already associated with this transaction
+      bitmap indexes only keep track of labels
      */
-    GDI_VertexHolder* v_hashmap = GDA_hashmap_get( transaction->v_translate_d2l, &internal_uid );
-    if( v_hashmap != NULL ) {
-      /**
-        vertex is already associated with this transaction
-       */
-      return GDI_SUCCESS;
+    if( ptype != GDI_PROPERTY_TYPE_NULL ) {
+      return GDI_ERROR_PROPERTY_TYPE;
+    }
+  } else {
+    if( (ptype == GDI_PROPERTY_TYPE_NULL) || (ptype == GDI_PROPERTY_TYPE_ID) || (ptype == GDI_PROPERTY_TYPE_DEGREE) ||
+        (ptype == GDI_PROPERTY_TYPE_INDEGREE) || (ptype == GDI_PROPERTY_TYPE_OUTDEGREE) ) {
+      return GDI_ERROR_PROPERTY_TYPE;
     }
 
+    if( ptype->db != graph_db ) {
+      return GDI_ERROR_OBJECT_MISMATCH;
+    }
+
+    if( (itype == GDI_INDEX_ORDERED) && !GDA_IsExactPropertyType( ptype ) ) {
+      return GDI_ERROR_PROPERTY_TYPE;
+    }
+
+    if( (itype == GDI_INDEX_PREFIX) && (ptype->dtype != GDI_CHAR) ) {
+      return GDI_ERROR_PROPERTY_TYPE;
+    }
+  }
+
+  if( graph_db->transactions->head != NULL ) {
     /**
-      vertex is not associated with this transaction:
-      1) acquire a read lock
-      2) check that there were no concurrent delete operations to that vertex
-      3) associate the vertex
+      transactions would miss the index during their commit
      */
-    GDI_VertexHolder vertex = malloc( sizeof(GDI_VertexHolder_desc_t) );
-    assert( vertex != NULL );
+    return GDI_ERROR_INCOMPATIBLE_TRANSACTIONS;
+  }
 
-    vertex->transaction = transaction;
-    vertex->lock_type = GDA_NO_LOCK;
+  /**
+    passed all checks
+   */
+
+  GDA_CreateIndex( itype, label, ptype, graph_db, index );
+
+  /**
+    add the vertices, that are already stored in the database: every
+    process handles the vertices, whose primary blocks it stores
+
+    GDI_StartCollectiveTransaction ensures, that all processes have set
+    up and initialized their remote accessible data structures
+   */
+  GDI_Transaction transaction;
+  int ret = GDI_StartCollectiveTransaction( graph_db, &transaction );
+  assert( ret == GDI_SUCCESS );
+
+  GDA_BackfillIndex( *index, transaction );
 
+  /**
+    the allreduce inside of GDI_CloseCollectiveTransaction ensures, that
+    all vertices are indexed, before any process returns
+   */
+  ret = GDI_CloseCollectiveTransaction( &transaction, GDI_TRANSACTION_COMMIT );
+  assert( ret == GDI_SUCCESS );
+
+  if( itype == GDI_INDEX_ORDERED ) {
     /**
-      TODO: Workaround: set up (*vertex)->blocks->data before
-      GDA_AcquireVertexReadLock is called. The initialization of
-      (*vertex)->blocks and its fields is finished later.
+      the width of the buckets so far is only a guess
      */
-    vertex->blocks = malloc( sizeof( GDA_Vector ) );
-    vertex->blocks->data = malloc( sizeof( GDA_DPointer ) );
-    *(uint64_t*)(vertex->blocks->data) = *internal_uid;
+    GDA_AdaptIndexBuckets( *index );
+  }
 
+  return GDI_SUCCESS;
+}
+
+
+/**
+  collective call
+ */
+int GDI_FreeIndex( GDI_Index* index ) {
+  /**
+    check the input arguments
+   */
+  if( index == NULL ) {
+    return GDI_ERROR_INDEX;
+  }
+
+  if( *index == GDI_INDEX_NULL ) {
+    return GDI_ERROR_INDEX;
+  }
+
+  GDI_Database graph_db = (*index)->db;
+  if( graph_db->transactions->head != NULL ) {
+    return GDI_ERROR_INCOMPATIBLE_TRANSACTIONS;
+  }
+
+  /**
+    passed all checks
+   */
+
+  /**
+    wait until no process accesses the index anymore
+   */
+  MPI_Barrier( graph_db->comm );
+
+  GDA_FreeIndex( index );
+
+  return GDI_SUCCESS;
+}
+
+
+int GDI_GetTypeOfIndex( int* itype, GDI_Index index ) {
+  /**
+    check the input arguments
+   */
+  if( itype == NULL ) {
+    return GDI_ERROR_BUFFER;
+  }
+
+  if( index == GDI_INDEX_NULL ) {
+    return GDI_ERROR_INDEX;
+  }
+
+  /**
+    passed all checks
+   */
+
+  *itype = index->itype;
+
+  return GDI_SUCCESS;
+}
+
+
+/**
+  an index covers a single label (GDI_LABEL_NONE, if it covers all
+  vertices)
+ */
+int GDI_GetAllLabelsOfIndex( GDI_Label array_of_labels[], size_t count, size_t* resultcount, GDI_Index index ) {
+  /**
+    check the input arguments
+   */
+  if( resultcount == NULL ) {
+    return GDI_ERROR_BUFFER;
+  }
+
+  if( index == GDI_INDEX_NULL ) {
+    return GDI_ERROR_INDEX;
+  }
+
+  /**
+    passed all checks
+   */
+
+  *resultcount = 1;
+
+  if( (array_of_labels == NULL) || (count == 0) ) {
     /**
-      try to acquire a read lock
+      size trick
      */
-    GDA_AcquireVertexReadLock( vertex );
-    if( vertex->lock_type == GDA_NO_LOCK ) {
-      /**
-        acquisition of a read lock failed, so free the allocated memory
-        and return an error
-       */
-      free( vertex->blocks->data );
-      free( vertex->blocks );
-      free( vertex );
-      transaction->critical_flag = true;
-      return GDI_ERROR_TRANSACTION_CRITICAL;
+    return GDI_SUCCESS;
+  }
+
+  array_of_labels[0] = index->label;
+
+  return GDI_SUCCESS;
+}
+
+
+/**
+  an index covers a single property type (none for GDI_INDEX_BITMAP)
+ */
+int GDI_GetAllPropertyTypesOfIndex( GDI_PropertyType array_of_ptypes[], size_t count, size_t* resultcount, GDI_Index index ) {
+  /**
+    check the input arguments
+   */
+  if( resultcount == NULL ) {
+    return GDI_ERROR_BUFFER;
+  }
+
+  if( index == GDI_INDEX_NULL ) {
+    return GDI_ERROR_INDEX;
+  }
+
+  /**
+    passed all checks
+   */
+
+  if( index->itype == GDI_INDEX_BITMAP ) {
+    *resultcount = 0;
+    return GDI_SUCCESS;
+  }
+
+  *resultcount = 1;
+
+  if( (array_of_ptypes == NULL) || (count == 0) ) {
+    /**
+      size trick
+     */
+    return GDI_SUCCESS;
+  }
+
+  array_of_ptypes[0] = index->ptype;
+
+  return GDI_SUCCESS;
+}
+
+
+int GDI_GetAllIndexesOfDatabase( GDI_Index array_of_indexes[], size_t count, size_t* resultcount, GDI_Database graph_db ) {
+  /**
+    check the input arguments
+   */
+  if( resultcount == NULL ) {
+    return GDI_ERROR_BUFFER;
+  }
+
+  if( graph_db == GDI_DATABASE_NULL ) {
+    return GDI_ERROR_DATABASE;
+  }
+
+  /**
+    passed all checks
+   */
+
+  if( (array_of_indexes == NULL) || (count == 0) ) {
+    /**
+      size trick
+     */
+    *resultcount = graph_db->indexes->size;
+    return GDI_SUCCESS;
+  }
+
+  size_t num_indexes = 0;
+  for( GDA_Node* node = graph_db->indexes->head ; node != NULL ; node = node->next ) {
+    if( num_indexes == count ) {
+      *resultcount = num_indexes;
+      return GDI_ERROR_TRUNCATE;
     }
+    array_of_indexes[num_indexes++] = *(GDI_Index*)(node->value);
+  }
+
+  *resultcount = num_indexes;
+  return GDI_SUCCESS;
+}
+
+
+/**
+  checks whether the vertex carries the given value of the property type
+  (prefix_flag == true: a value, that starts with the given value)
+ */
+static bool GDA_VertexHasPropertyValue( const void* value, size_t value_count, bool prefix_flag, GDI_PropertyType ptype, GDI_VertexHolder vertex ) {
+  size_t dsize;
+  GDI_GetSizeOfDatatype( &dsize, ptype->dtype );
 
-    if( (incarnation & 0x00000000FFFFFFFF) != vertex->incarnation ) {
+  if( !prefix_flag ) {
+    /**
+      dictionary encoded values are compared by their codes
+     */
+    return GDA_LinearScanningHasPropertyValue( value, value_count * dsize, GDA_DictionaryCode( value, value_count * dsize ), ptype, vertex );
+  }
+
+  size_t num_values;
+  size_t num_elements;
+  GDA_LinearScanningNumProperties( vertex, ptype, &num_values, &num_elements );
+  if( num_values == 0 ) {
+    return false;
+  }
+
+  char* buf = malloc( num_elements * dsize + 1 /* avoid a zero sized allocation */ );
+  assert( buf != NULL );
+  size_t* offsets = malloc( (num_values + 1) * sizeof(size_t) );
+  assert( offsets != NULL );
+
+  size_t buf_resultcount;
+  size_t offset_resultcount;
+  int ret = GDA_LinearScanningFindAllProperties( buf, num_elements, &buf_resultcount, offsets, num_values + 1, &offset_resultcount, ptype, vertex );
+  assert( ret == GDI_SUCCESS );
+
+  bool found_flag = false;
+  for( size_t i=0 ; i<num_values ; i++ ) {
+    size_t count = offsets[i+1] - offsets[i];
+    if( ((count == value_count) || (prefix_flag && (count > value_count))) && (memcmp( buf + offsets[i] * dsize, value, value_count * dsize ) == 0) ) {
+      found_flag = true;
+      break;
+    }
+  }
+
+  free( offsets );
+  free( buf );
+
+  return found_flag;
+}
+
+
+/**
+  removes the candidates of an index, whose keys are hashes or prefixes
+  of the values, that don't carry the value (or prefix) in question
+
+  the candidates are associated with the transaction for that purpose
+ */
+static int GDA_VerifyIndexCandidates( GDA_Vector* uids, const void* value, size_t value_count, bool prefix_flag, GDI_Index index, GDI_Transaction transaction ) {
+  GDI_Vertex_uid* data = uids->data;
+  size_t num_verified = 0;
+
+  for( size_t i=0 ; i<uids->size ; i++ ) {
+    GDI_VertexHolder vertex;
+    int ret = GDI_AssociateVertex( data[i], transaction, &vertex );
+    if( ret == GDI_ERROR_VERTEX ) {
       /**
-        the vertex in question was removed from the database, but the
-        internal index wasn't aware yet
+        vertex was deleted during this transaction
        */
-      free( vertex->blocks->data );
-      free( vertex->blocks );
-      free( vertex );
-      transaction->critical_flag = true;
-      return GDI_ERROR_TRANSACTION_CRITICAL;
+      continue;
     }
+    if( ret != GDI_SUCCESS ) {
+      return ret;
+    }
+
+    if( GDA_VertexHasPropertyValue( value, value_count, prefix_flag, index->ptype, vertex ) ) {
+      data[num_verified++] = data[i];
+    }
+  }
+
+  uids->size = num_verified;
+  return GDI_SUCCESS;
+}
 
-    GDA_AssociateVertex( *internal_uid, transaction, vertex );
+
+/**
+  copies the results of an index lookup into the output buffer of the
+  user (the size trick returns the number of results only)
+ */
+static int GDA_ReturnIndexResults( GDI_Vertex_uid array_of_uids[], size_t count, size_t* resultcount, GDA_Vector* uids ) {
+  if( (array_of_uids == NULL) || (count == 0) ) {
+    *resultcount = uids->size;
+    return GDI_SUCCESS;
   }
 
+  if( uids->size > count ) {
+    memcpy( array_of_uids, uids->data, count * sizeof(GDI_Vertex_uid) );
+    *resultcount = count;
+    return GDI_ERROR_TRUNCATE;
+  }
+
+  memcpy( array_of_uids, uids->data, uids->size * sizeof(GDI_Vertex_uid) );
+  *resultcount = uids->size;
   return GDI_SUCCESS;
 }
+
+
+/**
+  returns the UIDs of all vertices, that carry the given value (value_count
+  elements of the datatype of the property type of the index)
+
+  The lookup reflects the state of the database after the last commit,
+  changes of the current transaction are not visible. If the keys of the
+  index are hashes of the values, the candidates are associated with the
+  transaction to rule out collisions.
+
+  The UIDs are returned in ascending order.
+ */
+int GDI_GetVerticesOfIndexByValue( GDI_Vertex_uid array_of_uids[], size_t count, size_t* resultcount, const void* value, size_t value_count, GDI_Index index, GDI_Transaction transaction ) {
+  /**
+    check the input arguments
+   */
+  if( resultcount == NULL ) {
+    return GDI_ERROR_BUFFER;
+  }
+
+  if( (value == NULL) && (value_count > 0) ) {
+    return GDI_ERROR_BUFFER;
+  }
+
+  if( index == GDI_INDEX_NULL ) {
+    return GDI_ERROR_INDEX;
+  }
+
+  if( index->itype == GDI_INDEX_BITMAP ) {
+    return GDI_ERROR_WRONG_TYPE;
+  }
+
+  if( transaction == GDI_TRANSACTION_NULL ) {
+    return GDI_ERROR_TRANSACTION;
+  }
+
+  if( index->db != transaction->db ) {
+    return GDI_ERROR_OBJECT_MISMATCH;
+  }
+
+  /**
+    passed all checks
+   */
+
+  uint64_t key;
+  if( !GDA_EncodeIndexKey( &key, value, value_count, index ) ) {
+    /**
+      no vertex can carry such a value
+     */
+    *resultcount = 0;
+    return GDI_SUCCESS;
+  }
+
+  GDA_Vector* uids;
+  GDA_vector_create( &uids, sizeof(GDI_Vertex_uid), 16 /* initial capacity */ );
+
+  GDA_FindInIndex( key, key, uids, index );
+
+  int ret = GDI_SUCCESS;
+  if( !(index->exact_flag) ) {
+    ret = GDA_VerifyIndexCandidates( uids, value, value_count, false /* prefix_flag */, index, transaction );
+  }
+
+  if( ret == GDI_SUCCESS ) {
+    ret = GDA_ReturnIndexResults( array_of_uids, count, resultcount, uids );
+  }
+
+  GDA_vector_free( &uids );
+
+  return ret;
+}
+
+
+/**
+  returns the UIDs of all vertices, whose value lies within
+  [lower_value, upper_value] (both bounds are a single element of the
+  datatype of the property type of the index, NULL for no bound)
+
+  only supported by GDI_INDEX_ORDERED, otherwise the same as
+  GDI_GetVerticesOfIndexByValue
+
+  The range is clipped to the smallest and largest value in the index,
+  and a lookup visits one chain per bucket of the remaining range. The
+  width of the buckets is adapted to the values in the index at every
+  GDI_StartCollectiveTransaction, so that the number of visited buckets
+  follows the number of values in the range, as long as the values are
+  spread evenly. The lookup degrades to a scan of the whole index on all
+  processes, if the clipped range covers more buckets than the hash table
+  of the index has slots. This happens for ranges, that cover (nearly)
+  all values of the index, or if the values changed a lot since the last
+  collective transaction, e.g. after the index was filled by single
+  process transactions only.
+ */
+int GDI_GetVerticesOfIndexByRange( GDI_Vertex_uid array_of_uids[], size_t count, size_t* resultcount, const void* lower_value, const void* upper_value, GDI_Index index, GDI_Transaction transaction ) {
+  /**
+    check the input arguments
+   */
+  if( resultcount == NULL ) {
+    return GDI_ERROR_BUFFER;
+  }
+
+  if( index == GDI_INDEX_NULL ) {
+    return GDI_ERROR_INDEX;
+  }
+
+  if( index->itype != GDI_INDEX_ORDERED ) {
+    return GDI_ERROR_WRONG_TYPE;
+  }
+
+  if( transaction == GDI_TRANSACTION_NULL ) {
+    return GDI_ERROR_TRANSACTION;
+  }
+
+  if( index->db != transaction->db ) {
+    return GDI_ERROR_OBJECT_MISMATCH;
+  }
+
+  /**
+    passed all checks
+   */
+
+  uint64_t key_min = 0;
+  uint64_t key_max = UINT64_MAX;
+  bool encoded_flag = true;
+  if( lower_value != NULL ) {
+    encoded_flag = GDA_EncodeIndexKey( &key_min, lower_value, 1, index );
+  }
+  if( encoded_flag && (upper_value != NULL) ) {
+    encoded_flag = GDA_EncodeIndexKey( &key_max, upper_value, 1, index );
+  }
+
+  if( !encoded_flag || (key_min > key_max) ) {
+    /**
+      no vertex can carry a value in such a range
+     */
+    *resultcount = 0;
+    return GDI_SUCCESS;
+  }
+
+  GDA_Vector* uids;
+  GDA_vector_create( &uids, sizeof(GDI_Vertex_uid), 16 /* initial capacity */ );
+
+  GDA_FindInIndex( key_min, key_max, uids, index );
+
+  int ret = GDA_ReturnIndexResults( array_of_uids, count, resultcount, uids );
+
+  GDA_vector_free( &uids );
+
+  return ret;
+}
+
+
+/**
+  returns the UIDs of all vertices, that carry a value, which starts with
+  the given prefix (length characters)
+
+  only supported by GDI_INDEX_PREFIX
+
+  Prefixes of up to 8 characters are answered from the index alone,
+  longer prefixes are verified like the lookups of a hash index.
+
+  The UIDs are returned in ascending order.
+ */
+int GDI_GetVerticesOfIndexByPrefix( GDI_Vertex_uid array_of_uids[], size_t count, size_t* resultcount, const void* prefix, size_t length, GDI_Index index, GDI_Transaction transaction ) {
+  /**
+    check the input arguments
+   */
+  if( resultcount == NULL ) {
+    return GDI_ERROR_BUFFER;
+  }
+
+  if( (prefix == NULL) && (length > 0) ) {
+    return GDI_ERROR_BUFFER;
+  }
+
+  if( index == GDI_INDEX_NULL ) {
+    return GDI_ERROR_INDEX;
+  }
+
+  if( index->itype != GDI_INDEX_PREFIX ) {
+    return GDI_ERROR_WRONG_TYPE;
+  }
+
+  if( transaction == GDI_TRANSACTION_NULL ) {
+    return GDI_ERROR_TRANSACTION;
+  }
+
+  if( index->db != transaction->db ) {
+    return GDI_ERROR_OBJECT_MISMATCH;
+  }
+
+  /**
+    passed all checks
+   */
+
+  uint64_t key_min;
+  uint64_t key_max;
+  GDA_EncodeIndexPrefixRange( &key_min, &key_max, prefix, length );
+
+  GDA_Vector* uids;
+  GDA_vector_create( &uids, sizeof(GDI_Vertex_uid), 16 /* initial capacity */ );
+
+  GDA_FindInIndex( key_min, key_max, uids, index );
+
+  int ret = GDI_SUCCESS;
+  if( length > 8 ) {
+    ret = GDA_VerifyIndexCandidates( uids, prefix, length, true /* prefix_flag */, index, transaction );
+  }
+
+  if( ret == GDI_SUCCESS ) {
+    ret = GDA_ReturnIndexResults( array_of_uids, count, resultcount, uids );
+  }
+
+  GDA_vector_free( &uids );
+
+  return ret;
+}
+
+
+/**
+  returns the UIDs of all vertices of a bitmap index, whose primary blocks
+  are stored on the calling process
+
+  The lookup reflects the state of the database after the last commit,
+  changes of the current transaction are not visible. Collective
+  transactions can use it to enumerate the local vertices of every
+  process without any communication.
+
+  The UIDs are returned in ascending order.
+ */
+int GDI_GetLocalVerticesOfIndex( GDI_Vertex_uid array_of_uids[], size_t count, size_t* resultcount, GDI_Index index, GDI_Transaction transaction ) {
+  /**
+    check the input arguments
+   */
+  if( resultcount == NULL ) {
+    return GDI_ERROR_BUFFER;
+  }
+
+  if( index == GDI_INDEX_NULL ) {
+    return GDI_ERROR_INDEX;
+  }
+
+  if( index->itype != GDI_INDEX_BITMAP ) {
+    return GDI_ERROR_WRONG_TYPE;
+  }
+
+  if( transaction == GDI_TRANSACTION_NULL ) {
+    return GDI_ERROR_TRANSACTION;
+  }
+
+  if( index->db != transaction->db ) {
+    return GDI_ERROR_OBJECT_MISMATCH;
+  }
+
+  /**
+    passed all checks
+   */
+
+  GDA_Vector* uids;
+  GDA_vector_create( &uids, sizeof(GDI_Vertex_uid), 64 /* initial capacity */ );
+
+  GDA_CollectLocalVerticesOfIndex( uids, index );
+
+  int ret = GDA_ReturnIndexResults( array_of_uids, count, resultcount, uids );
+
+  GDA_vector_free( &uids );
+
+  return ret;
+}
@@ -28,6 +28,7 @@ int GDI_Init( int *argc, char ***argv ) {
   GDI_PROPERTY_TYPE_ID->etype = GDI_SINGLE_ENTITY;
   GDI_PROPERTY_TYPE_ID->dtype = GDI_BYTE;
   GDI_PROPERTY_TYPE_ID->stype = GDI_NO_SIZE_LIMIT;
+  GDI_PROPERTY_TYPE_ID->dictionary_flag = false;
   GDI_PROPERTY_TYPE_ID->count = 0;
   GDI_PROPERTY_TYPE_ID->int_handle = 3; /* value is fixed due to the label/property handling */
 
@@ -39,6 +40,7 @@ int GDI_Init( int *argc, char ***argv ) {
   GDI_PROPERTY_TYPE_DEGREE->etype = GDI_SINGLE_ENTITY;
   GDI_PROPERTY_TYPE_DEGREE->dtype = GDI_UINT64_T;
   GDI_PROPERTY_TYPE_DEGREE->stype = GDI_FIXED_SIZE;
+  GDI_PROPERTY_TYPE_DEGREE->dictionary_flag = false;
   GDI_PROPERTY_TYPE_DEGREE->count = 1;
   GDI_PROPERTY_TYPE_DEGREE->int_handle = 0;
 
@@ -50,6 +52,7 @@ int GDI_Init( int *argc, char ***argv ) {
   GDI_PROPERTY_TYPE_INDEGREE->etype = GDI_SINGLE_ENTITY;
   GDI_PROPERTY_TYPE_INDEGREE->dtype = GDI_UINT64_T;
   GDI_PROPERTY_TYPE_INDEGREE->stype = GDI_FIXED_SIZE;
+  GDI_PROPERTY_TYPE_INDEGREE->dictionary_flag = false;
   GDI_PROPERTY_TYPE_INDEGREE->count = 1;
   GDI_PROPERTY_TYPE_INDEGREE->int_handle = 1;
 
@@ -61,6 +64,7 @@ int GDI_Init( int *argc, char ***argv ) {
   GDI_PROPERTY_TYPE_OUTDEGREE->etype = GDI_SINGLE_ENTITY;
   GDI_PROPERTY_TYPE_OUTDEGREE->dtype = GDI_UINT64_T;
   GDI_PROPERTY_TYPE_OUTDEGREE->stype = GDI_FIXED_SIZE;
+  GDI_PROPERTY_TYPE_OUTDEGREE->dictionary_flag = false;
   GDI_PROPERTY_TYPE_OUTDEGREE->count = 1;
   GDI_PROPERTY_TYPE_OUTDEGREE->int_handle = 2;
 
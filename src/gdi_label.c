@@ -12,6 +12,7 @@
 
 #include "gdi.h"
 #include "gda_constraint.h"
+#include "gda_property.h"
 #include "gda_utf8.h"
 
 #define MIN(a,b) (((a)<(b))?(a):(b))
@@ -276,3 +277,63 @@ int GDI_GetAllLabelsOfDatabase( GDI_Label array_of_labels[], size_t count, size_
 
   return GDI_SUCCESS;
 }
+
+
+/**
+  Function beyond the specification: vertices with the label store the
+  properties of the given property types in fixed slots instead of a
+  record per property (see gda_property.h), which saves the meta data of
+  each record and allows to read the values at a known offset.
+
+  Only fixed size single entity property types are allowed. The schema
+  of a label can only be set once and should be set, before the label
+  is used. Like GDI_CreateLabel, it has to be called with the same
+  arguments on all processes.
+ */
+int GDI_SetPropertyTypesOfLabel( const GDI_PropertyType array_of_ptypes[], size_t count, GDI_Label label ) {
+  // check for GDI_ERROR_NOT_SAME is omitted
+
+  if(label == GDI_LABEL_NULL || label == GDI_LABEL_NONE) {
+    return GDI_ERROR_LABEL;
+  }
+
+  if(array_of_ptypes == NULL) {
+    return GDI_ERROR_BUFFER;
+  }
+
+  if(count == 0) {
+    return GDI_ERROR_COUNT;
+  }
+
+  for(size_t i = 0; i < count; i++) {
+    GDI_PropertyType ptype = array_of_ptypes[i];
+    if(ptype == GDI_PROPERTY_TYPE_NULL || ptype == GDI_PROPERTY_TYPE_ID || ptype == GDI_PROPERTY_TYPE_DEGREE ||
+       ptype == GDI_PROPERTY_TYPE_INDEGREE || ptype == GDI_PROPERTY_TYPE_OUTDEGREE || ptype->db != label->db) {
+      return GDI_ERROR_PROPERTY_TYPE;
+    }
+    if(ptype->etype != GDI_SINGLE_ENTITY || ptype->stype != GDI_FIXED_SIZE) {
+      return GDI_ERROR_PROPERTY_TYPE;
+    }
+    for(size_t j = 0; j < i; j++) {
+      if(array_of_ptypes[j] == ptype) {
+        return GDI_ERROR_PROPERTY_TYPE;
+      }
+    }
+  }
+
+  GDI_Label_db_t* labels = ((GDI_Database)label->db)->labels;
+  if(label->int_handle < labels->num_schemas && labels->schemas[label->int_handle] != NULL) {
+    return GDI_ERROR_STATE;
+  }
+
+  if(label->int_handle >= labels->num_schemas) {
+    uint32_t num_schemas = label->int_handle + 1;
+    labels->schemas = realloc(labels->schemas, num_schemas * sizeof(GDA_PropertySchema*));
+    assert(labels->schemas != NULL);
+    memset(labels->schemas + labels->num_schemas, 0, (num_schemas - labels->num_schemas) * sizeof(GDA_PropertySchema*));
+    labels->num_schemas = num_schemas;
+  }
+  labels->schemas[label->int_handle] = GDA_CreatePropertySchema(array_of_ptypes, count);
+
+  return GDI_SUCCESS;
+}
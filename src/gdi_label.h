@@ -53,6 +53,15 @@ typedef struct GDI_Label_db {
    */
   GDA_HashMap* name_to_address;
   uint32_t label_max;
+  /**
+    property schema (gda_property.h) of each label, indexed by the
+    integer handle of the label, NULL for labels without one
+
+    schemas are kept until the database is freed, because vertices still
+    store the slots of a label, after it was freed
+   */
+  struct GDA_PropertySchema_desc** schemas;
+  uint32_t num_schemas;
 } GDI_Label_db_t;
 
 /**
@@ -91,6 +91,8 @@ int GDI_CreatePropertyType( const char* name, int etype, GDI_Datatype dtype,
     return GDI_ERROR_STATE;
   }
 
+  bool dictionary_flag = (stype & GDI_DICTIONARY_ENCODED) != 0;
+  stype &= ~GDI_DICTIONARY_ENCODED;
   if(is_invalid_stype(stype) == GDI_TRUE) {
     return GDI_ERROR_STATE;
   }
@@ -133,6 +135,7 @@ int GDI_CreatePropertyType( const char* name, int etype, GDI_Datatype dtype,
   (*ptype)->etype = etype;
   (*ptype)->dtype = dtype;
   (*ptype)->stype = stype;
+  (*ptype)->dictionary_flag = dictionary_flag;
   (*ptype)->count = count;
 
   // add to the data structures: store the reference to the struct in the list
@@ -195,6 +198,8 @@ int GDI_UpdatePropertyType( const char* name, int etype, GDI_Datatype dtype,
     return GDI_ERROR_DATATYPE;
   }
 
+  bool dictionary_flag = (stype & GDI_DICTIONARY_ENCODED) != 0;
+  stype &= ~GDI_DICTIONARY_ENCODED;
   if(is_invalid_stype(stype) == GDI_TRUE) {
     return GDI_ERROR_STATE;
   }
@@ -293,6 +298,7 @@ int GDI_UpdatePropertyType( const char* name, int etype, GDI_Datatype dtype,
 
   ptype->etype = etype;
   ptype->stype = stype;
+  ptype->dictionary_flag = dictionary_flag;
   ptype->count = count;
   ptype->dtype = dtype;
 
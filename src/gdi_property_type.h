@@ -90,6 +90,11 @@ typedef struct GDI_PropertyType_desc {
     type of the size limitation (state)
    */
   uint8_t stype;
+  /**
+    whether the values are stored dictionary encoded
+    (GDI_DICTIONARY_ENCODED)
+   */
+  bool dictionary_flag;
   /**
     number of elements (positive integer)
    */
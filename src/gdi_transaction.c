@@ -11,17 +11,97 @@
 
 #include "gdi.h"
 #include "gda_block.h"
+#include "gda_dictionary.h"
 #include "gda_dpointer.h"
+#include "gda_edge_record.h"
+#include "gda_index.h"
+#include "gda_internal_index.h"
 #include "gda_lightweight_edges.h"
 #include "gda_lock.h"
 #include "gda_property.h"
 #include "gda_vertex.h"
+#include "gda_yield.h"
 
 /**
   constant definitions
  */
 #define LOCK_SINGLE_WRITER  1
 
+
+/**
+  Marks the blocks of a changed vertex, that have to be written back:
+  the primary block (vertex metadata) is always written, the other
+  blocks only if they contain changed lightweight edge data or property
+  data, or if their content was shifted, because the size of the
+  lightweight edge data changed. All blocks are written, if the vertex
+  is new or the number of its blocks changed.
+ */
+static void GDA_MarkChangedBlocks( bool changed_blocks[], uint64_t lightweight_edge_size, uint64_t property_size, uint64_t block_size, GDI_VertexHolder vertex ) {
+  uint32_t num_blocks = vertex->blocks->size;
+  bool all_flag = (num_blocks != vertex->num_stored_blocks);
+
+  changed_blocks[0] = true;
+  for( uint32_t i=1 ; i<num_blocks ; i++ ) {
+    changed_blocks[i] = all_flag;
+  }
+  if( all_flag ) {
+    return;
+  }
+
+  /**
+    offset of the lightweight edge data in the data of the vertex, which
+    is spread over its blocks in order
+   */
+  uint64_t edge_offset = GDA_VERTEX_METADATA_SIZE + (num_blocks - 1) * sizeof(GDA_DPointer);
+
+  /**
+    all data from changed_offset on has to be written
+   */
+  uint64_t changed_offset = edge_offset + lightweight_edge_size + property_size;
+  if( vertex->property_write_flag ) {
+    changed_offset = edge_offset + lightweight_edge_size;
+  }
+  if( lightweight_edge_size != vertex->lightweight_edge_stored_size ) {
+    uint64_t common_size = (lightweight_edge_size < vertex->lightweight_edge_stored_size) ? lightweight_edge_size : vertex->lightweight_edge_stored_size;
+    if( edge_offset + common_size < changed_offset ) {
+      changed_offset = edge_offset + common_size;
+    }
+  }
+  if( (vertex->lightweight_edge_dirty_offset < lightweight_edge_size) && (edge_offset + vertex->lightweight_edge_dirty_offset < changed_offset) ) {
+    changed_offset = edge_offset + vertex->lightweight_edge_dirty_offset;
+  }
+  for( uint64_t i=changed_offset/block_size ; i<num_blocks ; i++ ) {
+    changed_blocks[i] = true;
+  }
+
+  /**
+    blocks with changed pages of the lightweight edge data
+   */
+  for( uint64_t page=0 ; page<vertex->lightweight_edge_num_dirty_pages ; page++ ) {
+    uint64_t begin = page * block_size;
+    if( begin >= lightweight_edge_size ) {
+      break;
+    }
+    if( vertex->lightweight_edge_dirty_pages[page >> 6] & ((uint64_t) 1 << (page & 63)) ) {
+      uint64_t end = (begin + block_size < lightweight_edge_size) ? (begin + block_size) : lightweight_edge_size;
+      for( uint64_t i=(edge_offset+begin)/block_size ; i<=(edge_offset+end-1)/block_size ; i++ ) {
+        changed_blocks[i] = true;
+      }
+    }
+  }
+}
+
+
+/**
+  writes the next block of a vertex, if it was changed
+ */
+static inline void GDA_PutChangedBlock( const void* buf, uint32_t* block_index, const bool changed_blocks[], GDI_VertexHolder vertex ) {
+  if( changed_blocks[*block_index] ) {
+    GDA_PutBlock( buf, *(GDA_DPointer*) GDA_vector_at( vertex->blocks, *block_index ), vertex->transaction->db );
+  }
+  (*block_index)++;
+}
+
 int GDI_StartTransaction( GDI_Database graph_db, GDI_Transaction* transaction ) {
   /**
     check the input arguments
@@ -59,6 +139,7 @@ int GDI_StartTransaction( GDI_Database graph_db, GDI_Transaction* transaction )
    */
   GDA_vector_create( &((*transaction)->vertices), sizeof(GDI_VertexHolder), 8 /* initial capacity */ );
   GDA_vector_create( &((*transaction)->edges), sizeof(GDI_EdgeHolder), 8 /* initial capacity */ );
+  (*transaction)->removed_edge_records = NULL;
   /**
     init hash map that will translate vertex UIDs to vertex handles,
     in case a vertex is already associated with this transaction
@@ -107,14 +188,30 @@ int GDI_CloseTransaction( GDI_Transaction* transaction, int ctype ) {
      */
     uint64_t block_size = (*transaction)->db->block_size;
 
+    /**
+      write the edge records first, since storing the lightweight edges
+      of a vertex can change the offsets of its edges
+     */
+    GDA_StoreEdgeRecords( *transaction );
+
     char** buffers;
     size_t buf_index = 0;
-    buffers = malloc( vec_size * 4 * sizeof(char*) );
+    /**
+      at most four block buffers and the stored property data per vertex
+     */
+    buffers = malloc( vec_size * 5 * sizeof(char*) );
 
     for( size_t j=0 ; j<vec_size ; j++ ) {
       GDI_VertexHolder vertex = *(GDI_VertexHolder*)GDA_vector_at( (*transaction)->vertices, j );
 
       if( vertex->delete_flag ) {
+        /**
+          remove the vertex from the bitmap of all vertices and from
+          the secondary indexes, before its blocks can be reused
+         */
+        GDA_UpdateVertexBitmap( vertex );
+        GDA_UpdateIndexes( vertex );
+
         /**
           vertex is marked for deletion, so release its blocks
          */
@@ -128,15 +225,18 @@ int GDI_CloseTransaction( GDI_Transaction* transaction, int ctype ) {
           /**
             vertex was changed during the transaction, but is not marked for deletion
            */
-          uint64_t remaining_lightweight_edge_data = vertex->lightweight_edge_insert_offset * sizeof(GDA_DPointer);
-          if( ((vertex->lightweight_edge_insert_offset - 2) % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE) == 0 ) {
-            /**
-              omit the lightweight edge meta and label data of the next block
-             */
-            remaining_lightweight_edge_data -= 2 * sizeof(GDA_DPointer);
-          }
-          // TODO: property data not calculated correctly
-          uint64_t remaining_property_data = vertex->property_size;
+          uint8_t* lightweight_edge_data;
+          uint32_t num_lightweight_edges;
+          uint64_t remaining_lightweight_edge_data = GDA_LightweightEdgesPrepareStore( &lightweight_edge_data, &num_lightweight_edges, vertex );
+          /**
+            the property data is written in the stored format (gda_property.h)
+           */
+          uint64_t property_size = GDA_StoredPropertyListSize( vertex );
+          char* property_data = malloc( property_size );
+          assert( property_data != NULL );
+          property_size = GDA_StorePropertyList( property_data, vertex );
+          buffers[buf_index++] = property_data;
+          uint64_t remaining_property_data = property_size;
           uint64_t total_vertex_size = GDA_VERTEX_METADATA_SIZE + remaining_lightweight_edge_data + remaining_property_data;
           uint32_t total_num_blocks = 1;
           if( total_vertex_size > block_size ) {
@@ -154,12 +254,20 @@ int GDI_CloseTransaction( GDI_Transaction* transaction, int ctype ) {
               not enough blocks associated with this vertex
 
               we will try to get new blocks from the same rank
-              that stores the primary block
+              that stores the primary block, unless the vertex is a
+              hub: then the blocks above hub_threshold are distributed
+              round-robin over all ranks, so that no rank has to store
+              all of them
              */
             GDA_DPointer* primary_block = GDA_vector_at( vertex->blocks, 0 );
-            uint64_t offset, target_rank;
-            GDA_GetDPointer( &offset, &target_rank, *primary_block );
+            uint64_t offset, primary_rank;
+            GDA_GetDPointer( &offset, &primary_rank, *primary_block );
+            uint64_t hub_threshold = (*transaction)->db->hub_threshold;
             for( uint64_t i=vertex->blocks->size ; i<total_num_blocks ; i++ ) {
+              uint64_t target_rank = primary_rank;
+              if( (hub_threshold > 0) && (i >= hub_threshold) ) {
+                target_rank = (primary_rank + i) % (*transaction)->db->commsize;
+              }
               GDA_DPointer dpointer = GDA_AllocateBlock( target_rank, (*transaction)->db );
               if( dpointer == GDA_DPOINTER_NULL ) {
                 /**
@@ -175,14 +283,22 @@ int GDI_CloseTransaction( GDI_Transaction* transaction, int ctype ) {
               /**
                 more blocks than necessary
                */
-              for( uint64_t i=vertex->blocks->size-1 ; i>total_num_blocks ; i-- ) {
-                GDA_DPointer* dp_ptr = GDA_vector_at( vertex->blocks, i );
+              while( vertex->blocks->size > total_num_blocks ) {
+                GDA_DPointer* dp_ptr = GDA_vector_at( vertex->blocks, vertex->blocks->size-1 );
                 GDA_DeallocateBlock( *dp_ptr, (*transaction)->db );
+                GDA_vector_pop_back( vertex->blocks );
               }
             }
           }
           assert( total_num_blocks == vertex->blocks->size );
 
+          /**
+            only write back the blocks, that were changed
+           */
+          bool* changed_blocks = malloc( total_num_blocks * sizeof(bool) );
+          assert( changed_blocks != NULL );
+          GDA_MarkChangedBlocks( changed_blocks, remaining_lightweight_edge_data, property_size, block_size, vertex );
+
           char* buf = malloc( block_size );
           assert( buf != NULL );
           buffers[buf_index++] = buf;
@@ -197,19 +313,31 @@ int GDI_CloseTransaction( GDI_Transaction* transaction, int ctype ) {
             -----------------
             | unused size   |
             -----------------
+            | edge size     |
+            -----------------
+            |#in    | #out  |
+            -----------------
+            |#undir | unused|
+            -----------------
            */
           /**
             number of blocks, including the primary block
            */
           *(uint32_t*)(buf+GDA_OFFSET_NUM_BLOCKS) = vertex->blocks->size;
           /**
-            need to calculate the actual number of lightweight edges
-            assumes that shrink has been called before
+            number of lightweight edge slots (number of edges in the
+            compressed form)
+           */
+          *(uint32_t*)(buf+GDA_OFFSET_NUM_LIGHTWEIGHT_EDGES) = num_lightweight_edges;
+          *(uint64_t*)(buf+GDA_OFFSET_SIZE_PROPERTY_DATA) = property_size | GDA_PROPERTY_STORED_VARINT;
+          *(uint64_t*)(buf+GDA_OFFSET_SIZE_UNUSED_SPACE) = 0; /* only used by the in-memory format */
+          *(uint64_t*)(buf+GDA_OFFSET_SIZE_LIGHTWEIGHT_EDGES) = remaining_lightweight_edge_data;
+          /**
+            degree counters, so that the degrees are available without
+            scanning the edges
            */
-          *(uint32_t*)(buf+GDA_OFFSET_NUM_LIGHTWEIGHT_EDGES) = (vertex->lightweight_edge_insert_offset - 2) / GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE * (GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE-2)
-                                                               + (vertex->lightweight_edge_insert_offset - 2) % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE;
-          *(uint64_t*)(buf+GDA_OFFSET_SIZE_PROPERTY_DATA) = vertex->property_size;
-          *(uint64_t*)(buf+GDA_OFFSET_SIZE_UNUSED_SPACE) = vertex->unused_space;
+          memcpy( buf+GDA_OFFSET_DEGREES, vertex->lightweight_edge_degrees, sizeof(vertex->lightweight_edge_degrees) );
+          *(uint32_t*)(buf+GDA_OFFSET_DEGREES+sizeof(vertex->lightweight_edge_degrees)) = 0;
 
           /**
             now we will prepare the rest of the primary block,
@@ -222,10 +350,9 @@ int GDI_CloseTransaction( GDI_Transaction* transaction, int ctype ) {
             counter for the next block to transfer
            */
           uint32_t block_index = 0;
-          GDA_DPointer* dp = vertex->blocks->data;
           char* block_source_address = (char*)(vertex->blocks->data) + sizeof(GDA_DPointer);
-          char* lightweight_edge_source_address = (char*)vertex->lightweight_edge_data;
-          char* property_source_address = vertex->property_data;
+          char* lightweight_edge_source_address = (char*)lightweight_edge_data;
+          char* property_source_address = property_data;
           char* buf_target_address = buf+GDA_VERTEX_METADATA_SIZE;
 
           /**
@@ -260,7 +387,7 @@ int GDI_CloseTransaction( GDI_Transaction* transaction, int ctype ) {
               /**
                 block is completely filled
                */
-              GDA_PutBlock( buf, dp[block_index++], (*transaction)->db );
+              GDA_PutChangedBlock( buf, &block_index, changed_blocks, vertex );
 
               buf = malloc( block_size );
               assert( buf != NULL );
@@ -272,7 +399,7 @@ int GDI_CloseTransaction( GDI_Transaction* transaction, int ctype ) {
             uint32_t num_block_data_blocks = remaining_block_data/block_size;
 
             for( uint32_t i=0 ; i<num_block_data_blocks ; i++ ) {
-              GDA_PutBlock( block_source_address, dp[block_index++], (*transaction)->db );
+              GDA_PutChangedBlock( block_source_address, &block_index, changed_blocks, vertex );
 
               block_source_address += block_size;
             }
@@ -324,7 +451,7 @@ int GDI_CloseTransaction( GDI_Transaction* transaction, int ctype ) {
               /**
                 block is completely filled
                */
-              GDA_PutBlock( buf, dp[block_index++], (*transaction)->db );
+              GDA_PutChangedBlock( buf, &block_index, changed_blocks, vertex );
 
               buf = malloc( block_size );
               assert( buf != NULL );
@@ -339,7 +466,7 @@ int GDI_CloseTransaction( GDI_Transaction* transaction, int ctype ) {
             uint32_t num_block_lightweight_edges = remaining_lightweight_edge_data/block_size;
 
             for( uint32_t i=0 ; i<num_block_lightweight_edges ; i++ ) {
-              GDA_PutBlock( lightweight_edge_source_address, dp[block_index++], (*transaction)->db );
+              GDA_PutChangedBlock( lightweight_edge_source_address, &block_index, changed_blocks, vertex );
 
               lightweight_edge_source_address += block_size;
             }
@@ -394,7 +521,7 @@ int GDI_CloseTransaction( GDI_Transaction* transaction, int ctype ) {
               /**
                 block is completely filled
                */
-              GDA_PutBlock( buf, dp[block_index++], (*transaction)->db );
+              GDA_PutChangedBlock( buf, &block_index, changed_blocks, vertex );
 
               buf = malloc( block_size );
               assert( buf != NULL );
@@ -408,7 +535,7 @@ int GDI_CloseTransaction( GDI_Transaction* transaction, int ctype ) {
             uint32_t num_block_property = remaining_property_data/block_size;
 
             for( uint32_t i=0 ; i<num_block_property ; i++ ) {
-              GDA_PutBlock( property_source_address, dp[block_index++], (*transaction)->db );
+              GDA_PutChangedBlock( property_source_address, &block_index, changed_blocks, vertex );
 
               property_source_address += block_size;
             }
@@ -436,10 +563,11 @@ int GDI_CloseTransaction( GDI_Transaction* transaction, int ctype ) {
               at least partially packed the buffer, so have to transfer
               the buffer
              */
-            GDA_PutBlock( buf, dp[block_index++], (*transaction)->db );
+            GDA_PutChangedBlock( buf, &block_index, changed_blocks, vertex );
           }
 
           assert( block_index == vertex->blocks->size );
+          free( changed_blocks );
         }
       }
     }
@@ -447,6 +575,7 @@ int GDI_CloseTransaction( GDI_Transaction* transaction, int ctype ) {
     /**
       TODO: do this later (after the index update)?
      */
+    GDA_Yield();
     RMA_Win_flush_all( (*transaction)->db->win_blocks );
 
     /**
@@ -525,14 +654,14 @@ int GDI_CloseTransaction( GDI_Transaction* transaction, int ctype ) {
 
               key = (key & 0x00FFFFFFFFFFFFFF) | ((uint64_t)(GDI_LABEL_NONE->int_handle) << 56);
 
-              GDA_InsertElementIntoRMAHashMap( hashed_key, key, value, vertex->incarnation, (*transaction)->db->internal_index );
+              GDA_InsertIntoInternalIndex( hashed_key, key, value, vertex->incarnation, (*transaction)->db );
             } else {
               for( size_t i=0 ; i<num_labels ; i++ ) {
                 uint64_t hashed_key = GDA_hash_property_id( id_buf, id_size, (labels[i])->int_handle );
 
                 key = (key & 0x00FFFFFFFFFFFFFF) | ((uint64_t)((labels[i])->int_handle) << 56);
 
-                GDA_InsertElementIntoRMAHashMap( hashed_key, key, value, vertex->incarnation, (*transaction)->db->internal_index );
+                GDA_InsertIntoInternalIndex( hashed_key, key, value, vertex->incarnation, (*transaction)->db );
               }
             }
           } else {
@@ -551,7 +680,7 @@ int GDI_CloseTransaction( GDI_Transaction* transaction, int ctype ) {
                 key = (key & 0x00FFFFFFFFFFFFFF) | ((uint64_t)(GDI_LABEL_NONE->int_handle) << 56);
 
                 bool del_flag;
-                del_flag = GDA_RemoveElementFromRMAHashMap( hashed_key, key, (*transaction)->db->internal_index );
+                del_flag = GDA_RemoveFromInternalIndex( hashed_key, key, (*transaction)->db );
                 assert( del_flag );
               } else {
                 bool del_flag;
@@ -560,7 +689,7 @@ int GDI_CloseTransaction( GDI_Transaction* transaction, int ctype ) {
 
                   key = (key & 0x00FFFFFFFFFFFFFF) | ((uint64_t)((labels[i])->int_handle) << 56);
 
-                  del_flag = GDA_RemoveElementFromRMAHashMap( hashed_key, key, (*transaction)->db->internal_index );
+                  del_flag = GDA_RemoveFromInternalIndex( hashed_key, key, (*transaction)->db );
                   assert( del_flag );
                 }
               }
@@ -580,8 +709,18 @@ int GDI_CloseTransaction( GDI_Transaction* transaction, int ctype ) {
       }
     }
 
-    // TODO: update indexes
+    /**
+      update the bitmap of all vertices and the secondary indexes
 
+      deleted vertices are already handled
+     */
+    for( size_t j=0 ; j<vec_size ; j++ ) {
+      GDI_VertexHolder vertex = *(GDI_VertexHolder*)GDA_vector_at( (*transaction)->vertices, j );
+      if( !(vertex->delete_flag) ) {
+        GDA_UpdateVertexBitmap( vertex );
+        GDA_UpdateIndexes( vertex );
+      }
+    }
   }
 
   /**
@@ -604,8 +743,9 @@ int GDI_CloseTransaction( GDI_Transaction* transaction, int ctype ) {
   for( size_t i=0 ; i<vec_size ; i++ ) {
     // TODO: might be additional work necessary
     GDI_VertexHolder vertex = *(GDI_VertexHolder*)GDA_vector_at( (*transaction)->vertices, i );
-    free( vertex->property_data );
-    free( vertex->lightweight_edge_data );
+    GDA_FreeIndexEntries( vertex );
+    GDA_LinearScanningFreePropertyList( vertex );
+    GDA_LightweightEdgesFree( vertex );
     GDA_list_free( &(vertex->edges) );
     GDA_vector_free( &(vertex->blocks) );
     free( vertex );
@@ -618,9 +758,14 @@ int GDI_CloseTransaction( GDI_Transaction* transaction, int ctype ) {
   vec_size = (*transaction)->edges->size;
   for( size_t i=0 ; i<vec_size ; i++ ) {
     // TODO: might be additional work necessary
-    free( *(GDI_EdgeHolder*)GDA_vector_at( (*transaction)->edges, i ) );
+    GDI_EdgeHolder edge = *(GDI_EdgeHolder*)GDA_vector_at( (*transaction)->edges, i );
+    GDA_FreeEdgeRecord( edge );
+    free( edge );
   }
   GDA_vector_free( &((*transaction)->edges) );
+  if( (*transaction)->removed_edge_records != NULL ) {
+    GDA_vector_free( &((*transaction)->removed_edge_records) );
+  }
 
   /**
     free the vertex translation hash map
@@ -674,6 +819,16 @@ int GDI_StartCollectiveTransaction( GDI_Database graph_db, GDI_Transaction* tran
    */
   MPI_Barrier( graph_db->comm );
 
+  /**
+    no process accesses the internal index, the secondary indexes, the
+    edge records or the dictionary at this point, so pending rehashes are
+    finished and old table generations are freed
+   */
+  GDA_MaintainInternalIndex( graph_db );
+  GDA_MaintainIndexes( graph_db );
+  GDA_MaintainEdgeRecords( graph_db );
+  GDA_MaintainDictionary( graph_db );
+
   /**
     passed all input checks, so it is safe to create the output buffer
    */
@@ -692,6 +847,7 @@ int GDI_StartCollectiveTransaction( GDI_Database graph_db, GDI_Transaction* tran
    */
   GDA_vector_create( &((*transaction)->vertices), sizeof(GDI_VertexHolder), 8 /* initial capacity */ );
   GDA_vector_create( &((*transaction)->edges), sizeof(GDI_EdgeHolder), 8 /* initial capacity */ );
+  (*transaction)->removed_edge_records = NULL;
   /**
     init hash map that will translate vertex UIDs to vertex handles,
     in case a vertex is already associated with this transaction
@@ -749,8 +905,9 @@ int GDI_CloseCollectiveTransaction( GDI_Transaction* transaction, int ctype ) {
   for( size_t i=0 ; i<vec_size ; i++ ) {
     // TODO: might be additional work necessary
     GDI_VertexHolder vertex = *(GDI_VertexHolder*)GDA_vector_at( (*transaction)->vertices, i );
-    free( vertex->property_data );
-    free( vertex->lightweight_edge_data );
+    GDA_FreeIndexEntries( vertex );
+    GDA_LinearScanningFreePropertyList( vertex );
+    GDA_LightweightEdgesFree( vertex );
     GDA_list_free( &(vertex->edges) );
     GDA_vector_free( &(vertex->blocks) );
     free( vertex );
@@ -763,9 +920,14 @@ int GDI_CloseCollectiveTransaction( GDI_Transaction* transaction, int ctype ) {
   vec_size = (*transaction)->edges->size;
   for( size_t i=0 ; i<vec_size ; i++ ) {
     // TODO: might be additional work necessary
-    free( *(GDI_EdgeHolder*)GDA_vector_at( (*transaction)->edges, i ) );
+    GDI_EdgeHolder edge = *(GDI_EdgeHolder*)GDA_vector_at( (*transaction)->edges, i );
+    GDA_FreeEdgeRecord( edge );
+    free( edge );
   }
   GDA_vector_free( &((*transaction)->edges) );
+  if( (*transaction)->removed_edge_records != NULL ) {
+    GDA_vector_free( &((*transaction)->removed_edge_records) );
+  }
 
   /**
     free the vertex translation hash map
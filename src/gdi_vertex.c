@@ -13,7 +13,9 @@
 #include "gda_block.h"
 #include "gda_constraint.h"
 #include "gda_dpointer.h"
+#include "gda_edge_record.h"
 #include "gda_edge_uid.h"
+#include "gda_index.h"
 #include "gda_lock.h"
 #include "gda_lightweight_edges.h"
 #include "gda_property.h"
@@ -55,6 +57,9 @@ int GDI_CreateVertex( const void* external_id, size_t size, GDI_Transaction tran
   (*vertex)->delete_flag = false;
   (*vertex)->write_flag = true;
   (*vertex)->creation_flag = true;
+  (*vertex)->property_write_flag = true;
+  (*vertex)->num_stored_blocks = 0;
+  (*vertex)->index_entries = NULL;
   transaction->write_flag = true;
 
   GDA_vector_push_back( transaction->vertices, vertex );
@@ -220,6 +225,7 @@ int GDI_FreeVertex( GDI_VertexHolder* vertex ) {
   /**
     passed all input checks
    */
+  GDA_SnapshotIndexEntries( *vertex );
   (*vertex)->delete_flag = true;
   (*vertex)->write_flag = true;
   (*vertex)->transaction->write_flag = true;
@@ -242,21 +248,25 @@ int GDI_FreeVertex( GDI_VertexHolder* vertex ) {
     iterate over all edges from this vertex and associate the respective vertex,
     and delete the edge there
    */
-  uint8_t* metadata_iterator;
+  uint8_t *metadata, *label;
   uint32_t offset, max_offset;
   GDI_VertexHolder other_vertex;
   int status;
 
-  offset = 2;
   max_offset = (*vertex)->lightweight_edge_insert_offset;
-  metadata_iterator = (uint8_t*) (*vertex)->lightweight_edge_data;
 
   /**
     main loop over the edges
    */
-  while( offset < max_offset ) {
-    if( *metadata_iterator != 0 ) {
+  for( offset=2 ; offset<max_offset ; offset=GDA_LightweightEdgesNextOffset( offset, *vertex ) ) {
+    GDA_LightweightEdgesGetMetadataPointerWithOffset( &metadata, *vertex, offset );
+    if( *metadata != 0 ) {
       /* edge is not deleted */
+      GDA_LightweightEdgesGetLabelPointerWithOffset( &label, *vertex, offset );
+      if( *metadata & GDA_LIGHTWEIGHT_EDGES_RECORD ) {
+        GDA_RemoveEdgeRecord( GDA_EdgeRecordKey( *(GDA_DPointer*)((*vertex)->blocks->data), (*vertex)->lightweight_edge_data[offset], *metadata, *label ), (*vertex)->transaction );
+      }
+
       if( (*vertex)->lightweight_edge_data[offset] != *(GDA_DPointer*)((*vertex)->blocks->data) ) {
         /* not the same vertex/no self-edge */
         status = GDI_AssociateVertex( (*vertex)->lightweight_edge_data[offset], (*vertex)->transaction, &other_vertex );
@@ -276,7 +286,7 @@ int GDI_FreeVertex( GDI_VertexHolder* vertex ) {
           }
         }
 
-        uint32_t other_offset = GDA_LightweightEdgesFindEdge( *metadata_iterator + 256, *(GDA_DPointer*)((*vertex)->blocks->data), *(metadata_iterator+8), other_vertex );
+        uint32_t other_offset = GDA_LightweightEdgesFindEdge( (*metadata & GDA_LIGHTWEIGHT_EDGES_ORIENTATION) + 256, *(GDA_DPointer*)((*vertex)->blocks->data), *label, *metadata & ~GDA_LIGHTWEIGHT_EDGES_ORIENTATION, other_vertex );
         assert( other_offset != 0 );
 
         bool del_flag;
@@ -286,16 +296,6 @@ int GDI_FreeVertex( GDI_VertexHolder* vertex ) {
         other_vertex->write_flag = true;
       }
     }
-
-    offset++;
-    metadata_iterator++;
-    if( offset % GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE == 0 ) {
-      /**
-        go to the next block
-       */
-      offset += 2;
-      metadata_iterator += GDA_LIGHTWEIGHT_EDGES_BLOCK_SIZE_BYTES - sizeof(GDA_DPointer);
-    }
   }
 
   /**
@@ -340,12 +340,10 @@ int GDI_GetEdgesOfVertex( GDI_Edge_uid array_of_uids[], size_t count, size_t* re
   /**
     constraint evaluation
    */
-  uint8_t* list;
-  size_t list_size = 0;
-  bool list_flag; /* indicates whether the list is a whitelist (true) or a blacklist (false); only significant if list_size > 0 */
+  const uint64_t* label_set = NULL; /* NULL, if the labels are not restricted */
   if( constraint != NULL ) {
     int ret;
-    ret = GDA_EvalConstraintInLightweightEdgeContext( &list, &list_size, &list_flag, constraint );
+    ret = GDA_EvalConstraintInLightweightEdgeContext( &label_set, constraint );
     if( ret == GDI_ERROR_CONSTRAINT ) {
       return GDI_ERROR_CONSTRAINT;
     }
@@ -356,16 +354,10 @@ int GDI_GetEdgesOfVertex( GDI_Edge_uid array_of_uids[], size_t count, size_t* re
    */
 
   if( (array_of_uids == NULL) || (count == 0) ) {
-    if( list_size == 0 ) {
-      GDA_LightweightEdgesNumEdges( resultcount, edge_orientation, vertex );
+    if( label_set == NULL ) {
+      GDA_LightweightEdgesDegree( resultcount, edge_orientation, vertex );
     } else {
-      if( list_flag ) {
-        GDA_LightweightEdgesNumEdgesWithLabelWhitelist( resultcount, edge_orientation, list, list_size, vertex );
-      } else {
-        GDA_LightweightEdgesNumEdgesWithLabelBlacklist( resultcount, edge_orientation, list, list_size, vertex );
-      }
-
-      free( list );
+      GDA_LightweightEdgesNumEdgesWithLabelSet( resultcount, edge_orientation, label_set, vertex );
     }
 
     return GDI_SUCCESS;
@@ -377,14 +369,10 @@ int GDI_GetEdgesOfVertex( GDI_Edge_uid array_of_uids[], size_t count, size_t* re
   vertex_uid = *(GDA_DPointer*) vertex->blocks->data;
   array_of_offsets = malloc( count * sizeof(uint32_t) );
 
-  if( list_size == 0 ) {
+  if( label_set == NULL ) {
     status = GDA_LightweightEdgesFilterEdges( array_of_offsets, count, resultcount, edge_orientation, vertex );
   } else {
-    if( list_flag ) {
-      status = GDA_LightweightEdgesFilterEdgesWithLabelWhitelist( array_of_offsets, count, resultcount, edge_orientation, list, list_size, vertex );
-    } else {
-      status = GDA_LightweightEdgesFilterEdgesWithLabelBlacklist( array_of_offsets, count, resultcount, edge_orientation, list, list_size, vertex );
-    }
+    status = GDA_LightweightEdgesFilterEdgesWithLabelSet( array_of_offsets, count, resultcount, edge_orientation, label_set, vertex );
   }
 
   for( size_t i=0 ; i<*resultcount ; i++ ) {
@@ -392,9 +380,6 @@ int GDI_GetEdgesOfVertex( GDI_Edge_uid array_of_uids[], size_t count, size_t* re
     GDA_PackEdgeUid( vertex_uid, offset, array_of_uids + i );
   }
 
-  if( list_size > 0 ) {
-    free( list );
-  }
   free( array_of_offsets );
 
   return status;
@@ -433,12 +418,10 @@ int GDI_GetNeighborVerticesOfVertex( GDI_Vertex_uid array_of_uids[], size_t coun
   /**
     constraint evalulation
    */
-  uint8_t* list;
-  size_t list_size = 0;
-  bool list_flag; /* indicates whether the list is a whitelist (true) or a blacklist (false); only significant if list_size > 0 */
+  const uint64_t* label_set = NULL; /* NULL, if the labels are not restricted */
   if( constraint != NULL ) {
     int ret;
-    ret = GDA_EvalConstraintInLightweightEdgeContext( &list, &list_size, &list_flag, constraint );
+    ret = GDA_EvalConstraintInLightweightEdgeContext( &label_set, constraint );
     if( ret == GDI_ERROR_CONSTRAINT ) {
       return GDI_ERROR_CONSTRAINT;
     }
@@ -449,16 +432,10 @@ int GDI_GetNeighborVerticesOfVertex( GDI_Vertex_uid array_of_uids[], size_t coun
    */
 
   if( (array_of_uids == NULL) || (count == 0) ) {
-    if( list_size == 0 ) {
-      GDA_LightweightEdgesNumEdges( resultcount, edge_orientation, vertex );
+    if( label_set == NULL ) {
+      GDA_LightweightEdgesDegree( resultcount, edge_orientation, vertex );
     } else {
-      if( list_flag ) {
-        GDA_LightweightEdgesNumEdgesWithLabelWhitelist( resultcount, edge_orientation, list, list_size, vertex );
-      } else {
-        GDA_LightweightEdgesNumEdgesWithLabelBlacklist( resultcount, edge_orientation, list, list_size, vertex );
-      }
-
-      free( list );
+      GDA_LightweightEdgesNumEdgesWithLabelSet( resultcount, edge_orientation, label_set, vertex );
     }
 
     return GDI_SUCCESS;
@@ -468,14 +445,10 @@ int GDI_GetNeighborVerticesOfVertex( GDI_Vertex_uid array_of_uids[], size_t coun
   int status;
   array_of_offsets = malloc( count * sizeof(uint32_t) );
 
-  if( list_size == 0 ) {
+  if( label_set == NULL ) {
     status = GDA_LightweightEdgesFilterEdges( array_of_offsets, count, resultcount, edge_orientation, vertex );
   } else {
-    if( list_flag ) {
-      status = GDA_LightweightEdgesFilterEdgesWithLabelWhitelist( array_of_offsets, count, resultcount, edge_orientation, list, list_size, vertex );
-    } else {
-      status = GDA_LightweightEdgesFilterEdgesWithLabelBlacklist( array_of_offsets, count, resultcount, edge_orientation, list, list_size, vertex );
-    }
+    status = GDA_LightweightEdgesFilterEdgesWithLabelSet( array_of_offsets, count, resultcount, edge_orientation, label_set, vertex );
   }
 
   for( size_t i=0 ; i<*resultcount ; i++ ) {
@@ -483,15 +456,437 @@ int GDI_GetNeighborVerticesOfVertex( GDI_Vertex_uid array_of_uids[], size_t coun
     array_of_uids[i] = vertex->lightweight_edge_data[offset];
   }
 
-  if( list_size > 0 ) {
-    free( list );
-  }
   free( array_of_offsets );
 
   return status;
 }
 
 
+/**
+  Returns the neighbors of the vertex like GDI_GetNeighborVerticesOfVertex,
+  but only those, that satisfy target_constraint, which is evaluated
+  against the labels and properties of the neighbor vertices (NULL
+  doesn't filter anything), while constraint still applies to the
+  edges. A neighbor, that is reached through several edges, is returned
+  once for each of them.
+
+  In a collective transaction only the blocks with property data of the
+  neighbors, that aren't associated with the transaction, are fetched
+  (as in GDI_GetPropertiesOfVertices), and the neighbors are not
+  associated. In a single process transaction the neighbors are
+  associated, so that they stay read locked until the transaction ends.
+ */
+int GDI_GetNeighborVerticesOfVertexWithTargetConstraint( GDI_Vertex_uid array_of_uids[], size_t count, size_t* resultcount, GDI_Constraint constraint,
+  GDI_Constraint target_constraint, int edge_orientation, GDI_VertexHolder vertex ) {
+  /**
+    check the input arguments
+   */
+  if( vertex == GDI_VERTEX_NULL ) {
+    return GDI_ERROR_VERTEX;
+  }
+
+  if( resultcount == NULL ) {
+    return GDI_ERROR_BUFFER;
+  }
+
+  if( (target_constraint != NULL) && (target_constraint->stale == GDA_CONSTRAINT_STALE) ) {
+    return GDI_ERROR_STALE;
+  }
+
+  /**
+    the edge related checks are done by GDI_GetNeighborVerticesOfVertex,
+    the degree is an upper bound of the number of its results
+   */
+  size_t degree = 0;
+  uint8_t orientation = edge_orientation;
+  if( (orientation != 0) && (orientation <= 7) ) {
+    GDA_LightweightEdgesDegree( &degree, edge_orientation, vertex );
+  }
+  size_t num_neighbors;
+  GDI_Vertex_uid* neighbors = malloc( (degree + 1) * sizeof(GDI_Vertex_uid) );
+  assert( neighbors != NULL );
+  int ret = GDI_GetNeighborVerticesOfVertex( neighbors, degree + 1, &num_neighbors, constraint, edge_orientation, vertex );
+  if( ret != GDI_SUCCESS ) {
+    free( neighbors );
+    return ret;
+  }
+
+  /**
+    passed all input checks
+   */
+  bool buf_flag = (array_of_uids != NULL) && (count > 0);
+  *resultcount = 0;
+
+  if( target_constraint == NULL ) {
+    *resultcount = num_neighbors;
+    if( buf_flag ) {
+      memcpy( array_of_uids, neighbors, ((num_neighbors < count) ? num_neighbors : count) * sizeof(GDI_Vertex_uid) );
+    }
+    free( neighbors );
+    return (buf_flag && (num_neighbors > count)) ? GDI_ERROR_TRUNCATE : GDI_SUCCESS;
+  }
+
+  GDI_Transaction transaction = vertex->transaction;
+  GDA_CompiledConstraint* compiled = GDA_GetCompiledConstraint( target_constraint );
+
+  GDI_VertexHolder_desc_t* loaded = malloc( GDA_LOAD_VERTEX_PROPERTIES_BATCH * sizeof(GDI_VertexHolder_desc_t) );
+  assert( loaded != NULL );
+  GDI_Vertex_uid* uids = malloc( GDA_LOAD_VERTEX_PROPERTIES_BATCH * sizeof(GDI_Vertex_uid) );
+  assert( uids != NULL );
+  GDI_VertexHolder* vertices = malloc( GDA_LOAD_VERTEX_PROPERTIES_BATCH * sizeof(GDI_VertexHolder) );
+  assert( vertices != NULL );
+
+  for( size_t start=0 ; start<num_neighbors ; start+=GDA_LOAD_VERTEX_PROPERTIES_BATCH ) {
+    size_t batch_size = num_neighbors - start;
+    if( batch_size > GDA_LOAD_VERTEX_PROPERTIES_BATCH ) {
+      batch_size = GDA_LOAD_VERTEX_PROPERTIES_BATCH;
+    }
+
+    size_t num_loaded = 0;
+    for( size_t i=0 ; (i<batch_size) && (ret == GDI_SUCCESS) ; i++ ) {
+      GDI_VertexHolder* vertex_ptr = GDA_hashmap_get( transaction->v_translate_d2l, (void*) (neighbors + start + i) );
+      if( vertex_ptr != NULL ) {
+        vertices[i] = *vertex_ptr;
+      } else {
+        if( transaction->type == GDI_COLLECTIVE_TRANSACTION ) {
+          memset( loaded + num_loaded, 0, sizeof(GDI_VertexHolder_desc_t) );
+          uids[num_loaded] = neighbors[start+i];
+          vertices[i] = loaded + num_loaded;
+          num_loaded++;
+        } else {
+          ret = GDI_AssociateVertex( neighbors[start+i], transaction, vertices + i );
+        }
+      }
+    }
+    GDA_LoadVertexProperties( uids, num_loaded, transaction, loaded );
+
+    if( ret == GDI_SUCCESS ) {
+      for( size_t i=0 ; i<batch_size ; i++ ) {
+        if( vertices[i]->delete_flag || !GDA_EvalCompiledConstraint( compiled, vertices[i] ) ) {
+          continue;
+        }
+        if( buf_flag && (*resultcount < count) ) {
+          array_of_uids[*resultcount] = neighbors[start+i];
+        }
+        (*resultcount)++;
+      }
+    }
+
+    for( size_t i=0 ; i<num_loaded ; i++ ) {
+      GDA_LinearScanningFreePropertyList( loaded + i );
+    }
+
+    if( ret != GDI_SUCCESS ) {
+      break;
+    }
+  }
+
+  if( (ret == GDI_SUCCESS) && buf_flag && (*resultcount > count) ) {
+    ret = GDI_ERROR_TRUNCATE;
+  }
+
+  free( vertices );
+  free( uids );
+  free( loaded );
+  free( neighbors );
+
+  return ret;
+}
+
+
+/**
+  Prepares an iterator over the neighbors of the vertex, that returns
+  the same neighbors in the same order as GDI_GetNeighborVerticesOfVertex
+  without a result buffer. The constraint is only evaluated once here,
+  and the iterator doesn't hold any allocated memory, so it doesn't have
+  to be freed.
+
+  The iterator only visits the edges, that exist when it is prepared,
+  and becomes invalid, if edges of the vertex are removed or changed.
+ */
+int GDI_InitNeighborIterator( GDI_NeighborIterator* iterator, GDI_Constraint constraint, int edge_orientation, GDI_VertexHolder vertex ) {
+  /**
+    check the input arguments
+   */
+  if( vertex == GDI_VERTEX_NULL ) {
+    return GDI_ERROR_VERTEX;
+  }
+
+  if( vertex->delete_flag ) {
+    return GDI_ERROR_VERTEX;
+  }
+
+  if( iterator == NULL ) {
+    return GDI_ERROR_BUFFER;
+  }
+
+  if( (constraint != NULL) && (constraint->stale == GDA_CONSTRAINT_STALE) ) {
+    return GDI_ERROR_STALE;
+  }
+
+  uint8_t orientation = edge_orientation;
+
+  if( (orientation == 0) || (orientation > 7) ) {
+    return GDI_ERROR_EDGE_ORIENTATION;
+  }
+
+  /**
+    constraint evalulation
+   */
+  const uint64_t* label_set = NULL; /* NULL, if the labels are not restricted */
+  if( constraint != NULL ) {
+    int ret;
+    ret = GDA_EvalConstraintInLightweightEdgeContext( &label_set, constraint );
+    if( ret == GDI_ERROR_CONSTRAINT ) {
+      return GDI_ERROR_CONSTRAINT;
+    }
+  }
+
+  /**
+    passed all input checks
+   */
+  GDA_LightweightEdgesInitCursor( iterator, edge_orientation, label_set, vertex );
+
+  return GDI_SUCCESS;
+}
+
+
+/**
+  Returns the UID of the next neighbor of the iterator and sets
+  found_flag to true, or sets found_flag to false, once all neighbors
+  have been returned.
+ */
+int GDI_NextNeighborVertex( GDI_Vertex_uid* uid, bool* found_flag, GDI_NeighborIterator* iterator ) {
+  /**
+    check the input arguments
+   */
+  if( (uid == NULL) || (found_flag == NULL) || (iterator == NULL) ) {
+    return GDI_ERROR_BUFFER;
+  }
+
+  /**
+    passed all input checks
+   */
+  uint32_t offset;
+  GDA_LightweightEdgesCursorNext( &offset, found_flag, iterator );
+  if( *found_flag ) {
+    *uid = iterator->vertex->lightweight_edge_data[offset];
+  }
+
+  return GDI_SUCCESS;
+}
+
+
+/**
+  Returns the number of edges of the vertex with one of the orientations
+  in edge_orientation (bitwise OR of GDI_EDGE_INCOMING,
+  GDI_EDGE_OUTGOING and GDI_EDGE_UNDIRECTED) without scanning the edges,
+  once the counters of the vertex are available.
+ */
+int GDI_GetDegreeOfVertex( size_t* degree, int edge_orientation, GDI_VertexHolder vertex ) {
+  /**
+    check the input arguments
+   */
+  if( vertex == GDI_VERTEX_NULL ) {
+    return GDI_ERROR_VERTEX;
+  }
+
+  if( vertex->delete_flag ) {
+    return GDI_ERROR_VERTEX;
+  }
+
+  if( degree == NULL ) {
+    return GDI_ERROR_BUFFER;
+  }
+
+  uint8_t orientation = edge_orientation;
+
+  if( (orientation == 0) || (orientation > 7) ) {
+    return GDI_ERROR_EDGE_ORIENTATION;
+  }
+
+  /**
+    passed all input checks
+   */
+  GDA_LightweightEdgesDegree( degree, edge_orientation, vertex );
+
+  return GDI_SUCCESS;
+}
+
+
+static int GDA_CompareDPointers( const void* a, const void* b ) {
+  GDA_DPointer dp_a = *(const GDA_DPointer*) a;
+  GDA_DPointer dp_b = *(const GDA_DPointer*) b;
+  return (dp_a > dp_b) - (dp_a < dp_b);
+}
+
+
+/**
+  collects the DPointers of the neighbors of a vertex in ascending order
+
+  with a sorted adjacency, the neighbors are only sorted, if edges were
+  added during the transaction
+
+  returns the number of neighbors, *neighbors has to be freed by the caller
+ */
+static size_t GDA_CollectSortedNeighbors( GDA_DPointer** neighbors, int edge_orientation, const uint64_t* label_set, GDI_VertexHolder vertex ) {
+  size_t num_slots = GDA_LightweightEdgesNumSlots( vertex );
+  size_t num_neighbors;
+  uint32_t* array_of_offsets = malloc( (num_slots + 1) * sizeof(uint32_t) );
+  assert( array_of_offsets != NULL );
+
+  if( label_set == NULL ) {
+    GDA_LightweightEdgesFilterEdges( array_of_offsets, num_slots + 1, &num_neighbors, edge_orientation, vertex );
+  } else {
+    GDA_LightweightEdgesFilterEdgesWithLabelSet( array_of_offsets, num_slots + 1, &num_neighbors, edge_orientation, label_set, vertex );
+  }
+
+  GDA_DPointer* dpointers = malloc( (num_neighbors + 1) * sizeof(GDA_DPointer) );
+  assert( dpointers != NULL );
+  bool sorted_flag = true;
+  for( size_t i=0 ; i<num_neighbors ; i++ ) {
+    dpointers[i] = vertex->lightweight_edge_data[array_of_offsets[i]];
+    if( (i > 0) && (dpointers[i] < dpointers[i-1]) ) {
+      sorted_flag = false;
+    }
+  }
+  free( array_of_offsets );
+
+  if( !sorted_flag ) {
+    qsort( dpointers, num_neighbors, sizeof(GDA_DPointer), GDA_CompareDPointers );
+  }
+
+  *neighbors = dpointers;
+  return num_neighbors;
+}
+
+
+/**
+  returns the first index in [begin,end) of the sorted list, whose
+  element is not smaller than value
+
+  the distance to the element is doubled in each step, before the
+  remaining range is searched with a binary search, so that the cost is
+  logarithmic in the number of skipped elements
+ */
+static size_t GDA_GallopDPointers( const GDA_DPointer* list, size_t begin, size_t end, GDA_DPointer value ) {
+  if( (begin >= end) || (list[begin] >= value) ) {
+    return begin;
+  }
+
+  size_t low = begin; /* list[low] < value */
+  size_t step = 1;
+  while( (low + step < end) && (list[low+step] < value) ) {
+    low += step;
+    step *= 2;
+  }
+  size_t high = (low + step < end) ? (low + step) : end;
+
+  low++;
+  while( low < high ) {
+    size_t middle = low + (high - low) / 2;
+    if( list[middle] < value ) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low;
+}
+
+
+/**
+  Returns the number of pairs of edges of both vertices, that fulfill
+  the constraint and the edge orientation and lead to the same third
+  vertex (edges to vertex1 or vertex2 are not counted). Without
+  duplicate edges, this is the number of common neighbors, which is the
+  number of triangles, if both vertices are adjacent.
+
+  Both neighbor lists are intersected with a galloping merge, which is
+  linear in the number of neighbors, if both vertices store their edges
+  sorted (edge_sorted of GDA_Init_params).
+ */
+int GDI_GetNumCommonNeighborsOfVertices( size_t* resultcount, GDI_Constraint constraint, int edge_orientation, GDI_VertexHolder vertex1, GDI_VertexHolder vertex2 ) {
+  /**
+    check the input arguments
+   */
+  if( (vertex1 == GDI_VERTEX_NULL) || (vertex2 == GDI_VERTEX_NULL) ) {
+    return GDI_ERROR_VERTEX;
+  }
+
+  if( vertex1->delete_flag || vertex2->delete_flag ) {
+    return GDI_ERROR_VERTEX;
+  }
+
+  if( resultcount == NULL ) {
+    return GDI_ERROR_BUFFER;
+  }
+
+  if( (constraint != NULL) && (constraint->stale == GDA_CONSTRAINT_STALE) ) {
+    return GDI_ERROR_STALE;
+  }
+
+  uint8_t orientation = edge_orientation;
+
+  if( (orientation == 0) || (orientation > 7) ) {
+    return GDI_ERROR_EDGE_ORIENTATION;
+  }
+
+  /**
+    constraint evalulation
+   */
+  const uint64_t* label_set = NULL; /* NULL, if the labels are not restricted */
+  if( constraint != NULL ) {
+    int ret;
+    ret = GDA_EvalConstraintInLightweightEdgeContext( &label_set, constraint );
+    if( ret == GDI_ERROR_CONSTRAINT ) {
+      return GDI_ERROR_CONSTRAINT;
+    }
+  }
+
+  /**
+    passed all input checks
+   */
+  GDA_DPointer *neighbors1, *neighbors2;
+  size_t num_neighbors1 = GDA_CollectSortedNeighbors( &neighbors1, edge_orientation, label_set, vertex1 );
+  size_t num_neighbors2 = GDA_CollectSortedNeighbors( &neighbors2, edge_orientation, label_set, vertex2 );
+
+  GDA_DPointer uid1 = *(GDA_DPointer*)(vertex1->blocks->data);
+  GDA_DPointer uid2 = *(GDA_DPointer*)(vertex2->blocks->data);
+
+  size_t i = 0, j = 0, num_pairs = 0;
+  while( (i < num_neighbors1) && (j < num_neighbors2) ) {
+    if( neighbors1[i] < neighbors2[j] ) {
+      i = GDA_GallopDPointers( neighbors1, i, num_neighbors1, neighbors2[j] );
+    } else if( neighbors1[i] > neighbors2[j] ) {
+      j = GDA_GallopDPointers( neighbors2, j, num_neighbors2, neighbors1[i] );
+    } else {
+      /**
+        same neighbor: count the duplicate edges on both sides
+       */
+      GDA_DPointer neighbor = neighbors1[i];
+      size_t repetition1 = 0, repetition2 = 0;
+      while( (i < num_neighbors1) && (neighbors1[i] == neighbor) ) {
+        i++;
+        repetition1++;
+      }
+      while( (j < num_neighbors2) && (neighbors2[j] == neighbor) ) {
+        j++;
+        repetition2++;
+      }
+      if( (neighbor != uid1) && (neighbor != uid2) ) {
+        num_pairs += repetition1 * repetition2;
+      }
+    }
+  }
+
+  free( neighbors1 );
+  free( neighbors2 );
+
+  *resultcount = num_pairs;
+  return GDI_SUCCESS;
+}
+
 int GDI_AddLabelToVertex( GDI_Label label, GDI_VertexHolder vertex ) {
   /**
     check the input arguments
@@ -535,6 +930,7 @@ int GDI_AddLabelToVertex( GDI_Label label, GDI_VertexHolder vertex ) {
 
   bool found_flag;
 
+  GDA_SnapshotIndexEntries( vertex );
   GDA_LinearScanningInsertLabel( label, vertex, &found_flag );
 
   if( !found_flag ) {
@@ -542,8 +938,8 @@ int GDI_AddLabelToVertex( GDI_Label label, GDI_VertexHolder vertex ) {
       label was not already present
      */
     vertex->write_flag = true;
+    vertex->property_write_flag = true;
     vertex->transaction->write_flag = true;
-    // update the index (maybe)
   }
 
   return GDI_SUCCESS;
@@ -598,11 +994,12 @@ int GDI_RemoveLabelFromVertex( GDI_Label label, GDI_VertexHolder vertex ) {
 
   bool found_flag;
 
+  GDA_SnapshotIndexEntries( vertex );
   GDA_LinearScanningRemoveLabel( label, vertex, &found_flag );
   if( found_flag ) {
     vertex->write_flag = true;
+    vertex->property_write_flag = true;
     vertex->transaction->write_flag = true;
-    // TODO: update the index (maybe)
   }
 
   return GDI_SUCCESS;
@@ -706,6 +1103,7 @@ int GDI_AddPropertyToVertex( const void* value, size_t count, GDI_PropertyType p
     }
   }
 
+  GDA_SnapshotIndexEntries( vertex );
   int ret = GDA_LinearScanningAddProperty( ptype, value, count, vertex );
 
   if( ret == GDI_SUCCESS ) {
@@ -713,9 +1111,9 @@ int GDI_AddPropertyToVertex( const void* value, size_t count, GDI_PropertyType p
       a new property was inserted into the list
      */
     vertex->write_flag = true;
+    vertex->property_write_flag = true;
     vertex->transaction->write_flag = true;
     // TODO: probably have to handle GDI_PROPERTY_TYPE_ID differently
-    // TODO: index update (maybe)
   } else {
     if( ret == GDI_ERROR_PROPERTY_EXISTS ) {
       /**
@@ -800,15 +1198,15 @@ int GDI_GetPropertiesOfVertex( void* buf, size_t buf_count, size_t* buf_resultco
       }
       size_t num_edges;
       if( ptype == GDI_PROPERTY_TYPE_DEGREE ) {
-        GDA_LightweightEdgesNumEdges( &num_edges, (GDI_EDGE_INCOMING | GDI_EDGE_OUTGOING | GDI_EDGE_UNDIRECTED), vertex );
+        GDA_LightweightEdgesDegree( &num_edges, (GDI_EDGE_INCOMING | GDI_EDGE_OUTGOING | GDI_EDGE_UNDIRECTED), vertex );
       } else {
         if( ptype == GDI_PROPERTY_TYPE_INDEGREE ) {
-          GDA_LightweightEdgesNumEdges( &num_edges, GDI_EDGE_INCOMING, vertex );
+          GDA_LightweightEdgesDegree( &num_edges, GDI_EDGE_INCOMING, vertex );
         } else {
           /**
             ptype == GDI_PROPERTY_TYPE_OUTDEGREE
            */
-          GDA_LightweightEdgesNumEdges( &num_edges, GDI_EDGE_OUTGOING, vertex );
+          GDA_LightweightEdgesDegree( &num_edges, GDI_EDGE_OUTGOING, vertex );
         }
       }
       *(uint64_t*) buf = num_edges;
@@ -846,6 +1244,180 @@ int GDI_GetPropertiesOfVertex( void* buf, size_t buf_count, size_t* buf_resultco
 }
 
 
+/**
+  Columnar version of GDI_GetPropertiesOfVertex for many vertices, that
+  don't have to be associated: column j holds the values of property
+  type j of all vertices one after the other, and the values of vertex i
+  are the elements array_of_offsets[j][i] up to array_of_offsets[j][i+1]
+  (so each array of offsets needs count+1 entries).
+
+  array_of_buf_resultcounts[j] returns the number of elements needed for
+  column j. A buffer, that is NULL or too small, is not written from the
+  first vertex on, whose values don't fit, but the offsets are filled in
+  anyway.
+
+  Only the blocks with property data are fetched, and the requests for
+  all vertices are issued together. The function is restricted to
+  collective transactions, which are read-only, so that no locks have to
+  be acquired.
+ */
+int GDI_GetPropertiesOfVertices( void* array_of_bufs[], const size_t array_of_buf_counts[], size_t array_of_buf_resultcounts[], size_t* array_of_offsets[],
+  const GDI_PropertyType array_of_ptypes[], size_t num_ptypes, const GDI_Vertex_uid array_of_uids[], size_t count, GDI_Transaction transaction ) {
+  /**
+    check the input arguments
+   */
+  if( transaction == GDI_TRANSACTION_NULL ) {
+    return GDI_ERROR_TRANSACTION;
+  }
+
+  if( transaction->type != GDI_COLLECTIVE_TRANSACTION ) {
+    return GDI_ERROR_TRANSACTION;
+  }
+
+  if( (num_ptypes > 0) && ((array_of_ptypes == NULL) || (array_of_buf_resultcounts == NULL)) ) {
+    return GDI_ERROR_BUFFER;
+  }
+
+  if( (count > 0) && (array_of_uids == NULL) ) {
+    return GDI_ERROR_BUFFER;
+  }
+
+  for( size_t j=0 ; j<num_ptypes ; j++ ) {
+    GDI_PropertyType ptype = array_of_ptypes[j];
+    if( ptype == GDI_PROPERTY_TYPE_NULL ) {
+      return GDI_ERROR_PROPERTY_TYPE;
+    }
+
+    if( (ptype != GDI_PROPERTY_TYPE_ID) && (ptype != GDI_PROPERTY_TYPE_DEGREE) && (ptype != GDI_PROPERTY_TYPE_INDEGREE) &&
+        (ptype != GDI_PROPERTY_TYPE_OUTDEGREE) && (ptype->db != transaction->db) ) {
+      return GDI_ERROR_OBJECT_MISMATCH;
+    }
+  }
+
+  /**
+    passed all input checks
+   */
+  size_t* dsizes = malloc( num_ptypes * sizeof(size_t) );
+  assert( dsizes != NULL );
+  for( size_t j=0 ; j<num_ptypes ; j++ ) {
+    GDI_GetSizeOfDatatype( &dsizes[j], array_of_ptypes[j]->dtype );
+    array_of_buf_resultcounts[j] = 0;
+  }
+
+  size_t offsets_capacity = 16;
+  size_t* value_offsets = malloc( offsets_capacity * sizeof(size_t) );
+  assert( value_offsets != NULL );
+
+  GDI_VertexHolder_desc_t* loaded = malloc( GDA_LOAD_VERTEX_PROPERTIES_BATCH * sizeof(GDI_VertexHolder_desc_t) );
+  assert( loaded != NULL );
+  GDI_Vertex_uid* uids = malloc( GDA_LOAD_VERTEX_PROPERTIES_BATCH * sizeof(GDI_Vertex_uid) );
+  assert( uids != NULL );
+  GDI_VertexHolder* vertices = malloc( GDA_LOAD_VERTEX_PROPERTIES_BATCH * sizeof(GDI_VertexHolder) );
+  assert( vertices != NULL );
+
+  for( size_t start=0 ; start<count ; start+=GDA_LOAD_VERTEX_PROPERTIES_BATCH ) {
+    size_t batch_size = count - start;
+    if( batch_size > GDA_LOAD_VERTEX_PROPERTIES_BATCH ) {
+      batch_size = GDA_LOAD_VERTEX_PROPERTIES_BATCH;
+    }
+
+    /**
+      vertices, that are already associated with the transaction, don't
+      have to be fetched again
+     */
+    size_t num_loaded = 0;
+    for( size_t i=0 ; i<batch_size ; i++ ) {
+      GDI_VertexHolder* vertex_ptr = GDA_hashmap_get( transaction->v_translate_d2l, (void*) (array_of_uids + start + i) );
+      if( vertex_ptr != NULL ) {
+        vertices[i] = *vertex_ptr;
+      } else {
+        memset( loaded + num_loaded, 0, sizeof(GDI_VertexHolder_desc_t) );
+        uids[num_loaded] = array_of_uids[start+i];
+        vertices[i] = loaded + num_loaded;
+        num_loaded++;
+      }
+    }
+    GDA_LoadVertexProperties( uids, num_loaded, transaction, loaded );
+
+    for( size_t j=0 ; j<num_ptypes ; j++ ) {
+      GDI_PropertyType ptype = array_of_ptypes[j];
+      bool degree_flag = (ptype == GDI_PROPERTY_TYPE_DEGREE) || (ptype == GDI_PROPERTY_TYPE_INDEGREE) || (ptype == GDI_PROPERTY_TYPE_OUTDEGREE);
+      char* buf = (array_of_bufs != NULL) ? array_of_bufs[j] : NULL;
+      size_t buf_count = ((buf != NULL) && (array_of_buf_counts != NULL)) ? array_of_buf_counts[j] : 0;
+      size_t* offsets = (array_of_offsets != NULL) ? array_of_offsets[j] : NULL;
+
+      for( size_t i=0 ; i<batch_size ; i++ ) {
+        GDI_VertexHolder vertex = vertices[i];
+        size_t position = array_of_buf_resultcounts[j];
+        size_t num_properties = 1;
+        size_t num_elements = 1;
+
+        if( !degree_flag ) {
+          GDA_LinearScanningNumProperties( vertex, ptype, &num_properties, &num_elements );
+        }
+
+        if( offsets != NULL ) {
+          offsets[start+i] = position;
+        }
+        array_of_buf_resultcounts[j] += num_elements;
+
+        if( (num_elements == 0) || (array_of_buf_resultcounts[j] > buf_count) ) {
+          continue;
+        }
+
+        if( degree_flag ) {
+          size_t num_edges;
+          if( ptype == GDI_PROPERTY_TYPE_DEGREE ) {
+            GDA_LightweightEdgesDegree( &num_edges, (GDI_EDGE_INCOMING | GDI_EDGE_OUTGOING | GDI_EDGE_UNDIRECTED), vertex );
+          } else {
+            if( ptype == GDI_PROPERTY_TYPE_INDEGREE ) {
+              GDA_LightweightEdgesDegree( &num_edges, GDI_EDGE_INCOMING, vertex );
+            } else {
+              GDA_LightweightEdgesDegree( &num_edges, GDI_EDGE_OUTGOING, vertex );
+            }
+          }
+          ((uint64_t*) buf)[position] = num_edges;
+        } else {
+          if( num_properties+1 > offsets_capacity ) {
+            offsets_capacity = num_properties+1;
+            value_offsets = realloc( value_offsets, offsets_capacity * sizeof(size_t) );
+            assert( value_offsets != NULL );
+          }
+          size_t buf_resultcount, offset_resultcount;
+          GDA_LinearScanningFindAllProperties( buf + position * dsizes[j], num_elements, &buf_resultcount, value_offsets, num_properties+1,
+            &offset_resultcount, ptype, vertex );
+          assert( buf_resultcount == num_elements );
+        }
+      }
+
+      if( (offsets != NULL) && (start+batch_size == count) ) {
+        offsets[count] = array_of_buf_resultcounts[j];
+      }
+    }
+
+    for( size_t i=0 ; i<num_loaded ; i++ ) {
+      GDA_LinearScanningFreePropertyList( loaded + i );
+    }
+  }
+
+  int ret = GDI_SUCCESS;
+  for( size_t j=0 ; j<num_ptypes ; j++ ) {
+    if( (array_of_bufs != NULL) && (array_of_bufs[j] != NULL) && (array_of_buf_counts != NULL) &&
+        (array_of_buf_counts[j] > 0) && (array_of_buf_resultcounts[j] > array_of_buf_counts[j]) ) {
+      ret = GDI_ERROR_TRUNCATE;
+    }
+  }
+
+  free( vertices );
+  free( uids );
+  free( loaded );
+  free( value_offsets );
+  free( dsizes );
+
+  return ret;
+}
+
+
 int GDI_RemovePropertiesFromVertex( GDI_PropertyType ptype, GDI_VertexHolder vertex ) {
   /**
     check the input arguments
@@ -895,11 +1467,12 @@ int GDI_RemovePropertiesFromVertex( GDI_PropertyType ptype, GDI_VertexHolder ver
 
   bool found_flag;
 
+  GDA_SnapshotIndexEntries( vertex );
   GDA_LinearScanningRemoveProperties( ptype, vertex, &found_flag );
   if( found_flag ) {
     vertex->write_flag = true;
+    vertex->property_write_flag = true;
     vertex->transaction->write_flag = true;
-    // TODO: update the index (maybe)
     // TODO: probably have to handle GDI_PROPERTY_TYPE_ID differently
   }
 
@@ -972,11 +1545,12 @@ int GDI_RemoveSpecificPropertyFromVertex( const void* value, size_t count, GDI_P
 
   bool found_flag;
 
+  GDA_SnapshotIndexEntries( vertex );
   GDA_LinearScanningRemoveSpecificProperty( ptype, value, count, vertex, &found_flag );
   if( found_flag ) {
     vertex->write_flag = true;
+    vertex->property_write_flag = true;
     vertex->transaction->write_flag = true;
-    // TODO: update the index (maybe)
     // TODO: probably have to handle GDI_PROPERTY_TYPE_ID differently
   }
 
@@ -1047,12 +1621,13 @@ int GDI_UpdatePropertyOfVertex( const void* value, size_t count, GDI_PropertyTyp
     }
   }
 
+  GDA_SnapshotIndexEntries( vertex );
   int ret = GDA_LinearScanningUpdateSingleEntityProperty( ptype, value, count, vertex );
 
   if( ret == GDI_SUCCESS ) {
     vertex->write_flag = true;
+    vertex->property_write_flag = true;
     vertex->transaction->write_flag = true;
-    // TODO: update the index (maybe)
     // TODO: probably have to handle GDI_PROPERTY_TYPE_ID differently
   }
 
@@ -1119,12 +1694,13 @@ int GDI_UpdateSpecificPropertyOfVertex( const void* old_value, size_t old_count,
     }
   }
 
+  GDA_SnapshotIndexEntries( vertex );
   int ret = GDA_LinearScanningUpdateSpecificProperty( ptype, old_value, old_count, new_value, new_count, vertex );
 
   if( ret == GDI_SUCCESS ) {
     vertex->write_flag = true;
+    vertex->property_write_flag = true;
     vertex->transaction->write_flag = true;
-    // TODO: update the index (maybe)
     // TODO: probably have to handle GDI_PROPERTY_TYPE_ID differently
   }
 
@@ -1197,9 +1773,11 @@ int GDI_SetPropertyOfVertex( const void* value, size_t count, GDI_PropertyType p
 
   bool found_flag;
 
+  GDA_SnapshotIndexEntries( vertex );
   GDA_LinearScanningSetSingleEntityProperty( ptype, value, count, vertex, &found_flag );
 
   vertex->write_flag = true;
+  vertex->property_write_flag = true;
   vertex->transaction->write_flag = true;
 
 #if 0
@@ -1207,7 +1785,6 @@ int GDI_SetPropertyOfVertex( const void* value, size_t count, GDI_PropertyType p
     /**
       found an existing property, removed that one and added a new one
      */
-    // TODO: update the index (maybe)
     // TODO: probably have to handle GDI_PROPERTY_TYPE_ID differently
   }
 #endif